@@ -1,6 +1,10 @@
 ﻿#include "core.hpp"
 
+#include <fstream>
+#include <sstream>
+
 #include <MinHook.h>
+#include <ShlObj.h>
 
 #include "consts.hpp"
 
@@ -9,8 +13,14 @@
 #include "memory/memory_utils.hpp"
 #include "memory/robust_pattern_scanner.hpp"
 #include "debug/debug_helpers.hpp"
+#include "debug/flight_recorder.hpp"
+#include "prism/game_actor.hpp"
 
 #include "managers/window_manager.hpp"
+#include "windows/inspector_window.hpp"
+#include "windows/map_window.hpp"
+#include "windows/memory_diff_window.hpp"
+#include "windows/telemetry_window.hpp"
 #include "windows/trailer_manipulation.hpp"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler( HWND, UINT, WPARAM, LPARAM );
@@ -23,6 +33,11 @@ namespace ts_extra_utilities
     {
         this->hooks_manager_ = new CHooksManager();
         this->window_manager_ = new CWindowManager();
+        this->trailer_control_ = new trailers::CTrailerControlState();
+        this->reverse_controller_ = new trailers::CReverseSteeringController();
+        this->token_dictionary_ = new prism::CTokenDictionary();
+        this->map_index_ = new map::CMapIndex();
+        this->memory_diff_ = new memory::CMemoryDiffRecorder();
         scs_log_ = init_params->common.log;
         g_instance = this;
     }
@@ -53,6 +68,8 @@ namespace ts_extra_utilities
             
             truckersmp_ = GetModuleHandle( L"core_ets2mp.dll" ) != nullptr || GetModuleHandle( L"core_atsmp.dll" ) != nullptr;
 
+            this->load_offset_database();
+
             // Try to initialize DirectX11 hook
             this->dx11_hook = new CDirectX11Hook();
             if ( !this->dx11_hook->hook_present() )
@@ -79,31 +96,15 @@ namespace ts_extra_utilities
             
             this->info("TS-Extra-Utilities: Debug helpers initialized");
 
-            // Register telemetry callbacks for trailer detection (SDK 1.14 approach)
-            this->info("TS-Extra-Utilities: Registering trailer telemetry callbacks...");
-            if (init_params_ && init_params_->register_for_channel) {
-                // Register for each trailer's connected state (trailer.0.connected to trailer.9.connected)
-                for (int i = 0; i < MAX_TRAILERS; i++) {
-                    char channel_name[64];
-                    snprintf(channel_name, sizeof(channel_name), "trailer.%d.connected", i);
-                    
-                    scs_result_t result = init_params_->register_for_channel(
-                        channel_name, 
-                        SCS_U32_NIL,  // Use SCS_U32_NIL for non-array channels
-                        SCS_VALUE_TYPE_bool,  // trailer.X.connected is a boolean value
-                        SCS_TELEMETRY_CHANNEL_FLAG_none,  // no special flags
-                        trailer_connected_callback, 
-                        this
-                    );
-                    if (result == SCS_RESULT_ok) {
-                        this->info("TS-Extra-Utilities: Registered for %s", channel_name);
-                    } else {
-                        this->warning("TS-Extra-Utilities: Failed to register for %s (result: %d)", channel_name, result);
-                    }
-                }
-                this->info("TS-Extra-Utilities: Trailer telemetry registration complete");
+            // Register telemetry events and channels (SDK 1.14 approach)
+            this->info("TS-Extra-Utilities: Registering telemetry callbacks...");
+            this->telemetry_ = new telemetry::CTelemetry(init_params_);
+            if (this->telemetry_->init()) {
+                this->telemetry_->subscribe_frames( on_telemetry_frame, this );
+                this->telemetry_->get_configuration()->subscribe( telemetry::ConfigurationPart::TRAILER, on_configuration_changed, this );
+                this->info("TS-Extra-Utilities: Telemetry registration complete");
             } else {
-                this->error("TS-Extra-Utilities: Cannot register telemetry - init_params or register_for_channel is null");
+                this->error("TS-Extra-Utilities: Telemetry registration failed, trailer state will not be available");
             }
 
             const auto trailer_manipulation = this->window_manager_->register_window( std::make_shared< CTrailerManipulation >() );
@@ -118,6 +119,30 @@ namespace ts_extra_utilities
                 this->info("TS-Extra-Utilities: Trailer manipulation module initialized successfully");
             }
 
+            const auto telemetry_window = this->window_manager_->register_window( std::make_shared< CTelemetryWindow >() );
+            if ( !telemetry_window->init() )
+            {
+                this->error("TS-Extra-Utilities: Could not initialize the telemetry window");
+            }
+
+            const auto map_window = this->window_manager_->register_window( std::make_shared< CMapWindow >() );
+            if ( !map_window->init() )
+            {
+                this->error("TS-Extra-Utilities: Could not initialize the map window");
+            }
+
+            const auto inspector_window = this->window_manager_->register_window( std::make_shared< CInspectorWindow >() );
+            if ( !inspector_window->init() )
+            {
+                this->error("TS-Extra-Utilities: Could not initialize the inspector window");
+            }
+
+            const auto memory_diff_window = this->window_manager_->register_window( std::make_shared< CMemoryDiffWindow >() );
+            if ( !memory_diff_window->init() )
+            {
+                this->error("TS-Extra-Utilities: Could not initialize the memory diff window");
+            }
+
             this->info("TS-Extra-Utilities: Initialization completed successfully");
             return true;
         } catch (const std::exception& e) {
@@ -150,6 +175,32 @@ namespace ts_extra_utilities
             delete this->window_manager_;
             this->window_manager_ = nullptr;
         }
+        if (this->telemetry_) {
+            delete this->telemetry_;
+            this->telemetry_ = nullptr;
+        }
+        // after the hooks are gone, steering_advance reads it on the physics thread
+        if (this->trailer_control_) {
+            delete this->trailer_control_;
+            this->trailer_control_ = nullptr;
+        }
+        // after the telemetry, which calls it at frame_end
+        if (this->reverse_controller_) {
+            delete this->reverse_controller_;
+            this->reverse_controller_ = nullptr;
+        }
+        if (this->token_dictionary_) {
+            delete this->token_dictionary_;
+            this->token_dictionary_ = nullptr;
+        }
+        if (this->map_index_) {
+            delete this->map_index_;
+            this->map_index_ = nullptr;
+        }
+        if (this->memory_diff_) {
+            delete this->memory_diff_;
+            this->memory_diff_ = nullptr;
+        }
         
         debug::CrashHandler::shutdown();
         debug::DebugLogger::info("ATS mod shutdown completed");
@@ -172,8 +223,65 @@ namespace ts_extra_utilities
         return true;
     }
 
+    void CCore::on_telemetry_frame( const telemetry::telemetry_frame_t& frame, void* user_data )
+    {
+        const auto* core = static_cast< CCore* >( user_data );
+
+        float steering[ trailers::MAX_CONTROLLED_TRAILERS ];
+        const auto controlled = core->reverse_controller_->update( frame, steering );
+        for ( uint32_t i = 0; i < trailers::MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            core->trailer_control_->set_controller_steering( i, ( controlled >> i & 1 ) != 0, steering[ i ] );
+        }
+    }
+
+    void CCore::on_configuration_changed( const telemetry::configuration_change_t& change, const telemetry::CConfiguration& configuration,
+                                          void* user_data )
+    {
+        if ( ( change.changes & ( telemetry::ConfigurationChange::PRESENCE | telemetry::ConfigurationChange::WHEELS ) ) == 0 ) return;
+
+        const auto* core = static_cast< CCore* >( user_data );
+        core->reverse_controller_->set_geometry( trailers::make_reverse_rig_geometry( configuration ) );
+    }
+
+    void CCore::refresh_trailer_map( const bool force )
+    {
+        if ( this->telemetry_ == nullptr || this->trailer_control_ == nullptr ) return;
+
+        // the generation is read before walking, a change while walking makes the map stale right away and it's built again next frame
+        const auto generation = this->telemetry_->get_trailer_generation();
+        if ( !force && generation == this->trailer_control_->get_trailer_map_generation() ) return;
+
+        const void* trailers[ trailers::MAX_TRAILERS ] = {};
+        uint32_t count = 0;
+
+        const auto* game_actor = this->get_game_actor();
+        for ( const auto* trailer = game_actor != nullptr ? prism::fields::game_actor::game_trailer_actor( game_actor ) : nullptr;
+              trailer != nullptr && count < trailers::MAX_TRAILERS; trailer = prism::fields::physics_trailer::slave_trailer( trailer ) )
+        {
+            trailers[ count++ ] = static_cast< const prism::physics_trailer_u* >( trailer );
+        }
+
+        this->trailer_control_->rebuild_trailer_map( trailers, count, generation );
+        this->debug( "Trailer map rebuilt: %u trailers, generation %llu", count, generation );
+    }
+
     bool CCore::render()
     {
+        this->refresh_trailer_map();
+
+        // the index reads base_ctrl on its own thread, it only needs someone to have found it
+        if ( this->map_index_ != nullptr && !this->map_index_->is_running() && this->base_ctrl_instance_ptr_address != 0 )
+        {
+            this->map_index_->start( this->base_ctrl_instance_ptr_address );
+        }
+
+        // also while the UI is hidden, a recording with gaps lines up worse with the channel
+        if ( this->memory_diff_ != nullptr && this->memory_diff_->is_recording() )
+        {
+            this->memory_diff_->capture( this->telemetry_ != nullptr ? this->telemetry_->get_frame_store() : nullptr );
+        }
+
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
@@ -294,6 +402,60 @@ namespace ts_extra_utilities
         return base_ctrl_result;
     }
 
+    void CCore::load_offset_database()
+    {
+        const std::string game_id = this->init_params_->common.game_id != nullptr ? this->init_params_->common.game_id : "";
+        const auto is_ats = game_id == "ats"; // SCS_GAME_ID_ATS, ets2 is "eut2"
+        const auto* game = is_ats ? "ats" : "ets2";
+
+        // the pack set version is only in the game's log, it is written before plugins load
+        std::string version;
+        PWSTR documents = nullptr;
+        if ( SUCCEEDED( SHGetKnownFolderPath( FOLDERID_Documents, 0, nullptr, &documents ) ) )
+        {
+            std::wstring log_path = documents;
+            log_path += is_ats ? L"\\American Truck Simulator\\game.log.txt" : L"\\Euro Truck Simulator 2\\game.log.txt";
+            std::ifstream log( log_path, std::ios::binary );
+            std::string head( 64 * 1024, '\0' );
+            log.read( head.data(), static_cast< std::streamsize >( head.size() ) );
+            head.resize( static_cast< size_t >( log.gcount() ) );
+            version = prism::find_pack_set_version( head );
+        }
+        CoTaskMemFree( documents );
+        this->game_name_ = game;
+        this->game_version_ = version;
+
+        wchar_t path[ MAX_PATH ] = {};
+        HMODULE module = nullptr;
+        GetModuleHandleExW( GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast< LPCWSTR >( &CCore::g_instance ), &module );
+        GetModuleFileNameW( module, path, MAX_PATH );
+        std::wstring database_path = path;
+        database_path = database_path.substr( 0, database_path.find_last_of( L"\\/" ) + 1 ) + L"ts-extra-utilities.offsets";
+
+        std::ifstream file( database_path, std::ios::binary );
+        if ( !file )
+        {
+            this->info( "No offset database next to the plugin, using the built in offsets (%s %s)", game, version.c_str() );
+            return;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+
+        std::string error;
+        if ( !prism::parse_offset_database( text.str(), game, version, this->offsets_, error ) )
+        {
+            this->error( "Offset database: %s", error.c_str() );
+        }
+        prism::apply_offset_table( this->offsets_ );
+
+        uint32_t loaded = 0;
+        for ( uint32_t i = 0; i < prism::field_id::COUNT; ++i ) loaded += prism::is_field_loaded( this->offsets_, static_cast< prism::field_id::type >( i ) );
+        if ( this->offsets_.section.empty() ) this->warning( "Offset database has no section for %s %s, using the built in offsets", game, version.c_str() );
+        else this->info( "Offset database: [%s] for %s %s, %u of %u fields", this->offsets_.section.c_str(), game, version.c_str(), loaded,
+                         static_cast< uint32_t >( prism::field_id::COUNT ) );
+    }
+
     prism::game_actor_u* CCore::get_game_actor()
     {
         this->debug("=== GAME ACTOR LOOKUP START ===");
@@ -304,6 +466,11 @@ namespace ts_extra_utilities
         }
         this->debug("Base controller valid: 0x%016llx", reinterpret_cast<uint64_t>(base_ctrl));
 
+        // an offset from the database is tried like a cached one, the probe list below is only the last resort
+        if (this->game_actor_offset_in_base_ctrl == 0 && prism::is_field_loaded(this->offsets_, prism::field_id::base_ctrl_game_actor)) {
+            this->game_actor_offset_in_base_ctrl = this->offsets_.offsets[prism::field_id::base_ctrl_game_actor];
+        }
+
         // Validate the cached offset first
         if (this->game_actor_offset_in_base_ctrl != 0) {
             this->debug("Trying cached offset: 0x%x", this->game_actor_offset_in_base_ctrl);
@@ -405,44 +572,4 @@ namespace ts_extra_utilities
         this->debug("=== GAME ACTOR LOOKUP FAILED ===");
         return nullptr;
     }
-
-    // Telemetry callback for trailer connection states (SDK 1.14 approach)
-    SCSAPI_VOID CCore::trailer_connected_callback(const scs_string_t name, const scs_u32_t index, const scs_value_t* const value, const scs_context_t context)
-    {
-        auto* core = static_cast<CCore*>(context);
-        if (!core || !value || !name) {
-            return;
-        }
-
-        // Parse trailer index from channel name (e.g., "trailer.3.connected" -> index 3)
-        int trailer_index = -1;
-        if (sscanf(name, "trailer.%d.connected", &trailer_index) != 1 || trailer_index < 0 || trailer_index >= MAX_TRAILERS) {
-            core->warning("Invalid trailer channel name: %s", name);
-            return;
-        }
-
-        bool connected = (value->type == SCS_VALUE_TYPE_bool) ? value->value_bool.value : false;
-        bool was_connected = core->trailer_connected_[trailer_index];
-        
-        // Update trailer state
-        core->trailer_connected_[trailer_index] = connected;
-        
-        // Recalculate connected trailer count
-        int count = 0;
-        for (int i = 0; i < MAX_TRAILERS; i++) {
-            if (core->trailer_connected_[i]) {
-                count++;
-            }
-        }
-        core->connected_trailer_count_ = count;
-        
-        // Log changes
-        if (connected != was_connected) {
-            if (connected) {
-                core->info("TRAILER CONNECTED: trailer.%d (total: %d trailers)", trailer_index, count);
-            } else {
-                core->info("TRAILER DISCONNECTED: trailer.%d (total: %d trailers)", trailer_index, count);
-            }
-        }
-    }
 }
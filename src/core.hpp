@@ -6,7 +6,14 @@
 
 #include "graphics/dx11_hook.hpp"
 #include "input/di8_hook.hpp"
+#include "map/map_index.hpp"
 #include "managers/hooks_manager.hpp"
+#include "memory/memory_diff_recorder.hpp"
+#include "prism/offsets.hpp"
+#include "prism/token_dictionary.hpp"
+#include "telemetry/telemetry.hpp"
+#include "trailers/reverse_controller.hpp"
+#include "trailers/trailer_control.hpp"
 
 namespace ts_extra_utilities
 {
@@ -38,10 +45,23 @@ namespace ts_extra_utilities
 
         bool truckersmp_ = false;
         
-        // Trailer telemetry tracking (SDK 1.14 approach)
-        static constexpr int MAX_TRAILERS = 10; // SCS_TELEMETRY_trailers_count
-        bool trailer_connected_[MAX_TRAILERS] = {false};
-        int connected_trailer_count_ = 0;
+        telemetry::CTelemetry* telemetry_ = nullptr;
+        trailers::CTrailerControlState* trailer_control_ = nullptr;
+        trailers::CReverseSteeringController* reverse_controller_ = nullptr;
+        prism::CTokenDictionary* token_dictionary_ = nullptr; // UI thread
+        map::CMapIndex* map_index_ = nullptr; // started once base_ctrl is found
+        memory::CMemoryDiffRecorder* memory_diff_ = nullptr; // render thread
+        prism::offset_table_t offsets_ = {}; // what load_offset_database() applied
+        std::string game_name_; // "ats" or "ets2"
+        std::string game_version_; // pack set version from game.log.txt, empty if it wasn't found
+
+        // picks the game build's section out of ts-extra-utilities.offsets next to the plugin, before anything reads game memory
+        void load_offset_database();
+
+        // SDK thread, feeds the reverse steering controller and hands its output to the trailer control state
+        static void on_telemetry_frame( const telemetry::telemetry_frame_t& frame, void* user_data );
+        static void on_configuration_changed( const telemetry::configuration_change_t& change, const telemetry::CConfiguration& configuration,
+                                              void* user_data );
 
     public:
         static CCore* g_instance;
@@ -56,7 +76,6 @@ namespace ts_extra_utilities
         void destroy();
 
         void tick();
-        void telemetry_config( const scs_telemetry_configuration_t* );
 
         bool on_mouse_input( LPDIDEVICEOBJECTDATA );
         bool render();
@@ -74,13 +93,26 @@ namespace ts_extra_utilities
         prism::base_ctrl_u* get_base_ctrl_instance();
         prism::game_actor_u* get_game_actor();
         
+        telemetry::CTelemetry* get_telemetry() const { return this->telemetry_; }
+        trailers::CTrailerControlState* get_trailer_control() const { return this->trailer_control_; }
+        trailers::CReverseSteeringController* get_reverse_controller() const { return this->reverse_controller_; }
+        prism::CTokenDictionary* get_token_dictionary() const { return this->token_dictionary_; }
+        map::CMapIndex* get_map_index() const { return this->map_index_; }
+        memory::CMemoryDiffRecorder* get_memory_diff() const { return this->memory_diff_; }
+        const prism::offset_table_t& get_offsets() const { return this->offsets_; }
+        const std::string& get_game_name() const { return this->game_name_; }
+        const std::string& get_game_version() const { return this->game_version_; }
+
+        /**
+         * \brief Render thread, rebuilds the trailer control map from the game's trailer chain
+         * \param force also when the telemetry didn't report a change, e.g. right after the UI (dis)connected a trailer
+         */
+        void refresh_trailer_map( bool force = false );
+
         // Trailer telemetry methods (SDK 1.14 approach)
-        bool has_trailers() const { return connected_trailer_count_ > 0; }
-        int get_trailer_count() const { return connected_trailer_count_; }
-        bool is_trailer_connected(int index) const { return index >= 0 && index < MAX_TRAILERS && trailer_connected_[index]; }
-        
-        // Telemetry callback for trailer connection states
-        static SCSAPI_VOID trailer_connected_callback(const scs_string_t name, const scs_u32_t index, const scs_value_t* const value, const scs_context_t context);
+        bool has_trailers() const { return telemetry_ != nullptr && telemetry_->has_trailers(); }
+        int get_trailer_count() const { return telemetry_ != nullptr ? telemetry_->get_trailer_count() : 0; }
+        bool is_trailer_connected(int index) const { return telemetry_ != nullptr && telemetry_->is_trailer_connected(index); }
         
         // Getter for debug information
         uint32_t get_game_actor_offset() const { return game_actor_offset_in_base_ctrl; }
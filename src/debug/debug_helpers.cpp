@@ -0,0 +1,106 @@
+#include "debug_helpers.hpp"
+
+#include <DbgHelp.h>
+#include <mutex>
+
+#include "flight_recorder.hpp"
+
+namespace ts_extra_utilities::debug
+{
+    namespace
+    {
+        std::mutex log_mutex;
+        LPTOP_LEVEL_EXCEPTION_FILTER previous_filter = nullptr;
+        bool crash_handler_installed = false;
+        volatile LONG crash_in_progress = 0;
+    }
+
+    void DebugLogger::init()
+    {
+        CreateDirectoryA( LOG_DIRECTORY, nullptr );
+        write( "info", "---- log opened ----" );
+    }
+
+    void DebugLogger::write( const char* level, const char* message )
+    {
+        std::lock_guard lock( log_mutex );
+
+        FILE* file = nullptr;
+        if ( fopen_s( &file, LOG_PATH, "a" ) != 0 || file == nullptr ) return;
+
+        SYSTEMTIME time;
+        GetLocalTime( &time );
+        fprintf( file, "%02u:%02u:%02u.%03u [%s] %s\n", time.wHour, time.wMinute, time.wSecond, time.wMilliseconds, level, message );
+        fclose( file );
+    }
+
+    bool CrashHandler::write_crash_files( EXCEPTION_POINTERS* exception_info )
+    {
+        SYSTEMTIME time;
+        GetLocalTime( &time );
+
+        char base_path[ MAX_PATH ];
+        snprintf( base_path, sizeof( base_path ), "%s\\ats_mod_crash_%04u%02u%02u_%02u%02u%02u",
+                  DebugLogger::LOG_DIRECTORY, time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond );
+
+        char path[ MAX_PATH ];
+
+        // flight recorder first, it's the part that can't be reconstructed from the dump
+        snprintf( path, sizeof( path ), "%s.tsfr", base_path );
+        const bool recorder_written = CFlightRecorder::get().dump( path );
+
+        snprintf( path, sizeof( path ), "%s.dmp", base_path );
+        bool dump_written = false;
+        const HANDLE file = CreateFileA( path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if ( file != INVALID_HANDLE_VALUE )
+        {
+            MINIDUMP_EXCEPTION_INFORMATION dump_exception_info{};
+            dump_exception_info.ThreadId = GetCurrentThreadId();
+            dump_exception_info.ExceptionPointers = exception_info;
+            dump_exception_info.ClientPointers = FALSE;
+
+            dump_written = MiniDumpWriteDump( GetCurrentProcess(), GetCurrentProcessId(), file,
+                                              static_cast< MINIDUMP_TYPE >( MiniDumpWithIndirectlyReferencedMemory | MiniDumpWithThreadInfo ),
+                                              exception_info != nullptr ? &dump_exception_info : nullptr, nullptr, nullptr ) != FALSE;
+            CloseHandle( file );
+        }
+
+        DebugLogger::error( "Crash 0x%08x: minidump %s, flight recorder %s (%s.*)",
+                            exception_info != nullptr ? exception_info->ExceptionRecord->ExceptionCode : 0,
+                            dump_written ? "written" : "FAILED", recorder_written ? "written" : "FAILED", base_path );
+        return dump_written && recorder_written;
+    }
+
+    LONG WINAPI CrashHandler::unhandled_exception_filter( EXCEPTION_POINTERS* exception_info )
+    {
+        // only the first crashing thread writes files
+        if ( InterlockedCompareExchange( &crash_in_progress, 1, 0 ) == 0 )
+        {
+            write_crash_files( exception_info );
+        }
+
+        if ( previous_filter != nullptr )
+        {
+            return previous_filter( exception_info );
+        }
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    void CrashHandler::initialize()
+    {
+        if ( crash_handler_installed ) return;
+
+        previous_filter = SetUnhandledExceptionFilter( unhandled_exception_filter );
+        crash_handler_installed = true;
+        record_event( FlightEvent::MESSAGE, "crash_handler_installed" );
+    }
+
+    void CrashHandler::shutdown()
+    {
+        if ( !crash_handler_installed ) return;
+
+        SetUnhandledExceptionFilter( previous_filter );
+        previous_filter = nullptr;
+        crash_handler_installed = false;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <Windows.h>
+#include <cstdio>
+
+namespace ts_extra_utilities::debug
+{
+    /**
+     * \brief File logger that keeps working when the game log is not available (early init, shutdown, crashes)
+     */
+    class DebugLogger
+    {
+    public:
+        static constexpr const char* LOG_DIRECTORY = "C:\\Temp";
+        static constexpr const char* LOG_PATH = "C:\\Temp\\ats_mod_log.txt";
+
+        static void init();
+        static void write( const char* level, const char* message );
+
+        template < typename... Args >
+        static void info( const char* message, Args&&... args )
+        {
+            char buffer[ 1024 ];
+            snprintf( buffer, sizeof( buffer ), message, args... );
+            write( "info", buffer );
+        }
+
+        template < typename... Args >
+        static void warning( const char* message, Args&&... args )
+        {
+            char buffer[ 1024 ];
+            snprintf( buffer, sizeof( buffer ), message, args... );
+            write( "warning", buffer );
+        }
+
+        template < typename... Args >
+        static void error( const char* message, Args&&... args )
+        {
+            char buffer[ 1024 ];
+            snprintf( buffer, sizeof( buffer ), message, args... );
+            write( "error", buffer );
+        }
+    };
+
+    /**
+     * \brief Writes a minidump and the flight recorder rings next to each other when the game crashes
+     */
+    class CrashHandler
+    {
+    private:
+        static LONG WINAPI unhandled_exception_filter( EXCEPTION_POINTERS* exception_info );
+
+    public:
+        static void initialize();
+        static void shutdown();
+
+        // writes <base>.dmp and <base>.tsfr into the log directory, returns false if either failed
+        static bool write_crash_files( EXCEPTION_POINTERS* exception_info );
+    };
+}
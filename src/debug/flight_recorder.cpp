@@ -0,0 +1,327 @@
+#include "flight_recorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ts_extra_utilities::debug
+{
+    static_assert(( CFlightRecorder::RING_CAPACITY & ( CFlightRecorder::RING_CAPACITY - 1 ) ) == 0, "RING_CAPACITY must be a power of two");
+
+    namespace
+    {
+        uint64_t now_ns()
+        {
+            return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now().time_since_epoch() ).count() );
+        }
+
+        uint32_t current_thread_id()
+        {
+            thread_local uint32_t thread_id = 0;
+            if ( thread_id == 0 )
+            {
+#ifdef _WIN32
+                thread_id = GetCurrentThreadId();
+#else
+                thread_id = static_cast< uint32_t >( syscall( SYS_gettid ) );
+#endif
+            }
+            return thread_id;
+        }
+
+        // keep the end of long names, "prism::physics_trailer_u::connect_slave" is more useful as "..._u::connect_slave"
+        void copy_tag( char ( &dest )[ 24 ], const char* tag )
+        {
+            std::memset( dest, 0, sizeof( dest ) );
+            if ( tag == nullptr ) return;
+
+            const auto len = std::strlen( tag );
+            const auto* start = len > sizeof( dest ) ? tag + ( len - sizeof( dest ) ) : tag;
+            std::memcpy( dest, start, std::min( len, sizeof( dest ) ) );
+        }
+
+        // unbuffered OS file, stdio allocates its buffer and takes the CRT lock
+        class CRawFile
+        {
+#ifdef _WIN32
+            HANDLE handle_;
+
+        public:
+            explicit CRawFile( const char* path ) : handle_( CreateFileA( path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) ) {}
+            ~CRawFile() { if ( this->is_open() ) CloseHandle( this->handle_ ); }
+
+            bool is_open() const { return this->handle_ != INVALID_HANDLE_VALUE; }
+
+            bool write( const void* data, const size_t size ) const
+            {
+                DWORD written = 0;
+                return WriteFile( this->handle_, data, static_cast< DWORD >( size ), &written, nullptr ) != FALSE && written == size;
+            }
+#else
+            int fd_;
+
+        public:
+            explicit CRawFile( const char* path ) : fd_( open( path, O_WRONLY | O_CREAT | O_TRUNC, 0644 ) ) {}
+            ~CRawFile() { if ( this->is_open() ) close( this->fd_ ); }
+
+            bool is_open() const { return this->fd_ >= 0; }
+
+            bool write( const void* data, const size_t size ) const
+            {
+                return ::write( this->fd_, data, size ) == static_cast< ssize_t >( size );
+            }
+#endif
+
+            CRawFile( const CRawFile& ) = delete;
+            CRawFile& operator=( const CRawFile& ) = delete;
+        };
+
+        CFlightRecorder g_flight_recorder;
+    }
+
+    const char* to_string( const FlightEvent::Enum type )
+    {
+        switch ( type )
+        {
+            case FlightEvent::HOOK_CALL: return "hook_call";
+            case FlightEvent::HOOK_STATE: return "hook_state";
+            case FlightEvent::TRAILER_OPERATION: return "trailer_op";
+            case FlightEvent::PATTERN_HIT: return "pattern_hit";
+            case FlightEvent::PATTERN_MISS: return "pattern_miss";
+            case FlightEvent::TELEMETRY_TRANSITION: return "telemetry";
+            case FlightEvent::MESSAGE: return "message";
+            case FlightEvent::GAMEPLAY: return "gameplay";
+            default: return "none";
+        }
+    }
+
+    CFlightRecorder::CFlightRecorder()
+    {
+        this->rings_[ RING_COUNT ].shared = true;
+    }
+
+    CFlightRecorder& CFlightRecorder::get()
+    {
+        return g_flight_recorder;
+    }
+
+    CFlightRecorder::ring_t* CFlightRecorder::acquire_ring()
+    {
+        thread_local ring_t* ring = nullptr;
+        if ( ring != nullptr ) return ring;
+
+        const auto index = this->rings_in_use_.fetch_add( 1, std::memory_order_relaxed );
+        if ( index < RING_COUNT )
+        {
+            ring = &this->rings_[ index ];
+            ring->thread_id = current_thread_id();
+        }
+        else
+        {
+            ring = &this->rings_[ RING_COUNT ];
+        }
+        return ring;
+    }
+
+    void CFlightRecorder::record( const FlightEvent::Enum type, const char* tag, const uint64_t arg0, const uint64_t arg1, const uint16_t code )
+    {
+        if ( !this->enabled_.load( std::memory_order_relaxed ) ) return;
+
+        auto* ring = this->acquire_ring();
+
+        // owned rings have a single writer so a plain increment is enough, the overflow ring needs the RMW
+        const auto sequence = ring->shared
+                                  ? ring->head.fetch_add( 1, std::memory_order_relaxed ) + 1
+                                  : ring->head.load( std::memory_order_relaxed ) + 1;
+        if ( !ring->shared ) ring->head.store( sequence, std::memory_order_relaxed );
+
+        auto& slot = ring->slots[ ( sequence - 1 ) & ( RING_CAPACITY - 1 ) ];
+        slot.sequence.store( 0, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        slot.record.timestamp = now_ns();
+        slot.record.thread_id = ring->shared ? current_thread_id() : ring->thread_id;
+        slot.record.type = type;
+        slot.record.code = code;
+        slot.record.arg0 = arg0;
+        slot.record.arg1 = arg1;
+        copy_tag( slot.record.tag, tag );
+
+        slot.sequence.store( sequence, std::memory_order_release );
+    }
+
+    bool CFlightRecorder::read_slot( const slot_t& slot, flight_record_entry_t& out )
+    {
+        const auto before = slot.sequence.load( std::memory_order_acquire );
+        if ( before == 0 ) return false;
+
+        std::memcpy( &out.record, &slot.record, sizeof( out.record ) );
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        // the writer lapped us while copying, drop the torn record
+        if ( slot.sequence.load( std::memory_order_relaxed ) != before ) return false;
+
+        out.sequence = before;
+        return true;
+    }
+
+    std::vector< flight_record_entry_t > CFlightRecorder::snapshot() const
+    {
+        std::vector< flight_record_entry_t > result;
+        result.reserve( static_cast< size_t >( RING_COUNT + 1 ) * RING_CAPACITY );
+
+        for ( const auto& ring : this->rings_ )
+        {
+            for ( const auto& slot : ring.slots )
+            {
+                flight_record_entry_t entry{};
+                if ( read_slot( slot, entry ) ) result.push_back( entry );
+            }
+        }
+
+        std::sort( result.begin(), result.end(), []( const flight_record_entry_t& a, const flight_record_entry_t& b )
+        {
+            return a.record.timestamp < b.record.timestamp;
+        } );
+        return result;
+    }
+
+    bool CFlightRecorder::dump( const char* path ) const
+    {
+        static_assert(RING_CAPACITY % DUMP_BATCH == 0, "dump() writes whole batches");
+
+        const CRawFile file( path );
+        if ( !file.is_open() ) return false;
+
+        flight_recorder_file_header_t header{};
+        header.magic = FLIGHT_RECORDER_MAGIC;
+        header.version = FLIGHT_RECORDER_VERSION;
+        header.entry_size = sizeof( flight_record_entry_t );
+        header.ring_count = RING_COUNT + 1;
+        header.ring_capacity = RING_CAPACITY;
+        header.dump_timestamp = now_ns();
+
+        bool ok = file.write( &header, sizeof( header ) );
+
+        for ( const auto& ring : this->rings_ )
+        {
+            flight_recorder_ring_header_t ring_header{};
+            ring_header.thread_id = ring.shared ? 0 : ring.thread_id;
+            ring_header.flags = ring.shared ? 1 : 0;
+            ring_header.head = ring.head.load( std::memory_order_acquire );
+            ok = ok && file.write( &ring_header, sizeof( ring_header ) );
+
+            // batches through the recorder's own buffer, the heap or the stack may be what's broken when we get here
+            for ( uint32_t i = 0; i < RING_CAPACITY && ok; i += DUMP_BATCH )
+            {
+                for ( uint32_t j = 0; j < DUMP_BATCH; ++j )
+                {
+                    if ( !read_slot( ring.slots[ i + j ], this->dump_batch_[ j ] ) )
+                    {
+                        std::memset( &this->dump_batch_[ j ], 0, sizeof( this->dump_batch_[ j ] ) );
+                    }
+                }
+                ok = file.write( this->dump_batch_, sizeof( this->dump_batch_ ) );
+            }
+        }
+        return ok;
+    }
+
+    bool parse_flight_recorder_dump( const uint8_t* data, const size_t size, flight_recorder_dump_t& out, std::string& error )
+    {
+        out = {};
+        if ( data == nullptr || size < sizeof( flight_recorder_file_header_t ) )
+        {
+            error = "file is too small for a flight recorder header";
+            return false;
+        }
+
+        std::memcpy( &out.header, data, sizeof( out.header ) );
+        if ( out.header.magic != FLIGHT_RECORDER_MAGIC )
+        {
+            error = "bad magic, not a flight recorder dump";
+            return false;
+        }
+        if ( out.header.version != FLIGHT_RECORDER_VERSION || out.header.entry_size != sizeof( flight_record_entry_t ) )
+        {
+            error = "unsupported flight recorder version " + std::to_string( out.header.version );
+            return false;
+        }
+
+        const auto ring_size = sizeof( flight_recorder_ring_header_t ) +
+                               static_cast< size_t >( out.header.ring_capacity ) * sizeof( flight_record_entry_t );
+        if ( size < sizeof( out.header ) + ring_size * out.header.ring_count )
+        {
+            error = "file is truncated";
+            return false;
+        }
+
+        const auto* cursor = data + sizeof( out.header );
+        out.rings.resize( out.header.ring_count );
+        for ( auto& ring_header : out.rings )
+        {
+            std::memcpy( &ring_header, cursor, sizeof( ring_header ) );
+            cursor += sizeof( ring_header );
+
+            for ( uint32_t i = 0; i < out.header.ring_capacity; ++i, cursor += sizeof( flight_record_entry_t ) )
+            {
+                flight_record_entry_t entry{};
+                std::memcpy( &entry, cursor, sizeof( entry ) );
+                if ( entry.sequence != 0 ) out.entries.push_back( entry );
+            }
+        }
+
+        std::stable_sort( out.entries.begin(), out.entries.end(), []( const flight_record_entry_t& a, const flight_record_entry_t& b )
+        {
+            return a.record.timestamp < b.record.timestamp;
+        } );
+        return true;
+    }
+
+    bool load_flight_recorder_dump( const char* path, flight_recorder_dump_t& out, std::string& error )
+    {
+        FILE* file = std::fopen( path, "rb" );
+        if ( file == nullptr )
+        {
+            error = std::string( "could not open " ) + path;
+            return false;
+        }
+
+        std::vector< uint8_t > data;
+        uint8_t buffer[ 16384 ];
+        size_t read;
+        while ( ( read = std::fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+        {
+            data.insert( data.end(), buffer, buffer + read );
+        }
+        std::fclose( file );
+
+        return parse_flight_recorder_dump( data.data(), data.size(), out, error );
+    }
+
+    std::string format_flight_record( const flight_record_t& record, const uint64_t base_timestamp )
+    {
+        char tag[ sizeof( record.tag ) + 1 ] = {};
+        std::memcpy( tag, record.tag, sizeof( record.tag ) );
+
+        // negative = before the base (e.g. dump time), shown in milliseconds
+        const auto relative_ms = ( static_cast< double >( record.timestamp ) - static_cast< double >( base_timestamp ) ) / 1e6;
+
+        char buffer[ 256 ];
+        snprintf( buffer, sizeof( buffer ), "%12.3f ms  tid %-6u %-12s %-24s code=%-5u arg0=0x%016" PRIx64 " arg1=0x%016" PRIx64,
+                  relative_ms, record.thread_id, to_string( static_cast< FlightEvent::Enum >( record.type ) ), tag,
+                  record.code, record.arg0, record.arg1 );
+        return buffer;
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ts_extra_utilities::debug
+{
+    struct FlightEvent
+    {
+        enum Enum : uint16_t
+        {
+            NONE,
+            HOOK_CALL, // a detour was entered
+            HOOK_STATE, // a hook was created/enabled/disabled, code = CHook::Enum
+            TRAILER_OPERATION, // code = TrailerOperation::Enum
+            PATTERN_HIT, // code = pattern index, arg0 = offset from module base
+            PATTERN_MISS,
+            TELEMETRY_TRANSITION, // code = channel index, arg0 = new value
+            MESSAGE,
+            GAMEPLAY, // code = GameplayEventType, arg0 = event sequence, arg1 = render time
+        };
+    };
+
+    struct TrailerOperation
+    {
+        enum Enum : uint16_t
+        {
+            CONNECT,
+            DISCONNECT,
+            LOCK_STEERING,
+            UNLOCK_STEERING,
+            SET_STEERING,
+            LOCK_JOINT,
+            UNLOCK_JOINT,
+        };
+    };
+
+    const char* to_string( FlightEvent::Enum type );
+
+#pragma pack(push, 1)
+    struct flight_record_t // size: 0x0038
+    {
+        uint64_t timestamp; // 0x0000 (0x08) steady clock, nanoseconds
+        uint32_t thread_id; // 0x0008 (0x04)
+        uint16_t type; // 0x000C (0x02) FlightEvent::Enum
+        uint16_t code; // 0x000E (0x02) event specific
+        uint64_t arg0; // 0x0010 (0x08)
+        uint64_t arg1; // 0x0018 (0x08)
+        char tag[ 24 ]; // 0x0020 (0x18) nul padded, not nul terminated when full
+    };
+
+    static_assert(sizeof( flight_record_t ) == 0x38);
+
+    struct flight_record_entry_t // size: 0x0040
+    {
+        uint64_t sequence; // 0x0000 (0x08) 1-based write index in its ring
+        flight_record_t record; // 0x0008 (0x38)
+    };
+
+    static_assert(sizeof( flight_record_entry_t ) == 0x40);
+
+    // dump layout: header, then ring_count * ( ring header, ring_capacity * entry )
+    struct flight_recorder_file_header_t // size: 0x0020
+    {
+        uint32_t magic; // 0x0000 (0x04) 'TSFR'
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t entry_size; // 0x0006 (0x02)
+        uint32_t ring_count; // 0x0008 (0x04)
+        uint32_t ring_capacity; // 0x000C (0x04)
+        uint64_t dump_timestamp; // 0x0010 (0x08) same clock as the records
+        uint64_t reserved; // 0x0018 (0x08)
+    };
+
+    static_assert(sizeof( flight_recorder_file_header_t ) == 0x20);
+
+    struct flight_recorder_ring_header_t // size: 0x0010
+    {
+        uint32_t thread_id; // 0x0000 (0x04) 0 for the shared overflow ring
+        uint32_t flags; // 0x0004 (0x04) 1 = shared
+        uint64_t head; // 0x0008 (0x08) sequence of the next write
+    };
+
+    static_assert(sizeof( flight_recorder_ring_header_t ) == 0x10);
+#pragma pack(pop)
+
+    constexpr uint32_t FLIGHT_RECORDER_MAGIC = 0x52465354; // "TSFR" on disk
+    constexpr uint16_t FLIGHT_RECORDER_VERSION = 1;
+
+    /**
+     * \brief Always-on, fixed-size in-memory log of the most recent plugin events.
+     *
+     * Every thread that records gets its own ring on first use so the hot path is a
+     * thread_local lookup, a clock read and a single-writer store; threads beyond
+     * RING_COUNT share an overflow ring. Nothing is allocated after construction, so the
+     * crash handler can dump it from inside an exception filter.
+     */
+    class CFlightRecorder
+    {
+    public:
+        static constexpr uint32_t RING_COUNT = 16;
+        static constexpr uint32_t RING_CAPACITY = 512; // must be a power of two
+
+    private:
+        struct alignas( 64 ) slot_t
+        {
+            std::atomic< uint64_t > sequence; // 0 while being written
+            flight_record_t record;
+        };
+
+        static_assert(sizeof( slot_t ) == 64);
+
+        struct alignas( 64 ) ring_t
+        {
+            std::atomic< uint64_t > head;
+            uint32_t thread_id;
+            bool shared;
+            slot_t slots[ RING_CAPACITY ];
+        };
+
+        ring_t rings_[ RING_COUNT + 1 ] = {}; // last one is the shared overflow ring
+        std::atomic< uint32_t > rings_in_use_ = 0;
+        std::atomic< bool > enabled_ = true;
+
+        static constexpr uint32_t DUMP_BATCH = 32;
+        mutable flight_record_entry_t dump_batch_[ DUMP_BATCH ] = {}; // dump() writes through this, one dump at a time
+
+        ring_t* acquire_ring();
+        static bool read_slot( const slot_t& slot, flight_record_entry_t& out );
+
+    public:
+        CFlightRecorder();
+
+        static CFlightRecorder& get();
+
+        void record( FlightEvent::Enum type, const char* tag, uint64_t arg0 = 0, uint64_t arg1 = 0, uint16_t code = 0 );
+
+        void set_enabled( const bool enabled ) { this->enabled_.store( enabled, std::memory_order_relaxed ); }
+        bool is_enabled() const { return this->enabled_.load( std::memory_order_relaxed ); }
+
+        // Copies every consistent record out of the rings, oldest first.
+        std::vector< flight_record_entry_t > snapshot() const;
+
+        // Writes the raw rings to `path` with the OS file API and a buffer preallocated in the recorder, no heap and no
+        // CRT locks, safe to call from a crash handler. Not reentrant.
+        bool dump( const char* path ) const;
+    };
+
+    inline void record_event( const FlightEvent::Enum type, const char* tag, const uint64_t arg0 = 0, const uint64_t arg1 = 0, const uint16_t code = 0 )
+    {
+        CFlightRecorder::get().record( type, tag, arg0, arg1, code );
+    }
+
+    struct flight_recorder_dump_t
+    {
+        flight_recorder_file_header_t header{};
+        std::vector< flight_recorder_ring_header_t > rings;
+        std::vector< flight_record_entry_t > entries; // merged from all rings, ordered by timestamp
+    };
+
+    // Portable reader for files written by CFlightRecorder::dump.
+    bool parse_flight_recorder_dump( const uint8_t* data, size_t size, flight_recorder_dump_t& out, std::string& error );
+    bool load_flight_recorder_dump( const char* path, flight_recorder_dump_t& out, std::string& error );
+
+    std::string format_flight_record( const flight_record_t& record, uint64_t base_timestamp );
+}
@@ -3,6 +3,7 @@
 #include <MinHook.h>
 
 #include "core.hpp"
+#include "debug/flight_recorder.hpp"
 
 namespace ts_extra_utilities
 {
@@ -24,6 +25,7 @@ namespace ts_extra_utilities
             return this->status_;
         }
         this->status_ = CREATED;
+        debug::record_event( debug::FlightEvent::HOOK_STATE, this->name_.c_str(), this->original_address_, 0, this->status_ );
         return this->status_;
     }
 
@@ -52,6 +54,7 @@ namespace ts_extra_utilities
             return this->status_;
         }
         this->status_ = HOOKED;
+        debug::record_event( debug::FlightEvent::HOOK_STATE, this->name_.c_str(), this->original_address_, 0, this->status_ );
         return this->status_;
     }
 
@@ -69,6 +72,7 @@ namespace ts_extra_utilities
         }
 
         this->status_ = CREATED;
+        debug::record_event( debug::FlightEvent::HOOK_STATE, this->name_.c_str(), this->original_address_, 0, this->status_ );
         return this->status_;
     }
 
@@ -1,6 +1,7 @@
 #include "vtable_hook.hpp"
 
 #include "core.hpp"
+#include "debug/flight_recorder.hpp"
 
 namespace ts_extra_utilities
 {
@@ -25,6 +26,7 @@ namespace ts_extra_utilities
         VirtualProtect( reinterpret_cast< LPVOID >( this->original_address_ ), 8, old_protect, nullptr );
 
         this->status_ = HOOKED;
+        debug::record_event( debug::FlightEvent::HOOK_STATE, this->name_.c_str(), this->original_address_, 0, this->status_ );
         return this->status_;
     }
 
@@ -49,6 +51,7 @@ namespace ts_extra_utilities
         VirtualProtect( reinterpret_cast< LPVOID >( this->original_address_ ), 8, old_protect, nullptr );
 
         this->status_ = UNHOOKED;
+        debug::record_event( debug::FlightEvent::HOOK_STATE, this->name_.c_str(), this->original_address_, 0, this->status_ );
         return this->status_;
     }
 }
@@ -0,0 +1,192 @@
+#include "map_index.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+
+#include "memory/safe_read.hpp"
+#include "prism/collections/array_span.hpp"
+#include "prism/controllers/base_ctrl.hpp"
+#include "prism/offsets.hpp"
+
+namespace ts_extra_utilities::map
+{
+    namespace
+    {
+        constexpr float WORLD_LIMIT = 1.0e6f; // meters from the origin, horizontally
+        constexpr float HEIGHT_LIMIT = 1.0e4f;
+
+        // array_dyn_t without the virtual destructor, so it can be copied out of the game
+        struct raw_array_t
+        {
+            uint64_t vtable;
+            uint64_t value;
+            uint64_t size;
+            uint64_t capacity;
+        };
+
+        static_assert(sizeof( raw_array_t ) == sizeof( prism::array_dyn_t< void* > ));
+
+        bool is_world_position( const float3_t& position )
+        {
+            if ( !std::isfinite( position.x ) || !std::isfinite( position.y ) || !std::isfinite( position.z ) ) return false;
+            if ( position.x == 0.0f && position.y == 0.0f && position.z == 0.0f ) return false;
+            return std::fabs( position.x ) < WORLD_LIMIT && std::fabs( position.z ) < WORLD_LIMIT && std::fabs( position.y ) < HEIGHT_LIMIT;
+        }
+    }
+
+    CMapIndex::~CMapIndex()
+    {
+        this->stop();
+    }
+
+    void CMapIndex::start( const uint64_t base_ctrl_pointer )
+    {
+        if ( this->running_.load( std::memory_order_relaxed ) ) return;
+
+        this->base_ctrl_pointer_ = base_ctrl_pointer;
+        this->running_.store( true, std::memory_order_release );
+        this->worker_ = std::thread( &CMapIndex::run, this );
+    }
+
+    void CMapIndex::stop()
+    {
+        if ( !this->running_.exchange( false ) ) return;
+        if ( this->worker_.joinable() ) this->worker_.join();
+    }
+
+    std::shared_ptr< const CSpatialGrid > CMapIndex::get_grid() const
+    {
+        std::lock_guard lock( this->grid_mutex_ );
+        return this->grid_;
+    }
+
+    void CMapIndex::run()
+    {
+        constexpr uint32_t SLEEP_STEP_MS = 50;
+
+        while ( this->running_.load( std::memory_order_acquire ) )
+        {
+            uint32_t added = 0, removed = 0;
+            if ( this->refresh( added, removed ) && ( added != 0 || removed != 0 || this->builds_.load( std::memory_order_relaxed ) == 0 ) )
+            {
+                this->last_added_.store( added, std::memory_order_relaxed );
+                this->last_removed_.store( removed, std::memory_order_relaxed );
+                this->build();
+            }
+
+            for ( uint32_t slept = 0; slept < REFRESH_INTERVAL_MS && this->running_.load( std::memory_order_acquire ); slept += SLEEP_STEP_MS )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( SLEEP_STEP_MS ) );
+            }
+        }
+    }
+
+    bool CMapIndex::refresh( uint32_t& added, uint32_t& removed )
+    {
+        uint64_t base_ctrl = 0;
+        if ( !memory::safe_read( this->base_ctrl_pointer_, base_ctrl ) || base_ctrl == 0 ) return false;
+
+        const auto* instance = reinterpret_cast< const prism::base_ctrl_u* >( base_ctrl );
+        const auto nodes = this->refresh_kind( MapItemKind::NODE, reinterpret_cast< uint64_t >( &instance->map_nodes ), added, removed );
+        const auto kdop_items = this->refresh_kind( MapItemKind::KDOP_ITEM, reinterpret_cast< uint64_t >( &instance->map_kdop_items ), added, removed );
+        return nodes || kdop_items;
+    }
+
+    bool CMapIndex::refresh_kind( const MapItemKind::Enum kind, const uint64_t array_address, uint32_t& added, uint32_t& removed )
+    {
+        raw_array_t array{};
+        if ( !memory::safe_read( array_address, array ) || array.size > MAX_ITEMS || array.size > array.capacity ) return false;
+
+        std::vector< uint64_t > current( array.size );
+        if ( array.size != 0 && !memory::safe_copy( current.data(), array.value, array.size * sizeof( uint64_t ) ) ) return false;
+
+        // the game may have grown the array while it was copied
+        raw_array_t check{};
+        if ( !memory::safe_read( array_address, check ) || check.value != array.value || check.size != array.size ) return false;
+
+        std::vector< uint64_t > sorted = current;
+        std::sort( sorted.begin(), sorted.end() );
+        sorted.erase( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+        if ( !sorted.empty() && sorted.front() == 0 ) sorted.erase( sorted.begin() );
+
+        auto& known = this->known_[ kind ];
+        std::vector< uint64_t > changed;
+        std::set_difference( known.begin(), known.end(), sorted.begin(), sorted.end(), std::back_inserter( changed ) );
+        for ( const auto address : changed ) this->items_.erase( address );
+        removed += static_cast< uint32_t >( changed.size() );
+
+        // new items and known addresses in another slot than last time, the latter may be another item now
+        auto& slots = this->slots_[ kind ];
+        std::vector< const uint8_t* > read;
+        for ( size_t i = 0; i < current.size(); ++i )
+        {
+            if ( current[ i ] != 0 && ( i >= slots.size() || slots[ i ] != current[ i ] ) ) read.push_back( reinterpret_cast< const uint8_t* >( current[ i ] ) );
+        }
+        std::sort( read.begin(), read.end() );
+        read.erase( std::unique( read.begin(), read.end() ), read.end() );
+
+        // a whole sector's items appear at once, the misses of the next ones overlap with reading this one. The items
+        // are still read with safe_read, prefetching never faults
+        const auto position_offset = kind == MapItemKind::NODE ? prism::g_field_offsets[ prism::field_id::node_item_position ]
+                                                               : prism::g_field_offsets[ prism::field_id::kdop_item_bounds_min ];
+        for ( const auto* object : prism::prefetching( prism::array_span_t< const uint8_t* >( read.data(), read.size() ), position_offset ) )
+        {
+            const auto address = reinterpret_cast< uint64_t >( object );
+            map_item_t item;
+            if ( read_item( kind, address, item ) ) this->items_[ address ] = item;
+            else
+            {
+                this->items_.erase( address );
+                this->rejected_.fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+        added += static_cast< uint32_t >( read.size() );
+
+        known = std::move( sorted );
+        slots = std::move( current );
+        return true;
+    }
+
+    bool CMapIndex::read_item( const MapItemKind::Enum kind, const uint64_t address, map_item_t& item )
+    {
+        item = { {}, kind, address };
+        if ( kind == MapItemKind::NODE )
+        {
+            if ( !memory::safe_read( address + prism::g_field_offsets[ prism::field_id::node_item_position ], item.position ) ) return false;
+        }
+        else
+        {
+            // the middle of its bounding volume
+            float3_t min, max;
+            if ( !memory::safe_read( address + prism::g_field_offsets[ prism::field_id::kdop_item_bounds_min ], min ) ||
+                 !memory::safe_read( address + prism::g_field_offsets[ prism::field_id::kdop_item_bounds_max ], max ) )
+            {
+                return false;
+            }
+            if ( !( min.x <= max.x && min.y <= max.y && min.z <= max.z ) ) return false;
+            item.position = { ( min.x + max.x ) * 0.5f, ( min.y + max.y ) * 0.5f, ( min.z + max.z ) * 0.5f };
+        }
+        return is_world_position( item.position );
+    }
+
+    void CMapIndex::build()
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector< map_item_t > items;
+        items.reserve( this->items_.size() );
+        for ( const auto& [ address, item ] : this->items_ ) items.push_back( item );
+        auto grid = std::make_shared< const CSpatialGrid >( items.data(), items.size() );
+
+        {
+            std::lock_guard lock( this->grid_mutex_ );
+            this->grid_ = std::move( grid );
+        }
+
+        const auto elapsed = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - start ).count();
+        this->build_microseconds_.store( static_cast< uint32_t >( elapsed ), std::memory_order_relaxed );
+        this->builds_.fetch_add( 1, std::memory_order_relaxed );
+    }
+}
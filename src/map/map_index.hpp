@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "spatial_grid.hpp"
+
+namespace ts_extra_utilities::map
+{
+    /**
+     * \brief Keeps a spatial grid over base_ctrl's map_nodes and map_kdop_items up to date on a background thread.
+     *
+     * Every refresh copies the two item pointer arrays and compares them with the last ones slot by slot. Map items
+     * don't move, so only the item in a slot that changed is read, and items that went away with their sector are
+     * dropped. An address the game reused for another item almost always lands in another slot than before, so it's
+     * read again instead of keeping the old item's position. When anything changed a new grid is built and swapped
+     * in, readers keep using the grid they got until they let go of it.
+     */
+    class CMapIndex
+    {
+    private:
+        static constexpr uint32_t REFRESH_INTERVAL_MS = 500;
+        static constexpr uint64_t MAX_ITEMS = 4000000; // a size past this was read while the game reallocated the array
+
+        std::thread worker_;
+        std::atomic< bool > running_ = false;
+        uint64_t base_ctrl_pointer_ = 0; // the game's base_ctrl instance pointer, read on every refresh
+
+        mutable std::mutex grid_mutex_;
+        std::shared_ptr< const CSpatialGrid > grid_;
+
+        // worker thread only
+        std::vector< uint64_t > known_[ MapItemKind::COUNT ]; // item addresses of the last refresh, sorted
+        std::vector< uint64_t > slots_[ MapItemKind::COUNT ]; // the item array of the last refresh as the game had it
+        std::unordered_map< uint64_t, map_item_t > items_;
+
+        std::atomic< uint32_t > rejected_ = 0; // items whose position didn't look like world coordinates
+        std::atomic< uint32_t > last_added_ = 0; // read, new items and ones in a changed slot
+        std::atomic< uint32_t > last_removed_ = 0;
+        std::atomic< uint32_t > build_microseconds_ = 0;
+        std::atomic< uint64_t > builds_ = 0;
+
+        void run();
+        // false if base_ctrl or an array couldn't be read consistently, nothing is changed then
+        bool refresh( uint32_t& added, uint32_t& removed );
+        bool refresh_kind( MapItemKind::Enum kind, uint64_t array_address, uint32_t& added, uint32_t& removed );
+        static bool read_item( MapItemKind::Enum kind, uint64_t address, map_item_t& item );
+        void build();
+
+    public:
+        CMapIndex() = default;
+        CMapIndex( const CMapIndex& ) = delete;
+        CMapIndex& operator=( const CMapIndex& ) = delete;
+        ~CMapIndex();
+
+        /**
+         * \brief Starts the worker thread
+         * \param base_ctrl_pointer address of the game's base_ctrl instance pointer
+         */
+        void start( uint64_t base_ctrl_pointer );
+        void stop();
+
+        // any thread, nullptr until the first build
+        std::shared_ptr< const CSpatialGrid > get_grid() const;
+
+        bool is_running() const { return this->running_.load( std::memory_order_relaxed ); }
+        uint32_t get_rejected() const { return this->rejected_.load( std::memory_order_relaxed ); }
+        uint32_t get_last_added() const { return this->last_added_.load( std::memory_order_relaxed ); }
+        uint32_t get_last_removed() const { return this->last_removed_.load( std::memory_order_relaxed ); }
+        uint32_t get_build_microseconds() const { return this->build_microseconds_.load( std::memory_order_relaxed ); }
+        uint64_t get_builds() const { return this->builds_.load( std::memory_order_relaxed ); }
+    };
+}
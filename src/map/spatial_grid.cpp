@@ -0,0 +1,179 @@
+#include "spatial_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ts_extra_utilities::map
+{
+    namespace
+    {
+        uint64_t make_key( const int32_t x, const int32_t z )
+        {
+            return static_cast< uint64_t >( static_cast< uint32_t >( x ) ) << 32 | static_cast< uint32_t >( z );
+        }
+
+        uint64_t hash_key( const uint64_t key ) { return ( key * 0x9E3779B97F4A7C15ull ) >> 29; }
+
+        float distance_squared( const float3_t& a, const float x, const float y, const float z )
+        {
+            const auto dx = x - a.x, dy = y - a.y, dz = z - a.z;
+            return dx * dx + dy * dy + dz * dz;
+        }
+    }
+
+    CSpatialGrid::CSpatialGrid( const map_item_t* items, const size_t count, const float cell_size )
+        : cell_size_( cell_size ), inverse_cell_size_( 1.0f / cell_size )
+    {
+        std::vector< std::pair< uint64_t, uint32_t > > order;
+        order.reserve( count );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const auto& position = items[ i ].position;
+            if ( !std::isfinite( position.x ) || !std::isfinite( position.y ) || !std::isfinite( position.z ) ) continue;
+            order.emplace_back( make_key( this->get_cell( position.x ), this->get_cell( position.z ) ), static_cast< uint32_t >( i ) );
+        }
+        std::sort( order.begin(), order.end() );
+
+        for ( size_t i = 0; i < order.size(); ++i ) this->cell_count_ += i == 0 || order[ i ].first != order[ i - 1 ].first;
+        size_t table_size = 16;
+        while ( table_size < this->cell_count_ * 2 ) table_size *= 2;
+        this->cells_.assign( table_size, {} );
+        this->cell_mask_ = table_size - 1;
+
+        this->x_.resize( order.size() );
+        this->y_.resize( order.size() );
+        this->z_.resize( order.size() );
+        this->kinds_.resize( order.size() );
+        this->addresses_.resize( order.size() );
+        for ( size_t i = 0; i < order.size(); ++i )
+        {
+            const auto& item = items[ order[ i ].second ];
+            this->x_[ i ] = item.position.x;
+            this->y_[ i ] = item.position.y;
+            this->z_[ i ] = item.position.z;
+            this->kinds_[ i ] = item.kind;
+            this->addresses_[ i ] = item.address;
+        }
+
+        for ( size_t begin = 0, end; begin < order.size(); begin = end )
+        {
+            const auto key = order[ begin ].first;
+            for ( end = begin + 1; end < order.size() && order[ end ].first == key; ++end ) {}
+
+            auto slot = hash_key( key ) & this->cell_mask_;
+            while ( this->cells_[ slot ].end != this->cells_[ slot ].begin ) slot = ( slot + 1 ) & this->cell_mask_;
+            this->cells_[ slot ] = { key, static_cast< uint32_t >( begin ), static_cast< uint32_t >( end ) };
+
+            const auto x = static_cast< int32_t >( key >> 32 ), z = static_cast< int32_t >( key & 0xFFFFFFFF );
+            this->min_x_ = begin == 0 ? x : std::min( this->min_x_, x );
+            this->max_x_ = begin == 0 ? x : std::max( this->max_x_, x );
+            this->min_z_ = begin == 0 ? z : std::min( this->min_z_, z );
+            this->max_z_ = begin == 0 ? z : std::max( this->max_z_, z );
+        }
+    }
+
+    int32_t CSpatialGrid::get_cell( const float coordinate ) const
+    {
+        const auto cell = std::floor( coordinate * this->inverse_cell_size_ );
+        return static_cast< int32_t >( std::clamp( cell, -2147483648.0f, 2147483520.0f ) );
+    }
+
+    const CSpatialGrid::cell_t* CSpatialGrid::find_cell( const int64_t x, const int64_t z ) const
+    {
+        if ( x < this->min_x_ || x > this->max_x_ || z < this->min_z_ || z > this->max_z_ ) return nullptr;
+
+        const auto key = make_key( static_cast< int32_t >( x ), static_cast< int32_t >( z ) );
+        for ( auto slot = hash_key( key ) & this->cell_mask_;; slot = ( slot + 1 ) & this->cell_mask_ )
+        {
+            const auto& cell = this->cells_[ slot ];
+            if ( cell.end == cell.begin ) return nullptr;
+            if ( cell.key == key ) return &cell;
+        }
+    }
+
+    void CSpatialGrid::scan_nearest( const cell_t& cell, const float3_t& position, const uint32_t kinds, float& best, int64_t& best_index ) const
+    {
+        for ( auto i = cell.begin; i < cell.end; ++i )
+        {
+            const auto distance = distance_squared( position, this->x_[ i ], this->y_[ i ], this->z_[ i ] );
+            if ( distance < best && ( kinds >> this->kinds_[ i ] & 1 ) != 0 )
+            {
+                best = distance;
+                best_index = i;
+            }
+        }
+    }
+
+    int64_t CSpatialGrid::find_nearest( const float3_t& position, const uint32_t kinds, const float max_distance, float* distance ) const
+    {
+        if ( this->cell_count_ == 0 ) return -1;
+
+        const int64_t x = this->get_cell( position.x ), z = this->get_cell( position.z );
+        // rings past the occupied cells can't hold anything
+        auto max_ring = std::max( { x - this->min_x_, this->max_x_ - x, z - this->min_z_, this->max_z_ - z, int64_t( 0 ) } );
+        if ( std::isfinite( max_distance ) ) max_ring = std::min( max_ring, static_cast< int64_t >( std::ceil( max_distance * this->inverse_cell_size_ ) ) + 1 );
+
+        auto best = max_distance * max_distance;
+        int64_t best_index = -1;
+        const auto visit = [ & ]( const int64_t cell_x, const int64_t cell_z )
+        {
+            if ( const auto* cell = this->find_cell( cell_x, cell_z ); cell != nullptr ) this->scan_nearest( *cell, position, kinds, best, best_index );
+        };
+
+        for ( int64_t ring = 0; ring <= max_ring; ++ring )
+        {
+            // the closest point of a cell on this ring is at least ring - 1 cells away along x or z
+            const auto bound = static_cast< float >( ring - 1 ) * this->cell_size_;
+            if ( ring > 1 && bound * bound >= best ) break;
+
+            if ( ring == 0 )
+            {
+                visit( x, z );
+                continue;
+            }
+            for ( auto dx = -ring; dx <= ring; ++dx )
+            {
+                visit( x + dx, z - ring );
+                visit( x + dx, z + ring );
+            }
+            for ( auto dz = -ring + 1; dz < ring; ++dz )
+            {
+                visit( x - ring, z + dz );
+                visit( x + ring, z + dz );
+            }
+        }
+
+        if ( distance != nullptr && best_index >= 0 ) *distance = std::sqrt( best );
+        return best_index;
+    }
+
+    size_t CSpatialGrid::find_in_radius( const float3_t& position, const float radius, const uint32_t kinds, std::vector< uint32_t >& out ) const
+    {
+        out.clear();
+        if ( this->cell_count_ == 0 || !( radius >= 0.0f ) ) return 0;
+
+        const auto radius_squared = radius * radius;
+        const int64_t min_x = std::max( this->get_cell( position.x - radius ), this->min_x_ );
+        const int64_t max_x = std::min( this->get_cell( position.x + radius ), this->max_x_ );
+        const int64_t min_z = std::max( this->get_cell( position.z - radius ), this->min_z_ );
+        const int64_t max_z = std::min( this->get_cell( position.z + radius ), this->max_z_ );
+        for ( auto cell_x = min_x; cell_x <= max_x; ++cell_x )
+        {
+            for ( auto cell_z = min_z; cell_z <= max_z; ++cell_z )
+            {
+                const auto* cell = this->find_cell( cell_x, cell_z );
+                if ( cell == nullptr ) continue;
+
+                for ( auto i = cell->begin; i < cell->end; ++i )
+                {
+                    if ( distance_squared( position, this->x_[ i ], this->y_[ i ], this->z_[ i ] ) <= radius_squared && ( kinds >> this->kinds_[ i ] & 1 ) != 0 )
+                    {
+                        out.push_back( i );
+                    }
+                }
+            }
+        }
+        return out.size();
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "prism/common.hpp"
+
+namespace ts_extra_utilities::map
+{
+    struct MapItemKind
+    {
+        enum Enum : uint8_t
+        {
+            NODE, // base_ctrl.map_nodes
+            KDOP_ITEM, // base_ctrl.map_kdop_items
+            COUNT
+        };
+    };
+
+    constexpr uint32_t ALL_MAP_ITEM_KINDS = ( 1u << MapItemKind::COUNT ) - 1;
+
+    struct map_item_t
+    {
+        float3_t position; // world, meters
+        MapItemKind::Enum kind;
+        uint64_t address; // of the item in the game
+    };
+
+    /**
+     * \brief Immutable uniform grid over map items on the ground plane (x/z), distances are 3D.
+     *
+     * Items are sorted by cell and stored by component, cells are found through an open addressed hash table, so only
+     * occupied cells cost memory and a query touches a handful of short contiguous runs. Built once per change of the
+     * item set and then shared read only between threads.
+     */
+    class CSpatialGrid
+    {
+    private:
+        struct cell_t
+        {
+            uint64_t key;
+            uint32_t begin; // in the item arrays
+            uint32_t end; // == begin for an empty slot
+        };
+
+        float cell_size_;
+        float inverse_cell_size_;
+        std::vector< cell_t > cells_; // power of two
+        uint64_t cell_mask_ = 0;
+        size_t cell_count_ = 0;
+        int32_t min_x_ = 0, max_x_ = -1, min_z_ = 0, max_z_ = -1; // occupied cells
+
+        std::vector< float > x_, y_, z_;
+        std::vector< MapItemKind::Enum > kinds_;
+        std::vector< uint64_t > addresses_;
+
+        int32_t get_cell( float coordinate ) const;
+        const cell_t* find_cell( int64_t x, int64_t z ) const;
+
+        // checks the items of one cell against `best`, squared
+        void scan_nearest( const cell_t& cell, const float3_t& position, uint32_t kinds, float& best, int64_t& best_index ) const;
+
+    public:
+        static constexpr float DEFAULT_CELL_SIZE = 128.0f; // meters, a few road nodes per cell, short runs in cities
+
+        CSpatialGrid( const map_item_t* items, size_t count, float cell_size = DEFAULT_CELL_SIZE );
+
+        size_t size() const { return this->addresses_.size(); }
+        size_t get_cell_count() const { return this->cell_count_; }
+        float get_cell_size() const { return this->cell_size_; }
+
+        // indices are only valid for this grid, items are reordered by cell
+        float3_t get_position( const size_t index ) const { return { this->x_[ index ], this->y_[ index ], this->z_[ index ] }; }
+        MapItemKind::Enum get_kind( const size_t index ) const { return this->kinds_[ index ]; }
+        uint64_t get_address( const size_t index ) const { return this->addresses_[ index ]; }
+
+        /**
+         * \brief Closest item of `kinds` within `max_distance`, searching rings of cells outwards until no closer item
+         * can be left
+         * \param kinds bit per MapItemKind
+         * \param distance set to the distance of the item found
+         * \return item index, -1 if there is none in range
+         */
+        int64_t find_nearest( const float3_t& position, uint32_t kinds, float max_distance, float* distance = nullptr ) const;
+
+        /**
+         * \brief Every item of `kinds` within `radius`, in no particular order
+         * \param out cleared first
+         * \return number of items found
+         */
+        size_t find_in_radius( const float3_t& position, float radius, uint32_t kinds, std::vector< uint32_t >& out ) const;
+    };
+}
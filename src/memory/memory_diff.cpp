@@ -0,0 +1,476 @@
+#include "memory_diff.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#if defined( _M_X64 ) || defined( __SSE2__ )
+#include <emmintrin.h>
+#define TS_MEMORY_DIFF_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "snapshot.hpp"
+
+namespace ts_extra_utilities::memory
+{
+    namespace
+    {
+        constexpr uint32_t RANGE_ALIGNMENT = 16;
+        constexpr uint32_t MASK_BLOCK = 64 * sizeof( uint32_t ); // frame bytes per mask qword
+        constexpr float MAX_PLAUSIBLE_FLOAT = 1e9f; // anything larger is more likely a pointer or an id read as a float
+
+        uint32_t align_up( const uint32_t value, const uint32_t alignment ) { return ( value + alignment - 1 ) / alignment * alignment; }
+
+        uint32_t count_trailing_zeros( const uint64_t value )
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            return _BitScanForward64( &index, value ) ? index : 64;
+#else
+            return value == 0 ? 64 : static_cast< uint32_t >( __builtin_ctzll( value ) );
+#endif
+        }
+
+        // bit i set if dword i of the 256 byte blocks differs, one mask qword per block
+        void diff_frames( const uint8_t* current, const uint8_t* previous, uint64_t* masks, const uint32_t blocks )
+        {
+            for ( uint32_t block = 0; block < blocks; ++block, current += MASK_BLOCK, previous += MASK_BLOCK )
+            {
+                uint64_t mask = 0;
+#ifdef TS_MEMORY_DIFF_SSE2
+                for ( uint32_t i = 0; i < MASK_BLOCK / 16; ++i )
+                {
+                    const auto a = _mm_loadu_si128( reinterpret_cast< const __m128i* >( current + i * 16 ) );
+                    const auto b = _mm_loadu_si128( reinterpret_cast< const __m128i* >( previous + i * 16 ) );
+                    const auto equal = _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( a, b ) ) );
+                    mask |= static_cast< uint64_t >( equal ^ 0xF ) << ( i * 4 );
+                }
+#else
+                for ( uint32_t i = 0; i < 64; ++i )
+                {
+                    if ( memcmp( current + i * 4, previous + i * 4, 4 ) != 0 ) mask |= 1ull << i;
+                }
+#endif
+                masks[ block ] = mask;
+            }
+        }
+
+        // what the candidates of one reading of a dword are scored against
+        struct channel_series_t
+        {
+            const std::vector< uint8_t >& valid;
+            const std::vector< double >& values;
+            const std::vector< uint32_t >& event_sums; // channel changes in frames [0, i)
+            uint32_t events;
+            bool sparse; // changes on at most a quarter of the frames, the event score counts then
+        };
+
+        struct reading_score_t
+        {
+            uint32_t changes;
+            float correlation;
+            float event_score;
+            float score;
+        };
+
+        // prefix sums of change events, a change at i means frame i differs from a valid frame i - 1
+        uint32_t get_events( const std::vector< double >& values, const std::vector< uint8_t >& valid, std::vector< uint32_t >& sums )
+        {
+            sums.assign( values.size() + 1, 0 );
+            for ( size_t i = 0; i < values.size(); ++i )
+            {
+                const auto event = i != 0 && valid[ i ] && valid[ i - 1 ] && values[ i ] != values[ i - 1 ];
+                sums[ i + 1 ] = sums[ i ] + ( event ? 1 : 0 );
+            }
+            return sums.back();
+        }
+
+        // events within `tolerance` frames of each event of `sums`
+        uint32_t count_matched( const std::vector< uint32_t >& sums, const std::vector< uint32_t >& other, const uint32_t tolerance )
+        {
+            const auto frames = static_cast< uint32_t >( sums.size() - 1 );
+            uint32_t matched = 0;
+            for ( uint32_t i = 0; i < frames; ++i )
+            {
+                if ( sums[ i + 1 ] == sums[ i ] ) continue;
+                const auto begin = i > tolerance ? i - tolerance : 0;
+                const auto end = std::min( frames, i + tolerance + 1 );
+                if ( other[ end ] != other[ begin ] ) ++matched;
+            }
+            return matched;
+        }
+
+        reading_score_t score_reading( const std::vector< double >& values, const channel_series_t& channel, const uint32_t tolerance,
+                                       std::vector< uint32_t >& event_sums )
+        {
+            reading_score_t result{};
+            result.changes = get_events( values, channel.valid, event_sums );
+            if ( result.changes == 0 ) return result;
+
+            double count = 0, mean_x = 0, mean_y = 0;
+            for ( size_t i = 0; i < values.size(); ++i )
+            {
+                if ( !channel.valid[ i ] ) continue;
+                ++count;
+                mean_x += values[ i ];
+                mean_y += channel.values[ i ];
+            }
+            mean_x /= count;
+            mean_y /= count;
+
+            double covariance = 0, variance_x = 0, variance_y = 0;
+            for ( size_t i = 0; i < values.size(); ++i )
+            {
+                if ( !channel.valid[ i ] ) continue;
+                const auto x = values[ i ] - mean_x, y = channel.values[ i ] - mean_y;
+                covariance += x * y;
+                variance_x += x * x;
+                variance_y += y * y;
+            }
+            if ( variance_x > 0 && variance_y > 0 ) result.correlation = static_cast< float >( covariance / std::sqrt( variance_x * variance_y ) );
+
+            if ( channel.events != 0 )
+            {
+                const auto precision = static_cast< float >( count_matched( event_sums, channel.event_sums, tolerance ) ) / result.changes;
+                const auto recall = static_cast< float >( count_matched( channel.event_sums, event_sums, tolerance ) ) / channel.events;
+                if ( precision + recall > 0 ) result.event_score = 2 * precision * recall / ( precision + recall );
+            }
+
+            result.score = std::fabs( result.correlation );
+            if ( channel.sparse ) result.score = ( result.score + result.event_score ) / 2;
+            return result;
+        }
+    }
+
+    const char* to_string( const DiffValueType::Enum type )
+    {
+        switch ( type )
+        {
+            case DiffValueType::U8: return "uint8";
+            case DiffValueType::I32: return "int32";
+            case DiffValueType::FLOAT: return "float";
+            default: return "unknown";
+        }
+    }
+
+    bool CMemoryDiff::configure( const diff_range_t* ranges, const size_t count, std::string& error )
+    {
+        this->ranges_.clear();
+        this->range_offsets_.clear();
+        this->frame_bytes_ = 0;
+        this->capacity_ = 0;
+        this->reset();
+
+        if ( count == 0 )
+        {
+            error = "no ranges";
+            return false;
+        }
+
+        uint32_t offset = 0;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( ranges[ i ].size == 0 || ranges[ i ].size > MAX_FRAME_BYTES - offset )
+            {
+                error = std::string( ranges[ i ].label ) + ( ranges[ i ].size == 0 ? " is empty" : " doesn't fit in a frame" );
+                this->range_offsets_.clear();
+                return false;
+            }
+            this->range_offsets_.push_back( offset );
+            offset = align_up( offset + ranges[ i ].size, RANGE_ALIGNMENT );
+        }
+        this->ranges_.assign( ranges, ranges + count );
+        for ( auto& range : this->ranges_ ) range.label[ sizeof( range.label ) - 1 ] = '\0';
+
+        this->frame_bytes_ = align_up( offset, MASK_BLOCK );
+        this->mask_words_ = this->frame_bytes_ / MASK_BLOCK;
+        this->capacity_ = static_cast< uint32_t >( std::clamp< size_t >( RING_BYTES / this->frame_bytes_, MIN_FRAMES, MAX_FRAMES ) );
+        this->reset();
+        return true;
+    }
+
+    void CMemoryDiff::reset()
+    {
+        // zeroed again so the padding of every slot is
+        this->data_.assign( static_cast< size_t >( this->capacity_ ) * this->frame_bytes_, 0 );
+        this->masks_.assign( static_cast< size_t >( this->capacity_ ) * this->mask_words_, 0 );
+        this->frames_.assign( this->capacity_, {} );
+        this->change_counts_.assign( this->frame_bytes_ / sizeof( uint32_t ), 0 );
+        this->head_ = 0;
+        this->count_ = 0;
+        this->last_changed_ = 0;
+    }
+
+    uint32_t CMemoryDiff::get_slot( const uint32_t index ) const
+    {
+        return ( this->head_ + this->capacity_ - this->count_ + index ) % this->capacity_;
+    }
+
+    uint32_t CMemoryDiff::get_range_index( const uint32_t offset ) const
+    {
+        const auto it = std::upper_bound( this->range_offsets_.begin(), this->range_offsets_.end(), offset );
+        if ( it == this->range_offsets_.begin() ) return static_cast< uint32_t >( this->ranges_.size() );
+        const auto index = static_cast< uint32_t >( it - this->range_offsets_.begin() - 1 );
+        return offset - this->range_offsets_[ index ] < this->ranges_[ index ].size ? index : static_cast< uint32_t >( this->ranges_.size() );
+    }
+
+    uint8_t* CMemoryDiff::begin_frame()
+    {
+        if ( this->capacity_ == 0 ) return nullptr;
+        return this->data_.data() + static_cast< size_t >( this->head_ ) * this->frame_bytes_;
+    }
+
+    void CMemoryDiff::commit_frame( const uint64_t frame, const float channel, const bool valid )
+    {
+        if ( this->capacity_ == 0 ) return;
+
+        const auto slot = this->head_;
+        const auto previous = ( slot + this->capacity_ - 1 ) % this->capacity_;
+        auto* masks = this->masks_.data() + static_cast< size_t >( slot ) * this->mask_words_;
+        this->frames_[ slot ] = { frame, channel, valid };
+        this->last_changed_ = 0;
+
+        if ( valid && this->count_ != 0 && this->frames_[ previous ].valid )
+        {
+            diff_frames( this->data_.data() + static_cast< size_t >( slot ) * this->frame_bytes_,
+                         this->data_.data() + static_cast< size_t >( previous ) * this->frame_bytes_, masks, this->mask_words_ );
+            for ( uint32_t word = 0; word < this->mask_words_; ++word )
+            {
+                for ( auto bits = masks[ word ]; bits != 0; bits &= bits - 1 )
+                {
+                    ++this->change_counts_[ word * 64 + count_trailing_zeros( bits ) ];
+                    ++this->last_changed_;
+                }
+            }
+        }
+        else std::fill( masks, masks + this->mask_words_, 0 );
+
+        this->head_ = ( slot + 1 ) % this->capacity_;
+        this->count_ = std::min( this->count_ + 1, this->capacity_ );
+    }
+
+    uint32_t CMemoryDiff::get_change_count( const size_t range, const uint32_t offset ) const
+    {
+        const auto index = ( this->range_offsets_[ range ] + offset ) / sizeof( uint32_t );
+        return index < this->change_counts_.size() ? this->change_counts_[ index ] : 0;
+    }
+
+    void CMemoryDiff::analyze( const diff_options_t& options, std::vector< diff_candidate_t >& out ) const
+    {
+        out.clear();
+        if ( this->count_ < 2 ) return;
+
+        const auto frames = this->count_;
+        std::vector< uint8_t > valid( frames );
+        std::vector< double > channel( frames );
+        for ( uint32_t i = 0; i < frames; ++i )
+        {
+            const auto& info = this->frames_[ this->get_slot( i ) ];
+            valid[ i ] = info.valid;
+            channel[ i ] = info.valid ? info.channel : 0.0;
+        }
+        std::vector< uint32_t > channel_events;
+        const auto events = get_events( channel, valid, channel_events );
+        const channel_series_t series{ valid, channel, channel_events, events, events * 4 <= frames };
+
+        // the masks of the frames in the ring, the oldest one's is against a frame that was dropped
+        std::vector< uint32_t > counts( this->frame_bytes_ / sizeof( uint32_t ), 0 );
+        for ( uint32_t i = 1; i < frames; ++i )
+        {
+            const auto* masks = this->masks_.data() + static_cast< size_t >( this->get_slot( i ) ) * this->mask_words_;
+            for ( uint32_t word = 0; word < this->mask_words_; ++word )
+            {
+                for ( auto bits = masks[ word ]; bits != 0; bits &= bits - 1 ) ++counts[ word * 64 + count_trailing_zeros( bits ) ];
+            }
+        }
+
+        std::vector< uint32_t > raw( frames );
+        std::vector< double > values( frames );
+        std::vector< uint32_t > event_sums;
+        for ( uint32_t dword = 0; dword < counts.size(); ++dword )
+        {
+            if ( counts[ dword ] < options.min_changes ) continue;
+            const auto frame_offset = dword * static_cast< uint32_t >( sizeof( uint32_t ) );
+            const auto range = this->get_range_index( frame_offset );
+            if ( range == this->ranges_.size() ) continue;
+            const auto offset = frame_offset - this->range_offsets_[ range ];
+
+            for ( uint32_t i = 0; i < frames; ++i )
+            {
+                memcpy( &raw[ i ], this->data_.data() + static_cast< size_t >( this->get_slot( i ) ) * this->frame_bytes_ + frame_offset, sizeof( uint32_t ) );
+            }
+
+            const auto add = [ & ]( const uint32_t byte, const DiffValueType::Enum type, const reading_score_t& score )
+            {
+                if ( score.changes < options.min_changes || score.score < options.min_score ) return;
+                out.push_back( { static_cast< uint32_t >( range ), offset + byte, type, score.changes, score.correlation, score.event_score, score.score } );
+            };
+
+            float best_byte = 0;
+            for ( uint32_t byte = 0; byte < sizeof( uint32_t ) && offset + byte < this->ranges_[ range ].size; ++byte )
+            {
+                for ( uint32_t i = 0; i < frames; ++i ) values[ i ] = ( raw[ i ] >> ( byte * 8 ) ) & 0xFF;
+                const auto score = score_reading( values, series, options.tolerance, event_sums );
+                if ( score.changes < options.min_changes ) continue;
+                best_byte = std::max( best_byte, score.score );
+                add( byte, DiffValueType::U8, score );
+            }
+
+            for ( uint32_t i = 0; i < frames; ++i ) values[ i ] = static_cast< int32_t >( raw[ i ] );
+            const auto as_int = score_reading( values, series, options.tolerance, event_sums );
+
+            bool plausible = true;
+            for ( uint32_t i = 0; i < frames && plausible; ++i )
+            {
+                float value;
+                memcpy( &value, &raw[ i ], sizeof( value ) );
+                plausible = !valid[ i ] || ( std::isfinite( value ) && std::fabs( value ) < MAX_PLAUSIBLE_FLOAT );
+                values[ i ] = value;
+            }
+            const auto as_float = plausible ? score_reading( values, series, options.tolerance, event_sums ) : reading_score_t{};
+
+            const auto wide = as_float.score > as_int.score ? DiffValueType::FLOAT : DiffValueType::I32;
+            const auto& wide_score = wide == DiffValueType::FLOAT ? as_float : as_int;
+            if ( wide_score.score > best_byte ) add( 0, wide, wide_score );
+        }
+
+        std::sort( out.begin(), out.end(), []( const diff_candidate_t& a, const diff_candidate_t& b )
+        {
+            if ( a.score != b.score ) return a.score > b.score;
+            if ( a.range != b.range ) return a.range < b.range;
+            return a.offset < b.offset;
+        } );
+        if ( out.size() > options.max_results ) out.resize( options.max_results );
+    }
+
+    std::vector< uint8_t > CMemoryDiff::serialize( const std::string& game, const std::string& game_version ) const
+    {
+        diff_file_header_t header{};
+        header.magic = DIFF_MAGIC;
+        header.version = DIFF_VERSION;
+        header.range_size = sizeof( diff_file_range_t );
+        header.range_count = static_cast< uint32_t >( this->ranges_.size() );
+        header.frame_count = this->count_;
+        header.frame_bytes = this->frame_bytes_;
+        header.frame_size = sizeof( diff_file_frame_t );
+        header.timestamp = static_cast< uint64_t >( std::time( nullptr ) );
+        set_snapshot_string( header.game, sizeof( header.game ), game );
+        set_snapshot_string( header.game_version, sizeof( header.game_version ), game_version );
+        set_snapshot_string( header.channel, sizeof( header.channel ), this->channel_name_ );
+
+        std::vector< uint8_t > file( sizeof( header ) + this->ranges_.size() * sizeof( diff_file_range_t ) +
+                                     static_cast< size_t >( this->count_ ) * ( sizeof( diff_file_frame_t ) + this->frame_bytes_ ) );
+        auto* position = file.data();
+        memcpy( position, &header, sizeof( header ) );
+        position += sizeof( header );
+
+        for ( size_t i = 0; i < this->ranges_.size(); ++i )
+        {
+            diff_file_range_t range{};
+            range.address = this->ranges_[ i ].address;
+            range.offset = this->range_offsets_[ i ];
+            range.size = this->ranges_[ i ].size;
+            set_snapshot_string( range.label, sizeof( range.label ), this->ranges_[ i ].label );
+            memcpy( position, &range, sizeof( range ) );
+            position += sizeof( range );
+        }
+
+        for ( uint32_t i = 0; i < this->count_; ++i )
+        {
+            const auto slot = this->get_slot( i );
+            const auto& info = this->frames_[ slot ];
+            const diff_file_frame_t frame{ info.frame, info.channel, info.valid ? 1u : 0u };
+            memcpy( position, &frame, sizeof( frame ) );
+            position += sizeof( frame );
+            memcpy( position, this->data_.data() + static_cast< size_t >( slot ) * this->frame_bytes_, this->frame_bytes_ );
+            position += this->frame_bytes_;
+        }
+        return file;
+    }
+
+    bool CMemoryDiff::write( const char* path, const std::string& game, const std::string& game_version ) const
+    {
+        const auto file_data = this->serialize( game, game_version );
+
+        auto* file = std::fopen( path, "wb" );
+        if ( file == nullptr ) return false;
+        const auto ok = std::fwrite( file_data.data(), 1, file_data.size(), file ) == file_data.size();
+        return std::fclose( file ) == 0 && ok;
+    }
+
+    bool CMemoryDiff::load( const char* path, diff_file_header_t& header, std::string& error )
+    {
+        auto* file = std::fopen( path, "rb" );
+        if ( file == nullptr )
+        {
+            error = std::string( "cannot open " ) + path;
+            return false;
+        }
+        std::vector< uint8_t > data;
+        uint8_t buffer[ 64 * 1024 ];
+        for ( size_t read; ( read = std::fread( buffer, 1, sizeof( buffer ), file ) ) != 0; ) data.insert( data.end(), buffer, buffer + read );
+        std::fclose( file );
+
+        if ( data.size() < sizeof( header ) )
+        {
+            error = "file is too small for a diff header";
+            return false;
+        }
+        memcpy( &header, data.data(), sizeof( header ) );
+        if ( header.magic != DIFF_MAGIC )
+        {
+            error = "bad magic, not a memory diff export";
+            return false;
+        }
+        if ( header.version != DIFF_VERSION || header.range_size != sizeof( diff_file_range_t ) || header.frame_size != sizeof( diff_file_frame_t ) )
+        {
+            error = "unsupported diff version " + std::to_string( header.version );
+            return false;
+        }
+        const auto frames_offset = sizeof( header ) + static_cast< size_t >( header.range_count ) * sizeof( diff_file_range_t );
+        if ( header.frame_bytes > MAX_FRAME_BYTES ||
+             data.size() != frames_offset + static_cast< size_t >( header.frame_count ) * ( sizeof( diff_file_frame_t ) + header.frame_bytes ) )
+        {
+            error = "file size doesn't match the header";
+            return false;
+        }
+
+        std::vector< diff_range_t > ranges( header.range_count );
+        std::vector< uint32_t > offsets( header.range_count );
+        for ( uint32_t i = 0; i < header.range_count; ++i )
+        {
+            diff_file_range_t range;
+            memcpy( &range, data.data() + sizeof( header ) + i * sizeof( range ), sizeof( range ) );
+            ranges[ i ] = { range.address, range.size, {} };
+            memcpy( ranges[ i ].label, range.label, std::min( sizeof( ranges[ i ].label ) - 1, sizeof( range.label ) ) );
+            offsets[ i ] = range.offset;
+        }
+        if ( !this->configure( ranges.data(), ranges.size(), error ) ) return false;
+        if ( offsets != this->range_offsets_ || header.frame_bytes != this->frame_bytes_ )
+        {
+            std::string ignored;
+            this->configure( nullptr, 0, ignored );
+            error = "range layout doesn't match this version";
+            return false;
+        }
+        this->channel_name_ = get_snapshot_string( header.channel, sizeof( header.channel ) );
+
+        const auto* position = data.data() + frames_offset;
+        for ( uint32_t i = 0; i < header.frame_count; ++i )
+        {
+            diff_file_frame_t frame;
+            memcpy( &frame, position, sizeof( frame ) );
+            position += sizeof( frame );
+            memcpy( this->begin_frame(), position, this->frame_bytes_ );
+            position += this->frame_bytes_;
+            this->commit_frame( frame.frame, frame.channel, frame.valid != 0 );
+        }
+        return true;
+    }
+}
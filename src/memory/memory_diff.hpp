@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ts_extra_utilities::memory
+{
+    // how the bytes of a changed dword are read when correlating them with the channel
+    struct DiffValueType
+    {
+        enum Enum : uint8_t
+        {
+            U8, // one of the four bytes, flags and enums
+            I32,
+            FLOAT,
+            COUNT
+        };
+    };
+
+    const char* to_string( DiffValueType::Enum type );
+
+    // an object watched every frame, copied to a 16 byte aligned offset of the frame
+    struct diff_range_t
+    {
+        uint64_t address;
+        uint32_t size;
+        char label[ 24 ]; // "truck.chassis"
+    };
+
+    struct diff_options_t
+    {
+        uint32_t min_changes = 2; // of the value within the recorded frames
+        uint32_t tolerance = 1; // frames a change may lead or lag the channel's
+        float min_score = 0.5f;
+        uint32_t max_results = 256;
+    };
+
+    struct diff_candidate_t
+    {
+        uint32_t range;
+        uint32_t offset; // in the range
+        DiffValueType::Enum type;
+        uint32_t changes;
+        float correlation; // Pearson r of the value against the channel, 0 if either is constant
+        float event_score; // F1 of the value's changes against the channel's, within the tolerance
+        float score; // see CMemoryDiff::analyze
+    };
+
+#pragma pack(push, 1)
+    // file layout: header, range_count * range, then frame_count * ( frame, frame_bytes of data ), oldest first
+    struct diff_file_header_t // size: 0x0060
+    {
+        uint32_t magic; // 0x0000 (0x04) 'TSMD'
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t range_size; // 0x0006 (0x02) sizeof( diff_file_range_t )
+        uint32_t range_count; // 0x0008 (0x04)
+        uint32_t frame_count; // 0x000C (0x04)
+        uint32_t frame_bytes; // 0x0010 (0x04) data per frame, the ranges at their offsets
+        uint32_t frame_size; // 0x0014 (0x04) sizeof( diff_file_frame_t )
+        uint64_t timestamp; // 0x0018 (0x08) unix seconds
+        char game[ 4 ]; // 0x0020 (0x04) "ats" or "ets2", nul padded, not nul terminated when full
+        char game_version[ 12 ]; // 0x0024 (0x0c) pack set version, nul padded, not nul terminated when full
+        char channel[ 48 ]; // 0x0030 (0x30) telemetry channel the frames were recorded against, nul padded
+    };
+
+    static_assert(sizeof( diff_file_header_t ) == 0x60);
+
+    struct diff_file_range_t // size: 0x0030
+    {
+        uint64_t address; // 0x0000 (0x08) in the game process
+        uint32_t offset; // 0x0008 (0x04) in the frame data
+        uint32_t size; // 0x000C (0x04)
+        char label[ 24 ]; // 0x0010 (0x18) nul padded
+        uint64_t reserved; // 0x0028 (0x08)
+    };
+
+    static_assert(sizeof( diff_file_range_t ) == 0x30);
+
+    struct diff_file_frame_t // size: 0x0010
+    {
+        uint64_t frame; // 0x0000 (0x08) rendered frames since the recording started
+        float channel; // 0x0008 (0x04)
+        uint32_t valid; // 0x000C (0x04) 0 if a range wasn't readable or there was no telemetry
+    };
+
+    static_assert(sizeof( diff_file_frame_t ) == 0x10);
+#pragma pack(pop)
+
+    constexpr uint32_t DIFF_MAGIC = 0x444D5354; // "TSMD" on disk
+    constexpr uint16_t DIFF_VERSION = 1;
+
+    /**
+     * \brief Ring buffer of per-frame copies of a few objects, and which of their dwords changed from one frame to the
+     * next, to find the fields behind a telemetry channel.
+     *
+     * The caller fills the slot from begin_frame() and hands it back with the channel's value in commit_frame(), which
+     * compares it with the previous frame 16 bytes at a time and keeps one bit per dword. analyze() then only looks at
+     * dwords that changed at least `min_changes` times within the recorded frames, and correlates each of their byte,
+     * int and float readings with the channel. Not thread safe, capture and analysis are meant for the render thread.
+     */
+    class CMemoryDiff
+    {
+    public:
+        static constexpr uint32_t MAX_FRAME_BYTES = 64 * 1024;
+        static constexpr size_t RING_BYTES = 16 * 1024 * 1024; // the frame count follows the frame size, within the two below
+        static constexpr uint32_t MIN_FRAMES = 64;
+        static constexpr uint32_t MAX_FRAMES = 2048; // ~34 s at 60 FPS
+
+    private:
+        struct frame_info_t
+        {
+            uint64_t frame;
+            float channel;
+            bool valid;
+        };
+
+        std::vector< diff_range_t > ranges_;
+        std::vector< uint32_t > range_offsets_;
+        std::string channel_name_;
+        uint32_t frame_bytes_ = 0; // multiple of 256, one mask qword per 64 dwords
+        uint32_t mask_words_ = 0;
+        uint32_t capacity_ = 0;
+
+        std::vector< uint8_t > data_; // capacity_ * frame_bytes_
+        std::vector< uint64_t > masks_; // capacity_ * mask_words_, bit i set if dword i differs from the frame before
+        std::vector< frame_info_t > frames_;
+        std::vector< uint32_t > change_counts_; // per dword, since the last reset
+        uint32_t head_ = 0; // slot of the next frame
+        uint32_t count_ = 0;
+        uint32_t last_changed_ = 0; // dwords that changed on the last frame
+
+        uint32_t get_slot( uint32_t index ) const; // index 0 is the oldest frame
+        uint32_t get_range_index( uint32_t offset ) const; // of the range holding a frame offset, ranges_.size() for padding
+
+    public:
+        /**
+         * \brief Lays the ranges out in a frame and sizes the ring, drops the recorded frames
+         * \return false if the ranges are empty or don't fit in MAX_FRAME_BYTES
+         */
+        bool configure( const diff_range_t* ranges, size_t count, std::string& error );
+        void set_channel_name( const std::string& name ) { this->channel_name_ = name; }
+        void reset(); // drops the frames, keeps the ranges
+
+        // the slot to copy the ranges into, each at get_range_offset(), padding is zero and has to stay that way
+        uint8_t* begin_frame();
+        /**
+         * \brief Keeps the slot from begin_frame() and diffs it with the previous frame
+         * \param valid false if a range wasn't readable or the channel isn't known, the frame is then neither diffed nor analyzed
+         */
+        void commit_frame( uint64_t frame, float channel, bool valid );
+
+        const std::vector< diff_range_t >& get_ranges() const { return this->ranges_; }
+        uint32_t get_range_offset( const size_t range ) const { return this->range_offsets_[ range ]; }
+        const std::string& get_channel_name() const { return this->channel_name_; }
+        uint32_t get_frame_bytes() const { return this->frame_bytes_; }
+        uint32_t get_capacity() const { return this->capacity_; }
+        uint32_t get_frame_count() const { return this->count_; }
+        uint32_t get_last_changed() const { return this->last_changed_; }
+
+        // times the dword at `offset` of `range` changed since the last reset, also while it was out of the ring
+        uint32_t get_change_count( size_t range, uint32_t offset ) const;
+
+        /**
+         * \brief Fields whose changes follow the channel within the recorded frames, best first
+         *
+         * The score is |correlation|, averaged with the event score when the channel changes on at most a quarter of the
+         * frames, so a counter doesn't pass for a switch that was toggled once. A dword only gets its int or float
+         * reading reported when that scores higher than each of its bytes alone.
+         */
+        void analyze( const diff_options_t& options, std::vector< diff_candidate_t >& out ) const;
+
+        // the recorded frames, oldest first
+        std::vector< uint8_t > serialize( const std::string& game, const std::string& game_version ) const;
+        bool write( const char* path, const std::string& game, const std::string& game_version ) const;
+        // replaces the ranges and the frames with an export's, `header` for what else it says
+        bool load( const char* path, diff_file_header_t& header, std::string& error );
+    };
+}
@@ -0,0 +1,65 @@
+#include "memory_diff_recorder.hpp"
+
+#include <chrono>
+#include <cstring>
+
+#include "safe_read.hpp"
+#include "telemetry/frame_store.hpp"
+
+namespace ts_extra_utilities::memory
+{
+    namespace
+    {
+        bool read_channel( const telemetry::telemetry_frame_t& frame, const telemetry::frame_channel_t& channel, float& out )
+        {
+            const auto* data = reinterpret_cast< const uint8_t* >( &frame.truck ) + channel.offset;
+            switch ( channel.type )
+            {
+                case SCS_VALUE_TYPE_bool: out = *reinterpret_cast< const bool* >( data ) ? 1.0f : 0.0f; return true;
+                case SCS_VALUE_TYPE_s32: out = static_cast< float >( *reinterpret_cast< const int32_t* >( data ) ); return true;
+                case SCS_VALUE_TYPE_u32: out = static_cast< float >( *reinterpret_cast< const uint32_t* >( data ) ); return true;
+                case SCS_VALUE_TYPE_float: out = *reinterpret_cast< const float* >( data ); return true;
+                default: return false;
+            }
+        }
+    }
+
+    bool CMemoryDiffRecorder::start( const std::vector< diff_range_t >& ranges, const telemetry::frame_channel_t& channel, std::string& error )
+    {
+        this->recording_ = false;
+        if ( channel.type != SCS_VALUE_TYPE_bool && channel.type != SCS_VALUE_TYPE_s32 && channel.type != SCS_VALUE_TYPE_u32 &&
+             channel.type != SCS_VALUE_TYPE_float )
+        {
+            error = std::string( channel.name ) + " isn't a scalar channel";
+            return false;
+        }
+        if ( !this->diff_.configure( ranges.data(), ranges.size(), error ) ) return false;
+
+        this->diff_.set_channel_name( channel.name );
+        this->channel_ = &channel;
+        this->frames_ = 0;
+        this->invalid_frames_ = 0;
+        this->recording_ = true;
+        return true;
+    }
+
+    void CMemoryDiffRecorder::capture( const telemetry::CFrameStore* frame_store )
+    {
+        if ( !this->recording_ ) return;
+        const auto start = std::chrono::steady_clock::now();
+
+        float value = 0.0f;
+        auto valid = frame_store != nullptr && frame_store->read( this->frame_ ) && read_channel( this->frame_, *this->channel_, value );
+
+        auto* slot = this->diff_.begin_frame();
+        const auto& ranges = this->diff_.get_ranges();
+        for ( size_t i = 0; i < ranges.size() && valid; ++i )
+        {
+            valid = safe_copy( slot + this->diff_.get_range_offset( i ), ranges[ i ].address, ranges[ i ].size );
+        }
+        this->diff_.commit_frame( this->frames_++, value, valid );
+        if ( !valid ) ++this->invalid_frames_;
+
+        this->capture_microseconds_ = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "memory_diff.hpp"
+#include "telemetry/frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    class CFrameStore;
+}
+
+namespace ts_extra_utilities::memory
+{
+    /**
+     * \brief Render thread, feeds a CMemoryDiff with one guarded copy per range every frame, whether the UI is shown or
+     * not, and the value a truck channel had in the latest telemetry frame.
+     *
+     * A frame where a range faulted or no telemetry frame was published yet is kept but marked invalid. Stopping keeps
+     * the frames for the analysis, starting again drops them.
+     */
+    class CMemoryDiffRecorder
+    {
+    private:
+        CMemoryDiff diff_;
+        const telemetry::frame_channel_t* channel_ = nullptr;
+        bool recording_ = false;
+        uint64_t frames_ = 0; // since start
+        uint64_t invalid_frames_ = 0;
+        double capture_microseconds_ = 0; // the last frame's
+        telemetry::telemetry_frame_t frame_ = {}; // too big for the stack
+
+    public:
+        /**
+         * \param channel one of telemetry::get_truck_channels(), bool, s32, u32 or float
+         */
+        bool start( const std::vector< diff_range_t >& ranges, const telemetry::frame_channel_t& channel, std::string& error );
+        void stop() { this->recording_ = false; }
+        bool is_recording() const { return this->recording_; }
+
+        // `frame_store` is null without telemetry
+        void capture( const telemetry::CFrameStore* frame_store );
+
+        CMemoryDiff& get_diff() { return this->diff_; }
+        const telemetry::frame_channel_t* get_channel() const { return this->channel_; }
+        uint64_t get_frames() const { return this->frames_; }
+        uint64_t get_invalid_frames() const { return this->invalid_frames_; }
+        double get_capture_microseconds() const { return this->capture_microseconds_; }
+    };
+}
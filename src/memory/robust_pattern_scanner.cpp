@@ -1,5 +1,6 @@
 #include "robust_pattern_scanner.hpp"
 #include "memory_utils.hpp"
+#include "debug/flight_recorder.hpp"
 #include <Windows.h>
 
 using namespace ts_extra_utilities;
@@ -37,10 +38,12 @@ namespace ts_extra_utilities::pattern_scanner
 
             CCore::g_instance->info("Successfully found %s using pattern %zu: %s at +0x%llx", 
                 name.c_str(), i + 1, candidate.description.c_str(), memory::as_offset(address));
+            debug::record_event(debug::FlightEvent::PATTERN_HIT, name.c_str(), memory::as_offset(address), 0, static_cast<uint16_t>(i + 1));
             return address;
         }
 
         CCore::g_instance->error("Failed to find %s - all %zu patterns failed", name.c_str(), candidates.size());
+        debug::record_event(debug::FlightEvent::PATTERN_MISS, name.c_str(), 0, 0, static_cast<uint16_t>(candidates.size()));
         return 0;
     }
 
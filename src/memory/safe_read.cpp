@@ -0,0 +1,33 @@
+#include "safe_read.hpp"
+
+#include <Windows.h>
+#include <cstring>
+
+namespace ts_extra_utilities::memory
+{
+    bool is_readable( const uint64_t address, const size_t size )
+    {
+        constexpr DWORD READABLE = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+        for ( auto current = address; current < address + size; )
+        {
+            MEMORY_BASIC_INFORMATION info{};
+            if ( VirtualQuery( reinterpret_cast< const void* >( current ), &info, sizeof( info ) ) == 0 ) return false;
+            if ( info.State != MEM_COMMIT || ( info.Protect & READABLE ) == 0 || ( info.Protect & PAGE_GUARD ) != 0 ) return false;
+            current = reinterpret_cast< uint64_t >( info.BaseAddress ) + info.RegionSize;
+        }
+        return true;
+    }
+
+    bool safe_copy( void* destination, const uint64_t source, const size_t size )
+    {
+        __try
+        {
+            memcpy( destination, reinterpret_cast< const void* >( source ), size );
+            return true;
+        }
+        __except ( EXCEPTION_EXECUTE_HANDLER )
+        {
+            return false;
+        }
+    }
+}
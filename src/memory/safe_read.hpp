@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ts_extra_utilities::memory
+{
+    // every byte of the range is committed, readable and not a guard page
+    bool is_readable( uint64_t address, size_t size );
+
+    /**
+     * \brief Copies game memory that the game may free or change at any time, from any thread
+     * \return false if the copy faulted, `destination` is partly written then
+     */
+    bool safe_copy( void* destination, uint64_t source, size_t size );
+
+    template < typename T >
+    bool safe_read( const uint64_t address, T& out ) { return safe_copy( &out, address, sizeof( T ) ); }
+}
@@ -0,0 +1,289 @@
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ts_extra_utilities::memory
+{
+    namespace
+    {
+        constexpr size_t DATA_ALIGNMENT = 16;
+
+        size_t align_up( const size_t value ) { return ( value + DATA_ALIGNMENT - 1 ) & ~( DATA_ALIGNMENT - 1 ); }
+
+        // index of the region containing `address` in `order`, sorted by address, -1 if none does
+        int64_t find_source_region( const std::vector< const snapshot_source_region_t* >& order, const uint64_t address )
+        {
+            auto it = std::upper_bound( order.begin(), order.end(), address, []( const uint64_t value, const auto* region ) { return value < region->address; } );
+            if ( it == order.begin() ) return -1;
+            --it;
+            return address - ( *it )->address < ( *it )->size ? it - order.begin() : -1;
+        }
+
+        bool validate_memory_snapshot( memory_snapshot_t& out, std::string& error )
+        {
+            const auto* data = out.data;
+            const auto size = out.size;
+            if ( size < sizeof( snapshot_file_header_t ) )
+            {
+                error = "file is too small for a snapshot header";
+                return false;
+            }
+
+            std::memcpy( &out.header, data, sizeof( out.header ) );
+            if ( out.header.magic != SNAPSHOT_MAGIC )
+            {
+                error = "bad magic, not a memory snapshot";
+                return false;
+            }
+            if ( out.header.version != SNAPSHOT_VERSION || out.header.region_size != sizeof( snapshot_region_t ) ||
+                 out.header.relocation_size != sizeof( snapshot_relocation_t ) )
+            {
+                error = "unsupported snapshot version " + std::to_string( out.header.version );
+                return false;
+            }
+
+            const auto tables_size = sizeof( out.header ) + static_cast< size_t >( out.header.region_count ) * sizeof( snapshot_region_t ) +
+                                     static_cast< size_t >( out.header.relocation_count ) * sizeof( snapshot_relocation_t );
+            if ( size < tables_size )
+            {
+                error = "file is truncated";
+                return false;
+            }
+
+            // the tables are 8 byte aligned in the file, the packed structs don't need it anyway
+            out.regions = { reinterpret_cast< const snapshot_region_t* >( data + sizeof( out.header ) ), out.header.region_count };
+            out.relocations = { reinterpret_cast< const snapshot_relocation_t* >( out.regions.end() ), out.header.relocation_count };
+
+            for ( size_t i = 0; i < out.regions.size(); ++i )
+            {
+                const auto& region = out.regions[ i ];
+                if ( region.data_offset < tables_size || region.data_offset > size || region.size > size - region.data_offset )
+                {
+                    error = "region " + std::to_string( i ) + " is outside the file";
+                    return false;
+                }
+                if ( i != 0 && region.address < out.regions[ i - 1 ].address + out.regions[ i - 1 ].size )
+                {
+                    error = "region " + std::to_string( i ) + " overlaps the one before it or isn't sorted";
+                    return false;
+                }
+            }
+
+            for ( size_t i = 0; i < out.relocations.size(); ++i )
+            {
+                const auto& relocation = out.relocations[ i ];
+                const auto valid = relocation.region < out.regions.size() && relocation.target < out.regions.size() &&
+                                   static_cast< uint64_t >( relocation.offset ) + sizeof( uint64_t ) <= out.regions[ relocation.region ].size &&
+                                   relocation.target_offset < out.regions[ relocation.target ].size;
+                uint64_t value = 0;
+                if ( valid ) std::memcpy( &value, out.get_data( out.regions[ relocation.region ] ) + relocation.offset, sizeof( value ) );
+                if ( !valid || value != out.regions[ relocation.target ].address + relocation.target_offset )
+                {
+                    error = "relocation " + std::to_string( i ) + " doesn't match the regions";
+                    return false;
+                }
+
+                if ( i == 0 ) continue;
+                const auto& previous = out.relocations[ i - 1 ];
+                if ( previous.region > relocation.region || ( previous.region == relocation.region && previous.offset >= relocation.offset ) )
+                {
+                    error = "relocation " + std::to_string( i ) + " isn't sorted";
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    const char* to_string( const SnapshotType::Enum type )
+    {
+        switch ( type )
+        {
+            case SnapshotType::BASE_CTRL: return "base_ctrl";
+            case SnapshotType::GAME_ACTOR: return "game_actor";
+            case SnapshotType::GAME_PHYSICS_VEHICLE: return "game_physics_vehicle";
+            case SnapshotType::GAME_TRAILER_ACTOR: return "game_trailer_actor";
+            case SnapshotType::ACCESSORY_CHASSIS_DATA: return "accessory_chassis_data";
+            case SnapshotType::WHEEL_STEERING_DATA: return "wheel_steering_data";
+            case SnapshotType::PHYSICS_JOINT: return "physics_joint";
+            case SnapshotType::PX_D6_JOINT: return "px_d6_joint";
+            default: return "unknown";
+        }
+    }
+
+    void set_snapshot_string( char* field, const size_t size, const std::string& value )
+    {
+        std::memset( field, 0, size );
+        std::memcpy( field, value.data(), std::min( size, value.size() ) );
+    }
+
+    std::string get_snapshot_string( const char* field, const size_t size )
+    {
+        return std::string( field, std::find( field, field + size, '\0' ) );
+    }
+
+    std::vector< uint8_t > serialize_memory_snapshot( const snapshot_file_header_t& header, const snapshot_source_region_t* regions, const size_t count )
+    {
+        std::vector< const snapshot_source_region_t* > order( count );
+        for ( size_t i = 0; i < count; ++i ) order[ i ] = &regions[ i ];
+        std::sort( order.begin(), order.end(), []( const auto* a, const auto* b ) { return a->address < b->address; } );
+
+        std::vector< snapshot_relocation_t > relocations;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const auto& source = *order[ i ];
+            const auto* bytes = static_cast< const uint8_t* >( source.data );
+            for ( uint32_t offset = static_cast< uint32_t >( ( 8 - source.address % 8 ) % 8 ); offset + sizeof( uint64_t ) <= source.size; offset += 8 )
+            {
+                uint64_t value;
+                std::memcpy( &value, bytes + offset, sizeof( value ) );
+                if ( value == 0 ) continue;
+
+                const auto target = find_source_region( order, value );
+                if ( target < 0 ) continue;
+                relocations.push_back( { static_cast< uint32_t >( i ), offset, static_cast< uint32_t >( target ), static_cast< uint32_t >( value - order[ target ]->address ) } );
+            }
+        }
+
+        auto file_header = header;
+        file_header.magic = SNAPSHOT_MAGIC;
+        file_header.version = SNAPSHOT_VERSION;
+        file_header.region_size = sizeof( snapshot_region_t );
+        file_header.region_count = static_cast< uint32_t >( count );
+        file_header.relocation_size = sizeof( snapshot_relocation_t );
+        file_header.relocation_count = static_cast< uint32_t >( relocations.size() );
+
+        const auto relocations_offset = sizeof( snapshot_file_header_t ) + count * sizeof( snapshot_region_t );
+        auto size = align_up( relocations_offset + relocations.size() * sizeof( snapshot_relocation_t ) );
+        std::vector< snapshot_region_t > table( count );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const auto& source = *order[ i ];
+            table[ i ] = { source.address, size, source.size, source.type, source.depth, source.parent };
+            size = align_up( size + source.size );
+        }
+
+        std::vector< uint8_t > file( size, 0 );
+        std::memcpy( file.data(), &file_header, sizeof( file_header ) );
+        if ( count != 0 ) std::memcpy( file.data() + sizeof( file_header ), table.data(), count * sizeof( snapshot_region_t ) );
+        if ( !relocations.empty() ) std::memcpy( file.data() + relocations_offset, relocations.data(), relocations.size() * sizeof( snapshot_relocation_t ) );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( order[ i ]->size != 0 ) std::memcpy( file.data() + table[ i ].data_offset, order[ i ]->data, order[ i ]->size );
+        }
+        return file;
+    }
+
+    bool write_memory_snapshot( const char* path, const snapshot_file_header_t& header, const snapshot_source_region_t* regions, const size_t count )
+    {
+        const auto file_data = serialize_memory_snapshot( header, regions, count );
+
+        auto* file = std::fopen( path, "wb" );
+        if ( file == nullptr ) return false;
+        const auto ok = std::fwrite( file_data.data(), 1, file_data.size(), file ) == file_data.size();
+        return std::fclose( file ) == 0 && ok;
+    }
+
+    const snapshot_region_t* memory_snapshot_t::find_region( const uint64_t address ) const
+    {
+        // last region starting at or before the address
+        auto it = std::upper_bound( this->regions.begin(), this->regions.end(), address,
+                                    []( const uint64_t value, const snapshot_region_t& region ) { return value < region.address; } );
+        if ( it == this->regions.begin() ) return nullptr;
+        --it;
+        return address - it->address < it->size ? &*it : nullptr;
+    }
+
+    bool memory_snapshot_t::read( const uint64_t address, void* out, const size_t size ) const
+    {
+        const auto* region = this->find_region( address );
+        if ( region == nullptr || address - region->address + size > region->size ) return false;
+        std::memcpy( out, this->get_data( *region ) + ( address - region->address ), size );
+        return true;
+    }
+
+    const snapshot_region_t* memory_snapshot_t::follow( const snapshot_region_t& region, const uint32_t offset, uint32_t& target_offset ) const
+    {
+        const auto index = this->get_index( region );
+        const auto it = std::lower_bound( this->relocations.begin(), this->relocations.end(), std::make_pair( index, offset ),
+                                          []( const snapshot_relocation_t& relocation, const std::pair< uint32_t, uint32_t >& key )
+                                          {
+                                              return relocation.region < key.first || ( relocation.region == key.first && relocation.offset < key.second );
+                                          } );
+        if ( it == this->relocations.end() || it->region != index || it->offset != offset ) return nullptr;
+        target_offset = it->target_offset;
+        return &this->regions[ it->target ];
+    }
+
+    bool parse_memory_snapshot( std::vector< uint8_t > file, memory_snapshot_t& out, std::string& error )
+    {
+        out = {};
+        const auto storage = std::make_shared< std::vector< uint8_t > >( std::move( file ) );
+        out.data = storage->data();
+        out.size = storage->size();
+        out.storage = storage;
+        return validate_memory_snapshot( out, error );
+    }
+
+    bool load_memory_snapshot( const char* path, memory_snapshot_t& out, std::string& error )
+    {
+        out = {};
+#ifdef _WIN32
+        const auto file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        LARGE_INTEGER file_size{};
+        if ( file == INVALID_HANDLE_VALUE || !GetFileSizeEx( file, &file_size ) )
+        {
+            if ( file != INVALID_HANDLE_VALUE ) CloseHandle( file );
+            error = std::string( "cannot open " ) + path;
+            return false;
+        }
+
+        const auto mapping = file_size.QuadPart > 0 ? CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr ) : nullptr;
+        CloseHandle( file );
+        const void* data = mapping != nullptr ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+        if ( mapping != nullptr ) CloseHandle( mapping ); // the view keeps it open
+        if ( data == nullptr )
+        {
+            error = file_size.QuadPart > 0 ? std::string( "cannot map " ) + path : "file is too small for a snapshot header";
+            return false;
+        }
+
+        out.storage = std::shared_ptr< const void >( data, []( const void* view ) { UnmapViewOfFile( view ); } );
+        out.size = static_cast< size_t >( file_size.QuadPart );
+#else
+        const int fd = ::open( path, O_RDONLY );
+        struct stat info{};
+        if ( fd < 0 || fstat( fd, &info ) != 0 )
+        {
+            if ( fd >= 0 ) ::close( fd );
+            error = std::string( "cannot open " ) + path;
+            return false;
+        }
+
+        const auto size = static_cast< size_t >( info.st_size );
+        void* data = size > 0 ? mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 ) : MAP_FAILED;
+        ::close( fd ); // the mapping keeps the file
+        if ( data == MAP_FAILED )
+        {
+            error = size > 0 ? std::string( "cannot map " ) + path : "file is too small for a snapshot header";
+            return false;
+        }
+
+        out.storage = std::shared_ptr< const void >( data, [ size ]( const void* mapping ) { munmap( const_cast< void* >( mapping ), size ); } );
+        out.size = size;
+#endif
+        out.data = static_cast< const uint8_t* >( out.storage.get() );
+        return validate_memory_snapshot( out, error );
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ts_extra_utilities::memory
+{
+    // what a snapshot region was captured as
+    struct SnapshotType
+    {
+        enum Enum : uint16_t
+        {
+            UNKNOWN,
+            BASE_CTRL,
+            GAME_ACTOR,
+            GAME_PHYSICS_VEHICLE, // the truck
+            GAME_TRAILER_ACTOR,
+            ACCESSORY_CHASSIS_DATA,
+            WHEEL_STEERING_DATA,
+            PHYSICS_JOINT,
+            PX_D6_JOINT,
+            COUNT
+        };
+    };
+
+    const char* to_string( SnapshotType::Enum type );
+
+#pragma pack(push, 1)
+    // file layout: header, region_count * region, relocation_count * relocation, then the region data, each 16 byte aligned
+    struct snapshot_file_header_t // size: 0x0048
+    {
+        uint32_t magic; // 0x0000 (0x04) 'TSMS'
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t region_size; // 0x0006 (0x02) sizeof( snapshot_region_t )
+        uint32_t region_count; // 0x0008 (0x04)
+        uint32_t frame; // 0x000C (0x04) position in a series, snapshots of one session share their addresses
+        uint64_t image_base; // 0x0010 (0x08) game module
+        uint64_t rdata_begin; // 0x0018 (0x08) the game module's .rdata, where the vtables are
+        uint64_t rdata_end; // 0x0020 (0x08)
+        uint64_t timestamp; // 0x0028 (0x08) unix seconds
+        char game[ 4 ]; // 0x0030 (0x04) "ats" or "ets2", nul padded, not nul terminated when full
+        char game_version[ 12 ]; // 0x0034 (0x0c) pack set version, nul padded, not nul terminated when full
+        uint32_t relocation_count; // 0x0040 (0x04)
+        uint32_t relocation_size; // 0x0044 (0x04) sizeof( snapshot_relocation_t )
+    };
+
+    static_assert(sizeof( snapshot_file_header_t ) == 0x48);
+
+    struct snapshot_region_t // size: 0x0020
+    {
+        uint64_t address; // 0x0000 (0x08) in the game process
+        uint64_t data_offset; // 0x0008 (0x08) from the start of the file
+        uint32_t size; // 0x0010 (0x04)
+        uint16_t type; // 0x0014 (0x02) SnapshotType::Enum
+        uint16_t depth; // 0x0016 (0x02) pointers followed from the root
+        uint64_t parent; // 0x0018 (0x08) address of the region it was reached from, 0 for the root
+    };
+
+    static_assert(sizeof( snapshot_region_t ) == 0x20);
+
+    // a captured qword that points into a captured region, sorted by region and offset
+    struct snapshot_relocation_t // size: 0x0010
+    {
+        uint32_t region; // 0x0000 (0x04) index of the region holding the pointer
+        uint32_t offset; // 0x0004 (0x04) of the pointer in that region
+        uint32_t target; // 0x0008 (0x04) index of the region it points into
+        uint32_t target_offset; // 0x000C (0x04)
+    };
+
+    static_assert(sizeof( snapshot_relocation_t ) == 0x10);
+#pragma pack(pop)
+
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x534D5354; // "TSMS" on disk
+    constexpr uint16_t SNAPSHOT_VERSION = 2; // 2: relocations
+
+    // the nul padded strings of the header
+    void set_snapshot_string( char* field, size_t size, const std::string& value );
+    std::string get_snapshot_string( const char* field, size_t size );
+
+    // one region to write, `data` is copied
+    struct snapshot_source_region_t
+    {
+        uint64_t address;
+        const void* data;
+        uint32_t size;
+        SnapshotType::Enum type;
+        uint16_t depth;
+        uint64_t parent;
+    };
+
+    /**
+     * \brief Lays out a snapshot file, the regions are sorted by address and every 8 byte aligned qword that points into
+     * a region gets a relocation
+     * \param header everything but magic, version and the table sizes and counts, which are filled in
+     */
+    std::vector< uint8_t > serialize_memory_snapshot( const snapshot_file_header_t& header, const snapshot_source_region_t* regions, size_t count );
+    bool write_memory_snapshot( const char* path, const snapshot_file_header_t& header, const snapshot_source_region_t* regions, size_t count );
+
+    // array in a snapshot file
+    template < typename T >
+    struct snapshot_table_t
+    {
+        const T* items = nullptr;
+        size_t count = 0;
+
+        const T* begin() const { return this->items; }
+        const T* end() const { return this->items + this->count; }
+        size_t size() const { return this->count; }
+        bool empty() const { return this->count == 0; }
+        const T& operator[]( const size_t index ) const { return this->items[ index ]; }
+    };
+
+    // everything points into the file, which is mapped read only when loaded from disk
+    struct memory_snapshot_t
+    {
+        snapshot_file_header_t header{};
+        snapshot_table_t< snapshot_region_t > regions; // sorted by address
+        snapshot_table_t< snapshot_relocation_t > relocations; // sorted by region and offset
+        const uint8_t* data = nullptr; // the whole file
+        size_t size = 0;
+        std::shared_ptr< const void > storage; // keeps `data` alive, copies of the snapshot share it
+
+        const uint8_t* get_data( const snapshot_region_t& region ) const { return this->data + region.data_offset; }
+        uint32_t get_index( const snapshot_region_t& region ) const { return static_cast< uint32_t >( &region - this->regions.items ); }
+
+        // region that contains `address`, nullptr if it wasn't captured
+        const snapshot_region_t* find_region( uint64_t address ) const;
+
+        // false if any of the bytes weren't captured
+        bool read( uint64_t address, void* out, size_t size ) const;
+
+        template < typename T >
+        bool read( const uint64_t address, T& out ) const { return this->read( address, &out, sizeof( T ) ); }
+
+        /**
+         * \brief Follows the pointer at `offset` of `region` through the relocations, without looking up its address
+         * \param target_offset where in the returned region it points
+         * \return nullptr if the pointer doesn't point into a captured region
+         */
+        const snapshot_region_t* follow( const snapshot_region_t& region, uint32_t offset, uint32_t& target_offset ) const;
+    };
+
+    /**
+     * \brief Portable reader for snapshot files, validates the tables against the file before anything reads them
+     */
+    bool parse_memory_snapshot( std::vector< uint8_t > file, memory_snapshot_t& out, std::string& error );
+
+    // maps the file instead of reading it, nothing is copied
+    bool load_memory_snapshot( const char* path, memory_snapshot_t& out, std::string& error );
+}
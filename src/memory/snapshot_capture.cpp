@@ -0,0 +1,267 @@
+#include "snapshot_capture.hpp"
+
+#include <Windows.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+
+#include "safe_read.hpp"
+#include "snapshot.hpp"
+#include "prism/controllers/base_ctrl.hpp"
+#include "prism/game_actor.hpp"
+#include "prism/offsets.hpp"
+#include "prism/physics/physics_joint_t.hpp"
+#include "prism/vehicles/game_trailer_actor.hpp"
+#include "prism/vehicles/accessories/data/accessory_chassis_data.hpp"
+
+namespace ts_extra_utilities::memory
+{
+    namespace
+    {
+        constexpr uint32_t SIZE_SLACK = 0x100; // for fields a new build added
+        constexpr uint32_t NEIGHBOUR_SIZE = 0x100;
+        constexpr uint64_t MIN_POINTER = 0x10000, MAX_POINTER = 0x7FFF'FFFF'FFFF;
+
+        uint32_t get_known_size( const SnapshotType::Enum type )
+        {
+            switch ( type )
+            {
+                case SnapshotType::BASE_CTRL: return sizeof( prism::base_ctrl_u );
+                case SnapshotType::GAME_ACTOR: return sizeof( prism::game_actor_u );
+                case SnapshotType::GAME_PHYSICS_VEHICLE: return sizeof( prism::game_physics_vehicle_u );
+                case SnapshotType::GAME_TRAILER_ACTOR: return sizeof( prism::game_trailer_actor_u );
+                case SnapshotType::ACCESSORY_CHASSIS_DATA: return sizeof( prism::accessory_chassis_data_u );
+                case SnapshotType::WHEEL_STEERING_DATA: return sizeof( prism::vehicle_wheel_steering_data_t );
+                case SnapshotType::PHYSICS_JOINT: return sizeof( prism::physics_joint_physx_t );
+                case SnapshotType::PX_D6_JOINT: return sizeof( physx::PxD6Joint );
+                default: return NEIGHBOUR_SIZE;
+            }
+        }
+
+        struct module_sections_t
+        {
+            uint64_t image_base, image_end;
+            uint64_t rdata_begin, rdata_end;
+        };
+
+        module_sections_t find_module_sections()
+        {
+            module_sections_t sections{};
+            const auto base = reinterpret_cast< uint64_t >( GetModuleHandle( nullptr ) );
+            const auto* header = reinterpret_cast< const IMAGE_DOS_HEADER* >( base );
+            const auto* nt_header = reinterpret_cast< const IMAGE_NT_HEADERS64* >( base + header->e_lfanew );
+            sections.image_base = base;
+            sections.image_end = base + nt_header->OptionalHeader.SizeOfImage;
+
+            const auto* section = IMAGE_FIRST_SECTION( nt_header );
+            for ( WORD i = 0; i < nt_header->FileHeader.NumberOfSections; ++i, ++section )
+            {
+                if ( memcmp( section->Name, ".rdata", 7 ) != 0 ) continue;
+                sections.rdata_begin = base + section->VirtualAddress;
+                sections.rdata_end = sections.rdata_begin + section->Misc.VirtualSize;
+                break;
+            }
+            return sections;
+        }
+
+        class CSnapshotCapture
+        {
+        private:
+            struct captured_t
+            {
+                uint64_t address;
+                size_t data; // in arena_
+                uint32_t size;
+                SnapshotType::Enum type;
+                uint16_t depth;
+                uint64_t parent;
+            };
+
+            const snapshot_capture_options_t& options_;
+            const module_sections_t sections_;
+            std::vector< captured_t > captured_;
+            std::vector< uint8_t > arena_;
+            std::unordered_map< uint64_t, uint32_t > index_; // address -> captured_
+
+            const uint8_t* get_data( const captured_t& object ) const { return this->arena_.data() + object.data; }
+
+            // index of the copy, -1 if it couldn't be read
+            int64_t capture( const uint64_t address, const SnapshotType::Enum type, const uint16_t depth, const uint64_t parent )
+            {
+                if ( address == 0 ) return -1;
+                if ( const auto it = this->index_.find( address ); it != this->index_.end() ) return it->second;
+                if ( this->captured_.size() >= this->options_.max_regions || address % 8 != 0 )
+                {
+                    ++this->skipped;
+                    return -1;
+                }
+
+                auto size = get_known_size( type );
+                if ( type != SnapshotType::UNKNOWN && is_readable( address, size + SIZE_SLACK ) ) size += SIZE_SLACK;
+                else if ( !is_readable( address, size ) )
+                {
+                    ++this->skipped;
+                    return -1;
+                }
+
+                const auto data = this->arena_.size();
+                this->arena_.resize( data + size );
+                if ( !safe_copy( this->arena_.data() + data, address, size ) )
+                {
+                    this->arena_.resize( data );
+                    ++this->skipped;
+                    return -1;
+                }
+
+                const auto index = static_cast< uint32_t >( this->captured_.size() );
+                this->captured_.push_back( { address, data, size, type, depth, parent } );
+                this->index_.emplace( address, index );
+                return index;
+            }
+
+            // through the offset database, from the copy
+            void follow( const uint32_t index, const prism::field_id::type field, const SnapshotType::Enum type )
+            {
+                const auto object = this->captured_[ index ];
+                const auto offset = prism::g_field_offsets[ field ];
+                if ( object.depth >= this->options_.max_depth || offset + sizeof( uint64_t ) > object.size ) return;
+
+                uint64_t value;
+                memcpy( &value, this->get_data( object ) + offset, sizeof( value ) );
+                this->capture( value, type, static_cast< uint16_t >( object.depth + 1 ), object.address );
+            }
+
+            void follow_vehicle( const uint32_t index )
+            {
+                this->follow( index, prism::field_id::vehicle_shared_accessory_chassis_data, SnapshotType::ACCESSORY_CHASSIS_DATA );
+                this->follow( index, prism::field_id::vehicle_shared_wheel_steering_stuff, SnapshotType::WHEEL_STEERING_DATA );
+            }
+
+            void visit( const uint32_t index )
+            {
+                switch ( this->captured_[ index ].type )
+                {
+                    case SnapshotType::BASE_CTRL:
+                        this->follow( index, prism::field_id::base_ctrl_game_actor, SnapshotType::GAME_ACTOR );
+                        break;
+                    case SnapshotType::GAME_ACTOR:
+                        this->follow( index, prism::field_id::game_actor_game_physics_vehicle, SnapshotType::GAME_PHYSICS_VEHICLE );
+                        this->follow( index, prism::field_id::game_actor_game_trailer_actor, SnapshotType::GAME_TRAILER_ACTOR );
+                        break;
+                    case SnapshotType::GAME_PHYSICS_VEHICLE:
+                        this->follow_vehicle( index );
+                        break;
+                    case SnapshotType::GAME_TRAILER_ACTOR:
+                        // parent_vehicle points back up the chain, which is captured already
+                        this->follow_vehicle( index );
+                        this->follow( index, prism::field_id::physics_trailer_physics_joint, SnapshotType::PHYSICS_JOINT );
+                        this->follow( index, prism::field_id::physics_trailer_slave_trailer, SnapshotType::GAME_TRAILER_ACTOR );
+                        break;
+                    case SnapshotType::PHYSICS_JOINT:
+                        this->follow( index, prism::field_id::physics_joint_physx_px_joint, SnapshotType::PX_D6_JOINT );
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            // any other pointer of a typed object to something with a vtable of the game
+            void capture_neighbours( const uint32_t typed_count )
+            {
+                for ( uint32_t i = 0; i < typed_count; ++i )
+                {
+                    const auto object = this->captured_[ i ];
+                    if ( object.depth >= this->options_.max_depth ) continue;
+
+                    for ( uint32_t offset = 8; offset + sizeof( uint64_t ) <= object.size; offset += 8 )
+                    {
+                        uint64_t value;
+                        memcpy( &value, this->get_data( object ) + offset, sizeof( value ) );
+                        if ( value % 8 != 0 || value < MIN_POINTER || value > MAX_POINTER || this->index_.count( value ) != 0 ) continue;
+                        if ( value >= this->sections_.image_base && value < this->sections_.image_end ) continue; // statics and vtables
+
+                        uint64_t vtable = 0;
+                        if ( !is_readable( value, sizeof( vtable ) ) || !safe_copy( &vtable, value, sizeof( vtable ) ) ) continue;
+                        if ( vtable < this->sections_.rdata_begin || vtable >= this->sections_.rdata_end ) continue;
+                        this->capture( value, SnapshotType::UNKNOWN, static_cast< uint16_t >( object.depth + 1 ), object.address );
+                    }
+                }
+            }
+
+        public:
+            uint32_t skipped = 0;
+
+            explicit CSnapshotCapture( const snapshot_capture_options_t& options ) : options_( options ), sections_( find_module_sections() ) {}
+
+            bool run( const prism::base_ctrl_u* base_ctrl )
+            {
+                if ( this->capture( reinterpret_cast< uint64_t >( base_ctrl ), SnapshotType::BASE_CTRL, 0, 0 ) < 0 ) return false;
+
+                // breadth first, captured_ grows while it is walked
+                for ( uint32_t i = 0; i < this->captured_.size(); ++i ) this->visit( i );
+                if ( this->options_.capture_neighbours ) this->capture_neighbours( static_cast< uint32_t >( this->captured_.size() ) );
+                return true;
+            }
+
+            std::vector< uint8_t > serialize() const
+            {
+                std::vector< snapshot_source_region_t > regions;
+                regions.reserve( this->captured_.size() );
+                for ( const auto& object : this->captured_ )
+                {
+                    regions.push_back( { object.address, this->get_data( object ), object.size, object.type, object.depth, object.parent } );
+                }
+
+                snapshot_file_header_t header{};
+                header.frame = this->options_.frame;
+                header.image_base = this->sections_.image_base;
+                header.rdata_begin = this->sections_.rdata_begin;
+                header.rdata_end = this->sections_.rdata_end;
+                header.timestamp = static_cast< uint64_t >( std::time( nullptr ) );
+                set_snapshot_string( header.game, sizeof( header.game ), this->options_.game );
+                set_snapshot_string( header.game_version, sizeof( header.game_version ), this->options_.game_version );
+                return serialize_memory_snapshot( header, regions.data(), regions.size() );
+            }
+        };
+    }
+
+    bool capture_memory_snapshot( const char* path, const prism::base_ctrl_u* base_ctrl, const snapshot_capture_options_t& options,
+                                  snapshot_capture_stats_t& stats, std::string& error )
+    {
+        stats = {};
+        const auto start = std::chrono::steady_clock::now();
+        CSnapshotCapture capture( options );
+        const auto captured = capture.run( base_ctrl );
+        stats.milliseconds = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+        stats.skipped = capture.skipped;
+        if ( !captured )
+        {
+            error = base_ctrl == nullptr ? "base_ctrl not found" : "base_ctrl isn't readable";
+            return false;
+        }
+
+        const auto file_data = capture.serialize();
+        snapshot_file_header_t header;
+        memcpy( &header, file_data.data(), sizeof( header ) );
+        stats.regions = header.region_count;
+        stats.relocations = header.relocation_count;
+        stats.bytes = file_data.size();
+
+        FILE* file = nullptr;
+        if ( fopen_s( &file, path, "wb" ) != 0 || file == nullptr )
+        {
+            error = std::string( "cannot create " ) + path;
+            return false;
+        }
+        const auto written = fwrite( file_data.data(), 1, file_data.size(), file ) == file_data.size();
+        if ( fclose( file ) != 0 || !written )
+        {
+            error = std::string( "cannot write " ) + path;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace ts_extra_utilities::prism
+{
+    class base_ctrl_u;
+}
+
+namespace ts_extra_utilities::memory
+{
+    struct snapshot_capture_options_t
+    {
+        uint32_t max_depth = 8; // pointers followed from base_ctrl, a trailer chain is one level per trailer
+        uint32_t max_regions = 2048;
+        bool capture_neighbours = true;
+        uint32_t frame = 0; // position in a series
+        std::string game; // "ats" or "ets2"
+        std::string game_version; // pack set version
+    };
+
+    struct snapshot_capture_stats_t
+    {
+        uint32_t regions;
+        uint32_t relocations;
+        uint32_t skipped; // objects that weren't readable or past max_regions
+        uint64_t bytes; // file size
+        double milliseconds; // copying game memory, writing the file not included
+    };
+
+    /**
+     * \brief Render thread, copies the object graph below base_ctrl into a snapshot file for offset-discovery and the
+     * other tools that read snapshots.
+     *
+     * Follows the typed pointers base_ctrl -> game_actor -> truck and trailer chain -> chassis data, wheel steering,
+     * physics joint -> PxD6Joint through the offset database. With `capture_neighbours` every other pointer of those
+     * objects to something with a vtable in the game's .rdata is copied as well, untyped and not followed further, so a
+     * field that moved in a new build still has its target in the snapshot. Objects are copied with some slack past
+     * their known size for fields that were added. The game runs on, so the copy isn't atomic, but it is made within a
+     * few milliseconds.
+     */
+    bool capture_memory_snapshot( const char* path, const prism::base_ctrl_u* base_ctrl, const snapshot_capture_options_t& options,
+                                  snapshot_capture_stats_t& stats, std::string& error );
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <xmmintrin.h>
+#endif
+
+#include "./array_dyn.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    // objects ahead, enough to hide a miss behind a loop body that does a guarded read and a hash map insert
+    constexpr uint32_t DEFAULT_PREFETCH_DISTANCE = 16;
+
+    // starts loading the cache line of `address` without waiting for it, never faults, not even on bad addresses
+    inline void prefetch( const void* address )
+    {
+#ifdef _MSC_VER
+        _mm_prefetch( static_cast< const char* >( address ), _MM_HINT_T0 );
+#else
+        __builtin_prefetch( address );
+#endif
+    }
+
+    // the line `offset` bytes into an object, the pointer may be null
+    inline void prefetch( const void* object, const uint32_t offset )
+    {
+        prefetch( reinterpret_cast< const void* >( reinterpret_cast< uintptr_t >( object ) + offset ) );
+    }
+
+    /**
+     * \brief Bounds-checked view of an array_t's elements.
+     *
+     * make_span() gives an empty span when the array header doesn't look like one, no storage or more elements than
+     * the caller expects a collection of that kind to ever hold, so a misread header doesn't become a walk through memory.
+     */
+    template < class T >
+    class array_span_t
+    {
+    private:
+        T* data_ = nullptr;
+        uint64_t size_ = 0;
+
+    public:
+        array_span_t() = default;
+        array_span_t( T* data, const uint64_t size ) : data_( data ), size_( data != nullptr ? size : 0 ) {}
+
+        T* data() const { return this->data_; }
+        uint64_t size() const { return this->size_; }
+        bool empty() const { return this->size_ == 0; }
+
+        T* begin() const { return this->data_; }
+        T* end() const { return this->data_ + this->size_; }
+
+        // nullptr past the end
+        T* get( const uint64_t index ) const { return index < this->size_ ? this->data_ + index : nullptr; }
+
+        // unchecked, for loops over [0, size())
+        T& operator[]( const uint64_t index ) const { return this->data_[ index ]; }
+
+        // clamped to the span
+        array_span_t subspan( const uint64_t offset, const uint64_t count = UINT64_MAX ) const
+        {
+            if ( offset >= this->size_ ) return {};
+            return { this->data_ + offset, count < this->size_ - offset ? count : this->size_ - offset };
+        }
+    };
+
+    template < class T >
+    array_span_t< T > make_span( const array_t< T >& array, const uint64_t max_size )
+    {
+        if ( array.value == nullptr || array.size > max_size ) return {};
+        return { array.value, array.size };
+    }
+
+    template < class T >
+    array_span_t< T > make_span( const array_dyn_t< T >& array, const uint64_t max_size )
+    {
+        if ( array.value == nullptr || array.size > max_size || array.size > array.capacity ) return {};
+        return { array.value, array.size };
+    }
+
+    /**
+     * \brief Iterates the objects an array of pointers points to, prefetching the one `distance` elements ahead.
+     *
+     * `offset` picks the cache line to prefetch, game objects are large and the fields a loop reads are rarely in
+     * their first line. Null pointers are handed out as they are.
+     */
+    template < class T >
+    class prefetch_range_t
+    {
+    private:
+        T* const* begin_;
+        T* const* end_;
+        uint32_t offset_;
+        uint32_t distance_;
+
+    public:
+        class iterator
+        {
+        private:
+            T* const* current_;
+            T* const* end_;
+            uint32_t offset_;
+            uint32_t distance_;
+
+        public:
+            iterator( T* const* current, T* const* end, const uint32_t offset, const uint32_t distance )
+                : current_( current ), end_( end ), offset_( offset ), distance_( distance ) {}
+
+            T* operator*() const { return *this->current_; }
+
+            iterator& operator++()
+            {
+                ++this->current_;
+                if ( static_cast< uint64_t >( this->end_ - this->current_ ) > this->distance_ ) prefetch( this->current_[ this->distance_ ], this->offset_ );
+                return *this;
+            }
+
+            bool operator!=( const iterator& other ) const { return this->current_ != other.current_; }
+        };
+
+        prefetch_range_t( const array_span_t< T* >& objects, const uint32_t offset, const uint32_t distance )
+            : begin_( objects.begin() ), end_( objects.end() ), offset_( offset ), distance_( distance ) {}
+
+        iterator begin() const
+        {
+            // the first `distance` objects, operator++ keeps it that far ahead from there
+            for ( auto* it = this->begin_; it != this->end_ && static_cast< uint64_t >( it - this->begin_ ) <= this->distance_; ++it ) prefetch( *it, this->offset_ );
+            return { this->begin_, this->end_, this->offset_, this->distance_ };
+        }
+
+        iterator end() const { return { this->end_, this->end_, this->offset_, this->distance_ }; }
+    };
+
+    template < class T >
+    prefetch_range_t< T > prefetching( const array_span_t< T* >& objects, const uint32_t offset = 0,
+                                       const uint32_t distance = DEFAULT_PREFETCH_DISTANCE )
+    {
+        return { objects, offset, distance };
+    }
+}
@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include "offsets.hpp"
 #include "token.hpp"
 #include "./unit/unit.hpp"
 #include "./vehicles/game_trailer_actor.hpp"
@@ -108,28 +109,28 @@ namespace ts_extra_utilities::prism
     public:
         game_trailer_actor_u* get_actual_slave_trailer( const vehicle_shared_u* parent_vehicle ) const
         {
-            if ( this->game_trailer_actor == nullptr )
+            if ( fields::game_actor::game_trailer_actor( this ) == nullptr )
             {
                 return nullptr;
             }
 
-            auto* wanted_trailer = this->game_trailer_actor;
+            auto* wanted_trailer = fields::game_actor::game_trailer_actor( this );
 
             while ( wanted_trailer != nullptr )
             {
-                if ( wanted_trailer->parent_vehicle == parent_vehicle )
+                if ( fields::physics_trailer::parent_vehicle( wanted_trailer ) == parent_vehicle )
                 {
                     return wanted_trailer;
                 }
 
-                wanted_trailer = wanted_trailer->slave_trailer;
+                wanted_trailer = fields::physics_trailer::slave_trailer( wanted_trailer );
             }
             return nullptr;
         }
 
         game_trailer_actor_u* get_last_trailer_connected_to_truck() const
         {
-            vehicle_shared_u* last_vehicle = this->game_physics_vehicle;
+            vehicle_shared_u* last_vehicle = fields::game_actor::game_physics_vehicle( this );
             do
             {
                 auto* slave = this->get_actual_slave_trailer( last_vehicle );
@@ -138,7 +139,7 @@ namespace ts_extra_utilities::prism
             }
             while ( true );
 
-            if ( last_vehicle == this->game_physics_vehicle ) return nullptr;
+            if ( last_vehicle == fields::game_actor::game_physics_vehicle( this ) ) return nullptr;
             return reinterpret_cast< game_trailer_actor_u* >( last_vehicle );
         }
     };
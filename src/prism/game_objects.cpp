@@ -0,0 +1,69 @@
+#include "game_objects.hpp"
+
+#include <cstdio>
+
+#include "offsets.hpp"
+#include "memory/safe_read.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    namespace
+    {
+        constexpr uint32_t MAX_TRAILERS = 10; // chain walk limit, in case a slave_trailer points back up
+
+        void add_object( std::vector< game_object_t >& out, const char* label, const char* struct_name, const uint64_t address )
+        {
+            if ( address == 0 ) return;
+
+            game_object_t object{};
+            snprintf( object.label, sizeof( object.label ), "%s", label );
+            object.info = find_struct_info( struct_name );
+            object.address = address;
+            out.push_back( object );
+        }
+
+        void add_vehicle( std::vector< game_object_t >& out, const char* label, const uint64_t vehicle_shared, const char* vehicle_struct )
+        {
+            if ( vehicle_shared == 0 ) return;
+            add_object( out, label, "vehicle_shared", vehicle_shared );
+
+            const auto& info = *find_struct_info( "vehicle_shared" );
+            char child[ 24 ];
+            uint64_t vehicle = 0, chassis = 0;
+            if ( memory::safe_read( vehicle_shared + get_field_offset( info, *find_field_info( info, "vehicle" ) ), vehicle ) )
+            {
+                snprintf( child, sizeof( child ), "%s.vehicle", label );
+                add_object( out, child, vehicle_struct, vehicle );
+            }
+            if ( memory::safe_read( vehicle_shared + g_field_offsets[ field_id::vehicle_shared_accessory_chassis_data ], chassis ) )
+            {
+                snprintf( child, sizeof( child ), "%s.chassis", label );
+                add_object( out, child, "accessory_chassis_data", chassis );
+            }
+        }
+    }
+
+    void collect_game_objects( const uint64_t game_actor, std::vector< game_object_t >& out )
+    {
+        out.clear();
+        if ( game_actor == 0 ) return;
+        add_object( out, "game_actor", "game_actor", game_actor );
+
+        uint64_t truck = 0;
+        if ( memory::safe_read( game_actor + g_field_offsets[ field_id::game_actor_game_physics_vehicle ], truck ) )
+        {
+            add_vehicle( out, "truck", truck, "core_vehicle" );
+        }
+
+        uint64_t trailer = 0;
+        if ( !memory::safe_read( game_actor + g_field_offsets[ field_id::game_actor_game_trailer_actor ], trailer ) ) return;
+        for ( uint32_t i = 0; i < MAX_TRAILERS && trailer != 0; ++i )
+        {
+            char label[ 24 ];
+            snprintf( label, sizeof( label ), "trailer%u", i + 1 );
+            add_vehicle( out, label, trailer, "trailer" );
+
+            if ( !memory::safe_read( trailer + g_field_offsets[ field_id::physics_trailer_slave_trailer ], trailer ) ) break;
+        }
+    }
+}
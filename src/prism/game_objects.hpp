@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "reflection.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    // a reflected object reachable from the game actor
+    struct game_object_t
+    {
+        char label[ 24 ]; // "trailer2.chassis"
+        const struct_info_t* info;
+        uint64_t address;
+    };
+
+    /**
+     * \brief The game actor, the truck and the trailer chain, each with its vehicle and chassis data, through the offset
+     * database. Every pointer is read guarded, whatever hangs off one that doesn't read is left out.
+     */
+    void collect_game_objects( uint64_t game_actor, std::vector< game_object_t >& out );
+}
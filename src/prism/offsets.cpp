@@ -0,0 +1,153 @@
+#include "offsets.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ts_extra_utilities::prism
+{
+    const char* const field_names[ field_id::COUNT ] = {
+#define TS_PRISM_FIELD_NAME( owner, field, type, offset ) #owner "." #field,
+        TS_PRISM_OFFSET_FIELDS( TS_PRISM_FIELD_NAME )
+#undef TS_PRISM_FIELD_NAME
+    };
+
+    const uint32_t default_field_offsets[ field_id::COUNT ] = {
+#define TS_PRISM_FIELD_OFFSET( owner, field, type, offset ) offset,
+        TS_PRISM_OFFSET_FIELDS( TS_PRISM_FIELD_OFFSET )
+#undef TS_PRISM_FIELD_OFFSET
+    };
+
+    uint32_t g_field_offsets[ field_id::COUNT ] = {
+#define TS_PRISM_FIELD_OFFSET( owner, field, type, offset ) offset,
+        TS_PRISM_OFFSET_FIELDS( TS_PRISM_FIELD_OFFSET )
+#undef TS_PRISM_FIELD_OFFSET
+    };
+
+    namespace
+    {
+        std::string_view trim( std::string_view text )
+        {
+            while ( !text.empty() && ( text.front() == ' ' || text.front() == '\t' ) ) text.remove_prefix( 1 );
+            while ( !text.empty() && ( text.back() == ' ' || text.back() == '\t' || text.back() == '\r' ) ) text.remove_suffix( 1 );
+            return text;
+        }
+
+        // how many version components `prefix` matches, -1 if it isn't a prefix of `version`
+        int match_version( const std::string_view prefix, const std::string_view version )
+        {
+            if ( prefix.empty() ) return 0;
+            if ( version.compare( 0, prefix.size(), prefix ) != 0 ) return -1;
+            if ( version.size() != prefix.size() && version[ prefix.size() ] != '.' ) return -1;
+
+            int components = 1;
+            for ( const auto c : prefix ) components += c == '.';
+            return components;
+        }
+
+        bool parse_offset( const std::string_view text, uint32_t& offset )
+        {
+            char buffer[ 16 ];
+            if ( text.empty() || text.size() >= sizeof( buffer ) ) return false;
+            memcpy( buffer, text.data(), text.size() );
+            buffer[ text.size() ] = '\0';
+
+            char* end = nullptr;
+            const auto value = strtoul( buffer, &end, 0 );
+            if ( end != buffer + text.size() || value > 0xFFFFFF ) return false;
+            offset = static_cast< uint32_t >( value );
+            return true;
+        }
+
+        int find_field( const std::string_view name )
+        {
+            for ( int i = 0; i < field_id::COUNT; ++i )
+            {
+                if ( name == field_names[ i ] ) return i;
+            }
+            return -1;
+        }
+    }
+
+    bool parse_offset_database( const std::string_view text, const std::string_view game, const std::string_view version, offset_table_t& table,
+                                std::string& error )
+    {
+        memcpy( table.offsets, default_field_offsets, sizeof( table.offsets ) );
+        table.loaded = 0;
+        table.section.clear();
+        error.clear();
+
+        // every matching section applies, the more version components it matches the more it overrides
+        int levels[ field_id::COUNT ];
+        for ( auto& level : levels ) level = -1;
+        int section_match = -1, best_match = -1;
+        uint32_t line_number = 0;
+        for ( size_t start = 0; start < text.size(); )
+        {
+            auto end = text.find( '\n', start );
+            if ( end == std::string_view::npos ) end = text.size();
+            auto line = text.substr( start, end - start );
+            start = end + 1;
+            ++line_number;
+
+            if ( const auto comment = line.find( '#' ); comment != std::string_view::npos ) line = line.substr( 0, comment );
+            line = trim( line );
+            if ( line.empty() ) continue;
+
+            if ( line.front() == '[' )
+            {
+                section_match = -1;
+                if ( line.back() != ']' )
+                {
+                    if ( error.empty() ) error = "line " + std::to_string( line_number ) + ": unterminated section";
+                    continue;
+                }
+
+                const auto section = trim( line.substr( 1, line.size() - 2 ) );
+                const auto space = section.find( ' ' );
+                const auto section_version = space != std::string_view::npos ? trim( section.substr( space + 1 ) ) : std::string_view();
+                if ( section.substr( 0, space ) == game ) section_match = match_version( section_version, version );
+                if ( section_match > best_match )
+                {
+                    best_match = section_match;
+                    table.section = std::string( section );
+                }
+                continue;
+            }
+
+            // fields of sections that don't match are checked all the same, a typo shouldn't wait for the next update
+            const auto space = line.find_first_of( " \t" );
+            const auto field = find_field( line.substr( 0, space ) );
+            uint32_t offset = 0;
+            if ( field < 0 || space == std::string_view::npos || !parse_offset( trim( line.substr( space ) ), offset ) )
+            {
+                if ( error.empty() ) error = "line " + std::to_string( line_number ) + ": bad field '" + std::string( line ) + "'";
+                continue;
+            }
+            if ( section_match >= 0 && section_match >= levels[ field ] )
+            {
+                levels[ field ] = section_match;
+                table.offsets[ field ] = offset;
+                table.loaded |= 1ull << field;
+            }
+        }
+
+        return error.empty();
+    }
+
+    void apply_offset_table( const offset_table_t& table )
+    {
+        memcpy( g_field_offsets, table.offsets, sizeof( g_field_offsets ) );
+    }
+
+    std::string_view find_pack_set_version( const std::string_view log )
+    {
+        constexpr std::string_view marker = "pack set version ";
+        const auto position = log.find( marker );
+        if ( position == std::string_view::npos ) return {};
+
+        const auto start = position + marker.size();
+        auto end = start;
+        while ( end < log.size() && ( ( log[ end ] >= '0' && log[ end ] <= '9' ) || log[ end ] == '.' ) ) ++end;
+        return log.substr( start, end - start );
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ts_extra_utilities
+{
+    struct float3_t;
+
+    namespace physx
+    {
+        class PxD6Joint;
+    }
+}
+
+namespace ts_extra_utilities::prism
+{
+    class game_actor_u;
+    class game_physics_vehicle_u;
+    class game_trailer_actor_u;
+    class vehicle_shared_u;
+    class vehicle_wheel_steering_data_t;
+    class accessory_chassis_data_u;
+    class physics_joint_physx_t;
+
+    /**
+     * \brief Every field the plugin reaches through the offset database: owner, field, type and the offset of the game
+     * build the prism headers were written against, which is used for anything the database doesn't list.
+     *
+     * Each entry becomes a field_id, its "owner.field" name in the database file and an accessor
+     * `prism::fields::owner::field( object )` that adds the current offset, one array load per access.
+     *
+     * node_item and kdop_item are guesses from the map file layout (vtable, uid, then position or kdop bounds) that
+     * haven't been checked against a game build, the map index rejects positions that don't look like world coordinates.
+     */
+#define TS_PRISM_OFFSET_FIELDS( X ) \
+    X( base_ctrl, game_actor, game_actor_u*, 0x02E8 ) \
+    X( game_actor, game_physics_vehicle, game_physics_vehicle_u*, 0x0018 ) \
+    X( game_actor, game_trailer_actor, game_trailer_actor_u*, 0x00B8 ) \
+    X( vehicle_shared, accessory_chassis_data, accessory_chassis_data_u*, 0x0150 ) \
+    X( vehicle_shared, hook_locator, float3_t, 0x0334 ) \
+    X( vehicle_shared, steering, float, 0x04E8 ) \
+    X( vehicle_shared, wheel_steering_stuff, vehicle_wheel_steering_data_t*, 0x04F0 ) \
+    X( physics_trailer, physics_joint, physics_joint_physx_t*, 0x0D60 ) \
+    X( physics_trailer, parent_vehicle, vehicle_shared_u*, 0x0DE8 ) \
+    X( physics_trailer, slave_trailer, game_trailer_actor_u*, 0x0DF0 ) \
+    X( physics_joint_physx, px_joint, physx::PxD6Joint*, 0x0018 ) \
+    X( accessory_chassis_data, hook_position, float3_t, 0x0448 ) \
+    X( node_item, position, float3_t, 0x0010 ) \
+    X( kdop_item, bounds_min, float3_t, 0x0010 ) \
+    X( kdop_item, bounds_max, float3_t, 0x001C )
+
+    struct field_id
+    {
+        enum type : uint16_t
+        {
+#define TS_PRISM_FIELD_ID( owner, field, type, offset ) owner##_##field,
+            TS_PRISM_OFFSET_FIELDS( TS_PRISM_FIELD_ID )
+#undef TS_PRISM_FIELD_ID
+            COUNT
+        };
+    };
+
+    static_assert(field_id::COUNT <= 64, "offset_table_t::loaded is a 64 bit mask");
+
+    // "owner.field"
+    extern const char* const field_names[ field_id::COUNT ];
+    extern const uint32_t default_field_offsets[ field_id::COUNT ];
+
+    // what the accessors use, the defaults until apply_offset_table()
+    extern uint32_t g_field_offsets[ field_id::COUNT ];
+
+    namespace fields
+    {
+#define TS_PRISM_FIELD_ACCESSOR( owner, field, type, offset ) \
+        namespace owner \
+        { \
+            inline type& field( void* object ) \
+            { \
+                return *reinterpret_cast< type* >( static_cast< uint8_t* >( object ) + g_field_offsets[ field_id::owner##_##field ] ); \
+            } \
+            inline type const& field( const void* object ) \
+            { \
+                return *reinterpret_cast< type const* >( static_cast< const uint8_t* >( object ) + g_field_offsets[ field_id::owner##_##field ] ); \
+            } \
+        }
+        TS_PRISM_OFFSET_FIELDS( TS_PRISM_FIELD_ACCESSOR )
+#undef TS_PRISM_FIELD_ACCESSOR
+    }
+
+    struct offset_table_t
+    {
+        uint32_t offsets[ field_id::COUNT ];
+        uint64_t loaded; // bit per field that came from the database instead of the defaults
+        std::string section; // "game version" of the most specific matching section, empty if none matched
+    };
+
+    /**
+     * \brief Picks the offsets for one game build out of an offset database
+     *
+     * The database is text, one section per game build followed by "owner.field offset" lines, offsets in hex or
+     * decimal, # starts a comment:
+     *
+     *     [ats 1.56.1.10]
+     *     base_ctrl.game_actor 0x2e8
+     *
+     * Every section of `game` whose version is a prefix of `version` on dot boundaries applies, the ones matching more
+     * of it override the others, so "[ats]" can hold what never moved, "[ats 1.56]" what changed with 1.56 and
+     * "[ats 1.56.1.10]" a single build's fixes. Fields no section lists keep their defaults.
+     * \param game "ats" or "ets2"
+     * \param version pack set version, e.g. "1.56.1.10"
+     * \param error first malformed line, the table is still filled from the rest
+     * \return false if the text has errors
+     */
+    bool parse_offset_database( std::string_view text, std::string_view game, std::string_view version, offset_table_t& table, std::string& error );
+
+    // once at startup, before anything reads through the accessors
+    void apply_offset_table( const offset_table_t& table );
+
+    // "1.56.1.10" from the "Loaded pack set version 1.56.1.10" line of game.log.txt, empty if there is none
+    std::string_view find_pack_set_version( std::string_view log );
+
+    inline bool is_field_loaded( const offset_table_t& table, const field_id::type field ) { return ( table.loaded >> field & 1 ) != 0; }
+}
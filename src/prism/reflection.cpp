@@ -0,0 +1,240 @@
+#include "reflection.hpp"
+
+#include <cinttypes>
+#include <cstring>
+
+#include "offsets.hpp"
+#include "token.hpp"
+
+#ifdef _WIN32
+#include "game_actor.hpp"
+#include "vehicles/trailer.hpp"
+#include "vehicles/accessories/data/accessory_chassis_data.hpp"
+#endif
+
+namespace ts_extra_utilities::prism
+{
+    namespace
+    {
+#define TS_PRISM_FIELD_INFO( field, type, count, offset ) { #field, offset, FieldType::type, count },
+
+        constexpr field_info_t game_actor_fields[] = { TS_PRISM_GAME_ACTOR_FIELDS( TS_PRISM_FIELD_INFO ) };
+        constexpr field_info_t vehicle_shared_fields[] = { TS_PRISM_VEHICLE_SHARED_FIELDS( TS_PRISM_FIELD_INFO ) };
+        constexpr field_info_t core_vehicle_fields[] = { TS_PRISM_CORE_VEHICLE_FIELDS( TS_PRISM_FIELD_INFO ) };
+        constexpr field_info_t trailer_fields[] = {
+            TS_PRISM_CORE_VEHICLE_FIELDS( TS_PRISM_FIELD_INFO )
+            TS_PRISM_TRAILER_FIELDS( TS_PRISM_FIELD_INFO )
+        };
+        constexpr field_info_t accessory_chassis_data_fields[] = {
+            TS_PRISM_ACCESSORY_DATA_FIELDS( TS_PRISM_FIELD_INFO )
+            TS_PRISM_ACCESSORY_CHASSIS_DATA_FIELDS( TS_PRISM_FIELD_INFO )
+        };
+
+#undef TS_PRISM_FIELD_INFO
+
+        template < size_t N >
+        constexpr bool is_sorted_by_offset( const field_info_t ( &fields )[ N ] )
+        {
+            for ( size_t i = 1; i < N; ++i )
+            {
+                if ( fields[ i ].offset < fields[ i - 1 ].offset + fields[ i - 1 ].get_size() ) return false;
+            }
+            return true;
+        }
+
+        static_assert(is_sorted_by_offset( game_actor_fields ));
+        static_assert(is_sorted_by_offset( vehicle_shared_fields ));
+        static_assert(is_sorted_by_offset( trailer_fields ));
+        static_assert(is_sorted_by_offset( accessory_chassis_data_fields ));
+
+#ifdef _WIN32
+        // the lists against the headers, with the base class's fields checked on the derived class
+#define TS_PRISM_CHECK_FIELD( field, type, count, offset ) \
+        static_assert(offsetof( TS_PRISM_CHECKED, field ) == offset, #field " moved"); \
+        static_assert(sizeof( TS_PRISM_CHECKED::field ) == get_field_type_size( FieldType::type ) * count, #field " changed type");
+
+#define TS_PRISM_CHECKED game_actor_u
+        TS_PRISM_GAME_ACTOR_FIELDS( TS_PRISM_CHECK_FIELD )
+#undef TS_PRISM_CHECKED
+#define TS_PRISM_CHECKED vehicle_shared_u
+        TS_PRISM_VEHICLE_SHARED_FIELDS( TS_PRISM_CHECK_FIELD )
+#undef TS_PRISM_CHECKED
+#define TS_PRISM_CHECKED trailer_u
+        TS_PRISM_CORE_VEHICLE_FIELDS( TS_PRISM_CHECK_FIELD )
+        TS_PRISM_TRAILER_FIELDS( TS_PRISM_CHECK_FIELD )
+#undef TS_PRISM_CHECKED
+#define TS_PRISM_CHECKED accessory_chassis_data_u
+        TS_PRISM_ACCESSORY_DATA_FIELDS( TS_PRISM_CHECK_FIELD )
+        TS_PRISM_ACCESSORY_CHASSIS_DATA_FIELDS( TS_PRISM_CHECK_FIELD )
+#undef TS_PRISM_CHECKED
+
+#undef TS_PRISM_CHECK_FIELD
+#endif
+
+        template < size_t N >
+        constexpr struct_info_t make_struct_info( const char* name, const uint32_t size, const field_info_t ( &fields )[ N ] )
+        {
+            return { name, size, fields, N };
+        }
+
+        template < typename T >
+        T read_value( const uint8_t* data )
+        {
+            T value;
+            memcpy( &value, data, sizeof( T ) );
+            return value;
+        }
+    }
+
+    const struct_info_t reflected_structs[] = {
+        make_struct_info( "game_actor", 0x10D8, game_actor_fields ),
+        make_struct_info( "vehicle_shared", 0x0D58, vehicle_shared_fields ),
+        make_struct_info( "core_vehicle", 0x0158, core_vehicle_fields ),
+        make_struct_info( "trailer", 0x0188, trailer_fields ),
+        make_struct_info( "accessory_chassis_data", 0x0498, accessory_chassis_data_fields ),
+    };
+
+    const size_t reflected_struct_count = sizeof( reflected_structs ) / sizeof( reflected_structs[ 0 ] );
+
+#ifdef _WIN32
+    static_assert(sizeof( game_actor_u ) == 0x10D8 && sizeof( vehicle_shared_u ) == 0x0D58 && sizeof( core_vehicle_u ) == 0x0158 &&
+        sizeof( trailer_u ) == 0x0188 && sizeof( accessory_chassis_data_u ) == 0x0498);
+#endif
+
+    const char* to_string( const FieldType::Enum type )
+    {
+        switch ( type )
+        {
+            case FieldType::U8: return "uint8";
+            case FieldType::BOOL: return "bool";
+            case FieldType::U16: return "uint16";
+            case FieldType::U32: return "uint32";
+            case FieldType::I64: return "int64";
+            case FieldType::FLOAT: return "float";
+            case FieldType::POINTER: return "pointer";
+            case FieldType::TOKEN: return "token";
+            case FieldType::ARRAY: return "array";
+            case FieldType::STRING: return "string";
+            default: return "unknown";
+        }
+    }
+
+    const struct_info_t* find_struct_info( const std::string_view name )
+    {
+        for ( size_t i = 0; i < reflected_struct_count; ++i )
+        {
+            if ( name == reflected_structs[ i ].name ) return &reflected_structs[ i ];
+        }
+        return nullptr;
+    }
+
+    const field_info_t* find_field_info( const struct_info_t& info, const std::string_view name )
+    {
+        for ( const auto& field : info )
+        {
+            if ( name == field.name ) return &field;
+        }
+        return nullptr;
+    }
+
+    uint32_t get_field_offset( const struct_info_t& info, const field_info_t& field )
+    {
+        const auto owner = strlen( info.name );
+        for ( uint32_t i = 0; i < field_id::COUNT; ++i )
+        {
+            const std::string_view name = field_names[ i ];
+            if ( name.size() == owner + 1 + strlen( field.name ) && name.compare( 0, owner, info.name ) == 0 && name[ owner ] == '.' &&
+                 name.compare( owner + 1, std::string_view::npos, field.name ) == 0 )
+            {
+                return g_field_offsets[ i ];
+            }
+        }
+        return field.offset;
+    }
+
+    void format_field_value( const field_info_t& field, const uint8_t* data, char* buffer, const size_t size )
+    {
+        if ( size == 0 ) return;
+        buffer[ 0 ] = '\0';
+
+        switch ( field.type )
+        {
+            case FieldType::U8:
+                snprintf( buffer, size, "%u (0x%02x)", data[ 0 ], data[ 0 ] );
+                break;
+            case FieldType::BOOL:
+                if ( data[ 0 ] <= 1 ) snprintf( buffer, size, "%s", data[ 0 ] != 0 ? "true" : "false" );
+                else snprintf( buffer, size, "%u?", data[ 0 ] );
+                break;
+            case FieldType::U16:
+            {
+                const auto value = read_value< uint16_t >( data );
+                snprintf( buffer, size, "%u (0x%04x)", value, value );
+                break;
+            }
+            case FieldType::U32:
+                snprintf( buffer, size, "%" PRIu32, read_value< uint32_t >( data ) );
+                break;
+            case FieldType::I64:
+                snprintf( buffer, size, "%" PRId64, read_value< int64_t >( data ) );
+                break;
+            case FieldType::FLOAT:
+            {
+                size_t length = 0;
+                for ( uint16_t i = 0; i < field.count && length < size; ++i )
+                {
+                    const auto written = snprintf( buffer + length, size - length, i == 0 ? "%.6g" : " %.6g",
+                                                   static_cast< double >( read_value< float >( data + i * sizeof( float ) ) ) );
+                    if ( written < 0 ) break;
+                    length += static_cast< size_t >( written );
+                }
+                break;
+            }
+            case FieldType::POINTER:
+            {
+                const auto value = read_value< uint64_t >( data );
+                if ( value == 0 ) snprintf( buffer, size, "null" );
+                else snprintf( buffer, size, "0x%" PRIx64, value );
+                break;
+            }
+            case FieldType::TOKEN:
+            {
+                char name[ max_token_length ];
+                const auto length = token_t( read_value< uint64_t >( data ) ).decode( name );
+                snprintf( buffer, size, "%.*s", static_cast< int >( length ), name );
+                break;
+            }
+            case FieldType::ARRAY:
+                // vtable, value, size, capacity
+                snprintf( buffer, size, "%" PRIu64 " / %" PRIu64 " @ 0x%" PRIx64, read_value< uint64_t >( data + 0x10 ), read_value< uint64_t >( data + 0x18 ),
+                          read_value< uint64_t >( data + 0x08 ) );
+                break;
+            case FieldType::STRING:
+                // vtable, str, size, capacity
+                snprintf( buffer, size, "%" PRIu32 " chars @ 0x%" PRIx64, read_value< uint32_t >( data + 0x10 ), read_value< uint64_t >( data + 0x08 ) );
+                break;
+            default:
+                break;
+        }
+    }
+
+    void format_field_type( const field_info_t& field, char* buffer, const size_t size )
+    {
+        if ( field.count == 1 ) snprintf( buffer, size, "%s", to_string( field.type ) );
+        else snprintf( buffer, size, "%s[%u]", to_string( field.type ), field.count );
+    }
+
+    void write_struct_dump( FILE* file, const struct_info_t& info, const uint8_t* data, const size_t size )
+    {
+        char type[ 32 ], value[ 128 ];
+        for ( const auto& field : info )
+        {
+            const auto offset = get_field_offset( info, field );
+            if ( offset + field.get_size() > size ) continue;
+
+            format_field_type( field, type, sizeof( type ) );
+            format_field_value( field, data + offset, value, sizeof( value ) );
+            fprintf( file, "0x%04X  %-36s %-9s %s\n", offset, field.name, type, value );
+        }
+    }
+}
@@ -0,0 +1,293 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace ts_extra_utilities::prism
+{
+    struct FieldType
+    {
+        enum Enum : uint8_t
+        {
+            U8,
+            BOOL,
+            U16,
+            U32,
+            I64,
+            FLOAT,
+            POINTER,
+            TOKEN,
+            ARRAY, // array_dyn_t header
+            STRING, // string_dyn_t header
+            COUNT
+        };
+    };
+
+    constexpr uint32_t get_field_type_size( const FieldType::Enum type )
+    {
+        switch ( type )
+        {
+            case FieldType::U8:
+            case FieldType::BOOL: return 1;
+            case FieldType::U16: return 2;
+            case FieldType::U32:
+            case FieldType::FLOAT: return 4;
+            case FieldType::I64:
+            case FieldType::POINTER:
+            case FieldType::TOKEN: return 8;
+            case FieldType::ARRAY: return 0x20;
+            case FieldType::STRING: return 0x18;
+            default: return 0;
+        }
+    }
+
+    const char* to_string( FieldType::Enum type );
+
+    /**
+     * \brief The named fields of the prism classes the inspector shows: field, type, how many of that type (float3_t is
+     * FLOAT 3) and the offset in the game build the headers were written against. Padding and the vtable are left out.
+     *
+     * The plugin build checks every entry against its class with offsetof and sizeof, so the lists can't drift from the
+     * headers. A derived class's list starts with its base's, see reflection.cpp.
+     */
+#define TS_PRISM_GAME_ACTOR_FIELDS( X ) \
+    X( game_physics_vehicle, POINTER, 1, 0x0018 ) \
+    X( visual_interior, POINTER, 1, 0x0020 ) \
+    X( game_actor_hud, POINTER, 1, 0x0028 ) \
+    X( history_stream_set, POINTER, 1, 0x0098 ) \
+    X( history_manager, POINTER, 1, 0x00B0 ) \
+    X( game_trailer_actor, POINTER, 1, 0x00B8 ) \
+    X( current_camera, U32, 1, 0x0118 ) \
+    X( engine_state, U32, 1, 0x0124 ) \
+    X( parking_brake, U8, 1, 0x0130 ) \
+    X( speed_limiter, FLOAT, 1, 0x0170 ) \
+    X( road_speed_limit, FLOAT, 1, 0x0174 ) \
+    X( light_state, U16, 1, 0x01AC ) \
+    X( additional_illumination, U16, 1, 0x01B0 ) \
+    X( wipers_intermittent_time, FLOAT, 1, 0x01C0 ) \
+    X( wipers_position, FLOAT, 1, 0x01C4 ) \
+    X( rpm, FLOAT, 1, 0x01C8 ) \
+    X( air_pressure, FLOAT, 1, 0x01CC ) \
+    X( brake_pressure, FLOAT, 1, 0x01D0 ) \
+    X( max_air_pressure, FLOAT, 1, 0x01D4 ) \
+    X( oil_temp, FLOAT, 1, 0x01E0 ) \
+    X( water_temp, FLOAT, 1, 0x01E8 ) \
+    X( battery_voltage, FLOAT, 1, 0x01F0 ) \
+    X( turbo_pressure, FLOAT, 1, 0x01FC ) \
+    X( light_switch, FLOAT, 1, 0x0210 ) \
+    X( light_switch_state, FLOAT, 1, 0x0214 ) \
+    X( high_beam_stick, FLOAT, 1, 0x0218 ) \
+    X( high_beam_state, FLOAT, 1, 0x021C ) \
+    X( light_horn_stick, FLOAT, 1, 0x0220 ) \
+    X( light_horn_state, FLOAT, 1, 0x0224 ) \
+    X( indicator_stick, FLOAT, 1, 0x0228 ) \
+    X( indicator_state, FLOAT, 1, 0x022C ) \
+    X( hazard_warning_btn, FLOAT, 1, 0x0230 ) \
+    X( hazard_warning_state, FLOAT, 1, 0x0234 ) \
+    X( beacon_switch, FLOAT, 1, 0x0238 ) \
+    X( beacon_state, FLOAT, 1, 0x023C ) \
+    X( handbrake_handle, FLOAT, 1, 0x0248 ) \
+    X( handbrake_state, FLOAT, 1, 0x024C ) \
+    X( engine_brake_stick, FLOAT, 1, 0x0260 ) \
+    X( engine_brake_state, FLOAT, 1, 0x0264 ) \
+    X( wipers_stick, FLOAT, 1, 0x027C ) \
+    X( wipers_state, FLOAT, 1, 0x0280 ) \
+    X( left_window_moving_direction, U8, 1, 0x0298 ) \
+    X( is_left_window_moving, U8, 1, 0x0299 ) \
+    X( left_window_state, FLOAT, 1, 0x029C ) \
+    X( left_window_btn, FLOAT, 1, 0x02A0 ) \
+    X( left_window_btn_state, FLOAT, 1, 0x02A4 ) \
+    X( N00002B28, FLOAT, 1, 0x02A8 ) \
+    X( right_window_moving_direction, U8, 1, 0x02B0 ) \
+    X( is_right_window_moving, U8, 1, 0x02B1 ) \
+    X( right_window_state, FLOAT, 1, 0x02B4 ) \
+    X( right_window_btn, FLOAT, 1, 0x02B8 ) \
+    X( right_window_btn_state, FLOAT, 1, 0x02BC ) \
+    X( sound_events, POINTER, 1, 0x0A18 ) \
+    X( driver_model, POINTER, 1, 0x0AA8 ) \
+    X( physics_gearbox_sequential, POINTER, 1, 0x0AC0 ) \
+    X( physics_gearbox_automatic, POINTER, 1, 0x0AC8 ) \
+    X( physics_gearbox_direct, POINTER, 1, 0x0AD0 ) \
+    X( accessory_head_lights_data, POINTER, 1, 0x0AE0 ) \
+    X( N00002CB4, TOKEN, 1, 0x0FB8 )
+
+#define TS_PRISM_VEHICLE_SHARED_FIELDS( X ) \
+    X( dynamic_physics_actor, POINTER, 1, 0x0030 ) \
+    X( game_physics_vehicle, POINTER, 1, 0x0068 ) \
+    X( physics_powertrain, POINTER, 1, 0x0100 ) \
+    X( model_objects, ARRAY, 1, 0x0108 ) \
+    X( vehicle, POINTER, 1, 0x0148 ) \
+    X( accessory_chassis_data, POINTER, 1, 0x0150 ) \
+    X( fake_shadow, POINTER, 1, 0x01A0 ) \
+    X( current_kdop_item, POINTER, 1, 0x01D0 ) \
+    X( speed, FLOAT, 1, 0x0218 ) \
+    X( wheel_offset, ARRAY, 1, 0x0220 ) \
+    X( wheel_location, ARRAY, 1, 0x0240 ) \
+    X( tire_shift, ARRAY, 1, 0x0260 ) \
+    X( tire_size_idk, ARRAY, 1, 0x0280 ) \
+    X( N00002B76, ARRAY, 1, 0x02A0 ) \
+    X( N00002B7A, ARRAY, 1, 0x02C0 ) \
+    X( N00002B7E, ARRAY, 1, 0x02E0 ) \
+    X( N000060E9, FLOAT, 1, 0x032C ) \
+    X( N00002B88, FLOAT, 1, 0x0330 ) \
+    X( hook_locator, FLOAT, 3, 0x0334 ) \
+    X( N0000520A, FLOAT, 1, 0x0340 ) \
+    X( N00006014, FLOAT, 1, 0x0344 ) \
+    X( N00002B8A, FLOAT, 1, 0x0348 ) \
+    X( precalculated_axle_weight, ARRAY, 1, 0x0360 ) \
+    X( N00002B98, POINTER, 1, 0x03A8 ) \
+    X( N00002B9C, POINTER, 1, 0x03C8 ) \
+    X( N00002BA5, POINTER, 1, 0x0410 ) \
+    X( N00006465, POINTER, 1, 0x0430 ) \
+    X( N00002BB0, ARRAY, 1, 0x0448 ) \
+    X( wheel_weight_idk, ARRAY, 1, 0x0468 ) \
+    X( N00002BB4, ARRAY, 1, 0x0488 ) \
+    X( N00002BB8, ARRAY, 1, 0x04A8 ) \
+    X( N00002BBE, ARRAY, 1, 0x04C8 ) \
+    X( steering, FLOAT, 1, 0x04E8 ) \
+    X( wheel_steering_stuff, POINTER, 1, 0x04F0 ) \
+    X( accessory_model_objects, ARRAY, 1, 0x0598 ) \
+    X( accessory_hookup_model_objects, ARRAY, 1, 0x05B8 ) \
+    X( wheels_20_steering, ARRAY, 1, 0x0C00 )
+
+#define TS_PRISM_CORE_VEHICLE_FIELDS( X ) \
+    X( accessories, ARRAY, 1, 0x0010 ) \
+    X( odometer, U32, 1, 0x0038 ) \
+    X( odometer_float_part, FLOAT, 1, 0x003C ) \
+    X( integrity_odometer, U32, 1, 0x0040 ) \
+    X( integrity_odometer_float_part, FLOAT, 1, 0x0044 ) \
+    X( trip_fuel_l, U32, 1, 0x0048 ) \
+    X( trip_fuel, FLOAT, 1, 0x004C ) \
+    X( trip_recuperation_kwh, U32, 1, 0x0050 ) \
+    X( trip_recuperation, FLOAT, 1, 0x0054 ) \
+    X( trip_distance_km, U32, 1, 0x0058 ) \
+    X( trip_distance, FLOAT, 1, 0x005C ) \
+    X( trip_time_min, U32, 1, 0x0060 ) \
+    X( trip_time, FLOAT, 1, 0x0064 ) \
+    X( license_plate, STRING, 1, 0x0068 ) \
+    X( chassis_wear, FLOAT, 1, 0x0080 ) \
+    X( chassis_wear_unfixable, FLOAT, 1, 0x0084 ) \
+    X( wheels_wear, ARRAY, 1, 0x0088 ) \
+    X( wheels_wear_unfixable, ARRAY, 1, 0x00A8 )
+
+#define TS_PRISM_TRAILER_FIELDS( X ) \
+    X( trailer_definition, POINTER, 1, 0x0158 ) \
+    X( oversize, BOOL, 1, 0x0160 ) \
+    X( cargo_mass, FLOAT, 1, 0x0164 ) \
+    X( cargo_damage, FLOAT, 1, 0x0168 ) \
+    X( virtual_rear_wheels_offset, FLOAT, 1, 0x016C ) \
+    X( slave_trailer, POINTER, 1, 0x0170 ) \
+    X( is_private, BOOL, 1, 0x0178 ) \
+    X( trailer_body_wear, FLOAT, 1, 0x017C ) \
+    X( trailer_body_wear_unfixable, FLOAT, 1, 0x0180 )
+
+#define TS_PRISM_ACCESSORY_DATA_FIELDS( X ) \
+    X( name, STRING, 1, 0x0010 ) \
+    X( icon, STRING, 1, 0x0028 ) \
+    X( info, ARRAY, 1, 0x0040 ) \
+    X( price, I64, 1, 0x0060 ) \
+    X( unlock, U32, 1, 0x0068 ) \
+    X( part_type, U32, 1, 0x006C ) \
+    X( suitable_for, ARRAY, 1, 0x0070 ) \
+    X( conflict_with, ARRAY, 1, 0x0090 ) \
+    X( defaults, ARRAY, 1, 0x00B0 ) \
+    X( overrides, ARRAY, 1, 0x00D0 ) \
+    X( require, ARRAY, 1, 0x00F0 ) \
+    X( sync_over_network, BOOL, 1, 0x0110 ) \
+    X( steam_inventory_id, U32, 1, 0x0114 )
+
+#define TS_PRISM_ACCESSORY_CHASSIS_DATA_FIELDS( X ) \
+    X( detail_model, STRING, 1, 0x0118 ) \
+    X( model, STRING, 1, 0x0130 ) \
+    X( axle_model, ARRAY, 1, 0x0148 ) \
+    X( axle_model_collision, ARRAY, 1, 0x0168 ) \
+    X( lods, ARRAY, 1, 0x0188 ) \
+    X( collision, STRING, 1, 0x01A8 ) \
+    X( trailer_brace_model, STRING, 1, 0x01C0 ) \
+    X( trailer_brace_anim, STRING, 1, 0x01D8 ) \
+    X( trailer_brace_up_sound, STRING, 1, 0x01F0 ) \
+    X( trailer_brace_down_sound, STRING, 1, 0x0208 ) \
+    X( variant, TOKEN, 1, 0x0220 ) \
+    X( variant_uk, TOKEN, 1, 0x0228 ) \
+    X( look, TOKEN, 1, 0x0230 ) \
+    X( shadow_texture, STRING, 1, 0x0238 ) \
+    X( shadow_intensity, FLOAT, 1, 0x0250 ) \
+    X( extended_shadow_texture, STRING, 1, 0x0258 ) \
+    X( extended_shadow_intensity, FLOAT, 1, 0x0270 ) \
+    X( extended_shadow_fadeout_start, FLOAT, 1, 0x0274 ) \
+    X( extended_shadow_fadeout_length, FLOAT, 1, 0x0278 ) \
+    X( extended_shadow_shared_model_variant, TOKEN, 1, 0x0280 ) \
+    X( axle_model_extended_shadow_texture, ARRAY, 1, 0x0288 ) \
+    X( ui_shadow, STRING, 1, 0x02A8 ) \
+    X( tank_size, FLOAT, 1, 0x02C0 ) \
+    X( adblue_tank_size, FLOAT, 1, 0x02C4 ) \
+    X( air_tank_pressure, FLOAT, 1, 0x02C8 ) \
+    X( nominal_voltage, FLOAT, 1, 0x02CC ) \
+    X( residual_travel, ARRAY, 1, 0x02D0 ) \
+    X( trailer_mass, FLOAT, 1, 0x02F0 ) \
+    X( powered_axle, ARRAY, 1, 0x02F8 ) \
+    X( kerb_weight, ARRAY, 1, 0x0318 ) \
+    X( liftable_axle, ARRAY, 1, 0x0338 ) \
+    X( steerable_axle, ARRAY, 1, 0x0358 ) \
+    X( steerable_lifted_axle, BOOL, 1, 0x0378 ) \
+    X( powered_trailer, BOOL, 1, 0x0379 ) \
+    X( weight_distribution, U32, 1, 0x0388 ) \
+    X( cog_cargo_mass_min, FLOAT, 1, 0x038C ) \
+    X( cog_cargo_mass_max, FLOAT, 1, 0x0390 ) \
+    X( cog_cargo_offset_min, FLOAT, 3, 0x0394 ) \
+    X( cog_cargo_offset_max, FLOAT, 3, 0x03A0 ) \
+    X( passenger_capacity, U32, 1, 0x03AC ) \
+    X( master_collision_angle, FLOAT, 1, 0x03B0 ) \
+    X( wheel_positions, ARRAY, 1, 0x03B8 ) \
+    X( wheel_types, ARRAY, 1, 0x03D8 ) \
+    X( N00001EC5, ARRAY, 1, 0x03F8 ) \
+    X( axle_model_sliding_limits, FLOAT, 2, 0x0440 ) \
+    X( hook_position, FLOAT, 3, 0x0448 ) \
+    X( sounds, ARRAY, 1, 0x0458 ) \
+    X( lamp_setup, STRING, 1, 0x0478 )
+
+    struct field_info_t
+    {
+        const char* name;
+        uint32_t offset;
+        FieldType::Enum type;
+        uint16_t count;
+
+        constexpr uint32_t get_size() const { return get_field_type_size( this->type ) * this->count; }
+    };
+
+    struct struct_info_t
+    {
+        const char* name; // "game_actor", the owner in the offset database
+        uint32_t size;
+        const field_info_t* fields; // by offset
+        size_t field_count;
+
+        const field_info_t* begin() const { return this->fields; }
+        const field_info_t* end() const { return this->fields + this->field_count; }
+    };
+
+    // game_actor, vehicle_shared, core_vehicle, trailer and accessory_chassis_data
+    extern const struct_info_t reflected_structs[];
+    extern const size_t reflected_struct_count;
+
+    // nullptr if it isn't reflected
+    const struct_info_t* find_struct_info( std::string_view name );
+    const field_info_t* find_field_info( const struct_info_t& info, std::string_view name );
+
+    // the offset database's offset for "struct.field" if it has one, the reflected offset otherwise
+    uint32_t get_field_offset( const struct_info_t& info, const field_info_t& field );
+
+    /**
+     * \brief Formats a field's value, pointers and array/string headers as addresses and sizes, tokens decoded
+     * \param data the field's bytes, field.get_size() of them
+     */
+    void format_field_value( const field_info_t& field, const uint8_t* data, char* buffer, size_t size );
+
+    // "float[3]"
+    void format_field_type( const field_info_t& field, char* buffer, size_t size );
+
+    // one line per field of an object copied into `data`, fields past `size` are left out
+    void write_struct_dump( FILE* file, const struct_info_t& info, const uint8_t* data, size_t size );
+}
@@ -1,5 +1,9 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 
 namespace ts_extra_utilities::prism
 {
@@ -10,74 +14,92 @@ namespace ts_extra_utilities::prism
         'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '_'
     };
 
-    struct ulldiv_t
-    {
-        unsigned long long int quot;
-        unsigned long long int rem;
+    // 38^12 still fits into 64 bits, longer names can't be tokens
+    constexpr uint32_t max_token_length = 12;
 
-        ulldiv_t() : quot( 0ull ), rem( 0ull )
+    namespace detail
+    {
+        constexpr std::array< uint8_t, 256 > make_letter_ids()
         {
+            std::array< uint8_t, 256 > ids{};
+            for ( int i = 1; i < i_num_letters; ++i )
+            {
+                const auto letter = static_cast< uint8_t >( psz_letters[ i ] );
+                ids[ letter ] = static_cast< uint8_t >( i );
+                if ( letter >= 'a' && letter <= 'z' ) ids[ letter - 'a' + 'A' ] = static_cast< uint8_t >( i );
+            }
+            return ids;
         }
-    };
-
-    inline ulldiv_t div( unsigned long long int num, unsigned long long int divider )
-    {
-        ulldiv_t result;
-        result.rem = num % divider;
-        result.quot = num / divider;
-        return result;
     }
 
+    // letter id of every char, upper case the same as lower case, 0 for anything that isn't a token letter
+    inline constexpr std::array< uint8_t, 256 > letter_ids = detail::make_letter_ids();
 
     class token_t
     {
     public:
         uint64_t m_token;
 
-        explicit token_t( const uint64_t token ) : m_token( token )
+        explicit constexpr token_t( const uint64_t token ) : m_token( token )
         {
         }
 
-        [[nodiscard]] std::string to_string() const
+        /**
+         * \brief Writes the name into `buffer`, not zero terminated
+         * \param buffer at least max_token_length chars
+         * \return length of the name
+         */
+        constexpr uint32_t decode( char* buffer ) const
         {
-            uint64_t token_copy = m_token;
-            std::string dest;
-
-            ulldiv_t result;
-            int i = 0;
-            for ( ; token_copy != 0; ++i )
+            uint32_t length = 0;
+            for ( auto token = this->m_token; token != 0 && length < max_token_length; token /= 38 )
             {
-                result = div( token_copy, 38ull );
-                token_copy = result.quot;
-                dest.push_back( psz_letters[ result.rem ] );
+                buffer[ length++ ] = psz_letters[ token % 38 ];
             }
-            dest.push_back( '\0' );
-            return dest;
+            return length;
+        }
+
+        [[nodiscard]] std::string to_string() const
+        {
+            char buffer[ max_token_length ];
+            return std::string( buffer, this->decode( buffer ) );
         }
+
+        constexpr bool operator==( const token_t& other ) const { return this->m_token == other.m_token; }
+        constexpr bool operator!=( const token_t& other ) const { return this->m_token != other.m_token; }
     };
 
-    inline int get_id_char( const char letter )
+    constexpr int get_id_char( const char letter )
     {
-        for ( int i = 0; i < i_num_letters; ++i )
-            if ( letter == psz_letters[ i ] )
-                return i;
-        return 0;
+        return letter_ids[ static_cast< uint8_t >( letter ) ];
     }
 
-    inline unsigned long long int powull( const unsigned long long int base, const long num )
+    // the first letter is the lowest digit, so walking the name backwards is one multiply-add per letter
+    constexpr token_t encode_token( const std::string_view name )
     {
-        unsigned long long int result = 1;
-        for ( long i = 0; num > i; ++i )
-            result = result * base;
-        return result;
+        uint64_t token = 0;
+        for ( auto i = name.size() < max_token_length ? name.size() : max_token_length; i > 0; --i )
+        {
+            token = token * 38 + letter_ids[ static_cast< uint8_t >( name[ i - 1 ] ) ];
+        }
+        return token_t( token );
     }
 
     inline token_t string_to_token( const char* str )
     {
-        token_t result( 0 );
-        const unsigned len = strlen( str );
-        for ( unsigned i = 0; i < len; i++ )
-            result.m_token += powull( 38, i ) * static_cast< unsigned long long >( get_id_char( tolower( str[ i ] ) ) );
-        return result;
+        return encode_token( std::string_view( str, strlen( str ) ) );
     }
+
+    namespace literals
+    {
+        // "trailer_def"_tok is a compile time constant
+        constexpr token_t operator""_tok( const char* name, const size_t length )
+        {
+            return encode_token( std::string_view( name, length ) );
+        }
+    }
+
+    static_assert(encode_token( "a" ).m_token == 11);
+    static_assert(encode_token( "ab" ).m_token == 11 + 12 * 38);
+    static_assert(encode_token( "Trailer_Def" ) == encode_token( "trailer_def" ));
 }
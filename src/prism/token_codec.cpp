@@ -0,0 +1,94 @@
+#include "token_codec.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace ts_extra_utilities::prism
+{
+    namespace
+    {
+        constexpr uint32_t LETTER_PAIRS = 38 * 38;
+        constexpr uint64_t HALF_TOKEN = 38ull * 38 * 38 * 38 * 38 * 38; // 6 letters, < 2^32
+
+        // two letters per entry, the lower digit first like in the name
+        constexpr std::array< std::array< char, 2 >, LETTER_PAIRS > make_letter_pairs()
+        {
+            std::array< std::array< char, 2 >, LETTER_PAIRS > pairs{};
+            for ( uint32_t i = 0; i < LETTER_PAIRS; ++i )
+            {
+                pairs[ i ][ 0 ] = psz_letters[ i % 38 ];
+                pairs[ i ][ 1 ] = psz_letters[ i / 38 ];
+            }
+            return pairs;
+        }
+
+        constexpr auto letter_pairs = make_letter_pairs();
+
+        // a name is longer than i letters if its token is at least 38^i
+        constexpr std::array< uint64_t, max_token_length > make_letter_powers()
+        {
+            std::array< uint64_t, max_token_length > powers{};
+            uint64_t power = 1;
+            for ( auto& p : powers )
+            {
+                p = power;
+                power *= 38;
+            }
+            return powers;
+        }
+
+        constexpr auto letter_powers = make_letter_powers();
+
+        void write_pair( char* out, const uint32_t pair ) { std::memcpy( out, letter_pairs[ pair ].data(), 2 ); }
+    }
+
+    uint32_t decode_token( const token_t token, char* buffer )
+    {
+        const auto name = token.m_token % ( HALF_TOKEN * HALF_TOKEN );
+        const auto low = static_cast< uint32_t >( name % HALF_TOKEN );
+        const auto high = static_cast< uint32_t >( name / HALF_TOKEN );
+
+        // always all 12 letters, the length is the number of digits, no branch depends on the name
+        write_pair( buffer, low % LETTER_PAIRS );
+        write_pair( buffer + 2, low / LETTER_PAIRS % LETTER_PAIRS );
+        write_pair( buffer + 4, low / ( LETTER_PAIRS * LETTER_PAIRS ) );
+        write_pair( buffer + 6, high % LETTER_PAIRS );
+        write_pair( buffer + 8, high / LETTER_PAIRS % LETTER_PAIRS );
+        write_pair( buffer + 10, high / ( LETTER_PAIRS * LETTER_PAIRS ) );
+
+        uint32_t length = 0;
+        for ( const auto power : letter_powers ) length += name >= power;
+        return length;
+    }
+
+    size_t decode_tokens( const token_t* tokens, const size_t count, char* arena, token_name_t* names )
+    {
+        size_t offset = 0;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const auto length = decode_token( tokens[ i ], arena + offset );
+            arena[ offset + length ] = '\0';
+            if ( names != nullptr ) names[ i ] = { static_cast< uint32_t >( offset ), length };
+            offset += length + 1;
+        }
+        return offset;
+    }
+
+    void encode_tokens( const std::string_view* names, const size_t count, token_t* tokens )
+    {
+        for ( size_t i = 0; i < count; ++i ) tokens[ i ] = encode_token( names[ i ] );
+    }
+
+    size_t encode_token_arena( const char* arena, const size_t size, token_t* tokens, const size_t capacity )
+    {
+        size_t count = 0;
+        for ( size_t offset = 0; offset < size && count < capacity; )
+        {
+            const auto* end = static_cast< const char* >( std::memchr( arena + offset, '\0', size - offset ) );
+            const auto length = end != nullptr ? static_cast< size_t >( end - ( arena + offset ) ) : size - offset;
+            tokens[ count++ ] = encode_token( std::string_view( arena + offset, length ) );
+            offset += length + 1;
+        }
+        return count;
+    }
+}
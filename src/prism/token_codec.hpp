@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "token.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    // a decoded name inside the arena passed to decode_tokens
+    struct token_name_t
+    {
+        uint32_t offset;
+        uint32_t length; // without the terminating zero
+    };
+
+    // arena size that always fits `count` decoded names with their terminators
+    constexpr size_t decoded_arena_size( const size_t count ) { return count * ( max_token_length + 1 ); }
+
+    /**
+     * \brief Decodes one token, same result as token_t::decode
+     * \param buffer at least max_token_length chars, all of them are written, the name isn't zero terminated
+     * \return length of the name
+     */
+    uint32_t decode_token( token_t token, char* buffer );
+
+    /**
+     * \brief Decodes `count` tokens into `arena`, every name zero terminated and right behind the previous one
+     *
+     * Tokens are split into two 6 letter halves that fit 32 bits, each half is then written two letters per step
+     * from a 38 * 38 entry table, so the divisions are all by constants and become multiplications. All 12 letters
+     * are written and the length comes from comparisons, nothing branches on the name, the next name overwrites the
+     * unused letters. Nothing is allocated. Values past 38^12 aren't tokens, their lowest 12 letters are written.
+     * \param arena at least decoded_arena_size( count ) chars
+     * \param names optional, where each name ended up
+     * \return chars written including the terminators
+     */
+    size_t decode_tokens( const token_t* tokens, size_t count, char* arena, token_name_t* names = nullptr );
+
+    // encodes `count` names, like encode_token for each
+    void encode_tokens( const std::string_view* names, size_t count, token_t* tokens );
+
+    /**
+     * \brief Encodes the zero terminated names packed in `arena`, e.g. what decode_tokens wrote
+     * \return tokens written, at most `capacity`
+     */
+    size_t encode_token_arena( const char* arena, size_t size, token_t* tokens, size_t capacity );
+}
@@ -0,0 +1,209 @@
+#include "token_dictionary.hpp"
+
+#include <algorithm>
+
+#include "token_codec.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    namespace
+    {
+        constexpr uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+        // splitmix64 finalizer, tokens of similar names differ in few bits
+        uint64_t mix( uint64_t value )
+        {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ull;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebull;
+            return value ^ value >> 31;
+        }
+
+        size_t static_slot( const uint64_t token, const uint32_t displacement, const size_t mask )
+        {
+            return mix( token + 0x9e3779b97f4a7c15ull * ( displacement + 1ull ) ) & mask;
+        }
+
+        size_t round_up_pow2( const size_t value )
+        {
+            size_t result = 1;
+            while ( result < value ) result <<= 1;
+            return result;
+        }
+    }
+
+    CTokenDictionary::CTokenDictionary( const std::string_view* names, const size_t count )
+    {
+        std::vector< uint64_t > tokens;
+        tokens.reserve( count );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const auto token = encode_token( names[ i ] ).m_token;
+            if ( token != 0 ) tokens.push_back( token );
+        }
+        std::sort( tokens.begin(), tokens.end() );
+        tokens.erase( std::unique( tokens.begin(), tokens.end() ), tokens.end() );
+
+        this->dynamic_slots_.resize( 64, { 0, nullptr } );
+        if ( tokens.empty() ) return;
+
+        // ~80% load and about 4 tokens per bucket keeps the displacement search short
+        const auto slot_count = round_up_pow2( tokens.size() + tokens.size() / 4 );
+        const auto mask = slot_count - 1;
+        const auto bucket_count = std::max< size_t >( 1, tokens.size() / 4 );
+        this->static_slots_.resize( slot_count, { 0, nullptr } );
+        this->displacements_.resize( bucket_count, 0 );
+
+        std::vector< std::vector< uint64_t > > buckets( bucket_count );
+        for ( const auto token : tokens ) buckets[ mix( token ) % bucket_count ].push_back( token );
+
+        std::vector< uint32_t > order( bucket_count );
+        for ( uint32_t i = 0; i < bucket_count; ++i ) order[ i ] = i;
+        std::stable_sort( order.begin(), order.end(), [ &buckets ]( const uint32_t a, const uint32_t b ) { return buckets[ a ].size() > buckets[ b ].size(); } );
+
+        std::vector< size_t > slots;
+        for ( const auto bucket : order )
+        {
+            const auto& bucket_tokens = buckets[ bucket ];
+            if ( bucket_tokens.empty() ) break;
+
+            bool placed = false;
+            for ( uint32_t displacement = 0; displacement < MAX_DISPLACEMENT && !placed; ++displacement )
+            {
+                slots.clear();
+                placed = true;
+                for ( const auto token : bucket_tokens )
+                {
+                    const auto slot = static_slot( token, displacement, mask );
+                    if ( this->static_slots_[ slot ].token != 0 || std::find( slots.begin(), slots.end(), slot ) != slots.end() )
+                    {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back( slot );
+                }
+                if ( !placed ) continue;
+
+                this->displacements_[ bucket ] = displacement;
+                for ( size_t i = 0; i < bucket_tokens.size(); ++i )
+                {
+                    this->static_slots_[ slots[ i ] ] = { bucket_tokens[ i ], this->store( token_t( bucket_tokens[ i ] ) ) };
+                }
+            }
+
+            // practically never, the bucket still works through the dynamic table
+            if ( !placed )
+            {
+                this->displacements_[ bucket ] = MAX_DISPLACEMENT;
+                for ( const auto token : bucket_tokens ) this->insert_dynamic( { token, this->store( token_t( token ) ) } );
+            }
+        }
+    }
+
+    CTokenDictionary::~CTokenDictionary()
+    {
+        for ( auto* block : this->blocks_ ) delete[] block;
+    }
+
+    const CTokenDictionary::entry_t* CTokenDictionary::find_entry( const uint64_t token ) const
+    {
+        if ( !this->static_slots_.empty() )
+        {
+            const auto displacement = this->displacements_[ mix( token ) % this->displacements_.size() ];
+            if ( displacement != MAX_DISPLACEMENT )
+            {
+                const auto& entry = this->static_slots_[ static_slot( token, displacement, this->static_slots_.size() - 1 ) ];
+                if ( entry.token == token ) return &entry;
+            }
+        }
+
+        const auto mask = this->dynamic_slots_.size() - 1;
+        for ( auto slot = mix( token ) & mask;; slot = ( slot + 1 ) & mask )
+        {
+            const auto& entry = this->dynamic_slots_[ slot ];
+            if ( entry.token == token ) return &entry;
+            if ( entry.token == 0 ) return nullptr;
+        }
+    }
+
+    const char* CTokenDictionary::store( const token_t token )
+    {
+        // decode_token writes all 12 letters
+        if ( this->block_used_ + max_token_length + 1 > BLOCK_SIZE )
+        {
+            this->blocks_.push_back( new char[ BLOCK_SIZE ] );
+            this->block_used_ = 0;
+        }
+
+        auto* name = this->blocks_.back() + this->block_used_;
+        const auto length = decode_token( token, name );
+        name[ length ] = '\0';
+        this->block_used_ += length + 1;
+        return name;
+    }
+
+    void CTokenDictionary::insert_dynamic( const entry_t& entry )
+    {
+        if ( ( this->dynamic_count_ + 1 ) * 2 > this->dynamic_slots_.size() )
+        {
+            std::vector< entry_t > slots( this->dynamic_slots_.size() * 2, { 0, nullptr } );
+            std::swap( slots, this->dynamic_slots_ );
+            this->dynamic_count_ = 0;
+            for ( const auto& old : slots )
+            {
+                if ( old.token != 0 ) this->insert_dynamic( old );
+            }
+        }
+
+        const auto mask = this->dynamic_slots_.size() - 1;
+        auto slot = mix( entry.token ) & mask;
+        while ( this->dynamic_slots_[ slot ].token != 0 ) slot = ( slot + 1 ) & mask;
+        this->dynamic_slots_[ slot ] = entry;
+        ++this->dynamic_count_;
+    }
+
+    const char* CTokenDictionary::get_name( const token_t token )
+    {
+        if ( token.m_token == 0 ) return "";
+        if ( const auto* entry = this->find_entry( token.m_token ) ) return entry->name;
+
+        const entry_t entry = { token.m_token, this->store( token ) };
+        this->insert_dynamic( entry );
+        return entry.name;
+    }
+
+    const char* CTokenDictionary::find_name( const token_t token ) const
+    {
+        if ( token.m_token == 0 ) return "";
+        const auto* entry = this->find_entry( token.m_token );
+        return entry != nullptr ? entry->name : nullptr;
+    }
+
+    bool CTokenDictionary::find_token( const std::string_view name, token_t& token ) const
+    {
+        if ( name.empty() || name.size() > max_token_length ) return false;
+
+        // encoding folds case, cuts at max_token_length and maps unknown characters to 0, only the stored name tells
+        // whether it's exactly this one
+        const auto encoded = encode_token( name );
+        const auto* stored = this->find_name( encoded );
+        if ( stored == nullptr || name != stored ) return false;
+        token = encoded;
+        return true;
+    }
+
+    token_t CTokenDictionary::intern( const std::string_view name )
+    {
+        const auto token = encode_token( name );
+        this->get_name( token );
+        return token;
+    }
+
+    size_t CTokenDictionary::size() const
+    {
+        size_t count = this->dynamic_count_;
+        for ( const auto& entry : this->static_slots_ ) count += entry.token != 0;
+        return count;
+    }
+}
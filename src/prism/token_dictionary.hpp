@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "token.hpp"
+
+namespace ts_extra_utilities::prism
+{
+    /**
+     * \brief Interns decoded token names so game data can be printed and compared by token without allocating.
+     *
+     * The names given to the constructor go into a perfect hash: the tokens are split into buckets by one hash, the
+     * buckets are placed largest first, each with the first displacement that moves all of its tokens into free slots.
+     * A lookup is then two hashes and one compare. Tokens that show up later, read from game data, are decoded once
+     * and go into an open-addressed table with linear probing that doubles at half load.
+     *
+     * Names live in fixed blocks and never move, the pointers handed out stay valid as long as the dictionary. Not
+     * thread safe, meant for the UI thread.
+     */
+    class CTokenDictionary
+    {
+    private:
+        struct entry_t
+        {
+            uint64_t token; // 0 = empty slot, the empty name is never stored
+            const char* name;
+        };
+
+        static constexpr size_t BLOCK_SIZE = 4096;
+
+        // perfect hash over the constructor's names
+        std::vector< entry_t > static_slots_; // power of two
+        std::vector< uint32_t > displacements_; // per bucket
+
+        // everything interned later
+        std::vector< entry_t > dynamic_slots_; // power of two
+        size_t dynamic_count_ = 0;
+
+        std::vector< char* > blocks_;
+        size_t block_used_ = BLOCK_SIZE;
+
+        const entry_t* find_entry( uint64_t token ) const;
+        const char* store( token_t token );
+        void insert_dynamic( const entry_t& entry );
+
+    public:
+        explicit CTokenDictionary( const std::string_view* names = nullptr, size_t count = 0 );
+        ~CTokenDictionary();
+
+        CTokenDictionary( const CTokenDictionary& ) = delete;
+        CTokenDictionary& operator=( const CTokenDictionary& ) = delete;
+
+        /**
+         * \brief Name of `token`, decoded and interned the first time it is seen
+         * \return zero terminated, "" for the empty token, never nullptr
+         */
+        const char* get_name( token_t token );
+
+        // nullptr if the token was never interned
+        const char* find_name( token_t token ) const;
+
+        // the token of an interned name, false for names that were never interned, as stored, so "Trailer_Def" isn't found
+        bool find_token( std::string_view name, token_t& token ) const;
+
+        // interns `name` as its token decodes, so "Trailer_Def" is stored as "trailer_def"
+        token_t intern( std::string_view name );
+
+        size_t size() const;
+    };
+}
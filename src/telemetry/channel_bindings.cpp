@@ -0,0 +1,90 @@
+#include "channel_bindings.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    CChannelBindings::CChannelBindings( const scs_telemetry_init_params_v101_t* init_params ) : init_params_( init_params )
+    {
+    }
+
+    CChannelBindings::binding_t* CChannelBindings::allocate( const char* name, const uint32_t index, const scs_value_type_t type )
+    {
+        if ( name == nullptr || std::strlen( name ) >= MAX_NAME_LENGTH ) return nullptr;
+
+        // the binding address is the SDK context, so slots never move, unbound ones are reused instead
+        binding_t* binding = nullptr;
+        if ( this->binding_count_ < this->slot_count_ )
+        {
+            for ( uint32_t i = 0; i < this->slot_count_ && binding == nullptr; ++i )
+            {
+                if ( this->bindings_[ i ].type == SCS_VALUE_TYPE_INVALID ) binding = &this->bindings_[ i ];
+            }
+        }
+        if ( binding == nullptr )
+        {
+            if ( this->slot_count_ >= MAX_BINDINGS ) return nullptr;
+            binding = &this->bindings_[ this->slot_count_ ];
+        }
+
+        *binding = {};
+        std::memcpy( binding->name, name, std::strlen( name ) + 1 );
+        binding->index = index;
+        binding->type = type;
+        return binding;
+    }
+
+    scs_result_t CChannelBindings::register_binding( binding_t* binding, const scs_telemetry_channel_callback_t callback, const scs_u32_t flags )
+    {
+        if ( this->init_params_ == nullptr || this->init_params_->register_for_channel == nullptr )
+        {
+            return SCS_RESULT_generic_error;
+        }
+
+        const auto result = this->init_params_->register_for_channel( binding->name, binding->index, binding->type, flags, callback, binding );
+        if ( result != SCS_RESULT_ok )
+        {
+            // only a successful registration takes the slot, failed ones leave it free
+            binding->type = SCS_VALUE_TYPE_INVALID;
+            return result;
+        }
+
+        if ( binding == &this->bindings_[ this->slot_count_ ] ) ++this->slot_count_;
+        ++this->binding_count_;
+        return result;
+    }
+
+    uint32_t CChannelBindings::unbind_array( const char* name, const uint32_t first )
+    {
+        uint32_t unbound = 0;
+        for ( uint32_t i = 0; i < this->slot_count_; ++i )
+        {
+            auto& binding = this->bindings_[ i ];
+            if ( binding.type == SCS_VALUE_TYPE_INVALID || binding.index == SCS_U32_NIL || binding.index < first ) continue;
+            if ( std::strcmp( binding.name, name ) != 0 ) continue;
+
+            if ( this->init_params_ != nullptr && this->init_params_->unregister_from_channel != nullptr )
+            {
+                this->init_params_->unregister_from_channel( binding.name, binding.index, binding.type );
+            }
+
+            binding = {};
+            --this->binding_count_;
+            ++unbound;
+        }
+        return unbound;
+    }
+
+    void CChannelBindings::unbind_all()
+    {
+        if ( this->init_params_ != nullptr && this->init_params_->unregister_from_channel != nullptr )
+        {
+            for ( uint32_t i = 0; i < this->slot_count_; ++i )
+            {
+                const auto& binding = this->bindings_[ i ];
+                if ( binding.type == SCS_VALUE_TYPE_INVALID ) continue;
+                this->init_params_->unregister_from_channel( binding.name, binding.index, binding.type );
+            }
+        }
+        this->slot_count_ = 0;
+        this->binding_count_ = 0;
+    }
+}
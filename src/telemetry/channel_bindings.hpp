@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "scssdk_telemetry.h"
+
+namespace ts_extra_utilities::telemetry
+{
+    /**
+     * \brief Maps a C++ storage type to the SDK value type and how to read it out of a scs_value_t
+     */
+    template < typename T >
+    struct scs_value_traits;
+
+#define TS_SCS_VALUE_TRAITS( cpp_type, sdk_type, member )                                                  \
+    template <>                                                                                            \
+    struct scs_value_traits< cpp_type >                                                                    \
+    {                                                                                                      \
+        static constexpr scs_value_type_t type = sdk_type;                                                 \
+        static cpp_type read( const scs_value_t& value ) { return static_cast< cpp_type >( value.member ); } \
+    };
+
+    TS_SCS_VALUE_TRAITS( int32_t, SCS_VALUE_TYPE_s32, value_s32.value )
+    TS_SCS_VALUE_TRAITS( uint32_t, SCS_VALUE_TYPE_u32, value_u32.value )
+    TS_SCS_VALUE_TRAITS( uint64_t, SCS_VALUE_TYPE_u64, value_u64.value )
+    TS_SCS_VALUE_TRAITS( int64_t, SCS_VALUE_TYPE_s64, value_s64.value )
+    TS_SCS_VALUE_TRAITS( float, SCS_VALUE_TYPE_float, value_float.value )
+    TS_SCS_VALUE_TRAITS( double, SCS_VALUE_TYPE_double, value_double.value )
+    TS_SCS_VALUE_TRAITS( scs_value_fvector_t, SCS_VALUE_TYPE_fvector, value_fvector )
+    TS_SCS_VALUE_TRAITS( scs_value_dvector_t, SCS_VALUE_TYPE_dvector, value_dvector )
+    TS_SCS_VALUE_TRAITS( scs_value_euler_t, SCS_VALUE_TYPE_euler, value_euler )
+    TS_SCS_VALUE_TRAITS( scs_value_fplacement_t, SCS_VALUE_TYPE_fplacement, value_fplacement )
+    TS_SCS_VALUE_TRAITS( scs_value_dplacement_t, SCS_VALUE_TYPE_dplacement, value_dplacement )
+
+#undef TS_SCS_VALUE_TRAITS
+
+    template <>
+    struct scs_value_traits< bool >
+    {
+        static constexpr scs_value_type_t type = SCS_VALUE_TYPE_bool;
+        static bool read( const scs_value_t& value ) { return value.value_bool.value != 0; }
+    };
+
+    /**
+     * \brief Cache line aligned block for channel values written by the SDK thread, keeps unrelated hot values off each other's lines
+     */
+    template < typename T, uint32_t N >
+    struct alignas( 64 ) channel_storage_t
+    {
+        T values[ N ] = {};
+
+        T& operator[]( const uint32_t index ) { return values[ index ]; }
+        const T& operator[]( const uint32_t index ) const { return values[ index ]; }
+    };
+
+    /**
+     * \brief Registers channel callbacks with a pre-computed context per (channel, index).
+     *
+     * The SDK calls a per-type trampoline with the binding as context, which writes the value straight into the
+     * bound storage, so nothing in the callback path looks at the channel name. Names are only formatted once at
+     * bind time. An optional change callback fires when the stored value actually changes, which is where
+     * aggregates (connected trailer count, ...) are kept up to date incrementally.
+     */
+    class CChannelBindings
+    {
+    public:
+        static constexpr uint32_t MAX_BINDINGS = 1536;
+        static constexpr uint32_t MAX_NAME_LENGTH = 64;
+
+        template < typename T >
+        using change_callback_t = void( * )( uint32_t tag, const T& old_value, const T& new_value, void* user_data );
+
+    private:
+        struct binding_t
+        {
+            void* target = nullptr;
+            void ( *on_change )() = nullptr; // change_callback_t< T >, erased
+            void* user_data = nullptr;
+            uint32_t tag = 0;
+            uint32_t index = SCS_U32_NIL;
+            scs_value_type_t type = SCS_VALUE_TYPE_INVALID;
+            char name[ MAX_NAME_LENGTH ] = {};
+        };
+
+        const scs_telemetry_init_params_v101_t* init_params_ = nullptr;
+        binding_t bindings_[ MAX_BINDINGS ] = {};
+        uint32_t slot_count_ = 0; // slots ever used, unbound ones (type INVALID) below this are reused
+        uint32_t binding_count_ = 0;
+
+        template < typename T >
+        static SCSAPI_VOID channel_callback( const scs_string_t, const scs_u32_t, const scs_value_t* const value, const scs_context_t context )
+        {
+            auto* binding = static_cast< binding_t* >( context );
+            auto* target = static_cast< T* >( binding->target );
+
+            // a null value means the channel has no value right now (e.g. trailer.N.* while trailer N doesn't exist)
+            const T new_value = value != nullptr ? scs_value_traits< T >::read( *value ) : T{};
+
+            if ( binding->on_change != nullptr && std::memcmp( target, &new_value, sizeof( T ) ) != 0 )
+            {
+                const T old_value = *target;
+                *target = new_value;
+                reinterpret_cast< change_callback_t< T > >( binding->on_change )( binding->tag, old_value, new_value, binding->user_data );
+                return;
+            }
+
+            *target = new_value;
+        }
+
+        binding_t* allocate( const char* name, uint32_t index, scs_value_type_t type );
+        scs_result_t register_binding( binding_t* binding, scs_telemetry_channel_callback_t callback, scs_u32_t flags );
+
+    public:
+        explicit CChannelBindings( const scs_telemetry_init_params_v101_t* init_params );
+
+        /**
+         * \brief Binds a single channel (or one index of an array channel) to `target`
+         * \param tag passed back to on_change, usually the trailer/wheel index
+         */
+        template < typename T >
+        scs_result_t bind( const char* name, const uint32_t index, T* target, const scs_u32_t flags = SCS_TELEMETRY_CHANNEL_FLAG_none,
+                           const change_callback_t< T > on_change = nullptr, void* user_data = nullptr, const uint32_t tag = 0 )
+        {
+            static_assert(std::is_trivially_copyable_v< T >);
+
+            auto* binding = this->allocate( name, index, scs_value_traits< T >::type );
+            if ( binding == nullptr ) return SCS_RESULT_generic_error;
+
+            binding->target = target;
+            binding->on_change = reinterpret_cast< void( * )() >( on_change );
+            binding->user_data = user_data;
+            binding->tag = tag;
+            return this->register_binding( binding, &channel_callback< T >, flags );
+        }
+
+        /**
+         * \brief Binds `count` indices of an array channel ("truck.wheel.steering"[0..count)) to targets[0..count)
+         * \return number of indices that were bound
+         */
+        template < typename T >
+        uint32_t bind_array( const char* name, const uint32_t count, T* targets, const scs_u32_t flags = SCS_TELEMETRY_CHANNEL_FLAG_none,
+                             const change_callback_t< T > on_change = nullptr, void* user_data = nullptr )
+        {
+            return this->bind_array_range( name, 0, count, targets, flags, on_change, user_data );
+        }
+
+        /**
+         * \brief Binds indices [first, end) of an array channel to targets[first..end), used to grow an array after a configuration change
+         * \return number of indices that were bound
+         */
+        template < typename T >
+        uint32_t bind_array_range( const char* name, const uint32_t first, const uint32_t end, T* targets, const scs_u32_t flags = SCS_TELEMETRY_CHANNEL_FLAG_none,
+                                   const change_callback_t< T > on_change = nullptr, void* user_data = nullptr )
+        {
+            uint32_t bound = 0;
+            for ( uint32_t i = first; i < end; ++i )
+            {
+                if ( this->bind( name, i, &targets[ i ], flags, on_change, user_data, i ) == SCS_RESULT_ok ) ++bound;
+            }
+            return bound;
+        }
+
+        /**
+         * \brief Binds one channel per instance where the instance is part of the name, e.g. "trailer.%u.connected"
+         * \return number of instances that were bound
+         */
+        template < typename T >
+        uint32_t bind_indexed( const char* name_format, const uint32_t count, T* targets, const scs_u32_t flags = SCS_TELEMETRY_CHANNEL_FLAG_none,
+                               const change_callback_t< T > on_change = nullptr, void* user_data = nullptr )
+        {
+            uint32_t bound = 0;
+            char name[ MAX_NAME_LENGTH ];
+            for ( uint32_t i = 0; i < count; ++i )
+            {
+                snprintf( name, sizeof( name ), name_format, i );
+                if ( this->bind( name, SCS_U32_NIL, &targets[ i ], flags, on_change, user_data, i ) == SCS_RESULT_ok ) ++bound;
+            }
+            return bound;
+        }
+
+        /**
+         * \brief Unregisters the indices >= first of an array channel, used to shrink an array after a configuration change
+         * \return number of indices that were unbound
+         *
+         * Only valid where the SDK allows unregistering, i.e. in init or an event callback, never in a channel callback.
+         */
+        uint32_t unbind_array( const char* name, uint32_t first );
+
+        // Removes every registration made through this object, the SDK does this by itself on shutdown.
+        void unbind_all();
+
+        uint32_t get_binding_count() const { return this->binding_count_; }
+    };
+}
@@ -0,0 +1,207 @@
+#include "channel_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        bool is_scalar( const scs_value_type_t type )
+        {
+            return type == SCS_VALUE_TYPE_bool || type == SCS_VALUE_TYPE_s32 || type == SCS_VALUE_TYPE_u32 || type == SCS_VALUE_TYPE_float;
+        }
+
+        double read_value( const uint8_t* frame, const uint32_t offset, const scs_value_type_t type )
+        {
+            switch ( type )
+            {
+                case SCS_VALUE_TYPE_bool: return *reinterpret_cast< const bool* >( frame + offset ) ? 1.0 : 0.0;
+                case SCS_VALUE_TYPE_s32: return *reinterpret_cast< const int32_t* >( frame + offset );
+                case SCS_VALUE_TYPE_u32: return *reinterpret_cast< const uint32_t* >( frame + offset );
+                case SCS_VALUE_TYPE_float: return *reinterpret_cast< const float* >( frame + offset );
+                default: return 0.0;
+            }
+        }
+
+        // means of integer and bool channels are rounded back
+        void write_value( uint8_t* frame, const uint32_t offset, const scs_value_type_t type, const double value )
+        {
+            switch ( type )
+            {
+                case SCS_VALUE_TYPE_bool: *reinterpret_cast< bool* >( frame + offset ) = value >= 0.5; break;
+                case SCS_VALUE_TYPE_s32: *reinterpret_cast< int32_t* >( frame + offset ) = static_cast< int32_t >( std::lround( value ) ); break;
+                case SCS_VALUE_TYPE_u32: *reinterpret_cast< uint32_t* >( frame + offset ) = static_cast< uint32_t >( std::lround( value ) ); break;
+                case SCS_VALUE_TYPE_float: *reinterpret_cast< float* >( frame + offset ) = static_cast< float >( value ); break;
+                default: break;
+            }
+        }
+    }
+
+    CChannelFilter::CChannelFilter()
+    {
+        this->output_ = new telemetry_frame_t();
+    }
+
+    CChannelFilter::~CChannelFilter()
+    {
+        delete this->output_;
+    }
+
+    void CChannelFilter::add_value( const size_t offset, const scs_value_type_t type, const uint32_t rule )
+    {
+        // a second rule for the same channel replaces the first one
+        for ( auto& value : this->values_ )
+        {
+            if ( value.offset != offset ) continue;
+            value.rule = rule;
+            return;
+        }
+
+        filtered_value_t value{};
+        value.offset = static_cast< uint32_t >( offset );
+        value.type = type;
+        value.rule = rule;
+        this->values_.push_back( value );
+    }
+
+    bool CChannelFilter::set_rule( const char* channel, const channel_filter_rule_t& rule )
+    {
+        if ( channel == nullptr ) return false;
+
+        auto sanitized = rule;
+        sanitized.decimation = std::max( sanitized.decimation, 1u );
+        sanitized.deadband = std::fabs( sanitized.deadband );
+
+        const auto index = static_cast< uint32_t >( this->rules_.size() );
+        uint32_t added = 0;
+
+        for ( const auto& truck : get_truck_channels() )
+        {
+            if ( std::strcmp( truck.name, channel ) != 0 || !is_scalar( truck.type ) ) continue;
+            this->add_value( offsetof( telemetry_frame_t, truck ) + truck.offset, truck.type, index );
+            ++added;
+        }
+
+        for ( const auto& trailer : get_trailer_channels() )
+        {
+            if ( std::strcmp( trailer.name, channel ) != 0 || !is_scalar( trailer.type ) ) continue;
+            for ( uint32_t i = 0; i < MAX_TRAILERS; ++i )
+            {
+                this->add_value( offsetof( telemetry_frame_t, trailers ) + trailer.offset + trailer.size * i, trailer.type, index );
+                ++added;
+            }
+        }
+
+        const auto truck_wheel = std::strncmp( channel, "truck.wheel.", 12 ) == 0;
+        const auto trailer_wheel = std::strncmp( channel, "trailer.wheel.", 14 ) == 0;
+        for ( const auto& wheel : get_wheel_channels() )
+        {
+            if ( !is_scalar( wheel.type ) ) continue;
+
+            if ( truck_wheel && std::strcmp( channel + 12, wheel.name ) == 0 )
+            {
+                for ( uint32_t i = 0; i < MAX_WHEELS; ++i )
+                {
+                    this->add_value( offsetof( telemetry_frame_t, truck.wheels ) + wheel.offset + wheel.size * i, wheel.type, index );
+                    ++added;
+                }
+            }
+            else if ( trailer_wheel && std::strcmp( channel + 14, wheel.name ) == 0 )
+            {
+                for ( uint32_t trailer = 0; trailer < MAX_TRAILERS; ++trailer )
+                {
+                    for ( uint32_t i = 0; i < MAX_WHEELS; ++i )
+                    {
+                        this->add_value( offsetof( telemetry_frame_t, trailers.wheels ) + sizeof( wheels_soa_t ) * trailer + wheel.offset + wheel.size * i,
+                                         wheel.type, index );
+                        ++added;
+                    }
+                }
+            }
+        }
+
+        if ( added == 0 ) return false;
+
+        this->rules_.push_back( sanitized );
+        this->primed_ = false;
+        return true;
+    }
+
+    bool CChannelFilter::sample( filtered_value_t& value, const channel_filter_rule_t& rule, const double raw, double& candidate ) const
+    {
+        if ( rule.window > 1 )
+        {
+            value.min = value.count == 0 ? raw : std::min( value.min, raw );
+            value.max = value.count == 0 ? raw : std::max( value.max, raw );
+            value.sum += raw;
+            if ( ++value.count < rule.window ) return false;
+
+            switch ( rule.aggregate )
+            {
+                case FilterAggregate::MIN: candidate = value.min; break;
+                case FilterAggregate::MAX: candidate = value.max; break;
+                default: candidate = value.sum / value.count; break;
+            }
+            value.count = 0;
+            value.sum = 0.0;
+            return true;
+        }
+
+        candidate = raw;
+        return this->frame_counter_ % rule.decimation == 0;
+    }
+
+    const telemetry_frame_t& CChannelFilter::apply( const telemetry_frame_t& frame )
+    {
+        if ( this->values_.empty() || !this->is_enabled() )
+        {
+            this->primed_ = false;
+            return frame;
+        }
+
+        std::memcpy( this->output_, &frame, sizeof( telemetry_frame_t ) );
+        const auto* in = reinterpret_cast< const uint8_t* >( &frame );
+        auto* out = reinterpret_cast< uint8_t* >( this->output_ );
+
+        // the first frame after enabling (or a timer restart after loading a save) goes through as is and seeds the state
+        if ( !this->primed_ || frame.timer_restart )
+        {
+            for ( auto& value : this->values_ )
+            {
+                value.output = value.last_raw = read_value( in, value.offset, value.type );
+                value.count = 0;
+                value.sum = 0.0;
+            }
+            this->frame_counter_ = 0;
+            this->primed_ = true;
+            return *this->output_;
+        }
+
+        ++this->frame_counter_;
+
+        uint64_t raw_changes = 0;
+        uint64_t passed_changes = 0;
+        for ( auto& value : this->values_ )
+        {
+            const auto& rule = this->rules_[ value.rule ];
+            const auto raw = read_value( in, value.offset, value.type );
+            if ( raw != value.last_raw ) ++raw_changes;
+            value.last_raw = raw;
+
+            double candidate;
+            if ( this->sample( value, rule, raw, candidate ) && candidate != value.output && std::fabs( candidate - value.output ) >= rule.deadband )
+            {
+                value.output = candidate;
+                ++passed_changes;
+            }
+            write_value( out, value.offset, value.type, value.output );
+        }
+
+        this->raw_changes_.fetch_add( raw_changes, std::memory_order_relaxed );
+        this->passed_changes_.fetch_add( passed_changes, std::memory_order_relaxed );
+        return *this->output_;
+    }
+}
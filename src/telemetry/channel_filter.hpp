@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    struct FilterAggregate
+    {
+        enum Enum : uint8_t
+        {
+            NONE,
+            MIN,
+            MAX,
+            MEAN,
+        };
+    };
+
+    struct channel_filter_rule_t
+    {
+        uint32_t decimation = 1; // only look at every Nth frame, values in between are held
+        float deadband = 0.0f; // a new value is only passed on once it moved at least this far from the last passed one
+        uint32_t window = 0; // > 1 aggregates this many frames into one value instead of decimating
+        FilterAggregate::Enum aggregate = FilterAggregate::MEAN;
+    };
+
+    /**
+     * \brief Optional stage between the working frame and everything that publishes it (frame store, shared memory, recorder).
+     *
+     * Slow gauges like temperatures, voltage or the odometer arrive with a new value nearly every frame although
+     * nobody cares about the last digit. Rules are set per scalar channel of the frame channel tables, wheel channels
+     * as "truck.wheel.<name>" / "trailer.wheel.<name>" and trailer channels for all trailers at once. Filtered values
+     * are held in the output frame until decimation, the aggregation window and the deadband let a new one through,
+     * so downstream consumers see far fewer changes and the recorder's column encoders compress the held runs.
+     *
+     * Channels without a rule are copied through untouched and the working frame itself is never modified, the SDK
+     * only calls channel callbacks on change so it has to keep the raw values.
+     */
+    class CChannelFilter
+    {
+    private:
+        struct filtered_value_t
+        {
+            uint32_t offset; // in telemetry_frame_t
+            scs_value_type_t type;
+            uint32_t rule;
+
+            double output;
+            double last_raw;
+            double min, max, sum;
+            uint32_t count;
+        };
+
+        std::vector< channel_filter_rule_t > rules_;
+        std::vector< filtered_value_t > values_;
+        telemetry_frame_t* output_;
+
+        std::atomic< bool > enabled_ = true;
+        bool primed_ = false; // false until the first frame after a reset was passed through as is
+        uint64_t frame_counter_ = 0;
+
+        std::atomic< uint64_t > raw_changes_ = 0; // filtered channel values that differed from the previous frame
+        std::atomic< uint64_t > passed_changes_ = 0; // changes that made it into the output
+
+        void add_value( size_t offset, scs_value_type_t type, uint32_t rule );
+        bool sample( filtered_value_t& value, const channel_filter_rule_t& rule, double raw, double& candidate ) const;
+
+    public:
+        CChannelFilter();
+        CChannelFilter( const CChannelFilter& ) = delete;
+        CChannelFilter& operator=( const CChannelFilter& ) = delete;
+        ~CChannelFilter();
+
+        /**
+         * \brief Adds a rule for one channel, rules are only set up before the telemetry runs
+         * \return false for unknown channels and vector/placement channels
+         */
+        bool set_rule( const char* channel, const channel_filter_rule_t& rule );
+        uint32_t get_rule_count() const { return static_cast< uint32_t >( this->rules_.size() ); }
+
+        // any thread, takes effect on the next frame, re-enabling starts over from the current raw values
+        void set_enabled( const bool enabled ) { this->enabled_.store( enabled, std::memory_order_relaxed ); }
+        bool is_enabled() const { return this->enabled_.load( std::memory_order_relaxed ); }
+
+        /**
+         * \brief SDK thread, called from frame_end before publishing
+         * \return `frame` itself if filtering is off, the filtered copy otherwise, valid until the next call
+         */
+        const telemetry_frame_t& apply( const telemetry_frame_t& frame );
+
+        uint64_t get_raw_changes() const { return this->raw_changes_.load( std::memory_order_relaxed ); }
+        uint64_t get_passed_changes() const { return this->passed_changes_.load( std::memory_order_relaxed ); }
+    };
+}
@@ -0,0 +1,471 @@
+#include "columnar.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        uint32_t count_leading_zeros( const uint64_t value )
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            return _BitScanReverse64( &index, value ) ? 63 - index : 64;
+#else
+            return value == 0 ? 64 : static_cast< uint32_t >( __builtin_clzll( value ) );
+#endif
+        }
+
+        uint32_t count_trailing_zeros( const uint64_t value )
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            return _BitScanForward64( &index, value ) ? index : 64;
+#else
+            return value == 0 ? 64 : static_cast< uint32_t >( __builtin_ctzll( value ) );
+#endif
+        }
+
+        uint64_t zigzag( const int64_t value )
+        {
+            return ( static_cast< uint64_t >( value ) << 1 ) ^ static_cast< uint64_t >( value >> 63 );
+        }
+
+        int64_t unzigzag( const uint64_t value )
+        {
+            return static_cast< int64_t >( value >> 1 ) ^ -static_cast< int64_t >( value & 1 );
+        }
+
+        int64_t to_signed( const ColumnType::Enum type, const uint64_t raw )
+        {
+            return type == ColumnType::S32 ? static_cast< int64_t >( static_cast< int32_t >( raw ) ) : static_cast< int64_t >( raw );
+        }
+
+        uint64_t from_signed( const ColumnType::Enum type, const int64_t value )
+        {
+            return type == ColumnType::S32 || type == ColumnType::U32
+                       ? static_cast< uint64_t >( static_cast< uint32_t >( value ) )
+                       : static_cast< uint64_t >( value );
+        }
+
+        uint32_t get_width( const ColumnType::Enum type )
+        {
+            return type == ColumnType::F64 ? 64 : 32;
+        }
+
+        // bits used for the leading zero count and window length of XOR encoded values
+        uint32_t get_window_bits( const ColumnType::Enum type )
+        {
+            return type == ColumnType::F64 ? 6 : 5;
+        }
+
+        // reference value for XOR_LINEAR, must give bit identical results in the encoder and the decoder
+        uint64_t predict_linear( const ColumnType::Enum type, const uint32_t count, const uint64_t previous, const uint64_t previous2 )
+        {
+            if ( count < 2 ) return previous;
+
+            if ( type == ColumnType::F32 )
+            {
+                float a, b;
+                const auto a_bits = static_cast< uint32_t >( previous );
+                const auto b_bits = static_cast< uint32_t >( previous2 );
+                std::memcpy( &a, &a_bits, sizeof( a ) );
+                std::memcpy( &b, &b_bits, sizeof( b ) );
+
+                const float predicted = a + ( a - b );
+                if ( !std::isfinite( predicted ) ) return previous;
+
+                uint32_t bits;
+                std::memcpy( &bits, &predicted, sizeof( bits ) );
+                return bits;
+            }
+
+            double a, b;
+            std::memcpy( &a, &previous, sizeof( a ) );
+            std::memcpy( &b, &previous2, sizeof( b ) );
+
+            const double predicted = a + ( a - b );
+            if ( !std::isfinite( predicted ) ) return previous;
+
+            uint64_t bits;
+            std::memcpy( &bits, &predicted, sizeof( bits ) );
+            return bits;
+        }
+
+        class CBitReader
+        {
+        private:
+            const uint8_t* data_;
+            size_t size_;
+            size_t position_ = 0; // in bits
+
+        public:
+            CBitReader( const uint8_t* data, const size_t size ) : data_( data ), size_( size ) {}
+
+            bool read( const uint32_t count, uint64_t& out )
+            {
+                if ( this->position_ + count > this->size_ * 8 ) return false;
+
+                out = 0;
+                for ( uint32_t i = 0; i < count; ++i, ++this->position_ )
+                {
+                    const auto bit = ( this->data_[ this->position_ >> 3 ] >> ( 7 - ( this->position_ & 7 ) ) ) & 1;
+                    out = ( out << 1 ) | bit;
+                }
+                return true;
+            }
+        };
+    }
+
+    uint32_t get_column_value_size( const ColumnType::Enum type )
+    {
+        switch ( type )
+        {
+            case ColumnType::BOOL: return 1;
+            case ColumnType::S32:
+            case ColumnType::U32:
+            case ColumnType::F32: return 4;
+            default: return 8;
+        }
+    }
+
+    uint64_t read_varint( const uint8_t*& cursor, const uint8_t* end, bool& ok )
+    {
+        uint64_t value = 0;
+        for ( uint32_t shift = 0; shift < 64; shift += 7 )
+        {
+            if ( cursor >= end ) break;
+
+            const auto byte = *cursor++;
+            value |= static_cast< uint64_t >( byte & 0x7F ) << shift;
+            if ( ( byte & 0x80 ) == 0 ) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    void CColumnEncoder::xor_stream_t::reset()
+    {
+        this->bytes.clear();
+        this->bit_buffer = 0;
+        this->bit_count = 0;
+        this->leading = UINT32_MAX;
+        this->trailing = 0;
+    }
+
+    void CColumnEncoder::xor_stream_t::write_bits( const uint64_t value, uint32_t count )
+    {
+        while ( count > 0 )
+        {
+            const auto take = count > 32 ? 32 : count;
+            const auto chunk = ( value >> ( count - take ) ) & ( ( uint64_t{ 1 } << take ) - 1 );
+
+            this->bit_buffer = ( this->bit_buffer << take ) | chunk;
+            this->bit_count += take;
+            while ( this->bit_count >= 8 )
+            {
+                this->bytes.push_back( static_cast< uint8_t >( this->bit_buffer >> ( this->bit_count - 8 ) ) );
+                this->bit_count -= 8;
+            }
+            count -= take;
+        }
+    }
+
+    void CColumnEncoder::xor_stream_t::append( const uint64_t value, const uint64_t reference, const uint32_t width, const uint32_t window_bits )
+    {
+        const auto x = value ^ reference;
+        if ( x == 0 )
+        {
+            this->write_bits( 0, 1 );
+            return;
+        }
+
+        const auto max_leading = ( 1u << window_bits ) - 1;
+
+        auto leading = count_leading_zeros( x ) - ( 64 - width );
+        const auto trailing = count_trailing_zeros( x );
+        if ( leading > max_leading ) leading = max_leading;
+
+        // still fits in the previous window, skip re-sending it
+        if ( this->leading != UINT32_MAX && leading >= this->leading && trailing >= this->trailing )
+        {
+            this->write_bits( 0b10, 2 );
+            this->write_bits( x >> this->trailing, width - this->leading - this->trailing );
+            return;
+        }
+
+        const auto length = width - leading - trailing;
+        this->write_bits( 0b11, 2 );
+        this->write_bits( leading, window_bits );
+        this->write_bits( length - 1, window_bits );
+        this->write_bits( x >> trailing, length );
+
+        this->leading = leading;
+        this->trailing = trailing;
+    }
+
+    void CColumnEncoder::xor_stream_t::flush()
+    {
+        if ( this->bit_count != 0 ) this->write_bits( 0, 8 - this->bit_count );
+    }
+
+    void CColumnEncoder::reset()
+    {
+        this->count_ = 0;
+        this->first_ = 0;
+        this->previous_ = 0;
+        this->previous2_ = 0;
+        this->constant_ = true;
+        this->payload_.clear();
+        this->run_length_ = 0;
+        this->previous_delta_ = 0;
+        this->xor_.reset();
+        this->xor_linear_.reset();
+    }
+
+    void CColumnEncoder::write_varint( uint64_t value )
+    {
+        while ( value >= 0x80 )
+        {
+            this->payload_.push_back( static_cast< uint8_t >( value | 0x80 ) );
+            value >>= 7;
+        }
+        this->payload_.push_back( static_cast< uint8_t >( value ) );
+    }
+
+    void CColumnEncoder::append( const uint64_t value )
+    {
+        if ( this->count_ == 0 ) this->first_ = value;
+        else if ( value != this->first_ ) this->constant_ = false;
+
+        switch ( this->type_ )
+        {
+            case ColumnType::BOOL:
+            {
+                if ( this->count_ == 0 )
+                {
+                    this->payload_.push_back( static_cast< uint8_t >( value != 0 ) );
+                    this->run_length_ = 1;
+                }
+                else if ( value == this->previous_ )
+                {
+                    ++this->run_length_;
+                }
+                else
+                {
+                    this->write_varint( this->run_length_ );
+                    this->run_length_ = 1;
+                }
+                break;
+            }
+            case ColumnType::F32:
+            case ColumnType::F64:
+            {
+                const auto width = get_width( this->type_ );
+                const auto window_bits = get_window_bits( this->type_ );
+                this->xor_.append( value, this->previous_, width, window_bits );
+                this->xor_linear_.append( value, predict_linear( this->type_, this->count_, this->previous_, this->previous2_ ), width, window_bits );
+                break;
+            }
+            default:
+            {
+                // wrapping arithmetic, u64 values above INT64_MAX must round trip too
+                const auto previous = this->count_ == 0 ? 0 : static_cast< uint64_t >( to_signed( this->type_, this->previous_ ) );
+                const auto delta = static_cast< uint64_t >( to_signed( this->type_, value ) ) - previous;
+                const auto delta_of_delta = delta - this->previous_delta_;
+                this->previous_delta_ = delta;
+
+                if ( delta_of_delta == 0 )
+                {
+                    ++this->run_length_;
+                    break;
+                }
+
+                if ( this->run_length_ != 0 )
+                {
+                    this->write_varint( 0 );
+                    this->write_varint( this->run_length_ );
+                    this->run_length_ = 0;
+                }
+                this->write_varint( zigzag( static_cast< int64_t >( delta_of_delta ) ) );
+                break;
+            }
+        }
+
+        this->previous2_ = this->previous_;
+        this->previous_ = value;
+        ++this->count_;
+    }
+
+    void CColumnEncoder::finish( std::vector< uint8_t >& out )
+    {
+        const auto append_varint = [ &out ]( uint64_t value )
+        {
+            while ( value >= 0x80 )
+            {
+                out.push_back( static_cast< uint8_t >( value | 0x80 ) );
+                value >>= 7;
+            }
+            out.push_back( static_cast< uint8_t >( value ) );
+        };
+
+        const auto append_payload = [ & ]( const ColumnEncoding::Enum encoding, const std::vector< uint8_t >& payload )
+        {
+            out.push_back( encoding );
+            append_varint( payload.size() );
+            out.insert( out.end(), payload.begin(), payload.end() );
+        };
+
+        if ( this->constant_ )
+        {
+            const auto size = get_column_value_size( this->type_ );
+            out.push_back( ColumnEncoding::CONSTANT );
+            append_varint( size );
+            for ( uint32_t i = 0; i < size; ++i ) out.push_back( static_cast< uint8_t >( this->first_ >> ( i * 8 ) ) );
+        }
+        else if ( this->type_ == ColumnType::BOOL )
+        {
+            this->write_varint( this->run_length_ );
+            append_payload( ColumnEncoding::RLE, this->payload_ );
+        }
+        else if ( this->type_ == ColumnType::F32 || this->type_ == ColumnType::F64 )
+        {
+            this->xor_.flush();
+            this->xor_linear_.flush();
+            if ( this->xor_linear_.bytes.size() < this->xor_.bytes.size() ) append_payload( ColumnEncoding::XOR_LINEAR, this->xor_linear_.bytes );
+            else append_payload( ColumnEncoding::XOR, this->xor_.bytes );
+        }
+        else
+        {
+            if ( this->run_length_ != 0 )
+            {
+                this->write_varint( 0 );
+                this->write_varint( this->run_length_ );
+            }
+            append_payload( ColumnEncoding::DELTA_OF_DELTA, this->payload_ );
+        }
+
+        this->reset();
+    }
+
+    size_t decode_column( const ColumnType::Enum type, const uint8_t* data, const size_t size, const uint32_t count, uint64_t* out )
+    {
+        if ( size < 2 ) return 0;
+
+        const auto* cursor = data + 1;
+        const auto* end = data + size;
+        bool ok = true;
+        const auto payload_size = read_varint( cursor, end, ok );
+        if ( !ok || payload_size > static_cast< size_t >( end - cursor ) ) return 0;
+
+        const auto* payload = cursor;
+        const auto* payload_end = cursor + payload_size;
+        const auto consumed = static_cast< size_t >( payload_end - data );
+
+        switch ( static_cast< ColumnEncoding::Enum >( data[ 0 ] ) )
+        {
+            case ColumnEncoding::CONSTANT:
+            {
+                uint64_t value = 0;
+                for ( size_t i = 0; i < payload_size && i < 8; ++i ) value |= static_cast< uint64_t >( payload[ i ] ) << ( i * 8 );
+                for ( uint32_t i = 0; i < count; ++i ) out[ i ] = value;
+                return consumed;
+            }
+            case ColumnEncoding::RLE:
+            {
+                if ( payload_size == 0 ) return 0;
+
+                uint64_t value = payload[ 0 ];
+                cursor = payload + 1;
+                for ( uint32_t i = 0; i < count; value ^= 1 )
+                {
+                    const auto run = read_varint( cursor, payload_end, ok );
+                    if ( !ok || run == 0 || run > count - i ) return 0;
+                    for ( uint64_t j = 0; j < run; ++j ) out[ i++ ] = value;
+                }
+                return consumed;
+            }
+            case ColumnEncoding::DELTA_OF_DELTA:
+            {
+                uint64_t previous = 0;
+                uint64_t delta = 0;
+                cursor = payload;
+                for ( uint32_t i = 0; i < count; )
+                {
+                    const auto token = read_varint( cursor, payload_end, ok );
+                    if ( !ok ) return 0;
+
+                    uint64_t run = 1;
+                    if ( token == 0 )
+                    {
+                        run = read_varint( cursor, payload_end, ok );
+                        if ( !ok || run == 0 || run > count - i ) return 0;
+                    }
+                    else
+                    {
+                        delta += static_cast< uint64_t >( unzigzag( token ) );
+                    }
+
+                    for ( uint64_t j = 0; j < run; ++j )
+                    {
+                        previous += delta;
+                        out[ i++ ] = from_signed( type, static_cast< int64_t >( previous ) );
+                    }
+                }
+                return consumed;
+            }
+            case ColumnEncoding::XOR:
+            case ColumnEncoding::XOR_LINEAR:
+            {
+                const auto linear = data[ 0 ] == ColumnEncoding::XOR_LINEAR;
+                const auto width = get_width( type );
+                const auto window_bits = get_window_bits( type );
+                CBitReader reader( payload, payload_size );
+
+                uint64_t previous = 0;
+                uint64_t previous2 = 0;
+                uint32_t leading = UINT32_MAX;
+                uint32_t trailing = 0;
+                for ( uint32_t i = 0; i < count; ++i )
+                {
+                    const auto reference = linear ? predict_linear( type, i, previous, previous2 ) : previous;
+                    uint64_t x = 0;
+
+                    uint64_t bits;
+                    if ( !reader.read( 1, bits ) ) return 0;
+                    if ( bits == 1 )
+                    {
+                        if ( !reader.read( 1, bits ) ) return 0;
+                        if ( bits == 1 )
+                        {
+                            uint64_t new_leading, length;
+                            if ( !reader.read( window_bits, new_leading ) || !reader.read( window_bits, length ) ) return 0;
+                            leading = static_cast< uint32_t >( new_leading );
+                            trailing = width - leading - static_cast< uint32_t >( length + 1 );
+                            if ( trailing >= width ) return 0;
+                        }
+                        else if ( leading == UINT32_MAX )
+                        {
+                            return 0;
+                        }
+
+                        uint64_t meaningful;
+                        if ( !reader.read( width - leading - trailing, meaningful ) ) return 0;
+                        x = meaningful << trailing;
+                    }
+
+                    previous2 = previous;
+                    previous = reference ^ x;
+                    out[ i ] = previous;
+                }
+                return consumed;
+            }
+            default: return 0;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ts_extra_utilities::telemetry
+{
+    struct ColumnType
+    {
+        enum Enum : uint8_t
+        {
+            BOOL,
+            S32,
+            U32,
+            S64,
+            U64,
+            F32,
+            F64,
+        };
+    };
+
+    struct ColumnEncoding
+    {
+        enum Enum : uint8_t
+        {
+            CONSTANT, // one raw value for the whole block
+            RLE, // booleans, first value then alternating run lengths
+            DELTA_OF_DELTA, // integers, zigzag encoded second order deltas, runs of zeros are stored as a 0 token + run length
+            XOR, // floats, xor with the previous value, only the meaningful bits are stored
+            XOR_LINEAR, // floats, xor with the value extrapolated from the previous two, wins on smooth signals
+        };
+    };
+
+    // size of one value in the frame / in a CONSTANT payload
+    uint32_t get_column_value_size( ColumnType::Enum type );
+
+    /**
+     * \brief Encodes one column of one block incrementally, values are passed as their raw bit pattern
+     *
+     * The output is [encoding][varint payload size][payload], a block is just the columns back to back.
+     */
+    class CColumnEncoder
+    {
+    private:
+        struct xor_stream_t
+        {
+            std::vector< uint8_t > bytes;
+            uint64_t bit_buffer = 0;
+            uint32_t bit_count = 0;
+
+            // meaningful bit window of the previous value
+            uint32_t leading = UINT32_MAX;
+            uint32_t trailing = 0;
+
+            void reset();
+            void write_bits( uint64_t value, uint32_t count );
+            void append( uint64_t value, uint64_t reference, uint32_t width, uint32_t window_bits );
+            void flush();
+        };
+
+        ColumnType::Enum type_ = ColumnType::BOOL;
+        uint32_t count_ = 0;
+        uint64_t first_ = 0;
+        uint64_t previous_ = 0;
+        uint64_t previous2_ = 0;
+        bool constant_ = true;
+
+        // RLE and DELTA_OF_DELTA
+        std::vector< uint8_t > payload_;
+        uint32_t run_length_ = 0;
+        uint64_t previous_delta_ = 0;
+
+        // both float encodings are kept and the smaller one is written
+        xor_stream_t xor_;
+        xor_stream_t xor_linear_;
+
+        void write_varint( uint64_t value );
+
+    public:
+        explicit CColumnEncoder( ColumnType::Enum type = ColumnType::BOOL ) : type_( type ) {}
+
+        void reset();
+        void append( uint64_t value );
+
+        // Appends the encoded column to `out` and resets the encoder for the next block
+        void finish( std::vector< uint8_t >& out );
+
+        uint32_t get_count() const { return this->count_; }
+
+        // Every value of the block so far was 0, the recorder skips those columns through the block's zero mask
+        bool is_zero() const { return this->count_ != 0 && this->constant_ && this->first_ == 0; }
+    };
+
+    /**
+     * \brief Decodes `count` values of one column written by CColumnEncoder::finish
+     * \return bytes consumed from `data`, 0 on malformed input
+     */
+    size_t decode_column( ColumnType::Enum type, const uint8_t* data, size_t size, uint32_t count, uint64_t* out );
+
+    uint64_t read_varint( const uint8_t*& cursor, const uint8_t* end, bool& ok );
+}
@@ -0,0 +1,389 @@
+#include "configuration.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/scssdk_telemetry_common_configs.h"
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        bool is( const scs_named_value_t& attribute, const char* name )
+        {
+            return std::strcmp( attribute.name, name ) == 0;
+        }
+
+        // each read only accepts the value type the SDK documents for the attribute, anything else leaves it zeroed
+        void read( const scs_value_t& value, bool& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_bool ) out = value.value_bool.value != 0;
+        }
+
+        void read( const scs_value_t& value, int32_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_s32 ) out = value.value_s32.value;
+        }
+
+        void read( const scs_value_t& value, uint32_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_u32 ) out = value.value_u32.value;
+        }
+
+        void read( const scs_value_t& value, uint64_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_u64 ) out = value.value_u64.value;
+        }
+
+        void read( const scs_value_t& value, float& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_float ) out = value.value_float.value;
+        }
+
+        void read( const scs_value_t& value, scs_value_fvector_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_fvector ) out = value.value_fvector;
+        }
+
+        void read( const scs_value_t& value, char ( &out )[ MAX_CONFIG_STRING ] )
+        {
+            if ( value.type != SCS_VALUE_TYPE_string || value.value_string.value == nullptr ) return;
+            std::strncpy( out, value.value_string.value, MAX_CONFIG_STRING - 1 );
+        }
+
+        bool read_identity( const scs_named_value_t& attribute, vehicle_identity_t& identity )
+        {
+            if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_id ) ) read( attribute.value, identity.id );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_brand_id ) ) read( attribute.value, identity.brand_id );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_brand ) ) read( attribute.value, identity.brand );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_name ) ) read( attribute.value, identity.name );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_license_plate ) ) read( attribute.value, identity.license_plate );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_license_plate_country_id ) ) read( attribute.value, identity.license_plate_country_id );
+            else return false;
+            return true;
+        }
+
+        bool read_wheels( const scs_named_value_t& attribute, wheels_config_t& wheels )
+        {
+            if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_count ) )
+            {
+                read( attribute.value, wheels.count );
+                wheels.count = std::min( wheels.count, MAX_WHEELS );
+                return true;
+            }
+
+            // the per wheel attributes are indexed
+            wheel_config_t dummy{};
+            auto& wheel = attribute.index < MAX_WHEELS ? wheels.wheels[ attribute.index ] : dummy;
+
+            if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_position ) ) read( attribute.value, wheel.position );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_radius ) ) read( attribute.value, wheel.radius );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_steerable ) ) read( attribute.value, wheel.steerable );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_simulated ) ) read( attribute.value, wheel.simulated );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_powered ) ) read( attribute.value, wheel.powered );
+            else if ( is( attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_liftable ) ) read( attribute.value, wheel.liftable );
+            else return false;
+            return true;
+        }
+
+        template < typename T >
+        void zero( T& value )
+        {
+            std::memset( &value, 0, sizeof( T ) );
+        }
+
+        template < typename T >
+        bool differs( const T& a, const T& b )
+        {
+            return std::memcmp( &a, &b, sizeof( T ) ) != 0;
+        }
+
+        // differs outside the groups that `blank` clears
+        template < typename T, typename Blank >
+        bool differs_except( const T& a, const T& b, Blank blank )
+        {
+            T rest_a, rest_b;
+            std::memcpy( &rest_a, &a, sizeof( T ) );
+            std::memcpy( &rest_b, &b, sizeof( T ) );
+            blank( rest_a );
+            blank( rest_b );
+            return differs( rest_a, rest_b );
+        }
+
+        void parse_truck( const scs_named_value_t* attributes, truck_config_t& truck )
+        {
+            zero( truck );
+            truck.present = attributes->name != nullptr;
+
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                if ( read_identity( *attribute, truck.identity ) || read_wheels( *attribute, truck.wheels ) ) continue;
+
+                const auto& value = attribute->value;
+                if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_hook_position ) ) read( value, truck.hook_position );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_cabin_position ) ) read( value, truck.cabin_position );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_head_position ) ) read( value, truck.head_position );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_fuel_capacity ) ) read( value, truck.fuel_capacity );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_adblue_capacity ) ) read( value, truck.adblue_capacity );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_rpm_limit ) ) read( value, truck.rpm_limit );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_forward_gear_count ) ) read( value, truck.forward_gears );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_reverse_gear_count ) ) read( value, truck.reverse_gears );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_retarder_step_count ) ) read( value, truck.retarder_steps );
+            }
+        }
+
+        void parse_trailer( const scs_named_value_t* attributes, trailer_config_t& trailer )
+        {
+            zero( trailer );
+            trailer.present = attributes->name != nullptr;
+
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                if ( read_identity( *attribute, trailer.identity ) || read_wheels( *attribute, trailer.wheels ) ) continue;
+
+                const auto& value = attribute->value;
+                if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_hook_position ) ) read( value, trailer.hook_position );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_cargo_accessory_id ) ) read( value, trailer.cargo_accessory_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_chain_type ) ) read( value, trailer.chain_type );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_body_type ) ) read( value, trailer.body_type );
+            }
+        }
+
+        void parse_job( const scs_named_value_t* attributes, job_config_t& job )
+        {
+            zero( job );
+            job.present = attributes->name != nullptr;
+
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                const auto& value = attribute->value;
+                if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_cargo_id ) ) read( value, job.identity.cargo_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_cargo ) ) read( value, job.identity.cargo );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_source_city_id ) ) read( value, job.identity.source_city_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_source_company_id ) ) read( value, job.identity.source_company_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_destination_city_id ) ) read( value, job.identity.destination_city_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_destination_company_id ) ) read( value, job.identity.destination_company_id );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_job_market ) ) read( value, job.identity.job_market );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_cargo_mass ) ) read( value, job.cargo_mass );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_income ) ) read( value, job.income );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_delivery_time ) ) read( value, job.delivery_time );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_planned_distance_km ) ) read( value, job.planned_distance_km );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_is_cargo_loaded ) ) read( value, job.cargo_loaded );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_special_job ) ) read( value, job.special_job );
+            }
+        }
+
+        void parse_controls( const scs_named_value_t* attributes, controls_config_t& controls )
+        {
+            zero( controls );
+
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                if ( !is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_shifter_type ) ) continue;
+
+                char type[ MAX_CONFIG_STRING ] = {};
+                read( attribute->value, type );
+                if ( std::strcmp( type, SCS_SHIFTER_TYPE_arcade ) == 0 ) controls.shifter_type = ShifterType::ARCADE;
+                else if ( std::strcmp( type, SCS_SHIFTER_TYPE_automatic ) == 0 ) controls.shifter_type = ShifterType::AUTOMATIC;
+                else if ( std::strcmp( type, SCS_SHIFTER_TYPE_manual ) == 0 ) controls.shifter_type = ShifterType::MANUAL;
+                else if ( std::strcmp( type, SCS_SHIFTER_TYPE_hshifter ) == 0 ) controls.shifter_type = ShifterType::HSHIFTER;
+            }
+        }
+
+        void parse_hshifter( const scs_named_value_t* attributes, hshifter_config_t& hshifter )
+        {
+            zero( hshifter );
+
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_selector_count ) )
+                {
+                    read( attribute->value, hshifter.selector_count );
+                    continue;
+                }
+
+                if ( attribute->index >= MAX_HSHIFTER_SLOTS ) continue;
+
+                auto& slot = hshifter.slots[ attribute->index ];
+                if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_slot_gear ) ) read( attribute->value, slot.gear );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_slot_handle_position ) ) read( attribute->value, slot.handle_position );
+                else if ( is( *attribute, SCS_TELEMETRY_CONFIG_ATTRIBUTE_slot_selectors ) ) read( attribute->value, slot.selectors );
+                else continue;
+
+                hshifter.slot_count = std::max( hshifter.slot_count, attribute->index + 1 );
+            }
+        }
+
+        uint32_t diff_truck( const truck_config_t& a, const truck_config_t& b )
+        {
+            uint32_t changes = 0;
+            if ( a.present != b.present ) changes |= ConfigurationChange::PRESENCE;
+            if ( differs( a.identity, b.identity ) ) changes |= ConfigurationChange::IDENTITY;
+            if ( differs( a.wheels, b.wheels ) ) changes |= ConfigurationChange::WHEELS;
+            if ( differs( a.hook_position, b.hook_position ) ) changes |= ConfigurationChange::HOOK;
+
+            const auto other = differs_except( a, b, []( truck_config_t& truck )
+            {
+                truck.present = false;
+                zero( truck.identity );
+                zero( truck.wheels );
+                zero( truck.hook_position );
+            } );
+            if ( other ) changes |= ConfigurationChange::OTHER;
+            return changes;
+        }
+
+        uint32_t diff_trailer( const trailer_config_t& a, const trailer_config_t& b )
+        {
+            uint32_t changes = 0;
+            if ( a.present != b.present ) changes |= ConfigurationChange::PRESENCE;
+            if ( differs( a.identity, b.identity ) || differs( a.cargo_accessory_id, b.cargo_accessory_id ) ) changes |= ConfigurationChange::IDENTITY;
+            if ( differs( a.wheels, b.wheels ) ) changes |= ConfigurationChange::WHEELS;
+            if ( differs( a.hook_position, b.hook_position ) ) changes |= ConfigurationChange::HOOK;
+
+            const auto other = differs_except( a, b, []( trailer_config_t& trailer )
+            {
+                trailer.present = false;
+                zero( trailer.identity );
+                zero( trailer.cargo_accessory_id );
+                zero( trailer.wheels );
+                zero( trailer.hook_position );
+            } );
+            if ( other ) changes |= ConfigurationChange::OTHER;
+            return changes;
+        }
+
+        uint32_t diff_job( const job_config_t& a, const job_config_t& b )
+        {
+            uint32_t changes = 0;
+            if ( a.present != b.present ) changes |= ConfigurationChange::PRESENCE;
+            if ( differs( a.identity, b.identity ) ) changes |= ConfigurationChange::IDENTITY;
+
+            const auto other = differs_except( a, b, []( job_config_t& job )
+            {
+                job.present = false;
+                zero( job.identity );
+            } );
+            if ( other ) changes |= ConfigurationChange::OTHER;
+            return changes;
+        }
+    }
+
+    uint32_t CConfiguration::apply( const scs_telemetry_configuration_t& configuration )
+    {
+        if ( configuration.id == nullptr || configuration.attributes == nullptr ) return 0;
+
+        constexpr auto trailer_prefix_length = sizeof( SCS_TELEMETRY_CONFIG_trailer ) - 1;
+        const char* id = configuration.id;
+
+        if ( std::strcmp( id, SCS_TELEMETRY_CONFIG_truck ) == 0 )
+        {
+            truck_config_t truck;
+            parse_truck( configuration.attributes, truck );
+
+            const auto changes = diff_truck( this->truck_, truck );
+            if ( changes == 0 ) return 0;
+
+            std::memcpy( &this->truck_, &truck, sizeof( truck ) );
+            this->notify( ConfigurationPart::TRUCK, 0, changes );
+            return changes;
+        }
+
+        // trailer.N, the unindexed "trailer" set is a duplicate of trailer.0 kept for old plugins
+        if ( std::strncmp( id, SCS_TELEMETRY_CONFIG_trailer, trailer_prefix_length ) == 0 && id[ trailer_prefix_length ] == '.' )
+        {
+            const auto index = static_cast< uint32_t >( std::strtoul( id + trailer_prefix_length + 1, nullptr, 10 ) );
+            if ( index >= MAX_TRAILERS ) return 0;
+
+            trailer_config_t trailer;
+            parse_trailer( configuration.attributes, trailer );
+
+            const auto changes = diff_trailer( this->trailers_[ index ], trailer );
+            if ( changes == 0 ) return 0;
+
+            std::memcpy( &this->trailers_[ index ], &trailer, sizeof( trailer ) );
+            this->notify( ConfigurationPart::TRAILER, index, changes );
+            return changes;
+        }
+
+        if ( std::strcmp( id, SCS_TELEMETRY_CONFIG_job ) == 0 )
+        {
+            job_config_t job;
+            parse_job( configuration.attributes, job );
+
+            const auto changes = diff_job( this->job_, job );
+            if ( changes == 0 ) return 0;
+
+            std::memcpy( &this->job_, &job, sizeof( job ) );
+            this->notify( ConfigurationPart::JOB, 0, changes );
+            return changes;
+        }
+
+        if ( std::strcmp( id, SCS_TELEMETRY_CONFIG_controls ) == 0 )
+        {
+            controls_config_t controls;
+            parse_controls( configuration.attributes, controls );
+            if ( !differs( this->controls_, controls ) ) return 0;
+
+            std::memcpy( &this->controls_, &controls, sizeof( controls ) );
+            this->notify( ConfigurationPart::CONTROLS, 0, ConfigurationChange::OTHER );
+            return ConfigurationChange::OTHER;
+        }
+
+        if ( std::strcmp( id, SCS_TELEMETRY_CONFIG_hshifter ) == 0 )
+        {
+            hshifter_config_t hshifter;
+            parse_hshifter( configuration.attributes, hshifter );
+            if ( !differs( this->hshifter_, hshifter ) ) return 0;
+
+            std::memcpy( &this->hshifter_, &hshifter, sizeof( hshifter ) );
+            this->notify( ConfigurationPart::HSHIFTER, 0, ConfigurationChange::OTHER );
+            return ConfigurationChange::OTHER;
+        }
+
+        return 0;
+    }
+
+    void CConfiguration::notify( const ConfigurationPart::Enum part, const uint32_t index, const uint32_t changes ) const
+    {
+        const configuration_change_t change{ part, index, changes };
+        for ( const auto& subscriber : this->subscribers_ )
+        {
+            if ( subscriber.parts & part ) subscriber.callback( change, *this, subscriber.user_data );
+        }
+    }
+
+    void CConfiguration::subscribe( const uint32_t parts, const configuration_callback_t callback, void* user_data )
+    {
+        if ( callback == nullptr ) return;
+        this->subscribers_.push_back( { callback, user_data, parts } );
+    }
+
+    void CConfiguration::unsubscribe( const configuration_callback_t callback, void* user_data )
+    {
+        this->subscribers_.erase( std::remove_if( this->subscribers_.begin(), this->subscribers_.end(), [ & ]( const subscriber_t& subscriber )
+        {
+            return subscriber.callback == callback && subscriber.user_data == user_data;
+        } ), this->subscribers_.end() );
+    }
+
+    uint32_t CConfiguration::get_trailer_count() const
+    {
+        for ( uint32_t i = MAX_TRAILERS; i > 0; --i )
+        {
+            if ( this->trailers_[ i - 1 ].present ) return i;
+        }
+        return 0;
+    }
+
+    uint32_t CConfiguration::get_max_trailer_wheel_count() const
+    {
+        uint32_t count = 0;
+        for ( const auto& trailer : this->trailers_ )
+        {
+            if ( trailer.present ) count = std::max( count, trailer.wheels.count );
+        }
+        return count;
+    }
+}
@@ -0,0 +1,215 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "scssdk_telemetry.h"
+
+#include "frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    constexpr uint32_t MAX_CONFIG_STRING = 64;
+    constexpr uint32_t MAX_HSHIFTER_SLOTS = 32;
+
+    struct ConfigurationPart
+    {
+        enum Enum : uint32_t
+        {
+            TRUCK = 1 << 0,
+            TRAILER = 1 << 1,
+            JOB = 1 << 2,
+            CONTROLS = 1 << 3,
+            HSHIFTER = 1 << 4,
+            ALL = TRUCK | TRAILER | JOB | CONTROLS | HSHIFTER,
+        };
+    };
+
+    // what changed inside a part, a subscriber only gets the bits that actually differ from the cached state
+    struct ConfigurationChange
+    {
+        enum Enum : uint32_t
+        {
+            PRESENCE = 1 << 0, // truck/trailer/job appeared or went away
+            IDENTITY = 1 << 1, // ids, names, license plate, cargo
+            WHEELS = 1 << 2, // wheel count or wheel layout
+            HOOK = 1 << 3, // hook position
+            OTHER = 1 << 4, // anything else (capacities, gear counts, shifter layout, ...)
+        };
+    };
+
+    struct ShifterType
+    {
+        enum Enum : uint32_t
+        {
+            UNKNOWN,
+            ARCADE,
+            AUTOMATIC,
+            MANUAL,
+            HSHIFTER,
+        };
+    };
+
+    /*
+     * The structs below are always zeroed before being filled and copied with memcpy, so groups of fields can be
+     * compared with memcmp, padding included.
+     */
+
+    struct wheel_config_t
+    {
+        scs_value_fvector_t position; // *.wheel.position, vehicle space
+        float radius;
+        bool steerable;
+        bool simulated;
+        bool powered;
+        bool liftable;
+    };
+
+    struct wheels_config_t
+    {
+        uint32_t count; // clamped to MAX_WHEELS
+        wheel_config_t wheels[ MAX_WHEELS ];
+    };
+
+    struct vehicle_identity_t
+    {
+        char id[ MAX_CONFIG_STRING ];
+        char brand_id[ MAX_CONFIG_STRING ];
+        char brand[ MAX_CONFIG_STRING ];
+        char name[ MAX_CONFIG_STRING ];
+        char license_plate[ MAX_CONFIG_STRING ];
+        char license_plate_country_id[ MAX_CONFIG_STRING ];
+    };
+
+    struct truck_config_t
+    {
+        bool present;
+        vehicle_identity_t identity;
+        scs_value_fvector_t hook_position;
+        wheels_config_t wheels;
+
+        scs_value_fvector_t cabin_position;
+        scs_value_fvector_t head_position;
+        float fuel_capacity;
+        float adblue_capacity;
+        float rpm_limit;
+        uint32_t forward_gears;
+        uint32_t reverse_gears;
+        uint32_t retarder_steps;
+    };
+
+    struct trailer_config_t
+    {
+        bool present;
+        vehicle_identity_t identity;
+        char cargo_accessory_id[ MAX_CONFIG_STRING ];
+        scs_value_fvector_t hook_position;
+        wheels_config_t wheels;
+
+        char chain_type[ MAX_CONFIG_STRING ]; // first trailer only
+        char body_type[ MAX_CONFIG_STRING ]; // first trailer only
+    };
+
+    struct job_identity_t
+    {
+        char cargo_id[ MAX_CONFIG_STRING ];
+        char cargo[ MAX_CONFIG_STRING ];
+        char source_city_id[ MAX_CONFIG_STRING ];
+        char source_company_id[ MAX_CONFIG_STRING ]; // empty for special transport
+        char destination_city_id[ MAX_CONFIG_STRING ];
+        char destination_company_id[ MAX_CONFIG_STRING ]; // empty for special transport
+        char job_market[ MAX_CONFIG_STRING ];
+    };
+
+    struct job_config_t
+    {
+        bool present;
+        job_identity_t identity;
+
+        float cargo_mass;
+        uint64_t income;
+        uint32_t delivery_time; // game time in minutes
+        uint32_t planned_distance_km;
+        bool cargo_loaded;
+        bool special_job;
+    };
+
+    struct controls_config_t
+    {
+        ShifterType::Enum shifter_type;
+    };
+
+    struct hshifter_slot_t
+    {
+        int32_t gear;
+        uint32_t handle_position;
+        uint32_t selectors; // bitmask
+    };
+
+    struct hshifter_config_t
+    {
+        uint32_t selector_count;
+        uint32_t slot_count;
+        hshifter_slot_t slots[ MAX_HSHIFTER_SLOTS ];
+    };
+
+    class CConfiguration;
+
+    struct configuration_change_t
+    {
+        ConfigurationPart::Enum part;
+        uint32_t index; // trailer index, 0 for everything else
+        uint32_t changes; // ConfigurationChange bits
+    };
+
+    using configuration_callback_t = void( * )( const configuration_change_t& change, const CConfiguration& configuration, void* user_data );
+
+    /**
+     * \brief Typed cache of the SCS_TELEMETRY_EVENT_configuration attribute sets.
+     *
+     * The game resends whole attribute sets on every load and vehicle change, most of which repeat what we already
+     * have. Each set is parsed into a zeroed struct, diffed group by group against the cached one and subscribers are
+     * only told about the groups that changed. Everything runs on the SDK thread.
+     */
+    class CConfiguration
+    {
+    private:
+        struct subscriber_t
+        {
+            configuration_callback_t callback;
+            void* user_data;
+            uint32_t parts; // ConfigurationPart mask
+        };
+
+        truck_config_t truck_ = {};
+        trailer_config_t trailers_[ MAX_TRAILERS ] = {};
+        job_config_t job_ = {};
+        controls_config_t controls_ = {};
+        hshifter_config_t hshifter_ = {};
+
+        std::vector< subscriber_t > subscribers_;
+
+        void notify( ConfigurationPart::Enum part, uint32_t index, uint32_t changes ) const;
+
+    public:
+        /**
+         * \brief Updates the cache from one configuration event and notifies the subscribers
+         * \return ConfigurationChange bits of what changed, 0 if the set was identical or not one we track
+         */
+        uint32_t apply( const scs_telemetry_configuration_t& configuration );
+
+        void subscribe( uint32_t parts, configuration_callback_t callback, void* user_data );
+        void unsubscribe( configuration_callback_t callback, void* user_data );
+
+        const truck_config_t& get_truck() const { return this->truck_; }
+        const trailer_config_t& get_trailer( const uint32_t index ) const { return this->trailers_[ index < MAX_TRAILERS ? index : 0 ]; }
+        const job_config_t& get_job() const { return this->job_; }
+        const controls_config_t& get_controls() const { return this->controls_; }
+        const hshifter_config_t& get_hshifter() const { return this->hshifter_; }
+
+        // trailers the game reports, i.e. one past the last present trailer.N
+        uint32_t get_trailer_count() const;
+
+        // largest wheel count over the present trailers
+        uint32_t get_max_trailer_wheel_count() const;
+    };
+}
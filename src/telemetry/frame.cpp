@@ -0,0 +1,75 @@
+#include "frame.hpp"
+
+#include <cstddef>
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+#define TS_TRUCK_CHANNEL( name, type, member ) { name, type, offsetof( truck_state_t, member ), sizeof( truck_state_t::member ) }
+#define TS_WHEEL_CHANNEL( name, type, member ) { name, type, offsetof( wheels_soa_t, member ), sizeof( wheels_soa_t::member[ 0 ] ) }
+#define TS_TRAILER_CHANNEL( name, type, member ) { name, type, offsetof( trailers_soa_t, member ), sizeof( trailers_soa_t::member[ 0 ] ) }
+
+        const frame_channel_t truck_channels[ TRUCK_CHANNEL_COUNT ] = {
+            TS_TRUCK_CHANNEL( "truck.world.placement", SCS_VALUE_TYPE_dplacement, world_placement ),
+            TS_TRUCK_CHANNEL( "truck.local.velocity.linear", SCS_VALUE_TYPE_fvector, linear_velocity ),
+            TS_TRUCK_CHANNEL( "truck.local.velocity.angular", SCS_VALUE_TYPE_fvector, angular_velocity ),
+            TS_TRUCK_CHANNEL( "truck.speed", SCS_VALUE_TYPE_float, speed ),
+            TS_TRUCK_CHANNEL( "truck.engine.rpm", SCS_VALUE_TYPE_float, engine_rpm ),
+            TS_TRUCK_CHANNEL( "truck.engine.gear", SCS_VALUE_TYPE_s32, engine_gear ),
+            TS_TRUCK_CHANNEL( "truck.effective.steering", SCS_VALUE_TYPE_float, effective_steering ),
+            TS_TRUCK_CHANNEL( "truck.effective.throttle", SCS_VALUE_TYPE_float, effective_throttle ),
+            TS_TRUCK_CHANNEL( "truck.effective.brake", SCS_VALUE_TYPE_float, effective_brake ),
+            TS_TRUCK_CHANNEL( "truck.effective.clutch", SCS_VALUE_TYPE_float, effective_clutch ),
+            TS_TRUCK_CHANNEL( "truck.fuel.amount", SCS_VALUE_TYPE_float, fuel ),
+            TS_TRUCK_CHANNEL( "truck.oil.temperature", SCS_VALUE_TYPE_float, oil_temperature ),
+            TS_TRUCK_CHANNEL( "truck.water.temperature", SCS_VALUE_TYPE_float, water_temperature ),
+            TS_TRUCK_CHANNEL( "truck.battery.voltage", SCS_VALUE_TYPE_float, battery_voltage ),
+            TS_TRUCK_CHANNEL( "truck.odometer", SCS_VALUE_TYPE_float, odometer ),
+            TS_TRUCK_CHANNEL( "truck.brake.parking", SCS_VALUE_TYPE_bool, parking_brake ),
+            TS_TRUCK_CHANNEL( "truck.engine.enabled", SCS_VALUE_TYPE_bool, engine_enabled ),
+            TS_TRUCK_CHANNEL( "truck.lblinker", SCS_VALUE_TYPE_bool, lblinker ),
+            TS_TRUCK_CHANNEL( "truck.rblinker", SCS_VALUE_TYPE_bool, rblinker ),
+            TS_TRUCK_CHANNEL( "truck.light.beam.low", SCS_VALUE_TYPE_bool, light_low_beam ),
+            TS_TRUCK_CHANNEL( "truck.light.beam.high", SCS_VALUE_TYPE_bool, light_high_beam ),
+            TS_TRUCK_CHANNEL( "truck.wipers", SCS_VALUE_TYPE_bool, wipers ),
+        };
+
+        const frame_channel_t wheel_channels[ WHEEL_CHANNEL_COUNT ] = {
+            TS_WHEEL_CHANNEL( "suspension.deflection", SCS_VALUE_TYPE_float, suspension_deflection ),
+            TS_WHEEL_CHANNEL( "angular_velocity", SCS_VALUE_TYPE_float, angular_velocity ),
+            TS_WHEEL_CHANNEL( "steering", SCS_VALUE_TYPE_float, steering ),
+            TS_WHEEL_CHANNEL( "rotation", SCS_VALUE_TYPE_float, rotation ),
+            TS_WHEEL_CHANNEL( "lift", SCS_VALUE_TYPE_float, lift ),
+            TS_WHEEL_CHANNEL( "lift.offset", SCS_VALUE_TYPE_float, lift_offset ),
+            TS_WHEEL_CHANNEL( "substance", SCS_VALUE_TYPE_u32, substance ),
+            TS_WHEEL_CHANNEL( "on_ground", SCS_VALUE_TYPE_bool, on_ground ),
+        };
+
+        const frame_channel_t trailer_channels[ TRAILER_CHANNEL_COUNT ] = {
+            TS_TRAILER_CHANNEL( "trailer.connected", SCS_VALUE_TYPE_bool, connected ),
+            TS_TRAILER_CHANNEL( "trailer.cargo.damage", SCS_VALUE_TYPE_float, cargo_damage ),
+            TS_TRAILER_CHANNEL( "trailer.world.placement", SCS_VALUE_TYPE_dplacement, world_placement ),
+            TS_TRAILER_CHANNEL( "trailer.velocity.linear", SCS_VALUE_TYPE_fvector, linear_velocity ),
+        };
+
+#undef TS_TRUCK_CHANNEL
+#undef TS_WHEEL_CHANNEL
+#undef TS_TRAILER_CHANNEL
+    }
+
+    frame_channel_list_t get_truck_channels()
+    {
+        return { truck_channels, TRUCK_CHANNEL_COUNT };
+    }
+
+    frame_channel_list_t get_wheel_channels()
+    {
+        return { wheel_channels, WHEEL_CHANNEL_COUNT };
+    }
+
+    frame_channel_list_t get_trailer_channels()
+    {
+        return { trailer_channels, TRAILER_CHANNEL_COUNT };
+    }
+}
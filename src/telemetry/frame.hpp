@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+
+#include "scssdk_telemetry.h"
+#include "common/scssdk_telemetry_common_configs.h"
+
+namespace ts_extra_utilities::telemetry
+{
+    // storage bounds, the channels actually registered follow the configuration events
+    constexpr uint32_t MAX_TRAILERS = SCS_TELEMETRY_trailers_count;
+    constexpr uint32_t MAX_WHEELS = 16; // per vehicle, the SDK doesn't define a limit
+
+    /**
+     * \brief Per-wheel channels of one vehicle, one array per channel so a pass over e.g. all steering angles stays in one or two cache lines
+     */
+    struct wheels_soa_t
+    {
+        float suspension_deflection[ MAX_WHEELS ]; // *.wheel.suspension.deflection
+        float angular_velocity[ MAX_WHEELS ]; // *.wheel.angular_velocity
+        float steering[ MAX_WHEELS ]; // *.wheel.steering
+        float rotation[ MAX_WHEELS ]; // *.wheel.rotation
+        float lift[ MAX_WHEELS ]; // *.wheel.lift
+        float lift_offset[ MAX_WHEELS ]; // *.wheel.lift.offset
+        uint32_t substance[ MAX_WHEELS ]; // *.wheel.substance
+        bool on_ground[ MAX_WHEELS ]; // *.wheel.on_ground
+    };
+
+    struct truck_state_t
+    {
+        scs_value_dplacement_t world_placement; // truck.world.placement
+        scs_value_fvector_t linear_velocity; // truck.local.velocity.linear
+        scs_value_fvector_t angular_velocity; // truck.local.velocity.angular
+        float speed; // truck.speed, m/s
+        float engine_rpm; // truck.engine.rpm
+        int32_t engine_gear; // truck.engine.gear
+        float effective_steering; // truck.effective.steering
+        float effective_throttle; // truck.effective.throttle
+        float effective_brake; // truck.effective.brake
+        float effective_clutch; // truck.effective.clutch
+        float fuel; // truck.fuel.amount
+        float oil_temperature; // truck.oil.temperature
+        float water_temperature; // truck.water.temperature
+        float battery_voltage; // truck.battery.voltage
+        float odometer; // truck.odometer
+        bool parking_brake; // truck.brake.parking
+        bool engine_enabled; // truck.engine.enabled
+        bool lblinker; // truck.lblinker
+        bool rblinker; // truck.rblinker
+        bool light_low_beam; // truck.light.beam.low
+        bool light_high_beam; // truck.light.beam.high
+        bool wipers; // truck.wipers
+        wheels_soa_t wheels; // truck.wheel.*
+    };
+
+    /**
+     * \brief Per-trailer channels, indexed by the N in trailer.N.*
+     */
+    struct trailers_soa_t
+    {
+        bool connected[ MAX_TRAILERS ]; // trailer.N.connected
+        float cargo_damage[ MAX_TRAILERS ]; // trailer.N.cargo.damage
+        scs_value_dplacement_t world_placement[ MAX_TRAILERS ]; // trailer.N.world.placement
+        scs_value_fvector_t linear_velocity[ MAX_TRAILERS ]; // trailer.N.velocity.linear
+        wheels_soa_t wheels[ MAX_TRAILERS ]; // trailer.N.wheel.*
+    };
+
+    struct telemetry_frame_t
+    {
+        uint64_t frame_index; // number of frame_end events seen before this frame
+        scs_timestamp_t render_time; // microseconds, from frame_start
+        scs_timestamp_t simulation_time;
+        scs_timestamp_t paused_simulation_time;
+        bool paused;
+        bool timer_restart; // SCS_TELEMETRY_FRAME_START_FLAG_timer_restart was set on this frame
+
+        truck_state_t truck;
+        trailers_soa_t trailers;
+    };
+
+    /**
+     * \brief Where one channel of the frame lives, so exporters can walk the frame without naming every member
+     */
+    struct frame_channel_t
+    {
+        const char* name; // full channel name for truck channels, suffix after "wheel." for wheels, trailer index left out for trailers
+        scs_value_type_t type;
+        uint32_t offset; // in truck_state_t / wheels_soa_t / trailers_soa_t
+        uint32_t size; // of one element
+    };
+
+    struct frame_channel_list_t
+    {
+        const frame_channel_t* data;
+        uint32_t count;
+
+        const frame_channel_t* begin() const { return data; }
+        const frame_channel_t* end() const { return data + count; }
+    };
+
+    constexpr uint32_t TRUCK_CHANNEL_COUNT = 22;
+    constexpr uint32_t WHEEL_CHANNEL_COUNT = 8;
+    constexpr uint32_t TRAILER_CHANNEL_COUNT = 4;
+
+    frame_channel_list_t get_truck_channels();
+    frame_channel_list_t get_wheel_channels();
+    frame_channel_list_t get_trailer_channels();
+}
@@ -0,0 +1,55 @@
+#include "frame_store.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace ts_extra_utilities::telemetry
+{
+    static_assert(std::is_trivially_copyable_v< telemetry_frame_t >, "frames are copied with memcpy");
+
+    void CFrameStore::begin_frame( const scs_telemetry_frame_start_t& info, const bool paused )
+    {
+        this->working_.frame_index = this->published_count_.load( std::memory_order_relaxed );
+        this->working_.render_time = info.render_time;
+        this->working_.simulation_time = info.simulation_time;
+        this->working_.paused_simulation_time = info.paused_simulation_time;
+        this->working_.timer_restart = ( info.flags & SCS_TELEMETRY_FRAME_START_FLAG_timer_restart ) != 0;
+        this->working_.paused = paused;
+    }
+
+    void CFrameStore::publish( const telemetry_frame_t& frame )
+    {
+        // always write the buffer readers were not pointed at, they only collide with us if they are a whole frame behind
+        const auto target = this->latest_.load( std::memory_order_relaxed ) ^ 1;
+        auto& buffer = this->buffers_[ target ];
+
+        const auto sequence = buffer.sequence.load( std::memory_order_relaxed );
+        buffer.sequence.store( sequence + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        std::memcpy( &buffer.frame, &frame, sizeof( telemetry_frame_t ) );
+
+        buffer.sequence.store( sequence + 2, std::memory_order_release );
+        this->latest_.store( target, std::memory_order_release );
+        this->published_count_.fetch_add( 1, std::memory_order_release );
+    }
+
+    bool CFrameStore::read( telemetry_frame_t& out, const uint32_t max_attempts ) const
+    {
+        if ( this->published_count_.load( std::memory_order_acquire ) == 0 ) return false;
+
+        for ( uint32_t attempt = 0; attempt < max_attempts; ++attempt )
+        {
+            const auto& buffer = this->buffers_[ this->latest_.load( std::memory_order_acquire ) ];
+
+            const auto before = buffer.sequence.load( std::memory_order_acquire );
+            if ( ( before & 1 ) != 0 ) continue;
+
+            std::memcpy( &out, &buffer.frame, sizeof( telemetry_frame_t ) );
+            std::atomic_thread_fence( std::memory_order_acquire );
+
+            if ( buffer.sequence.load( std::memory_order_relaxed ) == before ) return true;
+        }
+        return false;
+    }
+}
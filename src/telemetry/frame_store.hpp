@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    /**
+     * \brief Collects the channel values of one SDK frame and publishes them as a whole on frame_end.
+     *
+     * Channel callbacks write into the working frame, which is only touched by the SDK thread. Publishing copies it
+     * into the older of two buffers under that buffer's sequence counter and then flips the latest index, so readers
+     * on other threads (render thread, exporters) get the last complete frame without taking a lock and only retry
+     * if they were slow enough for the writer to come back around to the buffer they were copying.
+     */
+    class CFrameStore
+    {
+    private:
+        struct alignas( 64 ) buffer_t
+        {
+            std::atomic< uint64_t > sequence = 0; // odd while being written
+            telemetry_frame_t frame = {};
+        };
+
+        telemetry_frame_t working_ = {};
+        buffer_t buffers_[ 2 ];
+        alignas( 64 ) std::atomic< uint32_t > latest_ = 0;
+        std::atomic< uint64_t > published_count_ = 0;
+
+    public:
+        // SDK thread only
+        telemetry_frame_t& working() { return this->working_; }
+
+        // SDK thread only, called from the frame_start event
+        void begin_frame( const scs_telemetry_frame_start_t& info, bool paused );
+
+        // SDK thread only, called from the frame_end event, publishes the working frame or a filtered copy of it
+        void publish() { this->publish( this->working_ ); }
+        void publish( const telemetry_frame_t& frame );
+
+        /**
+         * \brief Copies the latest published frame into `out`
+         * \return false if nothing has been published yet or the writer kept overtaking us
+         */
+        bool read( telemetry_frame_t& out, uint32_t max_attempts = 8 ) const;
+
+        uint64_t get_published_count() const { return this->published_count_.load( std::memory_order_acquire ); }
+    };
+}
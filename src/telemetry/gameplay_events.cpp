@@ -0,0 +1,246 @@
+#include "gameplay_events.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "common/scssdk_telemetry_common_gameplay_events.h"
+
+namespace ts_extra_utilities::telemetry
+{
+    static_assert(std::is_trivially_copyable_v< gameplay_event_t >, "events are copied with memcpy");
+
+    namespace
+    {
+        struct event_id_t
+        {
+            const char* id;
+            GameplayEventType::Enum type;
+        };
+
+        const event_id_t event_ids[] = {
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_job_cancelled, GameplayEventType::JOB_CANCELLED },
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_job_delivered, GameplayEventType::JOB_DELIVERED },
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_player_fined, GameplayEventType::PLAYER_FINED },
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_player_tollgate_paid, GameplayEventType::PLAYER_TOLLGATE_PAID },
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_player_use_ferry, GameplayEventType::PLAYER_USE_FERRY },
+            { SCS_TELEMETRY_GAMEPLAY_EVENT_player_use_train, GameplayEventType::PLAYER_USE_TRAIN },
+        };
+
+        bool is( const scs_named_value_t& attribute, const char* name )
+        {
+            return std::strcmp( attribute.name, name ) == 0;
+        }
+
+        // money is s64 in the SDK docs, smaller integer types are accepted as well in case a game version narrows it
+        void read( const scs_value_t& value, int64_t& out )
+        {
+            switch ( value.type )
+            {
+                case SCS_VALUE_TYPE_s64: out = value.value_s64.value; break;
+                case SCS_VALUE_TYPE_s32: out = value.value_s32.value; break;
+                case SCS_VALUE_TYPE_u32: out = value.value_u32.value; break;
+                default: break;
+            }
+        }
+
+        void read( const scs_value_t& value, int32_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_s32 ) out = value.value_s32.value;
+        }
+
+        void read( const scs_value_t& value, uint32_t& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_u32 ) out = value.value_u32.value;
+        }
+
+        void read( const scs_value_t& value, float& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_float ) out = value.value_float.value;
+        }
+
+        void read( const scs_value_t& value, bool& out )
+        {
+            if ( value.type == SCS_VALUE_TYPE_bool ) out = value.value_bool.value != 0;
+        }
+
+        // the target is zeroed, so copying at most N - 1 characters keeps it terminated
+        template < size_t N >
+        bool copy_string( const char* value, char ( &out )[ N ] )
+        {
+            if ( value == nullptr ) return false;
+            const auto length = std::strlen( value );
+            std::memcpy( out, value, length < N ? length : N - 1 );
+            return length >= N;
+        }
+
+        template < size_t N >
+        void read( const scs_value_t& value, char ( &out )[ N ], bool& truncated )
+        {
+            if ( value.type != SCS_VALUE_TYPE_string ) return;
+            if ( copy_string( value.value_string.value, out ) ) truncated = true;
+        }
+
+        void parse( const scs_named_value_t* attributes, gameplay_event_t& event )
+        {
+            for ( auto* attribute = attributes; attribute->name != nullptr; ++attribute )
+            {
+                const auto& value = attribute->value;
+                switch ( event.type )
+                {
+                    case GameplayEventType::JOB_CANCELLED:
+                    {
+                        if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_cancel_penalty ) ) read( value, event.job_cancelled.penalty );
+                        break;
+                    }
+                    case GameplayEventType::JOB_DELIVERED:
+                    {
+                        auto& delivered = event.job_delivered;
+                        if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_revenue ) ) read( value, delivered.revenue );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_earned_xp ) ) read( value, delivered.earned_xp );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_cargo_damage ) ) read( value, delivered.cargo_damage );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_distance_km ) ) read( value, delivered.distance_km );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_delivery_time ) ) read( value, delivered.delivery_time );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_auto_park_used ) ) read( value, delivered.auto_park_used );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_auto_load_used ) ) read( value, delivered.auto_load_used );
+                        break;
+                    }
+                    case GameplayEventType::PLAYER_FINED:
+                    {
+                        if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_fine_amount ) ) read( value, event.fine.amount );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_fine_offence ) ) read( value, event.fine.offence, event.truncated );
+                        break;
+                    }
+                    case GameplayEventType::PLAYER_TOLLGATE_PAID:
+                    {
+                        if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_pay_amount ) ) read( value, event.tollgate.pay_amount );
+                        break;
+                    }
+                    case GameplayEventType::PLAYER_USE_FERRY:
+                    case GameplayEventType::PLAYER_USE_TRAIN:
+                    {
+                        auto& transport = event.transport;
+                        if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_pay_amount ) ) read( value, transport.pay_amount );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_source_id ) ) read( value, transport.source_id, event.truncated );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_target_id ) ) read( value, transport.target_id, event.truncated );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_source_name ) ) read( value, transport.source_name, event.truncated );
+                        else if ( is( *attribute, SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_target_name ) ) read( value, transport.target_name, event.truncated );
+                        break;
+                    }
+                    default: return;
+                }
+            }
+        }
+    }
+
+    const char* to_string( const GameplayEventType::Enum type )
+    {
+        switch ( type )
+        {
+            case GameplayEventType::JOB_CANCELLED: return "job cancelled";
+            case GameplayEventType::JOB_DELIVERED: return "job delivered";
+            case GameplayEventType::PLAYER_FINED: return "fined";
+            case GameplayEventType::PLAYER_TOLLGATE_PAID: return "tollgate";
+            case GameplayEventType::PLAYER_USE_FERRY: return "ferry";
+            case GameplayEventType::PLAYER_USE_TRAIN: return "train";
+            default: return "unknown";
+        }
+    }
+
+    int format_gameplay_event( const gameplay_event_t& event, char* buffer, const size_t size )
+    {
+        switch ( event.type )
+        {
+            case GameplayEventType::JOB_CANCELLED:
+            {
+                return snprintf( buffer, size, "job cancelled, penalty %" PRId64, event.job_cancelled.penalty );
+            }
+            case GameplayEventType::JOB_DELIVERED:
+            {
+                const auto& delivered = event.job_delivered;
+                return snprintf( buffer, size, "job delivered, revenue %" PRId64 ", %d xp, damage %.1f%%, %.0f km, %u min%s%s", delivered.revenue,
+                                 delivered.earned_xp, delivered.cargo_damage * 100.0f, delivered.distance_km, delivered.delivery_time,
+                                 delivered.auto_park_used ? ", auto park" : "", delivered.auto_load_used ? ", auto load" : "" );
+            }
+            case GameplayEventType::PLAYER_FINED:
+            {
+                return snprintf( buffer, size, "fined %" PRId64 " for %s", event.fine.amount, event.fine.offence );
+            }
+            case GameplayEventType::PLAYER_TOLLGATE_PAID:
+            {
+                return snprintf( buffer, size, "tollgate, paid %" PRId64, event.tollgate.pay_amount );
+            }
+            case GameplayEventType::PLAYER_USE_FERRY:
+            case GameplayEventType::PLAYER_USE_TRAIN:
+            {
+                const auto& transport = event.transport;
+                return snprintf( buffer, size, "%s %s -> %s, paid %" PRId64, to_string( static_cast< GameplayEventType::Enum >( event.type ) ),
+                                 transport.source_name[ 0 ] != '\0' ? transport.source_name : transport.source_id,
+                                 transport.target_name[ 0 ] != '\0' ? transport.target_name : transport.target_id, transport.pay_amount );
+            }
+            default: return snprintf( buffer, size, "unknown event '%s'", event.id );
+        }
+    }
+
+    void CGameplayEventQueue::push( const scs_telemetry_gameplay_event_t& info, const int64_t render_time, const int64_t simulation_time )
+    {
+        const auto sequence = this->head_.load( std::memory_order_relaxed ) + 1;
+        auto& slot = this->slots_[ ( sequence - 1 ) & ( CAPACITY - 1 ) ];
+
+        slot.sequence.store( 0, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        // parsed straight into the slot, the callback does no other copy and no allocation
+        auto& event = slot.event;
+        std::memset( &event, 0, sizeof( event ) );
+        event.sequence = sequence;
+        event.render_time = render_time;
+        event.simulation_time = simulation_time;
+        event.type = GameplayEventType::UNKNOWN;
+        if ( copy_string( info.id, event.id ) ) event.truncated = true;
+
+        for ( const auto& known : event_ids )
+        {
+            if ( info.id == nullptr || std::strcmp( info.id, known.id ) != 0 ) continue;
+            event.type = known.type;
+            break;
+        }
+        if ( info.attributes != nullptr ) parse( info.attributes, event );
+
+        slot.sequence.store( sequence, std::memory_order_release );
+        this->head_.store( sequence, std::memory_order_release );
+    }
+
+    bool CGameplayEventQueue::poll( gameplay_event_cursor_t& cursor, gameplay_event_t& out ) const
+    {
+        const auto head = this->head_.load( std::memory_order_acquire );
+        while ( cursor.next <= head )
+        {
+            // everything older than the last CAPACITY events is gone already
+            if ( head - cursor.next >= CAPACITY )
+            {
+                cursor.lost += head - CAPACITY + 1 - cursor.next;
+                cursor.next = head - CAPACITY + 1;
+            }
+
+            const auto& slot = this->slots_[ ( cursor.next - 1 ) & ( CAPACITY - 1 ) ];
+            if ( slot.sequence.load( std::memory_order_acquire ) == cursor.next )
+            {
+                std::memcpy( &out, &slot.event, sizeof( gameplay_event_t ) );
+                std::atomic_thread_fence( std::memory_order_acquire );
+
+                if ( slot.sequence.load( std::memory_order_relaxed ) == cursor.next )
+                {
+                    ++cursor.next;
+                    return true;
+                }
+            }
+
+            // the writer came around to this slot while we were reading it
+            ++cursor.lost;
+            ++cursor.next;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "scssdk_telemetry.h"
+
+namespace ts_extra_utilities::telemetry
+{
+    struct GameplayEventType
+    {
+        enum Enum : uint8_t
+        {
+            UNKNOWN, // an id this build doesn't know, only the id is kept
+            JOB_CANCELLED,
+            JOB_DELIVERED,
+            PLAYER_FINED,
+            PLAYER_TOLLGATE_PAID,
+            PLAYER_USE_FERRY,
+            PLAYER_USE_TRAIN,
+        };
+    };
+
+    const char* to_string( GameplayEventType::Enum type );
+
+    /*
+     * Compact copy of one SCS_TELEMETRY_EVENT_gameplay event, the attributes only live for the duration of the
+     * callback so everything is copied into fixed size fields. Strings that don't fit are cut and flagged.
+     */
+
+    struct gameplay_job_cancelled_t // size: 0x0008
+    {
+        int64_t penalty; // 0x0000 (0x08) cancel.penalty
+    };
+
+    struct gameplay_job_delivered_t // size: 0x0020
+    {
+        int64_t revenue; // 0x0000 (0x08) revenue
+        int32_t earned_xp; // 0x0008 (0x04) earned.xp
+        float cargo_damage; // 0x000C (0x04) cargo.damage, 0 - 1
+        float distance_km; // 0x0010 (0x04) distance.km
+        uint32_t delivery_time; // 0x0014 (0x04) delivery.time, game minutes
+        bool auto_park_used; // 0x0018 (0x01) auto.park.used
+        bool auto_load_used; // 0x0019 (0x01) auto.load.used
+        uint8_t pad_001A[ 6 ]; // 0x001A (0x06)
+    };
+
+    struct gameplay_fine_t // size: 0x0028
+    {
+        int64_t amount; // 0x0000 (0x08) fine.amount
+        char offence[ 32 ]; // 0x0008 (0x20) fine.offence
+    };
+
+    struct gameplay_tollgate_t // size: 0x0008
+    {
+        int64_t pay_amount; // 0x0000 (0x08) pay.amount
+    };
+
+    struct gameplay_transport_t // size: 0x0078, ferry and train
+    {
+        int64_t pay_amount; // 0x0000 (0x08) pay.amount
+        char source_id[ 24 ]; // 0x0008 (0x18) source.id
+        char target_id[ 24 ]; // 0x0020 (0x18) target.id
+        char source_name[ 32 ]; // 0x0038 (0x20) source.name
+        char target_name[ 32 ]; // 0x0058 (0x20) target.name
+    };
+
+    static_assert(sizeof( gameplay_job_delivered_t ) == 0x20);
+    static_assert(sizeof( gameplay_fine_t ) == 0x28);
+    static_assert(sizeof( gameplay_transport_t ) == 0x78);
+
+    struct gameplay_event_t // size: 0x00C0
+    {
+        uint64_t sequence; // 0x0000 (0x08) 1-based, gaps mean a subscriber fell behind
+        int64_t render_time; // 0x0008 (0x08) of the last frame_start before the event
+        int64_t simulation_time; // 0x0010 (0x08)
+        uint8_t type; // 0x0018 (0x01) GameplayEventType
+        bool truncated; // 0x0019 (0x01) a string attribute didn't fit
+        uint8_t pad_001A[ 6 ]; // 0x001A (0x06)
+        char id[ 32 ]; // 0x0020 (0x20) SCS_TELEMETRY_GAMEPLAY_EVENT_* as sent by the game
+
+        union // 0x0040 (0x78) selected by type
+        {
+            gameplay_job_cancelled_t job_cancelled;
+            gameplay_job_delivered_t job_delivered;
+            gameplay_fine_t fine;
+            gameplay_tollgate_t tollgate;
+            gameplay_transport_t transport;
+        };
+
+        uint8_t pad_00B8[ 8 ]; // 0x00B8 (0x08)
+    };
+
+    static_assert(sizeof( gameplay_event_t ) == 0xC0);
+    static_assert(offsetof( gameplay_event_t, job_delivered ) == 0x40);
+
+    // "job delivered, revenue 12500, 340 xp, ..." without allocating, returns what snprintf returns
+    int format_gameplay_event( const gameplay_event_t& event, char* buffer, size_t size );
+
+    // read position of one subscriber, every subscriber sees every event unless it falls CAPACITY events behind
+    struct gameplay_event_cursor_t
+    {
+        uint64_t next = 1; // sequence to read next
+        uint64_t lost = 0; // events overwritten before this subscriber got to them
+    };
+
+    /**
+     * \brief Bounded broadcast queue for gameplay events, filled on the SDK thread and drained by any number of subscribers.
+     *
+     * The SDK thread copies the event straight into the next slot and never looks at the readers, so a burst of events
+     * or a stalled subscriber can't hold up the game, the oldest events are overwritten instead. Each subscriber keeps
+     * its own cursor and polls whenever it likes (logger at frame_end, recorder thread, render thread), slots are read
+     * under their sequence number and events that got overwritten while or before being read are counted as lost.
+     */
+    class CGameplayEventQueue
+    {
+    public:
+        static constexpr uint32_t CAPACITY = 64; // must be a power of two
+
+    private:
+        struct alignas( 64 ) slot_t
+        {
+            std::atomic< uint64_t > sequence = 0; // 0 while being written
+            gameplay_event_t event = {};
+        };
+
+        slot_t slots_[ CAPACITY ];
+        alignas( 64 ) std::atomic< uint64_t > head_ = 0; // sequence of the last complete event
+
+    public:
+        // SDK thread only, called from the gameplay event
+        void push( const scs_telemetry_gameplay_event_t& info, int64_t render_time, int64_t simulation_time );
+
+        // a cursor that starts with the next event pushed
+        gameplay_event_cursor_t subscribe() const { return { this->head_.load( std::memory_order_acquire ) + 1, 0 }; }
+
+        /**
+         * \brief Copies the next event for `cursor` into `out`
+         * \return false once the subscriber has caught up
+         */
+        bool poll( gameplay_event_cursor_t& cursor, gameplay_event_t& out ) const;
+
+        uint64_t get_pushed_count() const { return this->head_.load( std::memory_order_acquire ); }
+    };
+}
@@ -0,0 +1,587 @@
+#include "recorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        struct component_t
+        {
+            const char* suffix;
+            ColumnType::Enum type;
+            uint32_t offset;
+        };
+
+        const component_t fvector_components[] = {
+            { ".x", ColumnType::F32, offsetof( scs_value_fvector_t, x ) },
+            { ".y", ColumnType::F32, offsetof( scs_value_fvector_t, y ) },
+            { ".z", ColumnType::F32, offsetof( scs_value_fvector_t, z ) },
+        };
+
+        const component_t dplacement_components[] = {
+            { ".x", ColumnType::F64, offsetof( scs_value_dplacement_t, position ) + offsetof( scs_value_dvector_t, x ) },
+            { ".y", ColumnType::F64, offsetof( scs_value_dplacement_t, position ) + offsetof( scs_value_dvector_t, y ) },
+            { ".z", ColumnType::F64, offsetof( scs_value_dplacement_t, position ) + offsetof( scs_value_dvector_t, z ) },
+            { ".heading", ColumnType::F32, offsetof( scs_value_dplacement_t, orientation ) + offsetof( scs_value_euler_t, heading ) },
+            { ".pitch", ColumnType::F32, offsetof( scs_value_dplacement_t, orientation ) + offsetof( scs_value_euler_t, pitch ) },
+            { ".roll", ColumnType::F32, offsetof( scs_value_dplacement_t, orientation ) + offsetof( scs_value_euler_t, roll ) },
+        };
+
+        void add_column( std::vector< recording_column_t >& columns, const char* prefix, const char* name, const char* suffix,
+                         const ColumnType::Enum type, const uint32_t element, const size_t frame_offset )
+        {
+            recording_column_t column{};
+            snprintf( column.name, sizeof( column.name ), "%s%s%s", prefix, name, suffix );
+            column.element = static_cast< uint16_t >( element );
+            column.type = type;
+            column.frame_offset = static_cast< uint32_t >( frame_offset );
+            columns.push_back( column );
+        }
+
+        // splits vectors and placements into their scalar components
+        void add_channel( std::vector< recording_column_t >& columns, const char* prefix, const frame_channel_t& channel,
+                          const uint32_t element, const size_t frame_offset )
+        {
+            switch ( channel.type )
+            {
+                case SCS_VALUE_TYPE_fvector:
+                {
+                    for ( const auto& component : fvector_components )
+                    {
+                        add_column( columns, prefix, channel.name, component.suffix, component.type, element, frame_offset + component.offset );
+                    }
+                    break;
+                }
+                case SCS_VALUE_TYPE_dplacement:
+                {
+                    for ( const auto& component : dplacement_components )
+                    {
+                        add_column( columns, prefix, channel.name, component.suffix, component.type, element, frame_offset + component.offset );
+                    }
+                    break;
+                }
+                case SCS_VALUE_TYPE_bool: add_column( columns, prefix, channel.name, "", ColumnType::BOOL, element, frame_offset ); break;
+                case SCS_VALUE_TYPE_s32: add_column( columns, prefix, channel.name, "", ColumnType::S32, element, frame_offset ); break;
+                case SCS_VALUE_TYPE_u32: add_column( columns, prefix, channel.name, "", ColumnType::U32, element, frame_offset ); break;
+                case SCS_VALUE_TYPE_float: add_column( columns, prefix, channel.name, "", ColumnType::F32, element, frame_offset ); break;
+                default: break;
+            }
+        }
+
+        // 64 bit offsets, long is 32 bit on windows and a long drive records more than that
+        bool seek( FILE* file, const uint64_t offset, const int origin = SEEK_SET )
+        {
+#ifdef _WIN32
+            return _fseeki64( file, static_cast< int64_t >( offset ), origin ) == 0;
+#else
+            return fseeko( file, static_cast< off_t >( offset ), origin ) == 0;
+#endif
+        }
+
+        uint64_t tell( FILE* file )
+        {
+#ifdef _WIN32
+            return static_cast< uint64_t >( _ftelli64( file ) );
+#else
+            return static_cast< uint64_t >( ftello( file ) );
+#endif
+        }
+
+        uint64_t read_raw( const uint8_t* frame, const recording_column_t& column )
+        {
+            uint64_t raw = 0;
+            std::memcpy( &raw, frame + column.frame_offset, get_column_value_size( static_cast< ColumnType::Enum >( column.type ) ) );
+            return raw;
+        }
+
+        void write_raw( uint8_t* frame, const recording_column_t& column, const uint64_t raw )
+        {
+            std::memcpy( frame + column.frame_offset, &raw, get_column_value_size( static_cast< ColumnType::Enum >( column.type ) ) );
+        }
+    }
+
+    std::vector< recording_column_t > build_recording_columns()
+    {
+        std::vector< recording_column_t > columns;
+
+        add_column( columns, "", "frame.index", "", ColumnType::U64, 0, offsetof( telemetry_frame_t, frame_index ) );
+        add_column( columns, "", "frame.render_time", "", ColumnType::S64, 0, offsetof( telemetry_frame_t, render_time ) );
+        add_column( columns, "", "frame.simulation_time", "", ColumnType::S64, 0, offsetof( telemetry_frame_t, simulation_time ) );
+        add_column( columns, "", "frame.paused_simulation_time", "", ColumnType::S64, 0, offsetof( telemetry_frame_t, paused_simulation_time ) );
+        add_column( columns, "", "frame.paused", "", ColumnType::BOOL, 0, offsetof( telemetry_frame_t, paused ) );
+        add_column( columns, "", "frame.timer_restart", "", ColumnType::BOOL, 0, offsetof( telemetry_frame_t, timer_restart ) );
+
+        for ( const auto& channel : get_truck_channels() )
+        {
+            add_channel( columns, "", channel, 0, offsetof( telemetry_frame_t, truck ) + channel.offset );
+        }
+
+        for ( const auto& channel : get_wheel_channels() )
+        {
+            for ( uint32_t wheel = 0; wheel < MAX_WHEELS; ++wheel )
+            {
+                add_channel( columns, "truck.wheel.", channel, wheel, offsetof( telemetry_frame_t, truck.wheels ) + channel.offset + channel.size * wheel );
+            }
+        }
+
+        for ( const auto& channel : get_trailer_channels() )
+        {
+            for ( uint32_t trailer = 0; trailer < MAX_TRAILERS; ++trailer )
+            {
+                add_channel( columns, "", channel, trailer, offsetof( telemetry_frame_t, trailers ) + channel.offset + channel.size * trailer );
+            }
+        }
+
+        for ( const auto& channel : get_wheel_channels() )
+        {
+            for ( uint32_t trailer = 0; trailer < MAX_TRAILERS; ++trailer )
+            {
+                for ( uint32_t wheel = 0; wheel < MAX_WHEELS; ++wheel )
+                {
+                    add_channel( columns, "trailer.wheel.", channel, trailer * MAX_WHEELS + wheel,
+                                 offsetof( telemetry_frame_t, trailers.wheels ) + sizeof( wheels_soa_t ) * trailer + channel.offset + channel.size * wheel );
+                }
+            }
+        }
+
+        return columns;
+    }
+
+    CTelemetryRecorder::CTelemetryRecorder( const CGameplayEventQueue* gameplay_events ) : gameplay_events_( gameplay_events )
+    {
+        this->queue_ = new CSpscRing< telemetry_frame_t, QUEUE_CAPACITY >();
+        this->columns_ = build_recording_columns();
+        this->encoders_.reserve( this->columns_.size() );
+        for ( const auto& column : this->columns_ )
+        {
+            this->encoders_.emplace_back( static_cast< ColumnType::Enum >( column.type ) );
+        }
+    }
+
+    CTelemetryRecorder::~CTelemetryRecorder()
+    {
+        this->stop();
+        delete this->queue_;
+    }
+
+    bool CTelemetryRecorder::start( const char* path )
+    {
+        if ( this->is_recording() ) return false;
+
+        this->file_ = std::fopen( path, "wb" );
+        if ( this->file_ == nullptr ) return false;
+
+        this->file_offset_ = 0;
+        this->index_.clear();
+        this->block_.clear();
+        this->block_header_ = {};
+        for ( auto& encoder : this->encoders_ ) encoder.reset();
+        this->frames_recorded_ = 0;
+        this->frames_dropped_ = 0;
+        this->bytes_written_ = 0;
+        this->events_recorded_ = 0;
+        if ( this->gameplay_events_ != nullptr ) this->gameplay_cursor_ = this->gameplay_events_->subscribe();
+
+        recording_file_header_t header{};
+        header.magic = RECORDING_MAGIC;
+        header.version = RECORDING_VERSION;
+        header.header_size = sizeof( recording_file_header_t );
+        header.column_count = static_cast< uint32_t >( this->columns_.size() );
+        header.frame_size = sizeof( telemetry_frame_t );
+        header.block_frames = BLOCK_FRAMES;
+        header.created_time = static_cast< uint64_t >( std::time( nullptr ) );
+
+        if ( !this->write( &header, sizeof( header ) ) ||
+             !this->write( this->columns_.data(), sizeof( recording_column_t ) * this->columns_.size() ) )
+        {
+            std::fclose( this->file_ );
+            this->file_ = nullptr;
+            return false;
+        }
+
+        this->recording_.store( true, std::memory_order_release );
+        this->worker_ = std::thread( &CTelemetryRecorder::run, this );
+        return true;
+    }
+
+    void CTelemetryRecorder::stop()
+    {
+        if ( !this->recording_.exchange( false ) ) return;
+        if ( this->worker_.joinable() ) this->worker_.join();
+    }
+
+    void CTelemetryRecorder::push( const telemetry_frame_t& frame )
+    {
+        if ( !this->recording_.load( std::memory_order_relaxed ) ) return;
+
+        auto* slot = this->queue_->begin_push();
+        if ( slot == nullptr )
+        {
+            this->frames_dropped_.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+
+        std::memcpy( slot, &frame, sizeof( telemetry_frame_t ) );
+        this->queue_->commit_push();
+    }
+
+    bool CTelemetryRecorder::write( const void* data, const size_t size )
+    {
+        if ( size == 0 ) return true;
+        if ( std::fwrite( data, size, 1, this->file_ ) != 1 ) return false;
+
+        this->file_offset_ += size;
+        this->bytes_written_.fetch_add( size, std::memory_order_relaxed );
+        return true;
+    }
+
+    void CTelemetryRecorder::run()
+    {
+        while ( true )
+        {
+            this->drain_gameplay_events();
+
+            const auto* frame = this->queue_->begin_pop();
+            if ( frame == nullptr )
+            {
+                // drain everything pushed before stop() before finishing the file
+                if ( !this->recording_.load( std::memory_order_acquire ) && this->queue_->size() == 0 ) break;
+                std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+                continue;
+            }
+
+            this->append( *frame );
+            this->queue_->end_pop();
+        }
+
+        this->drain_gameplay_events();
+        this->flush_block();
+
+        recording_footer_t footer{};
+        footer.index_offset = this->file_offset_;
+        footer.block_count = static_cast< uint32_t >( this->index_.size() );
+        footer.magic = RECORDING_INDEX_MAGIC;
+        this->write( this->index_.data(), sizeof( recording_index_entry_t ) * this->index_.size() );
+        this->write( &footer, sizeof( footer ) );
+
+        std::fclose( this->file_ );
+        this->file_ = nullptr;
+    }
+
+    void CTelemetryRecorder::drain_gameplay_events()
+    {
+        if ( this->gameplay_events_ == nullptr ) return;
+
+        gameplay_event_t event;
+        auto lost = this->gameplay_cursor_.lost;
+        while ( this->gameplay_events_->poll( this->gameplay_cursor_, event ) )
+        {
+            recording_event_header_t header{};
+            header.magic = RECORDING_EVENT_MAGIC;
+            header.event_size = sizeof( gameplay_event_t );
+            header.lost = static_cast< uint32_t >( this->gameplay_cursor_.lost - lost );
+            lost = this->gameplay_cursor_.lost;
+
+            if ( this->write( &header, sizeof( header ) ) && this->write( &event, sizeof( event ) ) )
+            {
+                this->events_recorded_.fetch_add( 1, std::memory_order_relaxed );
+            }
+        }
+    }
+
+    void CTelemetryRecorder::append( const telemetry_frame_t& frame )
+    {
+        if ( this->block_header_.frame_count == 0 )
+        {
+            this->block_header_.first_frame_index = frame.frame_index;
+            this->block_header_.first_render_time = frame.render_time;
+        }
+        this->block_header_.last_render_time = frame.render_time;
+
+        const auto* bytes = reinterpret_cast< const uint8_t* >( &frame );
+        for ( size_t i = 0; i < this->columns_.size(); ++i )
+        {
+            this->encoders_[ i ].append( read_raw( bytes, this->columns_[ i ] ) );
+        }
+
+        this->frames_recorded_.fetch_add( 1, std::memory_order_relaxed );
+        if ( ++this->block_header_.frame_count == BLOCK_FRAMES ) this->flush_block();
+    }
+
+    void CTelemetryRecorder::flush_block()
+    {
+        if ( this->block_header_.frame_count == 0 ) return;
+
+        // zero mask first, most columns are unused wheels/trailers and would otherwise cost a CONSTANT each
+        this->block_.assign( ( this->encoders_.size() + 7 ) / 8, 0 );
+        for ( size_t i = 0; i < this->encoders_.size(); ++i )
+        {
+            if ( !this->encoders_[ i ].is_zero() ) continue;
+            this->block_[ i / 8 ] |= static_cast< uint8_t >( 1 << ( i % 8 ) );
+            this->encoders_[ i ].reset();
+        }
+        for ( auto& encoder : this->encoders_ )
+        {
+            if ( encoder.get_count() != 0 ) encoder.finish( this->block_ );
+        }
+
+        this->block_header_.magic = RECORDING_BLOCK_MAGIC;
+        this->block_header_.payload_size = static_cast< uint32_t >( this->block_.size() );
+
+        recording_index_entry_t entry{};
+        entry.file_offset = this->file_offset_;
+        entry.first_frame_index = this->block_header_.first_frame_index;
+        entry.first_render_time = this->block_header_.first_render_time;
+        entry.last_render_time = this->block_header_.last_render_time;
+
+        if ( this->write( &this->block_header_, sizeof( this->block_header_ ) ) && this->write( this->block_.data(), this->block_.size() ) )
+        {
+            this->index_.push_back( entry );
+        }
+        this->block_header_ = {};
+    }
+
+    CRecordingReader::~CRecordingReader()
+    {
+        this->close();
+    }
+
+    void CRecordingReader::close()
+    {
+        if ( this->file_ != nullptr ) std::fclose( this->file_ );
+        this->file_ = nullptr;
+        this->columns_.clear();
+        this->index_.clear();
+        this->data_offset_ = 0;
+        this->data_end_ = 0;
+        this->index_rebuilt_ = false;
+    }
+
+    bool CRecordingReader::open( const char* path, std::string& error )
+    {
+        this->close();
+
+        this->file_ = std::fopen( path, "rb" );
+        if ( this->file_ == nullptr )
+        {
+            error = std::string( "could not open " ) + path;
+            return false;
+        }
+
+        if ( std::fread( &this->header_, sizeof( this->header_ ), 1, this->file_ ) != 1 || this->header_.magic != RECORDING_MAGIC )
+        {
+            error = "not a telemetry recording";
+            this->close();
+            return false;
+        }
+        if ( this->header_.version == 0 || this->header_.version > RECORDING_VERSION || this->header_.header_size != sizeof( recording_file_header_t ) )
+        {
+            error = "unsupported recording version " + std::to_string( this->header_.version );
+            this->close();
+            return false;
+        }
+
+        this->columns_.resize( this->header_.column_count );
+        if ( !this->columns_.empty() &&
+             std::fread( this->columns_.data(), sizeof( recording_column_t ) * this->columns_.size(), 1, this->file_ ) != 1 )
+        {
+            error = "column table is truncated";
+            this->close();
+            return false;
+        }
+
+        const auto data_offset = sizeof( recording_file_header_t ) + sizeof( recording_column_t ) * this->columns_.size();
+        this->data_offset_ = data_offset;
+
+        seek( this->file_, 0, SEEK_END );
+        const auto file_size = tell( this->file_ );
+
+        recording_footer_t footer{};
+        if ( file_size >= data_offset + sizeof( footer ) )
+        {
+            seek( this->file_, file_size - sizeof( footer ) );
+            if ( std::fread( &footer, sizeof( footer ), 1, this->file_ ) == 1 && footer.magic == RECORDING_INDEX_MAGIC &&
+                 footer.index_offset + sizeof( recording_index_entry_t ) * footer.block_count + sizeof( footer ) == file_size )
+            {
+                this->index_.resize( footer.block_count );
+                seek( this->file_, footer.index_offset );
+                if ( footer.block_count == 0 ||
+                     std::fread( this->index_.data(), sizeof( recording_index_entry_t ) * footer.block_count, 1, this->file_ ) == 1 )
+                {
+                    this->data_end_ = footer.index_offset;
+                    return true;
+                }
+                this->index_.clear();
+            }
+        }
+
+        // no footer, the game (or the recorder) didn't shut down cleanly
+        return this->rebuild_index( data_offset, file_size );
+    }
+
+    bool CRecordingReader::rebuild_index( uint64_t offset, const uint64_t file_size )
+    {
+        this->index_rebuilt_ = true;
+
+        recording_block_header_t block{};
+        while ( offset + sizeof( block ) <= file_size )
+        {
+            seek( this->file_, offset );
+            if ( std::fread( &block, sizeof( block ), 1, this->file_ ) != 1 ) break;
+
+            // event records are smaller than a block header but always longer than one including their event
+            if ( block.magic == RECORDING_EVENT_MAGIC )
+            {
+                recording_event_header_t event{};
+                std::memcpy( &event, &block, sizeof( event ) );
+                if ( offset + sizeof( event ) + event.event_size > file_size ) break;
+                offset += sizeof( event ) + event.event_size;
+                continue;
+            }
+
+            if ( block.magic != RECORDING_BLOCK_MAGIC ) break;
+            if ( offset + sizeof( block ) + block.payload_size > file_size ) break; // cut off mid block
+
+            this->index_.push_back( { offset, block.first_frame_index, block.first_render_time, block.last_render_time } );
+            offset += sizeof( block ) + block.payload_size;
+        }
+        this->data_end_ = offset;
+        return true;
+    }
+
+    uint32_t CRecordingReader::find_block( const int64_t render_time ) const
+    {
+        const auto it = std::upper_bound( this->index_.begin(), this->index_.end(), render_time,
+                                          []( const int64_t time, const recording_index_entry_t& entry ) { return time < entry.first_render_time; } );
+        return it == this->index_.begin() ? 0 : static_cast< uint32_t >( it - this->index_.begin() - 1 );
+    }
+
+    bool CRecordingReader::read_block_columns( const uint32_t block, std::vector< std::vector< uint64_t > >& values, std::string& error ) const
+    {
+        if ( this->file_ == nullptr || block >= this->index_.size() )
+        {
+            error = "block out of range";
+            return false;
+        }
+
+        recording_block_header_t header{};
+        seek( this->file_, this->index_[ block ].file_offset );
+        if ( std::fread( &header, sizeof( header ), 1, this->file_ ) != 1 || header.magic != RECORDING_BLOCK_MAGIC )
+        {
+            error = "bad block header";
+            return false;
+        }
+
+        std::vector< uint8_t > payload( header.payload_size );
+        if ( !payload.empty() && std::fread( payload.data(), payload.size(), 1, this->file_ ) != 1 )
+        {
+            error = "block is truncated";
+            return false;
+        }
+
+        const auto mask_size = ( this->columns_.size() + 7 ) / 8;
+        if ( payload.size() < mask_size )
+        {
+            error = "block is missing its zero mask";
+            return false;
+        }
+
+        values.resize( this->columns_.size() );
+        size_t position = mask_size;
+        for ( size_t i = 0; i < this->columns_.size(); ++i )
+        {
+            if ( payload[ i / 8 ] & ( 1 << ( i % 8 ) ) )
+            {
+                values[ i ].assign( header.frame_count, 0 );
+                continue;
+            }
+
+            values[ i ].resize( header.frame_count );
+            const auto consumed = decode_column( static_cast< ColumnType::Enum >( this->columns_[ i ].type ), payload.data() + position,
+                                                 payload.size() - position, header.frame_count, values[ i ].data() );
+            if ( consumed == 0 )
+            {
+                error = std::string( "could not decode column " ) + this->columns_[ i ].name;
+                return false;
+            }
+            position += consumed;
+        }
+        return true;
+    }
+
+    bool CRecordingReader::read_block( const uint32_t block, std::vector< telemetry_frame_t >& frames, std::string& error ) const
+    {
+        if ( this->header_.frame_size != sizeof( telemetry_frame_t ) )
+        {
+            error = "recording was written with a different frame layout";
+            return false;
+        }
+
+        std::vector< std::vector< uint64_t > > values;
+        if ( !this->read_block_columns( block, values, error ) ) return false;
+
+        const auto frame_count = values.empty() ? 0 : values[ 0 ].size();
+        frames.assign( frame_count, telemetry_frame_t{} );
+        for ( size_t i = 0; i < this->columns_.size(); ++i )
+        {
+            for ( size_t frame = 0; frame < frame_count; ++frame )
+            {
+                write_raw( reinterpret_cast< uint8_t* >( &frames[ frame ] ), this->columns_[ i ], values[ i ][ frame ] );
+            }
+        }
+        return true;
+    }
+
+    bool CRecordingReader::read_events( std::vector< gameplay_event_t >& events, std::string& error ) const
+    {
+        events.clear();
+        if ( this->file_ == nullptr )
+        {
+            error = "no recording open";
+            return false;
+        }
+
+        auto offset = this->data_offset_;
+        recording_block_header_t block{};
+        while ( offset + sizeof( block ) <= this->data_end_ )
+        {
+            seek( this->file_, offset );
+            if ( std::fread( &block, sizeof( block ), 1, this->file_ ) != 1 )
+            {
+                error = "recording is truncated";
+                return false;
+            }
+
+            if ( block.magic == RECORDING_BLOCK_MAGIC )
+            {
+                offset += sizeof( block ) + block.payload_size;
+                continue;
+            }
+            if ( block.magic != RECORDING_EVENT_MAGIC )
+            {
+                error = "unknown record at offset " + std::to_string( offset );
+                return false;
+            }
+
+            recording_event_header_t header{};
+            std::memcpy( &header, &block, sizeof( header ) );
+
+            gameplay_event_t event{};
+            seek( this->file_, offset + sizeof( header ) );
+            if ( std::fread( &event, std::min< size_t >( header.event_size, sizeof( event ) ), 1, this->file_ ) != 1 )
+            {
+                error = "event record is truncated";
+                return false;
+            }
+
+            events.push_back( event );
+            offset += sizeof( header ) + header.event_size;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "columnar.hpp"
+#include "frame.hpp"
+#include "gameplay_events.hpp"
+#include "spsc_ring.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    constexpr uint32_t RECORDING_MAGIC = 0x43525354; // "TSRC"
+    constexpr uint32_t RECORDING_BLOCK_MAGIC = 0x42525354; // "TSRB"
+    constexpr uint32_t RECORDING_INDEX_MAGIC = 0x49525354; // "TSRI"
+    constexpr uint32_t RECORDING_EVENT_MAGIC = 0x45525354; // "TSRE"
+    constexpr uint16_t RECORDING_VERSION = 2; // 2 added gameplay event records
+
+    /*
+     * .tsrec layout:
+     *   recording_file_header_t
+     *   recording_column_t[ column_count ]
+     *   blocks: recording_block_header_t + zero mask (1 bit per column, set if the column was 0 for the whole block)
+     *           + every other column encoded by CColumnEncoder, back to back
+     *           gameplay events are written between the blocks as they arrive: recording_event_header_t + gameplay_event_t,
+     *           they are not part of the block index
+     *   recording_index_entry_t[ block_count ] + recording_footer_t, only written by stop(), the reader rebuilds
+     *   the index by walking the blocks if the game died before that
+     */
+
+    struct recording_file_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) RECORDING_MAGIC
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t header_size; // 0x0006 (0x02)
+        uint32_t column_count; // 0x0008 (0x04)
+        uint32_t frame_size; // 0x000C (0x04) sizeof( telemetry_frame_t ) of the writer, frame_offset is only usable if it matches
+        uint32_t block_frames; // 0x0010 (0x04) frames per block, the last one can be shorter
+        uint32_t pad_0014; // 0x0014 (0x04)
+        uint64_t created_time; // 0x0018 (0x08) unix seconds
+    };
+
+    static_assert(sizeof( recording_file_header_t ) == 0x20);
+
+    struct recording_column_t
+    {
+        char name[ 40 ]; // 0x0000 (0x28) channel name without trailer index, vectors/placements get a .x/.heading/... suffix
+        uint16_t element; // 0x0028 (0x02) wheel index, trailer index or trailer * MAX_WHEELS + wheel
+        uint8_t type; // 0x002A (0x01) ColumnType
+        uint8_t pad_002B; // 0x002B (0x01)
+        uint32_t frame_offset; // 0x002C (0x04) in telemetry_frame_t
+    };
+
+    static_assert(sizeof( recording_column_t ) == 0x30);
+
+    struct recording_block_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) RECORDING_BLOCK_MAGIC
+        uint32_t frame_count; // 0x0004 (0x04)
+        uint64_t first_frame_index; // 0x0008 (0x08)
+        int64_t first_render_time; // 0x0010 (0x08)
+        int64_t last_render_time; // 0x0018 (0x08)
+        uint32_t payload_size; // 0x0020 (0x04) encoded columns following this header
+        uint32_t pad_0024; // 0x0024 (0x04)
+    };
+
+    static_assert(sizeof( recording_block_header_t ) == 0x28);
+
+    struct recording_index_entry_t
+    {
+        uint64_t file_offset; // 0x0000 (0x08) of the block header
+        uint64_t first_frame_index; // 0x0008 (0x08)
+        int64_t first_render_time; // 0x0010 (0x08)
+        int64_t last_render_time; // 0x0018 (0x08)
+    };
+
+    static_assert(sizeof( recording_index_entry_t ) == 0x20);
+
+    struct recording_event_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) RECORDING_EVENT_MAGIC
+        uint32_t event_size; // 0x0004 (0x04) sizeof( gameplay_event_t ) of the writer
+        uint32_t lost; // 0x0008 (0x04) events the recorder missed right before this one
+        uint32_t pad_000C; // 0x000C (0x04)
+    };
+
+    static_assert(sizeof( recording_event_header_t ) == 0x10);
+
+    struct recording_footer_t
+    {
+        uint64_t index_offset; // 0x0000 (0x08)
+        uint32_t block_count; // 0x0008 (0x04)
+        uint32_t magic; // 0x000C (0x04) RECORDING_INDEX_MAGIC
+    };
+
+    static_assert(sizeof( recording_footer_t ) == 0x10);
+
+    // Every scalar of telemetry_frame_t as its own column
+    std::vector< recording_column_t > build_recording_columns();
+
+    /**
+     * \brief Records every published frame into a columnar .tsrec file.
+     *
+     * The SDK thread only copies the frame into a lock-free ring, encoding and file writes happen on the recorder
+     * thread. Frames are dropped (and counted) rather than stalling the game if the ring ever fills up. Gameplay events
+     * are picked up by the recorder thread through its own cursor on the gameplay event queue.
+     */
+    class CTelemetryRecorder
+    {
+    public:
+        static constexpr uint32_t QUEUE_CAPACITY = 256;
+        static constexpr uint32_t BLOCK_FRAMES = 512;
+
+    private:
+        CSpscRing< telemetry_frame_t, QUEUE_CAPACITY >* queue_;
+        const CGameplayEventQueue* gameplay_events_;
+        std::thread worker_;
+        std::atomic< bool > recording_ = false;
+
+        // recorder thread only
+        FILE* file_ = nullptr;
+        uint64_t file_offset_ = 0;
+        std::vector< recording_column_t > columns_;
+        std::vector< CColumnEncoder > encoders_;
+        std::vector< recording_index_entry_t > index_;
+        std::vector< uint8_t > block_;
+        recording_block_header_t block_header_ = {};
+        gameplay_event_cursor_t gameplay_cursor_ = {};
+
+        std::atomic< uint64_t > frames_recorded_ = 0;
+        std::atomic< uint64_t > frames_dropped_ = 0;
+        std::atomic< uint64_t > bytes_written_ = 0;
+        std::atomic< uint64_t > events_recorded_ = 0;
+
+        void run();
+        void drain_gameplay_events();
+        void append( const telemetry_frame_t& frame );
+        bool write( const void* data, size_t size );
+        void flush_block();
+
+    public:
+        explicit CTelemetryRecorder( const CGameplayEventQueue* gameplay_events = nullptr );
+        ~CTelemetryRecorder();
+
+        bool start( const char* path );
+        void stop();
+
+        // SDK thread, called from frame_end
+        void push( const telemetry_frame_t& frame );
+
+        bool is_recording() const { return this->recording_.load( std::memory_order_relaxed ); }
+        uint64_t get_frames_recorded() const { return this->frames_recorded_.load( std::memory_order_relaxed ); }
+        uint64_t get_frames_dropped() const { return this->frames_dropped_.load( std::memory_order_relaxed ); }
+        uint32_t get_queued_frames() const { return this->queue_->size(); } // pushed but not encoded yet
+        uint64_t get_bytes_written() const { return this->bytes_written_.load( std::memory_order_relaxed ); }
+        uint64_t get_events_recorded() const { return this->events_recorded_.load( std::memory_order_relaxed ); }
+    };
+
+    class CRecordingReader
+    {
+    private:
+        FILE* file_ = nullptr;
+        recording_file_header_t header_ = {};
+        std::vector< recording_column_t > columns_;
+        std::vector< recording_index_entry_t > index_;
+        uint64_t data_offset_ = 0;
+        uint64_t data_end_ = 0; // index offset, or the end of the last complete record without a footer
+        bool index_rebuilt_ = false;
+
+        bool rebuild_index( uint64_t data_offset, uint64_t file_size );
+
+    public:
+        CRecordingReader() = default;
+        CRecordingReader( const CRecordingReader& ) = delete;
+        CRecordingReader& operator=( const CRecordingReader& ) = delete;
+        ~CRecordingReader();
+
+        bool open( const char* path, std::string& error );
+        void close();
+
+        const recording_file_header_t& get_header() const { return this->header_; }
+        const std::vector< recording_column_t >& get_columns() const { return this->columns_; }
+        const std::vector< recording_index_entry_t >& get_index() const { return this->index_; }
+
+        // true if the file had no footer (recording wasn't stopped cleanly) and the index was rebuilt from the blocks
+        bool was_index_rebuilt() const { return this->index_rebuilt_; }
+
+        // Block containing render_time (or the closest one before it), render time restarts are not handled
+        uint32_t find_block( int64_t render_time ) const;
+
+        /**
+         * \brief Decodes one block into raw column values, `values[ column ][ frame ]`
+         */
+        bool read_block_columns( uint32_t block, std::vector< std::vector< uint64_t > >& values, std::string& error ) const;
+
+        /**
+         * \brief Decodes one block back into frames, only possible if the file was written with the same frame layout
+         */
+        bool read_block( uint32_t block, std::vector< telemetry_frame_t >& frames, std::string& error ) const;
+
+        /**
+         * \brief Collects the gameplay events of the whole recording, walks the file since events aren't indexed
+         */
+        bool read_events( std::vector< gameplay_event_t >& events, std::string& error ) const;
+    };
+}
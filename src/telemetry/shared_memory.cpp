@@ -0,0 +1,385 @@
+#include "shared_memory.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        static_assert(TRUCK_CHANNEL_COUNT + WHEEL_CHANNEL_COUNT * 2 + TRAILER_CHANNEL_COUNT <= SHARED_MEMORY_MAX_FIELDS);
+
+        uint32_t align_to( const uint32_t value, const uint32_t alignment )
+        {
+            return ( value + alignment - 1 ) & ~( alignment - 1 );
+        }
+
+        /**
+         * \brief Lays the fields out back to back after the slot header, recording the copies needed to fill them.
+         * \return size of the slot in bytes
+         */
+        template < typename Copy >
+        uint32_t build_layout( const uint32_t truck_wheels, const uint32_t trailers, const uint32_t trailer_wheels,
+                               shared_memory_field_t* fields, uint32_t& field_count, std::vector< Copy >& copies )
+        {
+            uint32_t cursor = sizeof( shared_memory_slot_header_t );
+            field_count = 0;
+            copies.clear();
+
+            const auto add_field = [ & ]( const char* prefix, const char* name, const scs_value_type_t type, const uint32_t element_size,
+                                          const uint32_t count, const uint32_t stride )
+            {
+                cursor = align_to( cursor, std::min( element_size, 8u ) );
+
+                auto& field = fields[ field_count++ ];
+                field = {};
+                snprintf( field.name, sizeof( field.name ), "%s%s", prefix, name );
+                field.offset = cursor;
+                field.type = static_cast< uint16_t >( type );
+                field.count = static_cast< uint16_t >( count );
+                field.stride = static_cast< uint16_t >( stride );
+                field.element_size = static_cast< uint16_t >( element_size );
+
+                cursor += element_size * count;
+                return field.offset;
+            };
+
+            for ( const auto& truck_field : get_truck_channels() )
+            {
+                const auto offset = add_field( "", truck_field.name, truck_field.type, truck_field.size, 1, 0 );
+                copies.push_back( { static_cast< uint32_t >( offsetof( telemetry_frame_t, truck ) ) + truck_field.offset, offset, truck_field.size } );
+            }
+
+            for ( const auto& wheel_field : get_wheel_channels() )
+            {
+                if ( truck_wheels == 0 ) break;
+                const auto offset = add_field( "truck.wheel.", wheel_field.name, wheel_field.type, wheel_field.size, truck_wheels, 0 );
+                copies.push_back( { static_cast< uint32_t >( offsetof( telemetry_frame_t, truck.wheels ) ) + wheel_field.offset, offset,
+                                    wheel_field.size * truck_wheels } );
+            }
+
+            for ( const auto& trailer_field : get_trailer_channels() )
+            {
+                if ( trailers == 0 ) break;
+                const auto offset = add_field( "", trailer_field.name, trailer_field.type, trailer_field.size, trailers, 0 );
+                copies.push_back( { static_cast< uint32_t >( offsetof( telemetry_frame_t, trailers ) ) + trailer_field.offset, offset,
+                                    trailer_field.size * trailers } );
+            }
+
+            for ( const auto& wheel_field : get_wheel_channels() )
+            {
+                if ( trailers == 0 || trailer_wheels == 0 ) break;
+                const auto offset = add_field( "trailer.wheel.", wheel_field.name, wheel_field.type, wheel_field.size,
+                                               trailers * trailer_wheels, trailer_wheels );
+
+                // one copy per trailer, the frame keeps MAX_WHEELS entries per trailer while the slot is packed to trailer_wheels
+                for ( uint32_t i = 0; i < trailers; ++i )
+                {
+                    copies.push_back( { static_cast< uint32_t >( offsetof( telemetry_frame_t, trailers.wheels ) + sizeof( wheels_soa_t ) * i ) +
+                                        wheel_field.offset,
+                                        offset + wheel_field.size * trailer_wheels * i,
+                                        wheel_field.size * trailer_wheels } );
+                }
+            }
+
+            return align_to( cursor, 64 );
+        }
+    }
+
+    CSharedMemoryRegion::~CSharedMemoryRegion()
+    {
+        this->close();
+    }
+
+    bool CSharedMemoryRegion::create( const char* name, const size_t size )
+    {
+        this->close();
+        snprintf( this->name_, sizeof( this->name_ ), "%s", name );
+
+#ifdef _WIN32
+        const auto mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast< DWORD >( size ), name );
+        if ( mapping == nullptr ) return false;
+
+        this->data_ = static_cast< uint8_t* >( MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size ) );
+        if ( this->data_ == nullptr )
+        {
+            CloseHandle( mapping );
+            return false;
+        }
+        this->handle_ = mapping;
+#else
+        const int fd = shm_open( name, O_CREAT | O_RDWR, 0644 );
+        if ( fd < 0 ) return false;
+
+        if ( ftruncate( fd, static_cast< off_t >( size ) ) != 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        void* data = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        if ( data == MAP_FAILED )
+        {
+            ::close( fd );
+            return false;
+        }
+        this->data_ = static_cast< uint8_t* >( data );
+        this->handle_ = reinterpret_cast< void* >( static_cast< intptr_t >( fd ) );
+#endif
+
+        this->size_ = size;
+        this->owner_ = true;
+        return true;
+    }
+
+    bool CSharedMemoryRegion::open( const char* name )
+    {
+        this->close();
+        snprintf( this->name_, sizeof( this->name_ ), "%s", name );
+
+#ifdef _WIN32
+        const auto mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, name );
+        if ( mapping == nullptr ) return false;
+
+        this->data_ = static_cast< uint8_t* >( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        if ( this->data_ == nullptr )
+        {
+            CloseHandle( mapping );
+            return false;
+        }
+
+        MEMORY_BASIC_INFORMATION info{};
+        VirtualQuery( this->data_, &info, sizeof( info ) );
+        this->size_ = info.RegionSize;
+        this->handle_ = mapping;
+#else
+        const int fd = shm_open( name, O_RDONLY, 0 );
+        if ( fd < 0 ) return false;
+
+        struct stat info{};
+        if ( fstat( fd, &info ) != 0 || info.st_size <= 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        void* data = mmap( nullptr, static_cast< size_t >( info.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+        if ( data == MAP_FAILED )
+        {
+            ::close( fd );
+            return false;
+        }
+        this->data_ = static_cast< uint8_t* >( data );
+        this->size_ = static_cast< size_t >( info.st_size );
+        this->handle_ = reinterpret_cast< void* >( static_cast< intptr_t >( fd ) );
+#endif
+
+        this->owner_ = false;
+        return true;
+    }
+
+    void CSharedMemoryRegion::close()
+    {
+        if ( this->data_ == nullptr ) return;
+
+#ifdef _WIN32
+        UnmapViewOfFile( this->data_ );
+        CloseHandle( this->handle_ );
+#else
+        munmap( this->data_, this->size_ );
+        ::close( static_cast< int >( reinterpret_cast< intptr_t >( this->handle_ ) ) );
+        // windows drops the mapping with the last handle, posix keeps it until unlinked
+        if ( this->owner_ ) shm_unlink( this->name_ );
+#endif
+
+        this->data_ = nullptr;
+        this->handle_ = nullptr;
+        this->size_ = 0;
+        this->owner_ = false;
+    }
+
+    bool CSharedMemoryExporter::init( const char* name )
+    {
+        // size the slots for the largest layout so reconfiguring never has to remap
+        shared_memory_field_t fields[ SHARED_MEMORY_MAX_FIELDS ];
+        uint32_t field_count = 0;
+        const auto slot_size = build_layout( MAX_WHEELS, MAX_TRAILERS, MAX_WHEELS, fields, field_count, this->copies_ );
+
+        const auto slot_offset = align_to( sizeof( shared_memory_header_t ), 64 );
+        const auto region_size = slot_offset + slot_size * SHARED_MEMORY_RING_CAPACITY;
+        if ( !this->region_.create( name, region_size ) ) return false;
+
+        std::memset( this->region_.data(), 0, region_size );
+        this->header_ = reinterpret_cast< shared_memory_header_t* >( this->region_.data() );
+        this->header_->header_size = sizeof( shared_memory_header_t );
+        this->header_->version = SHARED_MEMORY_VERSION;
+        this->header_->region_size = region_size;
+        this->header_->slot_offset = slot_offset;
+        this->header_->slot_size = slot_size;
+        this->header_->ring_capacity = SHARED_MEMORY_RING_CAPACITY;
+
+        this->configure( 0, 0, 0 );
+
+        // magic last, a reader seeing it can trust the rest of the header
+        std::atomic_thread_fence( std::memory_order_release );
+        this->header_->magic = SHARED_MEMORY_MAGIC;
+        return true;
+    }
+
+    void CSharedMemoryExporter::configure( const uint32_t truck_wheel_count, const uint32_t trailer_count, const uint32_t trailer_wheel_count )
+    {
+        if ( this->header_ == nullptr ) return;
+
+        const auto truck_wheels = std::min( truck_wheel_count, MAX_WHEELS );
+        const auto trailers = std::min( trailer_count, MAX_TRAILERS );
+        const auto trailer_wheels = std::min( trailer_wheel_count, MAX_WHEELS );
+
+        auto* header = this->header_;
+        const auto sequence = header->layout_sequence.load( std::memory_order_relaxed );
+        header->layout_sequence.store( sequence + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        header->truck_wheel_count = truck_wheels;
+        header->trailer_count = trailers;
+        header->trailer_wheel_count = trailer_wheels;
+        build_layout( truck_wheels, trailers, trailer_wheels, header->fields, header->field_count, this->copies_ );
+
+        header->layout_sequence.store( sequence + 2, std::memory_order_release );
+    }
+
+    uint8_t* CSharedMemoryExporter::get_slot( const uint64_t frame ) const
+    {
+        return this->region_.data() + this->header_->slot_offset + this->header_->slot_size * ( frame % this->header_->ring_capacity );
+    }
+
+    void CSharedMemoryExporter::publish( const telemetry_frame_t& frame )
+    {
+        if ( this->header_ == nullptr ) return;
+
+        const auto frame_count = this->header_->frame_count.load( std::memory_order_relaxed );
+        auto* slot = this->get_slot( frame_count );
+        auto* slot_header = reinterpret_cast< shared_memory_slot_header_t* >( slot );
+
+        const auto sequence = slot_header->sequence.load( std::memory_order_relaxed );
+        slot_header->sequence.store( sequence + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        slot_header->frame_index = frame.frame_index;
+        slot_header->render_time = frame.render_time;
+        slot_header->simulation_time = frame.simulation_time;
+        slot_header->paused_simulation_time = frame.paused_simulation_time;
+        slot_header->flags = ( frame.paused ? static_cast< uint32_t >( SharedFrameFlags::PAUSED ) : 0u ) |
+                             ( frame.timer_restart ? static_cast< uint32_t >( SharedFrameFlags::TIMER_RESTART ) : 0u );
+        slot_header->layout_sequence = static_cast< uint32_t >( this->header_->layout_sequence.load( std::memory_order_relaxed ) );
+
+        const auto* source = reinterpret_cast< const uint8_t* >( &frame );
+        for ( const auto& copy : this->copies_ )
+        {
+            std::memcpy( slot + copy.destination, source + copy.source, copy.size );
+        }
+
+        slot_header->sequence.store( sequence + 2, std::memory_order_release );
+        this->header_->frame_count.store( frame_count + 1, std::memory_order_release );
+    }
+
+    bool CSharedMemoryReader::open( const char* name )
+    {
+        this->header_ = nullptr;
+        if ( !this->region_.open( name ) ) return false;
+
+        const auto* header = reinterpret_cast< const shared_memory_header_t* >( this->region_.data() );
+        if ( this->region_.size() < sizeof( shared_memory_header_t ) ||
+             header->magic != SHARED_MEMORY_MAGIC ||
+             header->version != SHARED_MEMORY_VERSION ||
+             header->header_size != sizeof( shared_memory_header_t ) ||
+             this->region_.size() < header->region_size )
+        {
+            this->region_.close();
+            return false;
+        }
+
+        this->header_ = header;
+        return true;
+    }
+
+    bool CSharedMemoryReader::read_fields( std::vector< shared_memory_field_t >& out, const uint32_t max_attempts ) const
+    {
+        if ( this->header_ == nullptr ) return false;
+
+        const auto* header = this->header_;
+        for ( uint32_t attempt = 0; attempt < max_attempts; ++attempt )
+        {
+            const auto layout = header->layout_sequence.load( std::memory_order_acquire );
+            if ( ( layout & 1 ) != 0 ) continue;
+
+            out.resize( std::min( header->field_count, SHARED_MEMORY_MAX_FIELDS ) );
+            if ( !out.empty() ) std::memcpy( out.data(), header->fields, out.size() * sizeof( shared_memory_field_t ) );
+            std::atomic_thread_fence( std::memory_order_acquire );
+
+            if ( header->layout_sequence.load( std::memory_order_relaxed ) == layout ) return true;
+        }
+        out.clear();
+        return false;
+    }
+
+    bool CSharedMemoryReader::find_field( const char* name, shared_memory_field_t& out, const uint32_t max_attempts ) const
+    {
+        std::vector< shared_memory_field_t > fields;
+        if ( !this->read_fields( fields, max_attempts ) ) return false;
+
+        for ( const auto& field : fields )
+        {
+            if ( std::strncmp( field.name, name, sizeof( field.name ) ) == 0 )
+            {
+                out = field;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool CSharedMemoryReader::read_latest( std::vector< uint8_t >& out, const uint32_t max_attempts ) const
+    {
+        if ( this->header_ == nullptr ) return false;
+
+        const auto* header = this->header_;
+        out.resize( header->slot_size );
+
+        for ( uint32_t attempt = 0; attempt < max_attempts; ++attempt )
+        {
+            const auto frame_count = header->frame_count.load( std::memory_order_acquire );
+            if ( frame_count == 0 ) return false;
+
+            const auto layout = header->layout_sequence.load( std::memory_order_acquire );
+            if ( ( layout & 1 ) != 0 ) continue;
+
+            const auto* slot = this->region_.data() + header->slot_offset + header->slot_size * ( ( frame_count - 1 ) % header->ring_capacity );
+            const auto* slot_header = reinterpret_cast< const shared_memory_slot_header_t* >( slot );
+
+            const auto before = slot_header->sequence.load( std::memory_order_acquire );
+            if ( ( before & 1 ) != 0 ) continue;
+
+            std::memcpy( out.data(), slot, header->slot_size );
+            std::atomic_thread_fence( std::memory_order_acquire );
+
+            if ( slot_header->sequence.load( std::memory_order_relaxed ) != before ) continue;
+            if ( header->layout_sequence.load( std::memory_order_relaxed ) != layout ) continue;
+
+            // written before the last configure, the field table doesn't describe it
+            if ( reinterpret_cast< const shared_memory_slot_header_t* >( out.data() )->layout_sequence != static_cast< uint32_t >( layout ) ) continue;
+
+            return true;
+        }
+        return false;
+    }
+}
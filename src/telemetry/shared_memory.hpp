@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    constexpr uint32_t SHARED_MEMORY_MAGIC = 0x4D535354; // "TSSM"
+    constexpr uint16_t SHARED_MEMORY_VERSION = 1;
+    constexpr uint32_t SHARED_MEMORY_RING_CAPACITY = 16;
+    constexpr uint32_t SHARED_MEMORY_MAX_FIELDS = 64;
+
+#ifdef _WIN32
+    constexpr char SHARED_MEMORY_NAME[] = "Local\\TSExtraUtilitiesTelemetry";
+#else
+    constexpr char SHARED_MEMORY_NAME[] = "/ts_extra_utilities_telemetry";
+#endif
+
+    static_assert(std::atomic< uint64_t >::is_always_lock_free, "the shared memory protocol needs lock free 64 bit atomics");
+
+    struct SharedFrameFlags
+    {
+        enum Enum : uint32_t
+        {
+            PAUSED = 1 << 0,
+            TIMER_RESTART = 1 << 1,
+        };
+    };
+
+    /**
+     * \brief Describes where one channel lives inside a ring slot.
+     *
+     * Per-trailer channels are flattened: "trailer.world.placement" has `count` = trailer_count, per-trailer wheel
+     * channels like "trailer.wheel.steering" have `count` = trailer_count * stride with `stride` = trailer_wheel_count.
+     */
+    struct shared_memory_field_t
+    {
+        char name[ 36 ]; // 0x0000 (0x24) SDK channel name with the trailer index left out, 0 terminated
+        uint32_t offset; // 0x0024 (0x04) from the start of the slot
+        uint16_t type; // 0x0028 (0x02) scs_value_type_t
+        uint16_t count; // 0x002A (0x02) number of elements
+        uint16_t stride; // 0x002C (0x02) elements per trailer for per-trailer arrays, 0 otherwise
+        uint16_t element_size; // 0x002E (0x02)
+    };
+
+    static_assert(sizeof( shared_memory_field_t ) == 0x30);
+
+    /**
+     * \brief Start of the mapped region, written once on creation and again whenever the configuration changes the layout.
+     */
+    struct shared_memory_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) SHARED_MEMORY_MAGIC
+        uint16_t version; // 0x0004 (0x02) SHARED_MEMORY_VERSION
+        uint16_t header_size; // 0x0006 (0x02) sizeof( shared_memory_header_t )
+        uint32_t region_size; // 0x0008 (0x04)
+        uint32_t slot_offset; // 0x000C (0x04) first ring slot, from the start of the region
+        uint32_t slot_size; // 0x0010 (0x04) distance between ring slots
+        uint32_t ring_capacity; // 0x0014 (0x04)
+        uint32_t field_count; // 0x0018 (0x04)
+        uint32_t truck_wheel_count; // 0x001C (0x04)
+        uint32_t trailer_count; // 0x0020 (0x04) configured trailers, per-trailer arrays have this many entries
+        uint32_t trailer_wheel_count; // 0x0024 (0x04) highest wheel count over all trailers
+        std::atomic< uint64_t > layout_sequence; // 0x0028 (0x08) odd while the field table is rewritten
+        std::atomic< uint64_t > frame_count; // 0x0030 (0x08) frames published, the latest is in slot ( frame_count - 1 ) % ring_capacity
+        uint8_t pad_0038[ 0x8 ]; // 0x0038 (0x08)
+        shared_memory_field_t fields[ SHARED_MEMORY_MAX_FIELDS ]; // 0x0040 (0xC00)
+    };
+
+    static_assert(sizeof( shared_memory_header_t ) == 0xC40);
+
+    /**
+     * \brief Start of every ring slot, the channel values follow at the offsets given by the field table
+     */
+    struct shared_memory_slot_header_t
+    {
+        std::atomic< uint64_t > sequence; // 0x0000 (0x08) odd while the slot is written
+        uint64_t frame_index; // 0x0008 (0x08)
+        int64_t render_time; // 0x0010 (0x08)
+        int64_t simulation_time; // 0x0018 (0x08)
+        int64_t paused_simulation_time; // 0x0020 (0x08)
+        uint32_t flags; // 0x0028 (0x04) SharedFrameFlags
+        uint32_t layout_sequence; // 0x002C (0x04) low bits of the header layout_sequence the slot was written with
+        uint8_t pad_0030[ 0x10 ]; // 0x0030 (0x10)
+    };
+
+    static_assert(sizeof( shared_memory_slot_header_t ) == 0x40);
+
+    /**
+     * \brief Named, mapped region, CreateFileMapping on windows and shm_open everywhere else
+     */
+    class CSharedMemoryRegion
+    {
+    private:
+        void* handle_ = nullptr;
+        uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+        bool owner_ = false;
+        char name_[ 64 ] = {};
+
+    public:
+        CSharedMemoryRegion() = default;
+        CSharedMemoryRegion( const CSharedMemoryRegion& ) = delete;
+        CSharedMemoryRegion& operator=( const CSharedMemoryRegion& ) = delete;
+        ~CSharedMemoryRegion();
+
+        bool create( const char* name, size_t size );
+        bool open( const char* name );
+        void close();
+
+        uint8_t* data() const { return this->data_; }
+        size_t size() const { return this->size_; }
+    };
+
+    /**
+     * \brief Writes every published frame into a ring of shared memory slots for external readers.
+     *
+     * The layout is computed from the wheel and trailer counts of the configuration event and described in the
+     * header's field table, so a reader needs nothing but the field names. Publishing walks a precomputed list of
+     * copies out of the frame store's working frame, it never looks at names or types per frame.
+     */
+    class CSharedMemoryExporter
+    {
+    private:
+        struct copy_t
+        {
+            uint32_t source; // offset in telemetry_frame_t
+            uint32_t destination; // offset in the slot
+            uint32_t size;
+        };
+
+        CSharedMemoryRegion region_;
+        shared_memory_header_t* header_ = nullptr;
+        std::vector< copy_t > copies_;
+
+        uint8_t* get_slot( uint64_t frame ) const;
+
+    public:
+        bool init( const char* name = SHARED_MEMORY_NAME );
+
+        // Rebuilds the field table, SDK thread only
+        void configure( uint32_t truck_wheel_count, uint32_t trailer_count, uint32_t trailer_wheel_count );
+
+        // SDK thread only, called from frame_end
+        void publish( const telemetry_frame_t& frame );
+
+        bool is_open() const { return this->header_ != nullptr; }
+    };
+
+    /**
+     * \brief Reader side of the protocol, used by the offline tools and anything else that wants to attach
+     */
+    class CSharedMemoryReader
+    {
+    private:
+        CSharedMemoryRegion region_;
+        const shared_memory_header_t* header_ = nullptr;
+
+    public:
+        bool open( const char* name = SHARED_MEMORY_NAME );
+
+        const shared_memory_header_t* get_header() const { return this->header_; }
+
+        /**
+         * \brief Copies the field table, retried while configure() rewrites it
+         * \return false if the writer kept rewriting it
+         */
+        bool read_fields( std::vector< shared_memory_field_t >& out, uint32_t max_attempts = 8 ) const;
+        // a copy of the field named `name` out of a consistent table, false if there is none
+        bool find_field( const char* name, shared_memory_field_t& out, uint32_t max_attempts = 8 ) const;
+
+        /**
+         * \brief Copies the latest complete slot into `out` (slot_size bytes), values can then be read at the field offsets
+         * \return false if nothing was published yet or the writer kept overtaking the read
+         */
+        bool read_latest( std::vector< uint8_t >& out, uint32_t max_attempts = 8 ) const;
+    };
+}
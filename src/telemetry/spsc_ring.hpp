@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace ts_extra_utilities::telemetry
+{
+    /**
+     * \brief Bounded single producer / single consumer ring, the SDK thread pushes and one worker thread pops.
+     *
+     * Neither side ever blocks, a full ring makes try_push fail so the caller decides whether to drop or count.
+     * Slots are written in place (begin_push/commit_push) so large elements like whole frames aren't copied twice.
+     */
+    template < typename T, uint32_t Capacity >
+    class CSpscRing
+    {
+        static_assert(( Capacity & ( Capacity - 1 ) ) == 0, "Capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v< T >);
+
+    private:
+        alignas( 64 ) std::atomic< uint64_t > head_ = 0; // next slot to write, producer owned
+        alignas( 64 ) std::atomic< uint64_t > tail_ = 0; // next slot to read, consumer owned
+        alignas( 64 ) T slots_[ Capacity ];
+
+    public:
+        // Producer: slot to fill or nullptr if the ring is full, nothing is visible until commit_push()
+        T* begin_push()
+        {
+            const auto head = this->head_.load( std::memory_order_relaxed );
+            if ( head - this->tail_.load( std::memory_order_acquire ) >= Capacity ) return nullptr;
+            return &this->slots_[ head & ( Capacity - 1 ) ];
+        }
+
+        void commit_push()
+        {
+            this->head_.store( this->head_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+
+        bool try_push( const T& value )
+        {
+            auto* slot = this->begin_push();
+            if ( slot == nullptr ) return false;
+            *slot = value;
+            this->commit_push();
+            return true;
+        }
+
+        // Consumer: oldest element or nullptr if empty, stays valid until end_pop()
+        const T* begin_pop() const
+        {
+            const auto tail = this->tail_.load( std::memory_order_relaxed );
+            if ( tail == this->head_.load( std::memory_order_acquire ) ) return nullptr;
+            return &this->slots_[ tail & ( Capacity - 1 ) ];
+        }
+
+        void end_pop()
+        {
+            this->tail_.store( this->tail_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+        }
+
+        bool try_pop( T& out )
+        {
+            const auto* slot = this->begin_pop();
+            if ( slot == nullptr ) return false;
+            out = *slot;
+            this->end_pop();
+            return true;
+        }
+
+        uint32_t size() const
+        {
+            return static_cast< uint32_t >( this->head_.load( std::memory_order_acquire ) - this->tail_.load( std::memory_order_acquire ) );
+        }
+
+        static constexpr uint32_t capacity() { return Capacity; }
+    };
+}
@@ -0,0 +1,610 @@
+#include "stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        static_assert(sizeof( sockaddr_in ) == 16);
+
+#ifdef _WIN32
+        using native_socket_t = SOCKET;
+        using socket_length_t = int;
+#else
+        using native_socket_t = int;
+        using socket_length_t = socklen_t;
+#endif
+
+        constexpr uintptr_t NO_SOCKET = ~static_cast< uintptr_t >( 0 );
+
+        native_socket_t native( const uintptr_t socket )
+        {
+            return static_cast< native_socket_t >( socket );
+        }
+
+        // non-blocking UDP socket, winsock is reference counted so every socket starts and cleans it up itself
+        uintptr_t open_socket()
+        {
+#ifdef _WIN32
+            WSADATA data;
+            if ( WSAStartup( MAKEWORD( 2, 2 ), &data ) != 0 ) return NO_SOCKET;
+
+            const auto socket = ::socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+            u_long non_blocking = 1;
+            if ( socket == INVALID_SOCKET || ioctlsocket( socket, FIONBIO, &non_blocking ) != 0 )
+            {
+                if ( socket != INVALID_SOCKET ) closesocket( socket );
+                WSACleanup();
+                return NO_SOCKET;
+            }
+            return static_cast< uintptr_t >( socket );
+#else
+            const auto socket = ::socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+            if ( socket < 0 ) return NO_SOCKET;
+            if ( fcntl( socket, F_SETFL, fcntl( socket, F_GETFL, 0 ) | O_NONBLOCK ) != 0 )
+            {
+                ::close( socket );
+                return NO_SOCKET;
+            }
+            return static_cast< uintptr_t >( socket );
+#endif
+        }
+
+        void close_socket( uintptr_t& socket )
+        {
+            if ( socket == NO_SOCKET ) return;
+#ifdef _WIN32
+            closesocket( native( socket ) );
+            WSACleanup();
+#else
+            ::close( native( socket ) );
+#endif
+            socket = NO_SOCKET;
+        }
+
+        bool wait_readable( const uintptr_t socket, const uint32_t timeout_ms )
+        {
+            fd_set readable;
+            FD_ZERO( &readable );
+            FD_SET( native( socket ), &readable );
+
+            timeval timeout{};
+            timeout.tv_sec = static_cast< long >( timeout_ms / 1000 );
+            timeout.tv_usec = static_cast< long >( timeout_ms % 1000 * 1000 );
+            return select( static_cast< int >( native( socket ) + 1 ), &readable, nullptr, nullptr, &timeout ) > 0;
+        }
+
+        int receive_from( const uintptr_t socket, uint8_t* buffer, const uint32_t size, sockaddr_in& from )
+        {
+            socket_length_t length = sizeof( from );
+            return static_cast< int >( recvfrom( native( socket ), reinterpret_cast< char* >( buffer ), static_cast< int >( size ), 0,
+                                                 reinterpret_cast< sockaddr* >( &from ), &length ) );
+        }
+
+        bool send_to( const uintptr_t socket, const void* data, const uint32_t size, const uint8_t* address )
+        {
+            const auto sent = sendto( native( socket ), static_cast< const char* >( data ), static_cast< int >( size ), 0,
+                                      reinterpret_cast< const sockaddr* >( address ), sizeof( sockaddr_in ) );
+            return sent >= 0 && static_cast< uint32_t >( sent ) == size;
+        }
+
+        // only family, address and port, so addresses compare with memcmp
+        void normalize( const sockaddr_in& address, uint8_t ( &out )[ 16 ] )
+        {
+            sockaddr_in normalized{};
+            normalized.sin_family = AF_INET;
+            normalized.sin_port = address.sin_port;
+            normalized.sin_addr = address.sin_addr;
+            std::memcpy( out, &normalized, sizeof( normalized ) );
+        }
+
+        uint64_t now_ms()
+        {
+            return static_cast< uint64_t >(
+                std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+        }
+
+        uint64_t fnv1a( const uint8_t* data, const uint32_t size, uint64_t hash = 0xcbf29ce484222325ull )
+        {
+            for ( uint32_t i = 0; i < size; ++i ) hash = ( hash ^ data[ i ] ) * 0x100000001b3ull;
+            return hash;
+        }
+    }
+
+    CTelemetryStreamServer::CTelemetryStreamServer() : socket_( NO_SOCKET )
+    {
+        this->queue_ = new CSpscRing< telemetry_frame_t, QUEUE_CAPACITY >();
+        this->subscribers_ = new subscriber_t[ MAX_SUBSCRIBERS ];
+        this->columns_ = build_recording_columns();
+    }
+
+    CTelemetryStreamServer::~CTelemetryStreamServer()
+    {
+        this->stop();
+        delete[] this->subscribers_;
+        delete this->queue_;
+    }
+
+    bool CTelemetryStreamServer::start( const uint16_t port, const bool allow_remote )
+    {
+        if ( this->is_running() ) return false;
+
+        this->socket_ = open_socket();
+        if ( this->socket_ == NO_SOCKET ) return false;
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons( port );
+        address.sin_addr.s_addr = htonl( allow_remote ? INADDR_ANY : INADDR_LOOPBACK );
+        if ( bind( native( this->socket_ ), reinterpret_cast< const sockaddr* >( &address ), sizeof( address ) ) != 0 )
+        {
+            close_socket( this->socket_ );
+            return false;
+        }
+
+        for ( uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i ) this->subscribers_[ i ].active = false;
+        this->subscriber_count_ = 0;
+        this->frames_streamed_ = 0;
+        this->frames_dropped_ = 0;
+        this->datagrams_sent_ = 0;
+        this->bytes_sent_ = 0;
+        this->send_errors_ = 0;
+
+        this->running_.store( true, std::memory_order_release );
+        this->worker_ = std::thread( &CTelemetryStreamServer::run, this );
+        return true;
+    }
+
+    void CTelemetryStreamServer::stop()
+    {
+        if ( !this->running_.exchange( false ) ) return;
+        if ( this->worker_.joinable() ) this->worker_.join();
+
+        // the worker is gone, so this thread is the only consumer left, stale frames must not leak into the next start
+        while ( this->queue_->begin_pop() != nullptr ) this->queue_->end_pop();
+
+        this->subscriber_count_ = 0;
+        close_socket( this->socket_ );
+    }
+
+    void CTelemetryStreamServer::push( const telemetry_frame_t& frame )
+    {
+        if ( !this->running_.load( std::memory_order_relaxed ) || this->subscriber_count_.load( std::memory_order_relaxed ) == 0 ) return;
+
+        auto* slot = this->queue_->begin_push();
+        if ( slot == nullptr )
+        {
+            this->frames_dropped_.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+
+        std::memcpy( slot, &frame, sizeof( telemetry_frame_t ) );
+        this->queue_->commit_push();
+    }
+
+    void CTelemetryStreamServer::run()
+    {
+        while ( this->running_.load( std::memory_order_acquire ) )
+        {
+            // doubles as the idle wait, frames queued meanwhile are picked up at most a millisecond late
+            if ( wait_readable( this->socket_, 1 ) ) this->receive();
+
+            const auto now = now_ms();
+            for ( uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i )
+            {
+                auto& subscriber = this->subscribers_[ i ];
+                if ( !subscriber.active || now - subscriber.last_seen < STREAM_SUBSCRIBER_TIMEOUT_MS ) continue;
+
+                subscriber.active = false;
+                this->subscriber_count_.fetch_sub( 1, std::memory_order_relaxed );
+            }
+
+            while ( const auto* frame = this->queue_->begin_pop() )
+            {
+                for ( uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i )
+                {
+                    if ( this->subscribers_[ i ].active ) this->encode( this->subscribers_[ i ], *frame, now );
+                }
+                this->queue_->end_pop();
+            }
+
+            for ( uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i )
+            {
+                auto& subscriber = this->subscribers_[ i ];
+                if ( subscriber.active && subscriber.batch_frames != 0 && now - subscriber.batch_started >= STREAM_MAX_BATCH_DELAY_MS )
+                {
+                    this->flush( subscriber );
+                }
+            }
+        }
+    }
+
+    void CTelemetryStreamServer::receive()
+    {
+        uint8_t buffer[ STREAM_MAX_DATAGRAM ];
+        sockaddr_in from{};
+
+        int size;
+        while ( ( size = receive_from( this->socket_, buffer, sizeof( buffer ), from ) ) >= 0 )
+        {
+            if ( static_cast< uint32_t >( size ) < sizeof( stream_subscribe_t ) || from.sin_family != AF_INET ) continue;
+
+            uint8_t address[ 16 ];
+            normalize( from, address );
+            this->subscribe( address, buffer, static_cast< uint32_t >( size ), now_ms() );
+        }
+    }
+
+    void CTelemetryStreamServer::subscribe( const uint8_t* address, const uint8_t* data, const uint32_t size, const uint64_t now )
+    {
+        stream_subscribe_t request{};
+        std::memcpy( &request, data, sizeof( request ) );
+        if ( request.version != STREAM_VERSION ) return;
+        if ( request.magic != STREAM_SUBSCRIBE_MAGIC && request.magic != STREAM_UNSUBSCRIBE_MAGIC ) return;
+
+        subscriber_t* subscriber = nullptr;
+        subscriber_t* free = nullptr;
+        for ( uint32_t i = 0; i < MAX_SUBSCRIBERS; ++i )
+        {
+            auto& slot = this->subscribers_[ i ];
+            if ( !slot.active )
+            {
+                if ( free == nullptr ) free = &slot;
+            }
+            else if ( std::memcmp( slot.address, address, sizeof( slot.address ) ) == 0 )
+            {
+                subscriber = &slot;
+            }
+        }
+
+        if ( request.magic == STREAM_UNSUBSCRIBE_MAGIC )
+        {
+            if ( subscriber == nullptr ) return;
+            subscriber->active = false;
+            this->subscriber_count_.fetch_sub( 1, std::memory_order_relaxed );
+            return;
+        }
+
+        const auto* prefixes = reinterpret_cast< const char* >( data + sizeof( request ) );
+        const auto prefixes_size = size - static_cast< uint32_t >( sizeof( request ) );
+        const auto hash = fnv1a( data + offsetof( stream_subscribe_t, prefix_count ), offsetof( stream_subscribe_t, flags ) - offsetof( stream_subscribe_t, prefix_count ),
+                                 fnv1a( data + sizeof( request ), prefixes_size ) );
+
+        if ( subscriber == nullptr )
+        {
+            if ( free == nullptr ) return; // full, the client keeps asking
+            subscriber = free;
+            std::memcpy( subscriber->address, address, sizeof( subscriber->address ) );
+            subscriber->filter_hash = ~hash;
+            subscriber->sequence = 0;
+            subscriber->active = true;
+            this->subscriber_count_.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        subscriber->last_seen = now;
+        if ( subscriber->filter_hash != hash )
+        {
+            subscriber->filter_hash = hash;
+            subscriber->max_batch_frames = request.max_batch_frames;
+            subscriber->frame_divisor = std::max< uint16_t >( request.frame_divisor, 1 );
+            subscriber->frames_seen = 0;
+            subscriber->datagram_size = 0;
+            subscriber->batch_frames = 0;
+            subscriber->schema_id = this->next_schema_id_++;
+            if ( this->next_schema_id_ == 0 ) this->next_schema_id_ = 1;
+
+            this->resolve_columns( *subscriber, prefixes, request.prefix_count, prefixes_size );
+            this->send_schema( *subscriber );
+        }
+        else if ( request.flags & StreamSubscribeFlags::SEND_SCHEMA )
+        {
+            this->send_schema( *subscriber );
+        }
+    }
+
+    void CTelemetryStreamServer::resolve_columns( subscriber_t& subscriber, const char* prefixes, const uint32_t prefix_count, const uint32_t size ) const
+    {
+        // only the prefixes that are fully inside the datagram
+        std::vector< const char* > names;
+        for ( uint32_t offset = 0; names.size() < prefix_count && offset < size; )
+        {
+            const auto* name = prefixes + offset;
+            const auto* end = static_cast< const char* >( std::memchr( name, '\0', size - offset ) );
+            if ( end == nullptr ) break;
+            if ( end != name ) names.push_back( name );
+            offset += static_cast< uint32_t >( end - name ) + 1;
+        }
+
+        subscriber.columns.clear();
+        subscriber.copies.clear();
+        subscriber.frame_size = sizeof( int64_t );
+
+        // whatever doesn't fit into one datagram next to the batch header is left out
+        constexpr uint32_t max_frame_size = STREAM_MAX_DATAGRAM - sizeof( stream_batch_header_t );
+        for ( uint32_t i = 0; i < this->columns_.size(); ++i )
+        {
+            const auto& column = this->columns_[ i ];
+            const auto matches = names.empty() || std::any_of( names.begin(), names.end(), [ &column ]( const char* prefix )
+            {
+                return std::strncmp( column.name, prefix, std::strlen( prefix ) ) == 0;
+            } );
+            if ( !matches ) continue;
+
+            const auto value_size = get_column_value_size( static_cast< ColumnType::Enum >( column.type ) );
+            if ( subscriber.frame_size + value_size > max_frame_size ) break;
+
+            subscriber.columns.push_back( static_cast< uint16_t >( i ) );
+            subscriber.frame_size += value_size;
+
+            auto& copies = subscriber.copies;
+            if ( !copies.empty() && copies.back().frame_offset + copies.back().size == column.frame_offset ) copies.back().size += value_size;
+            else copies.push_back( { column.frame_offset, value_size } );
+        }
+    }
+
+    void CTelemetryStreamServer::send_schema( subscriber_t& subscriber )
+    {
+        constexpr uint32_t columns_per_part = ( STREAM_MAX_DATAGRAM - sizeof( stream_schema_header_t ) ) / sizeof( recording_column_t );
+
+        uint8_t buffer[ STREAM_MAX_DATAGRAM ];
+        const auto total = static_cast< uint32_t >( subscriber.columns.size() );
+        for ( uint32_t first = 0; first == 0 || first < total; first += columns_per_part )
+        {
+            const auto count = std::min( columns_per_part, total - first );
+
+            stream_schema_header_t header{};
+            header.magic = STREAM_SCHEMA_MAGIC;
+            header.version = STREAM_VERSION;
+            header.schema_id = subscriber.schema_id;
+            header.first_column = static_cast< uint16_t >( first );
+            header.column_count = static_cast< uint16_t >( count );
+            header.total_columns = static_cast< uint16_t >( total );
+            header.frame_size = static_cast< uint16_t >( subscriber.frame_size );
+            std::memcpy( buffer, &header, sizeof( header ) );
+
+            for ( uint32_t i = 0; i < count; ++i )
+            {
+                std::memcpy( buffer + sizeof( header ) + sizeof( recording_column_t ) * i, &this->columns_[ subscriber.columns[ first + i ] ],
+                             sizeof( recording_column_t ) );
+            }
+            this->send( subscriber, buffer, static_cast< uint32_t >( sizeof( header ) + sizeof( recording_column_t ) * count ) );
+            if ( total == 0 ) break;
+        }
+    }
+
+    void CTelemetryStreamServer::encode( subscriber_t& subscriber, const telemetry_frame_t& frame, const uint64_t now )
+    {
+        if ( subscriber.frames_seen++ % subscriber.frame_divisor != 0 ) return;
+
+        if ( subscriber.datagram_size + subscriber.frame_size > STREAM_MAX_DATAGRAM ) this->flush( subscriber );
+        if ( subscriber.batch_frames == 0 )
+        {
+            subscriber.datagram_size = sizeof( stream_batch_header_t );
+            subscriber.batch_frame_index = frame.frame_index;
+            subscriber.batch_started = now;
+        }
+
+        auto* cursor = subscriber.datagram + subscriber.datagram_size;
+        const auto render_time = static_cast< int64_t >( frame.render_time );
+        std::memcpy( cursor, &render_time, sizeof( render_time ) );
+        cursor += sizeof( render_time );
+
+        const auto* bytes = reinterpret_cast< const uint8_t* >( &frame );
+        for ( const auto& copy : subscriber.copies )
+        {
+            std::memcpy( cursor, bytes + copy.frame_offset, copy.size );
+            cursor += copy.size;
+        }
+
+        subscriber.datagram_size += subscriber.frame_size;
+        this->frames_streamed_.fetch_add( 1, std::memory_order_relaxed );
+        if ( ++subscriber.batch_frames == subscriber.max_batch_frames ) this->flush( subscriber );
+    }
+
+    void CTelemetryStreamServer::flush( subscriber_t& subscriber )
+    {
+        if ( subscriber.batch_frames == 0 ) return;
+
+        stream_batch_header_t header{};
+        header.magic = STREAM_BATCH_MAGIC;
+        header.version = STREAM_VERSION;
+        header.schema_id = subscriber.schema_id;
+        header.sequence = ++subscriber.sequence;
+        header.frame_count = subscriber.batch_frames;
+        header.frame_size = static_cast< uint16_t >( subscriber.frame_size );
+        header.first_frame_index = subscriber.batch_frame_index;
+        std::memcpy( subscriber.datagram, &header, sizeof( header ) );
+
+        this->send( subscriber, subscriber.datagram, subscriber.datagram_size );
+        subscriber.datagram_size = 0;
+        subscriber.batch_frames = 0;
+    }
+
+    bool CTelemetryStreamServer::send( const subscriber_t& subscriber, const void* data, const uint32_t size )
+    {
+        // a full socket buffer drops the datagram, the client sees the sequence gap
+        if ( !send_to( this->socket_, data, size, subscriber.address ) )
+        {
+            this->send_errors_.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        this->datagrams_sent_.fetch_add( 1, std::memory_order_relaxed );
+        this->bytes_sent_.fetch_add( size, std::memory_order_relaxed );
+        return true;
+    }
+
+    CTelemetryStreamClient::CTelemetryStreamClient() : socket_( NO_SOCKET )
+    {
+    }
+
+    CTelemetryStreamClient::~CTelemetryStreamClient()
+    {
+        this->disconnect();
+    }
+
+    bool CTelemetryStreamClient::connect( const char* host, const uint16_t port, const std::vector< std::string >& prefixes,
+                                          const uint16_t max_batch_frames, const uint16_t frame_divisor )
+    {
+        this->disconnect();
+
+        sockaddr_in server{};
+        server.sin_family = AF_INET;
+        server.sin_port = htons( port );
+        if ( inet_pton( AF_INET, host, &server.sin_addr ) != 1 ) return false;
+        std::memcpy( this->server_, &server, sizeof( server ) );
+
+        this->socket_ = open_socket();
+        if ( this->socket_ == NO_SOCKET ) return false;
+
+        stream_subscribe_t request{};
+        request.magic = STREAM_SUBSCRIBE_MAGIC;
+        request.version = STREAM_VERSION;
+        request.prefix_count = static_cast< uint16_t >( prefixes.size() );
+        request.max_batch_frames = max_batch_frames;
+        request.frame_divisor = frame_divisor;
+
+        this->subscription_.assign( reinterpret_cast< const uint8_t* >( &request ), reinterpret_cast< const uint8_t* >( &request + 1 ) );
+        for ( const auto& prefix : prefixes ) this->subscription_.insert( this->subscription_.end(), prefix.c_str(), prefix.c_str() + prefix.size() + 1 );
+
+        this->columns_.clear();
+        this->column_received_.clear();
+        this->schema_id_ = 0;
+        this->schema_received_ = 0;
+        this->next_sequence_ = 0;
+        this->stats_ = {};
+
+        this->send_subscription();
+        return true;
+    }
+
+    void CTelemetryStreamClient::disconnect()
+    {
+        if ( this->socket_ == NO_SOCKET ) return;
+
+        stream_subscribe_t request{};
+        request.magic = STREAM_UNSUBSCRIBE_MAGIC;
+        request.version = STREAM_VERSION;
+        send_to( this->socket_, &request, sizeof( request ), this->server_ );
+        close_socket( this->socket_ );
+    }
+
+    void CTelemetryStreamClient::send_subscription()
+    {
+        auto* request = reinterpret_cast< stream_subscribe_t* >( this->subscription_.data() );
+        request->flags = this->has_schema() ? StreamSubscribeFlags::NONE : StreamSubscribeFlags::SEND_SCHEMA;
+
+        send_to( this->socket_, this->subscription_.data(), static_cast< uint32_t >( this->subscription_.size() ), this->server_ );
+        this->last_subscribe_ = now_ms();
+    }
+
+    uint32_t CTelemetryStreamClient::poll( const uint32_t timeout_ms, const frame_callback_t callback, void* user_data )
+    {
+        if ( this->socket_ == NO_SOCKET ) return 0;
+
+        // keepalive, and a retry while the server isn't up yet or the schema went missing
+        if ( now_ms() - this->last_subscribe_ >= ( this->has_schema() ? 1000u : 200u ) ) this->send_subscription();
+
+        if ( !wait_readable( this->socket_, timeout_ms ) ) return 0;
+
+        uint8_t buffer[ STREAM_MAX_DATAGRAM ];
+        sockaddr_in from{};
+        uint32_t frames = 0;
+
+        int size;
+        while ( ( size = receive_from( this->socket_, buffer, sizeof( buffer ), from ) ) >= 0 )
+        {
+            frames += this->handle( buffer, static_cast< uint32_t >( size ), callback, user_data );
+        }
+        return frames;
+    }
+
+    uint32_t CTelemetryStreamClient::handle( const uint8_t* data, const uint32_t size, const frame_callback_t callback, void* user_data )
+    {
+        if ( size < sizeof( uint32_t ) ) return 0;
+
+        uint32_t magic;
+        std::memcpy( &magic, data, sizeof( magic ) );
+
+        if ( magic == STREAM_SCHEMA_MAGIC && size >= sizeof( stream_schema_header_t ) )
+        {
+            stream_schema_header_t header{};
+            std::memcpy( &header, data, sizeof( header ) );
+            if ( header.version != STREAM_VERSION ) return 0;
+            if ( size < sizeof( header ) + sizeof( recording_column_t ) * header.column_count ) return 0;
+            if ( header.first_column + header.column_count > header.total_columns ) return 0;
+
+            if ( header.schema_id != this->schema_id_ || this->columns_.size() != header.total_columns )
+            {
+                this->schema_id_ = header.schema_id;
+                this->frame_size_ = header.frame_size;
+                this->columns_.assign( header.total_columns, recording_column_t{} );
+                this->column_received_.assign( header.total_columns, 0 );
+                this->schema_received_ = 0;
+            }
+
+            for ( uint32_t i = 0; i < header.column_count; ++i )
+            {
+                const auto column = header.first_column + i;
+                std::memcpy( &this->columns_[ column ], data + sizeof( header ) + sizeof( recording_column_t ) * i, sizeof( recording_column_t ) );
+                if ( this->column_received_[ column ] == 0 ) ++this->schema_received_;
+                this->column_received_[ column ] = 1;
+            }
+            return 0;
+        }
+
+        if ( magic != STREAM_BATCH_MAGIC || size < sizeof( stream_batch_header_t ) ) return 0;
+
+        stream_batch_header_t header{};
+        std::memcpy( &header, data, sizeof( header ) );
+        if ( header.version != STREAM_VERSION ) return 0;
+
+        ++this->stats_.datagrams;
+        this->stats_.bytes += size;
+        if ( this->next_sequence_ != 0 && header.sequence > this->next_sequence_ ) this->stats_.lost_datagrams += header.sequence - this->next_sequence_;
+        this->next_sequence_ = header.sequence + 1;
+
+        // batches of an older subscription or before the whole schema arrived can't be decoded
+        if ( header.schema_id != this->schema_id_ || !this->has_schema() || header.frame_size != this->frame_size_ ) return 0;
+        if ( size < sizeof( header ) + static_cast< uint32_t >( header.frame_size ) * header.frame_count ) return 0;
+
+        this->values_.resize( this->columns_.size() );
+        const auto* cursor = data + sizeof( header );
+        for ( uint32_t frame = 0; frame < header.frame_count; ++frame )
+        {
+            int64_t render_time;
+            std::memcpy( &render_time, cursor, sizeof( render_time ) );
+            cursor += sizeof( render_time );
+
+            for ( size_t i = 0; i < this->columns_.size(); ++i )
+            {
+                const auto value_size = get_column_value_size( static_cast< ColumnType::Enum >( this->columns_[ i ].type ) );
+                this->values_[ i ] = 0;
+                std::memcpy( &this->values_[ i ], cursor, value_size );
+                cursor += value_size;
+            }
+
+            ++this->stats_.frames;
+            if ( callback != nullptr )
+            {
+                callback( header.first_frame_index + frame, render_time, this->values_.data(), static_cast< uint32_t >( this->values_.size() ), user_data );
+            }
+        }
+        return header.frame_count;
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame.hpp"
+#include "recorder.hpp"
+#include "spsc_ring.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    constexpr uint16_t STREAM_DEFAULT_PORT = 45454;
+    constexpr uint32_t STREAM_SUBSCRIBE_MAGIC = 0x53535354; // "TSSS"
+    constexpr uint32_t STREAM_UNSUBSCRIBE_MAGIC = 0x55535354; // "TSSU"
+    constexpr uint32_t STREAM_SCHEMA_MAGIC = 0x48535354; // "TSSH"
+    constexpr uint32_t STREAM_BATCH_MAGIC = 0x42535354; // "TSSB"
+    constexpr uint16_t STREAM_VERSION = 1;
+    constexpr uint32_t STREAM_MAX_DATAGRAM = 1400; // fits an ethernet MTU, nothing gets fragmented on the way to another machine
+    constexpr uint32_t STREAM_SUBSCRIBER_TIMEOUT_MS = 5000; // clients re-send their subscription as keepalive
+    constexpr uint32_t STREAM_MAX_BATCH_DELAY_MS = 50; // a partly filled batch is sent after this, e.g. while the game is paused
+
+    struct StreamSubscribeFlags
+    {
+        enum Enum : uint32_t
+        {
+            NONE = 0,
+            SEND_SCHEMA = 1 << 0, // the client is missing (part of) the schema, sent again even if nothing changed
+        };
+    };
+
+    /*
+     * UDP protocol, everything little endian:
+     *   client -> server  stream_subscribe_t + prefix_count nul terminated channel name prefixes (none = every channel),
+     *                     sent again at least every few seconds, a changed subscription gets a new schema
+     *   client -> server  stream_subscribe_t with STREAM_UNSUBSCRIBE_MAGIC
+     *   server -> client  stream_schema_header_t + recording_column_t[ column_count ], split over several datagrams if
+     *                     needed, the columns are named like the .tsrec columns
+     *   server -> client  stream_batch_header_t + frame_count frames, each the render time (s64) followed by the raw
+     *                     values of the schema's columns back to back at their ColumnType size
+     */
+
+    struct stream_subscribe_t
+    {
+        uint32_t magic; // 0x0000 (0x04) STREAM_SUBSCRIBE_MAGIC or STREAM_UNSUBSCRIBE_MAGIC
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t prefix_count; // 0x0006 (0x02)
+        uint16_t max_batch_frames; // 0x0008 (0x02) frames per datagram at most, 0 = as many as fit
+        uint16_t frame_divisor; // 0x000A (0x02) only every Nth published frame, 0 and 1 = all of them
+        uint32_t flags; // 0x000C (0x04) StreamSubscribeFlags
+    };
+
+    static_assert(sizeof( stream_subscribe_t ) == 0x10);
+
+    struct stream_schema_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) STREAM_SCHEMA_MAGIC
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t schema_id; // 0x0006 (0x02) batches refer to it, changes with every new subscription
+        uint16_t first_column; // 0x0008 (0x02) of this part
+        uint16_t column_count; // 0x000A (0x02) in this part
+        uint16_t total_columns; // 0x000C (0x02)
+        uint16_t frame_size; // 0x000E (0x02) bytes per frame in a batch
+    };
+
+    static_assert(sizeof( stream_schema_header_t ) == 0x10);
+
+    struct stream_batch_header_t
+    {
+        uint32_t magic; // 0x0000 (0x04) STREAM_BATCH_MAGIC
+        uint16_t version; // 0x0004 (0x02)
+        uint16_t schema_id; // 0x0006 (0x02)
+        uint32_t sequence; // 0x0008 (0x04) per subscriber, gaps are lost datagrams
+        uint16_t frame_count; // 0x000C (0x02)
+        uint16_t frame_size; // 0x000E (0x02)
+        uint64_t first_frame_index; // 0x0010 (0x08)
+    };
+
+    static_assert(sizeof( stream_batch_header_t ) == 0x18);
+
+    /**
+     * \brief Streams published frames to UDP subscribers, several frames per datagram and only the channels each one asked for.
+     *
+     * The SDK thread only copies the frame into a lock-free ring like the recorder does, and only while someone is
+     * subscribed. The server thread answers subscriptions, encodes every frame into each subscriber's datagram buffer
+     * and sends it once it's full or the subscriber's batch size is reached. Subscriber slots and their buffers are
+     * allocated with the server, nothing on the send path allocates and a slow network never reaches the game.
+     * Binds to loopback unless other machines are explicitly allowed.
+     */
+    class CTelemetryStreamServer
+    {
+    public:
+        static constexpr uint32_t QUEUE_CAPACITY = 64;
+        static constexpr uint32_t MAX_SUBSCRIBERS = 8;
+
+    private:
+        struct copy_t
+        {
+            uint32_t frame_offset;
+            uint32_t size;
+        };
+
+        struct subscriber_t
+        {
+            bool active = false;
+            uint8_t address[ 16 ] = {}; // sockaddr_in
+            uint64_t last_seen = 0; // steady clock, ms
+            uint64_t filter_hash = 0;
+            uint16_t schema_id = 0;
+            uint16_t max_batch_frames = 0;
+            uint16_t frame_divisor = 1;
+            uint32_t frame_size = 0;
+            uint32_t sequence = 0;
+            uint64_t frames_seen = 0;
+            std::vector< uint16_t > columns; // indices into columns_
+            std::vector< copy_t > copies; // the same columns with neighbouring values merged into one copy
+
+            uint8_t datagram[ STREAM_MAX_DATAGRAM ] = {};
+            uint32_t datagram_size = 0;
+            uint16_t batch_frames = 0;
+            uint64_t batch_frame_index = 0;
+            uint64_t batch_started = 0;
+        };
+
+        CSpscRing< telemetry_frame_t, QUEUE_CAPACITY >* queue_;
+        std::thread worker_;
+        std::atomic< bool > running_ = false;
+        std::atomic< uint32_t > subscriber_count_ = 0;
+
+        // server thread only
+        uintptr_t socket_;
+        std::vector< recording_column_t > columns_;
+        subscriber_t* subscribers_;
+        uint16_t next_schema_id_ = 1;
+
+        std::atomic< uint64_t > frames_streamed_ = 0;
+        std::atomic< uint64_t > frames_dropped_ = 0;
+        std::atomic< uint64_t > datagrams_sent_ = 0;
+        std::atomic< uint64_t > bytes_sent_ = 0;
+        std::atomic< uint64_t > send_errors_ = 0;
+
+        void run();
+        void receive();
+        void subscribe( const uint8_t* address, const uint8_t* data, uint32_t size, uint64_t now );
+        void resolve_columns( subscriber_t& subscriber, const char* prefixes, uint32_t prefix_count, uint32_t size ) const;
+        void send_schema( subscriber_t& subscriber );
+        void encode( subscriber_t& subscriber, const telemetry_frame_t& frame, uint64_t now );
+        void flush( subscriber_t& subscriber );
+        bool send( const subscriber_t& subscriber, const void* data, uint32_t size );
+
+    public:
+        CTelemetryStreamServer();
+        CTelemetryStreamServer( const CTelemetryStreamServer& ) = delete;
+        CTelemetryStreamServer& operator=( const CTelemetryStreamServer& ) = delete;
+        ~CTelemetryStreamServer();
+
+        /**
+         * \brief Opens the socket and starts the server thread
+         * \param allow_remote bind to every interface instead of loopback only
+         */
+        bool start( uint16_t port = STREAM_DEFAULT_PORT, bool allow_remote = false );
+        void stop();
+
+        // SDK thread, called from frame_end
+        void push( const telemetry_frame_t& frame );
+
+        bool is_running() const { return this->running_.load( std::memory_order_relaxed ); }
+        uint32_t get_subscriber_count() const { return this->subscriber_count_.load( std::memory_order_relaxed ); }
+        uint64_t get_frames_streamed() const { return this->frames_streamed_.load( std::memory_order_relaxed ); }
+        uint64_t get_frames_dropped() const { return this->frames_dropped_.load( std::memory_order_relaxed ); }
+        uint32_t get_queued_frames() const { return this->queue_->size(); } // pushed but not encoded yet
+        uint64_t get_datagrams_sent() const { return this->datagrams_sent_.load( std::memory_order_relaxed ); }
+        uint64_t get_bytes_sent() const { return this->bytes_sent_.load( std::memory_order_relaxed ); }
+        uint64_t get_send_errors() const { return this->send_errors_.load( std::memory_order_relaxed ); }
+    };
+
+    /**
+     * \brief Portable client for CTelemetryStreamServer, used by the tools and anything else on the rig.
+     */
+    class CTelemetryStreamClient
+    {
+    public:
+        // raw column values of one frame in schema order, see get_columns()
+        using frame_callback_t = void ( * )( uint64_t frame_index, int64_t render_time, const uint64_t* values, uint32_t count, void* user_data );
+
+        struct stats_t
+        {
+            uint64_t datagrams = 0;
+            uint64_t frames = 0;
+            uint64_t bytes = 0;
+            uint64_t lost_datagrams = 0; // sequence gaps
+        };
+
+    private:
+        uintptr_t socket_;
+        uint8_t server_[ 16 ] = {}; // sockaddr_in
+        std::vector< uint8_t > subscription_;
+        uint64_t last_subscribe_ = 0;
+
+        std::vector< recording_column_t > columns_;
+        uint16_t schema_id_ = 0;
+        uint16_t frame_size_ = 0;
+        std::vector< uint8_t > column_received_;
+        uint32_t schema_received_ = 0;
+        uint32_t next_sequence_ = 0; // 0 until the first batch
+        std::vector< uint64_t > values_;
+        stats_t stats_;
+
+        void send_subscription();
+        uint32_t handle( const uint8_t* data, uint32_t size, frame_callback_t callback, void* user_data );
+
+    public:
+        CTelemetryStreamClient();
+        CTelemetryStreamClient( const CTelemetryStreamClient& ) = delete;
+        CTelemetryStreamClient& operator=( const CTelemetryStreamClient& ) = delete;
+        ~CTelemetryStreamClient();
+
+        bool connect( const char* host, uint16_t port, const std::vector< std::string >& prefixes, uint16_t max_batch_frames = 0,
+                      uint16_t frame_divisor = 1 );
+        void disconnect();
+
+        /**
+         * \brief Waits up to `timeout_ms` for datagrams and hands every decoded frame to `callback`, also keeps the subscription alive
+         * \return frames delivered
+         */
+        uint32_t poll( uint32_t timeout_ms, frame_callback_t callback, void* user_data );
+
+        // complete once every part of the current schema arrived, frames are only delivered after that
+        bool has_schema() const { return !this->columns_.empty() && this->schema_received_ == this->columns_.size(); }
+        const std::vector< recording_column_t >& get_columns() const { return this->columns_; }
+        const stats_t& get_stats() const { return this->stats_; }
+    };
+}
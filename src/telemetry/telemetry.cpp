@@ -0,0 +1,336 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "common/scssdk_telemetry_trailer_common_channels.h"
+#include "common/scssdk_telemetry_truck_common_channels.h"
+
+#include "debug/flight_recorder.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    namespace
+    {
+        struct default_filter_t
+        {
+            const char* channel;
+            channel_filter_rule_t rule;
+        };
+
+        // gauges that change a little nearly every frame, steps below these are not visible on any dashboard
+        const default_filter_t default_filters[] = {
+            { SCS_TELEMETRY_TRUCK_CHANNEL_oil_temperature, { 10, 0.1f } },
+            { SCS_TELEMETRY_TRUCK_CHANNEL_water_temperature, { 10, 0.1f } },
+            { SCS_TELEMETRY_TRUCK_CHANNEL_battery_voltage, { 1, 0.05f, 30, FilterAggregate::MEAN } },
+            { SCS_TELEMETRY_TRUCK_CHANNEL_odometer, { 1, 0.01f } }, // km
+            { SCS_TELEMETRY_TRUCK_CHANNEL_fuel, { 1, 0.1f } }, // litres
+        };
+    }
+
+    CTelemetry::CTelemetry( const scs_telemetry_init_params_v101_t* init_params ) : init_params_( init_params )
+    {
+        if ( init_params != nullptr ) this->scs_log_ = init_params->common.log;
+        this->bindings_ = new CChannelBindings( init_params );
+        this->configuration_ = new CConfiguration();
+        this->configuration_->subscribe( ConfigurationPart::TRUCK | ConfigurationPart::TRAILER, on_configuration_changed, this );
+        this->filter_ = new CChannelFilter();
+        this->frame_store_ = new CFrameStore();
+        this->gameplay_events_ = new CGameplayEventQueue();
+        this->log_cursor_ = this->gameplay_events_->subscribe();
+        this->shared_memory_ = new CSharedMemoryExporter();
+        this->recorder_ = new CTelemetryRecorder( this->gameplay_events_ );
+        this->stream_ = new CTelemetryStreamServer();
+    }
+
+    CTelemetry::~CTelemetry()
+    {
+        // the SDK drops the registrations itself on shutdown
+        delete this->bindings_;
+        delete this->configuration_;
+        delete this->filter_;
+        delete this->frame_store_;
+        delete this->shared_memory_;
+        delete this->recorder_; // finishes the file if still recording
+        delete this->stream_;
+        delete this->gameplay_events_;
+    }
+
+    bool CTelemetry::init()
+    {
+        if ( this->init_params_ == nullptr || this->init_params_->register_for_event == nullptr || this->init_params_->register_for_channel == nullptr )
+        {
+            this->log( SCS_LOG_TYPE_error, "Cannot register telemetry - init_params or register functions are null" );
+            return false;
+        }
+
+        for ( const auto event : { SCS_TELEMETRY_EVENT_frame_start, SCS_TELEMETRY_EVENT_frame_end, SCS_TELEMETRY_EVENT_paused, SCS_TELEMETRY_EVENT_started,
+                                  SCS_TELEMETRY_EVENT_configuration, SCS_TELEMETRY_EVENT_gameplay } )
+        {
+            if ( this->init_params_->register_for_event( event, on_event, this ) != SCS_RESULT_ok )
+            {
+                this->log( SCS_LOG_TYPE_error, "Could not register for telemetry event %u", event );
+                return false;
+            }
+        }
+
+        // trailer.0.connected to trailer.9.connected, each bound to its own slot so the callback needs no name parsing
+        const auto connected = this->bindings_->bind_indexed< bool >( "trailer.%u.connected",
+                                                                      MAX_TRAILERS,
+                                                                      this->trailer_connected_.values,
+                                                                      SCS_TELEMETRY_CHANNEL_FLAG_none,
+                                                                      on_trailer_connected_changed,
+                                                                      this );
+        if ( connected != MAX_TRAILERS )
+        {
+            this->log( SCS_LOG_TYPE_warning, "Only registered %u/%u trailer.N.connected channels", connected, MAX_TRAILERS );
+        }
+
+        if ( !this->shared_memory_->init() )
+        {
+            // not fatal, only external readers lose out
+            this->log( SCS_LOG_TYPE_warning, "Could not create the telemetry shared memory %s", SHARED_MEMORY_NAME );
+        }
+
+        const auto truck = this->bind_truck();
+        const auto trailers = this->bind_trailers();
+        const auto filters = this->set_default_filters();
+        this->log( SCS_LOG_TYPE_message, "Telemetry registered: %u truck, %u trailer channels, wheels follow the configuration, %u filtered",
+                   truck, trailers + connected, filters );
+        return true;
+    }
+
+    void CTelemetry::subscribe_frames( const frame_callback_t callback, void* user_data )
+    {
+        if ( callback == nullptr ) return;
+        this->frame_subscribers_.push_back( { callback, user_data } );
+    }
+
+    void CTelemetry::unsubscribe_frames( const frame_callback_t callback, void* user_data )
+    {
+        this->frame_subscribers_.erase( std::remove_if( this->frame_subscribers_.begin(), this->frame_subscribers_.end(), [ & ]( const frame_subscriber_t& subscriber )
+        {
+            return subscriber.callback == callback && subscriber.user_data == user_data;
+        } ), this->frame_subscribers_.end() );
+    }
+
+    void CTelemetry::resize_wheels( const char* prefix, wheels_soa_t& wheels, uint32_t& bound, uint32_t count )
+    {
+        count = std::min( count, MAX_WHEELS );
+        if ( count == bound ) return;
+
+        char name[ CChannelBindings::MAX_NAME_LENGTH ];
+        const auto format = [ & ]( const char* channel )
+        {
+            snprintf( name, sizeof( name ), "%s.wheel.%s", prefix, channel );
+            return name;
+        };
+
+        if ( count < bound )
+        {
+            // wheels that went away must not keep their last values in the published frames
+            auto* storage = reinterpret_cast< uint8_t* >( &wheels );
+            for ( const auto& channel : get_wheel_channels() )
+            {
+                this->bindings_->unbind_array( format( channel.name ), count );
+                std::memset( storage + channel.offset + channel.size * count, 0, channel.size * ( bound - count ) );
+            }
+            bound = count;
+            return;
+        }
+
+        auto* bindings = this->bindings_;
+        bindings->bind_array_range< float >( format( "suspension.deflection" ), bound, count, wheels.suspension_deflection );
+        bindings->bind_array_range< float >( format( "angular_velocity" ), bound, count, wheels.angular_velocity );
+        bindings->bind_array_range< float >( format( "steering" ), bound, count, wheels.steering );
+        bindings->bind_array_range< float >( format( "rotation" ), bound, count, wheels.rotation );
+        bindings->bind_array_range< float >( format( "lift" ), bound, count, wheels.lift );
+        bindings->bind_array_range< float >( format( "lift.offset" ), bound, count, wheels.lift_offset );
+        bindings->bind_array_range< uint32_t >( format( "substance" ), bound, count, wheels.substance );
+        bindings->bind_array_range< bool >( format( "on_ground" ), bound, count, wheels.on_ground );
+        bound = count;
+    }
+
+    uint32_t CTelemetry::bind_truck()
+    {
+        auto& truck = this->frame_store_->working().truck;
+        auto* bindings = this->bindings_;
+
+        uint32_t bound = 0;
+        const auto count = [ &bound ]( const scs_result_t result ) { if ( result == SCS_RESULT_ok ) ++bound; };
+
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_world_placement, SCS_U32_NIL, &truck.world_placement ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_local_linear_velocity, SCS_U32_NIL, &truck.linear_velocity ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_local_angular_velocity, SCS_U32_NIL, &truck.angular_velocity ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_speed, SCS_U32_NIL, &truck.speed ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_engine_rpm, SCS_U32_NIL, &truck.engine_rpm ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_engine_gear, SCS_U32_NIL, &truck.engine_gear ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_effective_steering, SCS_U32_NIL, &truck.effective_steering ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_effective_throttle, SCS_U32_NIL, &truck.effective_throttle ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_effective_brake, SCS_U32_NIL, &truck.effective_brake ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_effective_clutch, SCS_U32_NIL, &truck.effective_clutch ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_fuel, SCS_U32_NIL, &truck.fuel ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_oil_temperature, SCS_U32_NIL, &truck.oil_temperature ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_water_temperature, SCS_U32_NIL, &truck.water_temperature ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_battery_voltage, SCS_U32_NIL, &truck.battery_voltage ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_odometer, SCS_U32_NIL, &truck.odometer ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_parking_brake, SCS_U32_NIL, &truck.parking_brake ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_engine_enabled, SCS_U32_NIL, &truck.engine_enabled ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_lblinker, SCS_U32_NIL, &truck.lblinker ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_rblinker, SCS_U32_NIL, &truck.rblinker ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_light_low_beam, SCS_U32_NIL, &truck.light_low_beam ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_light_high_beam, SCS_U32_NIL, &truck.light_high_beam ) );
+        count( bindings->bind( SCS_TELEMETRY_TRUCK_CHANNEL_wipers, SCS_U32_NIL, &truck.wipers ) );
+
+        return bound;
+    }
+
+    uint32_t CTelemetry::bind_trailers()
+    {
+        auto& trailers = this->frame_store_->working().trailers;
+        auto* bindings = this->bindings_;
+
+        uint32_t bound = 0;
+        bound += bindings->bind_indexed< float >( "trailer.%u.cargo.damage", MAX_TRAILERS, trailers.cargo_damage );
+        bound += bindings->bind_indexed< scs_value_dplacement_t >( "trailer.%u.world.placement", MAX_TRAILERS, trailers.world_placement );
+        bound += bindings->bind_indexed< scs_value_fvector_t >( "trailer.%u.velocity.linear", MAX_TRAILERS, trailers.linear_velocity );
+        return bound;
+    }
+
+    uint32_t CTelemetry::set_default_filters()
+    {
+        uint32_t count = 0;
+        for ( const auto& filter : default_filters )
+        {
+            if ( this->filter_->set_rule( filter.channel, filter.rule ) ) ++count;
+            else this->log( SCS_LOG_TYPE_warning, "Could not filter %s", filter.channel );
+        }
+        return count;
+    }
+
+    SCSAPI_VOID CTelemetry::on_event( const scs_event_t event, const void* const event_info, const scs_context_t context )
+    {
+        auto* telemetry = static_cast< CTelemetry* >( context );
+
+        switch ( event )
+        {
+            case SCS_TELEMETRY_EVENT_frame_start:
+            {
+                telemetry->frame_store_->begin_frame( *static_cast< const scs_telemetry_frame_start_t* >( event_info ),
+                                                      telemetry->paused_.load( std::memory_order_relaxed ) );
+                break;
+            }
+            case SCS_TELEMETRY_EVENT_frame_end:
+            {
+                std::memcpy( telemetry->frame_store_->working().trailers.connected, telemetry->trailer_connected_.values, sizeof( bool ) * MAX_TRAILERS );
+
+                const auto& frame = telemetry->filter_->apply( telemetry->frame_store_->working() );
+                telemetry->frame_store_->publish( frame );
+                telemetry->shared_memory_->publish( frame );
+                telemetry->recorder_->push( frame );
+                telemetry->stream_->push( frame );
+                telemetry->log_gameplay_events();
+                telemetry->advance_clocks( telemetry->frame_store_->working() );
+                for ( const auto& subscriber : telemetry->frame_subscribers_ ) subscriber.callback( telemetry->frame_store_->working(), subscriber.user_data );
+                break;
+            }
+            case SCS_TELEMETRY_EVENT_paused:
+            case SCS_TELEMETRY_EVENT_started:
+            {
+                telemetry->paused_.store( event == SCS_TELEMETRY_EVENT_paused, std::memory_order_relaxed );
+                debug::record_event( debug::FlightEvent::TELEMETRY_TRANSITION, event == SCS_TELEMETRY_EVENT_paused ? "paused" : "started" );
+                break;
+            }
+            case SCS_TELEMETRY_EVENT_configuration:
+            {
+                telemetry->configuration_->apply( *static_cast< const scs_telemetry_configuration_t* >( event_info ) );
+                break;
+            }
+            case SCS_TELEMETRY_EVENT_gameplay:
+            {
+                const auto& frame = telemetry->frame_store_->working();
+                telemetry->gameplay_events_->push( *static_cast< const scs_telemetry_gameplay_event_t* >( event_info ), frame.render_time,
+                                                   frame.simulation_time );
+                break;
+            }
+            default: break;
+        }
+    }
+
+    // The logger is just another subscriber of the gameplay queue, formatting and the game log stay out of the event callback
+    void CTelemetry::log_gameplay_events()
+    {
+        gameplay_event_t event;
+        const auto lost = this->log_cursor_.lost;
+        while ( this->gameplay_events_->poll( this->log_cursor_, event ) )
+        {
+            char text[ 256 ];
+            format_gameplay_event( event, text, sizeof( text ) );
+            debug::record_event( debug::FlightEvent::GAMEPLAY, event.id, event.sequence, static_cast< uint64_t >( event.render_time ), event.type );
+            this->log( SCS_LOG_TYPE_message, "Gameplay: %s", text );
+        }
+        if ( this->log_cursor_.lost != lost )
+        {
+            this->log( SCS_LOG_TYPE_warning, "Gameplay: %llu events were lost", static_cast< unsigned long long >( this->log_cursor_.lost - lost ) );
+        }
+    }
+
+    // Configuration events run on the SDK thread outside of any channel callback, so registrations can change here
+    void CTelemetry::on_configuration_changed( const configuration_change_t& change, const CConfiguration& configuration, void* user_data )
+    {
+        if ( ( change.changes & ( ConfigurationChange::PRESENCE | ConfigurationChange::WHEELS ) ) == 0 ) return;
+
+        auto* telemetry = static_cast< CTelemetry* >( user_data );
+        auto& frame = telemetry->frame_store_->working();
+
+        if ( change.part == ConfigurationPart::TRUCK )
+        {
+            telemetry->resize_wheels( "truck", frame.truck.wheels, telemetry->truck_wheels_bound_, configuration.get_truck().wheels.count );
+        }
+        else
+        {
+            const auto& trailer = configuration.get_trailer( change.index );
+            if ( change.changes & ConfigurationChange::PRESENCE ) telemetry->trailer_generation_.fetch_add( 1, std::memory_order_release );
+
+            char prefix[ 16 ];
+            snprintf( prefix, sizeof( prefix ), "trailer.%u", change.index );
+            telemetry->resize_wheels( prefix, frame.trailers.wheels[ change.index ], telemetry->trailer_wheels_bound_[ change.index ],
+                                      trailer.present ? trailer.wheels.count : 0 );
+        }
+
+        telemetry->shared_memory_->configure( configuration.get_truck().wheels.count, configuration.get_trailer_count(),
+                                              configuration.get_max_trailer_wheel_count() );
+        telemetry->log( SCS_LOG_TYPE_message, "Configuration: truck %u wheels, %u trailers (%u bindings)", configuration.get_truck().wheels.count,
+                        configuration.get_trailer_count(), telemetry->bindings_->get_binding_count() );
+    }
+
+    void CTelemetry::advance_clocks( const telemetry_frame_t& frame )
+    {
+        const auto previous = this->simulation_time_.load( std::memory_order_relaxed );
+        const auto elapsed = static_cast< int64_t >( frame.simulation_time ) - previous;
+
+        // nothing is integrated over a timer restart (loading a save) or anything longer than a hitch
+        if ( !frame.timer_restart && previous != 0 && elapsed > 0 && elapsed < 1000000 )
+        {
+            const auto distance = std::fabs( static_cast< double >( frame.truck.speed ) ) * static_cast< double >( elapsed ) / 1000000.0;
+            this->travelled_distance_.store( this->travelled_distance_.load( std::memory_order_relaxed ) + distance, std::memory_order_relaxed );
+        }
+        this->simulation_time_.store( static_cast< int64_t >( frame.simulation_time ), std::memory_order_relaxed );
+    }
+
+    // Trailer connection state changes, only called by the bindings when the value actually changed
+    void CTelemetry::on_trailer_connected_changed( const uint32_t trailer_index, const bool& /*was_connected*/, const bool& connected, void* context )
+    {
+        auto* telemetry = static_cast< CTelemetry* >( context );
+
+        const int delta = connected ? 1 : -1;
+        const int count = telemetry->connected_trailer_count_.fetch_add( delta, std::memory_order_relaxed ) + delta;
+        telemetry->trailer_generation_.fetch_add( 1, std::memory_order_release );
+
+        debug::record_event( debug::FlightEvent::TELEMETRY_TRANSITION, "trailer.connected", connected ? 1 : 0, count,
+                             static_cast< uint16_t >( trailer_index ) );
+        telemetry->log( SCS_LOG_TYPE_message, "TRAILER %s: trailer.%u (total: %d trailers)",
+                        connected ? "CONNECTED" : "DISCONNECTED", trailer_index, count );
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#include "scssdk_telemetry.h"
+
+#include "channel_bindings.hpp"
+#include "channel_filter.hpp"
+#include "configuration.hpp"
+#include "frame_store.hpp"
+#include "gameplay_events.hpp"
+#include "recorder.hpp"
+#include "shared_memory.hpp"
+#include "stream.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    using frame_callback_t = void( * )( const telemetry_frame_t& frame, void* user_data );
+
+    /**
+     * \brief Owns everything registered with the telemetry SDK.
+     *
+     * The SDK accepts a single callback per event, so the frame events are registered once here and fanned out to
+     * whatever needs them. Channels are bound straight into the frame store's working frame, trailer.N.connected is
+     * kept separately as live state because the UI needs it immediately rather than at the next frame_end. Per wheel
+     * channels are only bound for the wheels the configuration events report and follow them as vehicles change.
+     * Gameplay events are only copied into a queue inside the callback, the log line for them is written at frame_end.
+     * Slow gauges go through the channel filter before a frame is published, see set_default_filters().
+     * Anything that has to react to every frame on the SDK thread subscribes to frame_end, it gets the unfiltered
+     * working frame after all exporters had theirs.
+     */
+    class CTelemetry
+    {
+    private:
+        struct frame_subscriber_t
+        {
+            frame_callback_t callback;
+            void* user_data;
+        };
+
+        const scs_telemetry_init_params_v101_t* init_params_;
+        scs_log_t scs_log_ = nullptr;
+
+        CChannelBindings* bindings_ = nullptr;
+        CConfiguration* configuration_ = nullptr;
+        CChannelFilter* filter_ = nullptr;
+        CFrameStore* frame_store_ = nullptr;
+        CGameplayEventQueue* gameplay_events_ = nullptr;
+        gameplay_event_cursor_t log_cursor_ = {};
+        CSharedMemoryExporter* shared_memory_ = nullptr;
+        CTelemetryRecorder* recorder_ = nullptr;
+        CTelemetryStreamServer* stream_ = nullptr;
+        std::vector< frame_subscriber_t > frame_subscribers_;
+
+        // wheel indices currently registered per vehicle
+        uint32_t truck_wheels_bound_ = 0;
+        uint32_t trailer_wheels_bound_[ MAX_TRAILERS ] = {};
+
+        channel_storage_t< bool, MAX_TRAILERS > trailer_connected_;
+        std::atomic< int > connected_trailer_count_ = 0;
+        std::atomic< uint64_t > trailer_generation_ = 0; // bumped whenever a trailer connects, disconnects, appears or goes away
+
+        // clocks for anything keyed to game time or distance, updated at frame_end
+        std::atomic< int64_t > simulation_time_ = 0;
+        std::atomic< double > travelled_distance_ = 0.0;
+        std::atomic< bool > paused_ = true; // SDK thread writes, is_paused() reads from any thread
+
+        static SCSAPI_VOID on_event( scs_event_t event, const void* event_info, scs_context_t context );
+        static void on_configuration_changed( const configuration_change_t& change, const CConfiguration& configuration, void* user_data );
+        static void on_trailer_connected_changed( uint32_t trailer_index, const bool& /*was_connected*/, const bool& connected, void* context );
+
+        void resize_wheels( const char* prefix, wheels_soa_t& wheels, uint32_t& bound, uint32_t count );
+        uint32_t bind_truck();
+        uint32_t bind_trailers();
+        uint32_t set_default_filters();
+        void log_gameplay_events();
+        void advance_clocks( const telemetry_frame_t& frame );
+
+        template < typename... Args >
+        void log( const scs_log_type_t type, const char* message, Args&&... args ) const
+        {
+            if ( this->scs_log_ == nullptr ) return;
+
+            char buffer[ 1024 ];
+            int length = snprintf( buffer, sizeof( buffer ), "[extra_utils] " );
+            snprintf( buffer + length, sizeof( buffer ) - length, message, args... );
+            this->scs_log_( type, buffer );
+        }
+
+    public:
+        explicit CTelemetry( const scs_telemetry_init_params_v101_t* init_params );
+        ~CTelemetry();
+
+        bool init();
+
+        // SDK thread, like CConfiguration::subscribe
+        void subscribe_frames( frame_callback_t callback, void* user_data );
+        void unsubscribe_frames( frame_callback_t callback, void* user_data );
+
+        bool has_trailers() const { return this->connected_trailer_count_.load( std::memory_order_relaxed ) > 0; }
+        int get_trailer_count() const { return this->connected_trailer_count_.load( std::memory_order_relaxed ); }
+        bool is_trailer_connected( const int index ) const { return index >= 0 && index < static_cast< int >( MAX_TRAILERS ) && this->trailer_connected_[ index ]; }
+        bool is_paused() const { return this->paused_.load( std::memory_order_relaxed ); }
+
+        // anything cached about the game's trailer objects is stale once this changed
+        uint64_t get_trailer_generation() const { return this->trailer_generation_.load( std::memory_order_acquire ); }
+
+        // any thread, stands still while paused
+        double get_simulation_seconds() const { return static_cast< double >( this->simulation_time_.load( std::memory_order_relaxed ) ) / 1000000.0; }
+        // any thread, meters the truck moved since the plugin was loaded, reversing counts as well
+        double get_travelled_distance() const { return this->travelled_distance_.load( std::memory_order_relaxed ); }
+
+        CFrameStore* get_frame_store() const { return this->frame_store_; }
+        const CGameplayEventQueue* get_gameplay_events() const { return this->gameplay_events_; }
+        CChannelBindings* get_bindings() const { return this->bindings_; }
+        CConfiguration* get_configuration() const { return this->configuration_; }
+        CChannelFilter* get_filter() const { return this->filter_; }
+        CSharedMemoryExporter* get_shared_memory() const { return this->shared_memory_; }
+        CTelemetryRecorder* get_recorder() const { return this->recorder_; }
+        CTelemetryStreamServer* get_stream() const { return this->stream_; }
+    };
+}
@@ -0,0 +1,199 @@
+#include "reverse_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "telemetry/configuration.hpp"
+
+namespace ts_extra_utilities::trailers
+{
+    namespace
+    {
+        constexpr float PI = 3.14159265358979f;
+        constexpr float MIN_CURVATURE = 1.0e-4f; // below this the arc is treated as a straight line, radius 10 km
+
+        // SCS headings are 0 - 1 counterclockwise from north
+        float heading_to_angle( const float heading ) { return ( heading + 0.25f ) * 2.0f * PI; }
+
+        float wrap_angle( const float angle ) { return angle - 2.0f * PI * std::floor( angle / ( 2.0f * PI ) + 0.5f ); }
+    }
+
+    reverse_rig_geometry_t make_reverse_rig_geometry( const telemetry::CConfiguration& configuration )
+    {
+        reverse_rig_geometry_t geometry = {};
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            const auto& trailer = configuration.get_trailer( i );
+            if ( !trailer.present || trailer.wheels.count == 0 ) continue;
+
+            float steered[ 3 ] = {}; // x, z, count
+            float all[ 3 ] = {};
+            for ( uint32_t wheel = 0; wheel < trailer.wheels.count; ++wheel )
+            {
+                const auto& config = trailer.wheels.wheels[ wheel ];
+                auto& sum = config.steerable ? steered : all;
+                sum[ 0 ] += config.position.x;
+                sum[ 1 ] += config.position.z;
+                sum[ 2 ] += 1.0f;
+            }
+
+            if ( steered[ 2 ] > 0.0f )
+            {
+                geometry.axle_x[ i ] = steered[ 0 ] / steered[ 2 ];
+                geometry.axle_z[ i ] = steered[ 1 ] / steered[ 2 ];
+                geometry.steerable |= 1u << i;
+            }
+            else
+            {
+                geometry.axle_x[ i ] = all[ 0 ] / all[ 2 ];
+                geometry.axle_z[ i ] = all[ 1 ] / all[ 2 ];
+            }
+        }
+        return geometry;
+    }
+
+    void CReverseSteeringController::request_engage( const float curvature )
+    {
+        this->requested_curvature_.store( curvature, std::memory_order_relaxed );
+        this->requested_engaged_.store( true, std::memory_order_relaxed );
+        this->request_serial_.fetch_add( 1, std::memory_order_release );
+    }
+
+    void CReverseSteeringController::request_disengage()
+    {
+        this->requested_engaged_.store( false, std::memory_order_relaxed );
+        this->request_serial_.fetch_add( 1, std::memory_order_release );
+    }
+
+    void CReverseSteeringController::set_params( const reverse_controller_params_t& params )
+    {
+        this->lookahead_.store( std::max( params.lookahead, 0.5f ), std::memory_order_relaxed );
+        this->max_wheel_angle_.store( std::clamp( params.max_wheel_angle, 0.05f, 1.5f ), std::memory_order_relaxed );
+        this->min_speed_.store( std::max( params.min_speed, 0.0f ), std::memory_order_relaxed );
+        this->invert_.store( params.invert, std::memory_order_relaxed );
+    }
+
+    reverse_controller_params_t CReverseSteeringController::get_params() const
+    {
+        return {
+            this->lookahead_.load( std::memory_order_relaxed ),
+            this->max_wheel_angle_.load( std::memory_order_relaxed ),
+            this->min_speed_.load( std::memory_order_relaxed ),
+            this->invert_.load( std::memory_order_relaxed ),
+        };
+    }
+
+    void CReverseSteeringController::engage( const telemetry::telemetry_frame_t& frame, const float curvature )
+    {
+        this->engaged_ = false;
+        this->engaged_trailers_ = 0;
+        uint32_t last = 0;
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            if ( !frame.trailers.connected[ i ] ) continue;
+            this->engaged_trailers_ |= 1u << i;
+            last = i;
+        }
+        if ( this->engaged_trailers_ == 0 ) return;
+
+        // the arc starts at the axle of the last trailer and leaves backwards
+        const auto& placement = frame.trailers.world_placement[ last ];
+        const auto angle = heading_to_angle( placement.orientation.heading );
+        const auto cos_angle = std::cos( angle ), sin_angle = std::sin( angle );
+        const auto axle_x = this->geometry_.axle_x[ last ], axle_z = this->geometry_.axle_z[ last ];
+
+        this->origin_x_ = placement.position.x + axle_x * sin_angle - axle_z * cos_angle;
+        this->origin_y_ = -placement.position.z - axle_x * cos_angle - axle_z * sin_angle;
+        this->direction_x_ = -cos_angle;
+        this->direction_y_ = -sin_angle;
+        this->curvature_ = curvature;
+        std::fill_n( this->steering_, MAX_CONTROLLED_TRAILERS, 0.0f );
+        std::fill_n( this->station_, MAX_CONTROLLED_TRAILERS, 0.0f );
+        this->engaged_ = true;
+    }
+
+    uint32_t CReverseSteeringController::update( const telemetry::telemetry_frame_t& frame, float* steering )
+    {
+        const auto serial = this->request_serial_.load( std::memory_order_acquire );
+        if ( serial != this->handled_serial_ )
+        {
+            this->handled_serial_ = serial;
+            if ( this->requested_engaged_.load( std::memory_order_relaxed ) ) this->engage( frame, this->requested_curvature_.load( std::memory_order_relaxed ) );
+            else this->engaged_ = false;
+        }
+
+        uint32_t connected = 0;
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i ) connected |= static_cast< uint32_t >( frame.trailers.connected[ i ] ) << i;
+        if ( ( connected & this->engaged_trailers_ ) != this->engaged_trailers_ ) this->engaged_ = false;
+
+        this->active_.store( this->engaged_, std::memory_order_release );
+        if ( !this->engaged_ ) return 0;
+
+        const auto lookahead = this->lookahead_.load( std::memory_order_relaxed );
+        const auto max_wheel_angle = this->max_wheel_angle_.load( std::memory_order_relaxed );
+        const auto sign = this->invert_.load( std::memory_order_relaxed ) ? -1.0f : 1.0f;
+        const auto reversing = frame.truck.speed < -this->min_speed_.load( std::memory_order_relaxed );
+
+        const auto dx = this->direction_x_, dy = this->direction_y_;
+        const auto path_angle = std::atan2( dy, dx );
+        const auto k = this->curvature_;
+        const auto straight = std::fabs( k ) < MIN_CURVATURE;
+        const auto inverse_k = straight ? 0.0f : 1.0f / k;
+        const auto period = straight ? 0.0f : 2.0f * PI / std::fabs( k ); // meters around the whole circle
+        const auto inverse_period = std::fabs( k ) / ( 2.0f * PI );
+
+        // placements to angles and axle positions relative to the arc start
+        float angle[ MAX_CONTROLLED_TRAILERS ], axle_x[ MAX_CONTROLLED_TRAILERS ], axle_y[ MAX_CONTROLLED_TRAILERS ];
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            const auto& placement = frame.trailers.world_placement[ i ];
+            angle[ i ] = heading_to_angle( placement.orientation.heading );
+            axle_x[ i ] = static_cast< float >( placement.position.x - this->origin_x_ );
+            axle_y[ i ] = static_cast< float >( -placement.position.z - this->origin_y_ );
+        }
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            const auto cos_angle = std::cos( angle[ i ] ), sin_angle = std::sin( angle[ i ] );
+            axle_x[ i ] += this->geometry_.axle_x[ i ] * sin_angle - this->geometry_.axle_z[ i ] * cos_angle;
+            axle_y[ i ] += -this->geometry_.axle_x[ i ] * cos_angle - this->geometry_.axle_z[ i ] * sin_angle;
+        }
+
+        float cross_track[ MAX_CONTROLLED_TRAILERS ];
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            // in the path's frame: u along the start direction, w to its left. Ahead of the start the path is the line the
+            // rig stood on, behind it the arc ( sin( k s ), 1 - cos( k s ) ) / k
+            const auto u = axle_x[ i ] * dx + axle_y[ i ] * dy;
+            const auto w = axle_y[ i ] * dx - axle_x[ i ] * dy;
+
+            // closest point on the path and the distance to it, the angle around the arc is only known up to full turns,
+            // the one closest to the last update is taken so the arc can go on past half a circle
+            const auto ku = k * u, kw = 1.0f - k * w;
+            const auto arc = std::atan2( ku, kw ) * inverse_k;
+            const auto arc_station = arc + period * std::floor( ( this->station_[ i ] - arc ) * inverse_period + 0.5f );
+            const auto on_arc = !straight && arc_station > 0.0f;
+            const auto s = on_arc ? arc_station : u;
+            cross_track[ i ] = on_arc ? ( 1.0f - std::sqrt( ku * ku + kw * kw ) ) * inverse_k : w;
+            this->station_[ i ] = s;
+
+            // along the path where it's closest, turned towards it by the error over the lookahead. Reversing, the axle
+            // travels opposite to where its wheels point
+            const auto tangent = path_angle + ( on_arc ? k * s : 0.0f );
+            const auto travel = tangent - std::atan2( cross_track[ i ], lookahead );
+            const auto wheel_angle = wrap_angle( travel - angle[ i ] - PI );
+            const auto value = sign * std::clamp( wheel_angle / max_wheel_angle, -1.0f, 1.0f );
+
+            // standing or going forwards keeps whatever was steered last
+            this->steering_[ i ] = reversing ? value : this->steering_[ i ];
+        }
+
+        const auto steered = this->engaged_trailers_ & this->geometry_.steerable;
+        for ( uint32_t i = 0; i < MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            const auto in_use = ( steered >> i & 1 ) != 0;
+            steering[ i ] = in_use ? this->steering_[ i ] : 0.0f;
+            this->cross_track_[ i ].store( in_use ? cross_track[ i ] : 0.0f, std::memory_order_relaxed );
+        }
+        return steered;
+    }
+}
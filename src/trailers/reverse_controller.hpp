@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "telemetry/frame.hpp"
+
+namespace ts_extra_utilities::telemetry
+{
+    class CConfiguration;
+}
+
+namespace ts_extra_utilities::trailers
+{
+    constexpr uint32_t MAX_CONTROLLED_TRAILERS = telemetry::MAX_TRAILERS; // the telemetry only has placements for these
+
+    // where each trailer's steered axle is, taken from the configuration
+    struct reverse_rig_geometry_t
+    {
+        float axle_x[ MAX_CONTROLLED_TRAILERS ]; // vehicle space, meters right of the placement origin
+        float axle_z[ MAX_CONTROLLED_TRAILERS ]; // vehicle space, meters behind the placement origin
+        uint32_t steerable; // bit per trailer with at least one steerable wheel
+    };
+
+    /**
+     * \brief Center of the steerable wheels of every present trailer, the center of all wheels for trailers without any
+     */
+    reverse_rig_geometry_t make_reverse_rig_geometry( const telemetry::CConfiguration& configuration );
+
+    struct reverse_controller_params_t
+    {
+        float lookahead; // meters over which an axle is steered back onto the path, shorter corrects harder
+        float max_wheel_angle; // radians, the wheel angle of steering 1.0
+        float min_speed; // m/s, reversing slower than this holds the last steering
+        bool invert; // positive steering is taken to turn the wheels left (counterclockwise from above), for games that do the opposite
+    };
+
+    /**
+     * \brief Steers the steerable trailers of a rig along a path while it reverses.
+     *
+     * Engaging lays a path along the rig: the line the last connected trailer stands on up to its steered axle, from
+     * there a circular arc (or more of the line) leaving backwards. From then on every frame_end each steerable
+     * trailer's axle is projected onto the path and sent along the path's direction there, turned towards the path
+     * by atan( error / lookahead ). A steered axle goes where its wheels point, opposite to them when reversing, so
+     * the wheel angle is that direction minus the trailer heading minus half a turn and the error decays over about
+     * `lookahead` meters without any lag on the arc. The trailers are independent of each other that way, the ones in
+     * front reach the arc later.
+     *
+     * Everything is done in the ground plane with x east and y north, angles counterclockwise from east, relative to
+     * the arc's start so floats keep centimeters far away from the map origin. All trailers go through the same
+     * straight-line math over fixed size arrays, no branches on the trailer and no allocations, the compiler can
+     * vectorize the loops apart from the trigonometry.
+     *
+     * update() and set_geometry() run on the SDK thread, the UI only sets atomics that update() picks up.
+     */
+    class CReverseSteeringController
+    {
+    private:
+        // SDK thread only
+        reverse_rig_geometry_t geometry_ = {};
+        bool engaged_ = false;
+        uint32_t engaged_trailers_ = 0; // connected trailers when engaged, any of them going away disengages
+        double origin_x_ = 0.0, origin_y_ = 0.0; // start of the arc
+        float direction_x_ = 0.0f, direction_y_ = 0.0f; // reversing direction at the start
+        float curvature_ = 0.0f; // 1/m of the arc, positive bends left looking in the reversing direction
+        float steering_[ MAX_CONTROLLED_TRAILERS ] = {};
+        float station_[ MAX_CONTROLLED_TRAILERS ] = {}; // meters along the path of each axle at the last update
+
+        // requests from the UI
+        std::atomic< uint32_t > request_serial_ = 0;
+        uint32_t handled_serial_ = 0;
+        std::atomic< bool > requested_engaged_ = false;
+        std::atomic< float > requested_curvature_ = 0.0f;
+
+        std::atomic< float > lookahead_ = 6.0f;
+        std::atomic< float > max_wheel_angle_ = 0.5f;
+        std::atomic< float > min_speed_ = 0.05f;
+        std::atomic< bool > invert_ = false;
+
+        // published for the UI
+        std::atomic< bool > active_ = false;
+        std::atomic< float > cross_track_[ MAX_CONTROLLED_TRAILERS ] = {};
+
+        void engage( const telemetry::telemetry_frame_t& frame, float curvature );
+
+    public:
+        // UI thread, applied at the next frame_end
+        void request_engage( float curvature );
+        void request_disengage();
+        void set_params( const reverse_controller_params_t& params );
+
+        // any thread
+        reverse_controller_params_t get_params() const;
+        bool is_engaged() const { return this->active_.load( std::memory_order_acquire ); }
+        // meters between the trailer's steered axle and the path, positive left of it looking in the reversing direction
+        float get_cross_track( const uint32_t index ) const
+        {
+            return index < MAX_CONTROLLED_TRAILERS ? this->cross_track_[ index ].load( std::memory_order_relaxed ) : 0.0f;
+        }
+
+        // SDK thread
+        void set_geometry( const reverse_rig_geometry_t& geometry ) { this->geometry_ = geometry; }
+
+        /**
+         * \brief SDK thread, once per frame with the frame's placements
+         * \param steering -1 - 1 like set_individual_steering for each trailer, MAX_CONTROLLED_TRAILERS entries
+         * \return bit per trailer that is steered right now, 0 while disengaged
+         */
+        uint32_t update( const telemetry::telemetry_frame_t& frame, float* steering );
+    };
+}
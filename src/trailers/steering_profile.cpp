@@ -0,0 +1,158 @@
+#include "steering_profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ts_extra_utilities::trailers
+{
+    const char* to_string( const SteeringProfileAxis::Enum axis )
+    {
+        switch ( axis )
+        {
+            case SteeringProfileAxis::TIME: return "time";
+            case SteeringProfileAxis::DISTANCE: return "distance";
+            default: return "unknown";
+        }
+    }
+
+    const char* to_string( const SteeringInterpolation::Enum interpolation )
+    {
+        switch ( interpolation )
+        {
+            case SteeringInterpolation::LINEAR: return "linear";
+            case SteeringInterpolation::CUBIC: return "cubic";
+            case SteeringInterpolation::SPLINE: return "spline";
+            default: return "unknown";
+        }
+    }
+
+    bool CSteeringProfile::build( const steering_keyframe_t* keyframes, const uint32_t count, const SteeringProfileAxis::Enum axis,
+                                  const SteeringInterpolation::Enum interpolation, const bool loop )
+    {
+        this->segment_count_ = 0;
+        this->end_ = 0.0f;
+        this->axis_ = axis;
+        this->interpolation_ = interpolation;
+        this->loop_ = loop;
+
+        if ( keyframes == nullptr || count < 2 || count > MAX_KEYFRAMES ) return false;
+        for ( uint32_t i = 1; i < count; ++i )
+        {
+            if ( !( keyframes[ i ].position > keyframes[ i - 1 ].position ) ) return false;
+        }
+
+        const auto n = count - 1; // segments
+        float slopes[ MAX_KEYFRAMES ] = {}; // cubic: dy/dx at every key
+        float curvature[ MAX_KEYFRAMES ] = {}; // spline: second derivative at every key, 0 at both ends
+
+        if ( interpolation == SteeringInterpolation::CUBIC )
+        {
+            slopes[ 0 ] = ( keyframes[ 1 ].steering - keyframes[ 0 ].steering ) / ( keyframes[ 1 ].position - keyframes[ 0 ].position );
+            slopes[ n ] = ( keyframes[ n ].steering - keyframes[ n - 1 ].steering ) / ( keyframes[ n ].position - keyframes[ n - 1 ].position );
+            for ( uint32_t i = 1; i < n; ++i )
+            {
+                slopes[ i ] = ( keyframes[ i + 1 ].steering - keyframes[ i - 1 ].steering ) / ( keyframes[ i + 1 ].position - keyframes[ i - 1 ].position );
+            }
+        }
+        else if ( interpolation == SteeringInterpolation::SPLINE && n > 1 )
+        {
+            // tridiagonal system for the inner keys, thomas algorithm
+            float diagonal[ MAX_KEYFRAMES ] = {};
+            float rhs[ MAX_KEYFRAMES ] = {};
+            for ( uint32_t i = 1; i < n; ++i )
+            {
+                const auto h0 = keyframes[ i ].position - keyframes[ i - 1 ].position;
+                const auto h1 = keyframes[ i + 1 ].position - keyframes[ i ].position;
+                diagonal[ i ] = 2.0f * ( h0 + h1 );
+                rhs[ i ] = 6.0f * ( ( keyframes[ i + 1 ].steering - keyframes[ i ].steering ) / h1 - ( keyframes[ i ].steering - keyframes[ i - 1 ].steering ) / h0 );
+            }
+            for ( uint32_t i = 2; i < n; ++i )
+            {
+                const auto h0 = keyframes[ i ].position - keyframes[ i - 1 ].position;
+                const auto factor = h0 / diagonal[ i - 1 ];
+                diagonal[ i ] -= factor * h0;
+                rhs[ i ] -= factor * rhs[ i - 1 ];
+            }
+            for ( uint32_t i = n - 1; i >= 1; --i )
+            {
+                const auto h1 = keyframes[ i + 1 ].position - keyframes[ i ].position;
+                curvature[ i ] = ( rhs[ i ] - h1 * curvature[ i + 1 ] ) / diagonal[ i ];
+            }
+        }
+
+        for ( uint32_t i = 0; i < n; ++i )
+        {
+            const auto& from = keyframes[ i ];
+            const auto& to = keyframes[ i + 1 ];
+            const auto length = to.position - from.position;
+            const auto delta = to.steering - from.steering;
+
+            auto& segment = this->segments_[ i ];
+            segment.start = from.position;
+            segment.inverse_length = 1.0f / length;
+            segment.c0 = from.steering;
+
+            switch ( interpolation )
+            {
+                case SteeringInterpolation::CUBIC:
+                {
+                    const auto m0 = slopes[ i ] * length;
+                    const auto m1 = slopes[ i + 1 ] * length;
+                    segment.c1 = m0;
+                    segment.c2 = 3.0f * delta - 2.0f * m0 - m1;
+                    segment.c3 = -2.0f * delta + m0 + m1;
+                    break;
+                }
+                case SteeringInterpolation::SPLINE:
+                {
+                    const auto h2 = length * length;
+                    segment.c1 = delta - h2 * ( 2.0f * curvature[ i ] + curvature[ i + 1 ] ) / 6.0f;
+                    segment.c2 = h2 * curvature[ i ] * 0.5f;
+                    segment.c3 = h2 * ( curvature[ i + 1 ] - curvature[ i ] ) / 6.0f;
+                    break;
+                }
+                default:
+                {
+                    segment.c1 = delta;
+                    segment.c2 = 0.0f;
+                    segment.c3 = 0.0f;
+                    break;
+                }
+            }
+        }
+
+        this->end_ = keyframes[ n ].position;
+        this->segment_count_ = n;
+        return true;
+    }
+
+    float CSteeringProfile::evaluate( float position, uint32_t& hint ) const
+    {
+        const auto count = std::min( this->segment_count_, MAX_KEYFRAMES - 1 );
+        if ( count == 0 ) return 0.0f;
+
+        // CTrailerControlState evaluates in place and only then checks for a replacement, a torn read must not reach a
+        // clamp with start > end or a fmod by 0, build() never leaves a profile like that
+        const auto start = this->segments_[ 0 ].start;
+        const auto end = this->end_;
+        if ( !( end > start ) ) return std::clamp( this->segments_[ 0 ].c0, -1.0f, 1.0f );
+
+        if ( this->loop_ )
+        {
+            const auto length = end - start;
+            position = start + std::fmod( position - start, length );
+            if ( position < start ) position += length;
+        }
+        position = std::clamp( position, start, end );
+
+        // the position only moves a little between physics steps, so this is the same or the next segment nearly always
+        auto index = hint < count ? hint : 0;
+        while ( index + 1 < count && position >= this->segments_[ index + 1 ].start ) ++index;
+        while ( index > 0 && position < this->segments_[ index ].start ) --index;
+        hint = index;
+
+        const auto& segment = this->segments_[ index ];
+        const auto t = std::clamp( ( position - segment.start ) * segment.inverse_length, 0.0f, 1.0f );
+        return std::clamp( segment.c0 + t * ( segment.c1 + t * ( segment.c2 + t * segment.c3 ) ), -1.0f, 1.0f );
+    }
+}
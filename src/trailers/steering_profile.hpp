@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+
+namespace ts_extra_utilities::trailers
+{
+    struct SteeringProfileAxis
+    {
+        enum Enum : uint8_t
+        {
+            TIME, // keyframe positions in simulation seconds
+            DISTANCE, // keyframe positions in meters driven, forwards and backwards both count
+        };
+    };
+
+    struct SteeringInterpolation
+    {
+        enum Enum : uint8_t
+        {
+            LINEAR,
+            CUBIC, // hermite through the keyframes with catmull-rom tangents, local, a key only bends its neighbours
+            SPLINE, // natural cubic spline, smoothest but every key moves the whole curve
+        };
+    };
+
+    const char* to_string( SteeringProfileAxis::Enum axis );
+    const char* to_string( SteeringInterpolation::Enum interpolation );
+
+    struct steering_keyframe_t
+    {
+        float position; // seconds or meters from the start of the profile, strictly increasing
+        float steering; // -1 - 1 like set_individual_steering
+    };
+
+    /**
+     * \brief Steering curve over time or distance, built once from keyframes and evaluated every physics step.
+     *
+     * Building turns every pair of keyframes into a segment with a cubic in the segment's local 0 - 1 parameter, so
+     * evaluating is finding the segment (usually the one of the last call, see `hint`) and four multiply-adds. Fixed
+     * capacity and no allocations, copies are plain memcpy-able data which CTrailerControlState relies on.
+     */
+    class CSteeringProfile
+    {
+    public:
+        static constexpr uint32_t MAX_KEYFRAMES = 32;
+
+    private:
+        struct segment_t
+        {
+            float start;
+            float inverse_length;
+            float c0, c1, c2, c3; // c0 + t * ( c1 + t * ( c2 + t * c3 ) )
+        };
+
+        segment_t segments_[ MAX_KEYFRAMES - 1 ] = {};
+        uint32_t segment_count_ = 0;
+        float end_ = 0.0f;
+        SteeringProfileAxis::Enum axis_ = SteeringProfileAxis::TIME;
+        SteeringInterpolation::Enum interpolation_ = SteeringInterpolation::LINEAR;
+        bool loop_ = false;
+
+    public:
+        /**
+         * \brief Replaces the curve
+         * \return false (and leaves the profile empty) for fewer than 2 or more than MAX_KEYFRAMES keyframes or positions that don't increase
+         */
+        bool build( const steering_keyframe_t* keyframes, uint32_t count, SteeringProfileAxis::Enum axis, SteeringInterpolation::Enum interpolation,
+                    bool loop = false );
+
+        /**
+         * \brief Steering at `position`, held at the first/last keyframe outside of the profile unless it loops
+         * \param hint segment of the previous call, updated, any value is fine
+         * \note Safe to call on a copy torn by a concurrent build(), the result is then meaningless and has to be discarded
+         */
+        float evaluate( float position, uint32_t& hint ) const;
+
+        bool is_empty() const { return this->segment_count_ == 0; }
+        float get_start() const { return this->segment_count_ != 0 ? this->segments_[ 0 ].start : 0.0f; }
+        float get_end() const { return this->end_; }
+        SteeringProfileAxis::Enum get_axis() const { return this->axis_; }
+        SteeringInterpolation::Enum get_interpolation() const { return this->interpolation_; }
+        bool is_looping() const { return this->loop_; }
+    };
+}
@@ -0,0 +1,221 @@
+#include "trailer_control.hpp"
+
+#include <algorithm>
+
+namespace ts_extra_utilities::trailers
+{
+    void CTrailerControlState::set_steering_locked( const uint32_t index, const bool locked )
+    {
+        if ( index >= MAX_TRAILERS ) return;
+
+        // set by hand, the controller leaves it alone from now on
+        auto& slot = this->slots_[ index ];
+        slot.controller_locked.store( false, std::memory_order_relaxed );
+        slot.steering_locked.store( locked, std::memory_order_release );
+    }
+
+    void CTrailerControlState::set_steering_target( const uint32_t index, const float steering )
+    {
+        if ( index >= MAX_TRAILERS ) return;
+
+        auto& slot = this->slots_[ index ];
+        slot.steering_target.store( std::clamp( steering, -1.0f, 1.0f ), std::memory_order_relaxed );
+        slot.steering_serial.fetch_add( 1, std::memory_order_release );
+    }
+
+    void CTrailerControlState::set_joint( const uint32_t index, const TrailerJointState::Enum joint )
+    {
+        if ( index >= MAX_TRAILERS ) return;
+        this->slots_[ index ].joint.store( joint, std::memory_order_relaxed );
+    }
+
+    uint32_t CTrailerControlState::map_bucket( const uintptr_t trailer )
+    {
+        // objects are at least 16 byte aligned, fibonacci hashing spreads the rest over the top bits
+        return static_cast< uint32_t >( ( trailer >> 4 ) * 0x9E3779B97F4A7C15ull >> 59 ) & ( MAP_SIZE - 1 );
+    }
+
+    void CTrailerControlState::rebuild_trailer_map( const void* const* trailers, uint32_t count, const uint64_t generation )
+    {
+        static_assert(MAP_SIZE == 1u << 5 && MAP_SIZE > MAX_TRAILERS);
+        count = std::min( count, MAX_TRAILERS );
+
+        this->map_sequence_.fetch_add( 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        for ( auto& entry : this->map_ ) entry.store( 0, std::memory_order_relaxed );
+        for ( uint32_t i = 0; i < count; ++i )
+        {
+            const auto trailer = reinterpret_cast< uintptr_t >( trailers[ i ] );
+            if ( trailer == 0 ) continue;
+
+            auto bucket = map_bucket( trailer );
+            while ( this->map_[ bucket ].load( std::memory_order_relaxed ) != 0 ) bucket = ( bucket + 1 ) & ( MAP_SIZE - 1 );
+            this->map_[ bucket ].store( trailer | static_cast< uint64_t >( i + 1 ) << 56, std::memory_order_relaxed );
+        }
+        this->map_generation_.store( generation, std::memory_order_relaxed );
+
+        this->map_sequence_.fetch_add( 1, std::memory_order_release );
+    }
+
+    int32_t CTrailerControlState::find_trailer( const void* trailer ) const
+    {
+        const auto key = reinterpret_cast< uintptr_t >( trailer );
+        if ( key == 0 || key >> 56 != 0 ) return -1;
+
+        // a rebuild overlapping the lookup is retried a few times, after that the trailer is treated as unknown
+        for ( uint32_t attempt = 0; attempt < 4; ++attempt )
+        {
+            const auto sequence = this->map_sequence_.load( std::memory_order_acquire );
+            if ( sequence & 1 ) continue;
+
+            // a map of an older generation is still used, the rebuild only happens on the next rendered frame
+            int32_t index = -1;
+            for ( auto bucket = map_bucket( key );; bucket = ( bucket + 1 ) & ( MAP_SIZE - 1 ) )
+            {
+                const auto entry = this->map_[ bucket ].load( std::memory_order_relaxed );
+                if ( entry == 0 ) break;
+                if ( ( entry & 0x00FFFFFFFFFFFFFFull ) == key )
+                {
+                    index = static_cast< int32_t >( entry >> 56 ) - 1;
+                    break;
+                }
+            }
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( this->map_sequence_.load( std::memory_order_relaxed ) == sequence ) return index;
+        }
+        return -1;
+    }
+
+    bool CTrailerControlState::set_profile( const uint32_t profile, const CSteeringProfile& curve )
+    {
+        if ( profile >= MAX_PROFILES || curve.is_empty() ) return false;
+
+        auto& slot = this->profiles_[ profile ];
+        slot.playing.store( false, std::memory_order_release );
+
+        slot.sequence.fetch_add( 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        slot.curve = curve;
+        slot.sequence.fetch_add( 1, std::memory_order_release );
+        return true;
+    }
+
+    void CTrailerControlState::start_profile( const uint32_t profile, const steering_clock_t& now )
+    {
+        if ( profile >= MAX_PROFILES ) return;
+
+        // the curve only changes on this thread, no need for the sequence here
+        auto& slot = this->profiles_[ profile ];
+        if ( slot.curve.is_empty() ) return;
+
+        const auto clock = slot.curve.get_axis() == SteeringProfileAxis::DISTANCE ? now.meters : now.seconds;
+        slot.origin.store( clock - slot.curve.get_start(), std::memory_order_relaxed );
+        slot.playing.store( true, std::memory_order_release );
+    }
+
+    void CTrailerControlState::stop_profile( const uint32_t profile )
+    {
+        if ( profile >= MAX_PROFILES ) return;
+        this->profiles_[ profile ].playing.store( false, std::memory_order_release );
+    }
+
+    void CTrailerControlState::assign_profile( const uint32_t index, const int32_t profile, const float gain, const float delay )
+    {
+        if ( index >= MAX_TRAILERS ) return;
+
+        auto& slot = this->slots_[ index ];
+        slot.profile_gain.store( gain, std::memory_order_relaxed );
+        slot.profile_delay.store( delay, std::memory_order_relaxed );
+        slot.profile.store( static_cast< int8_t >( profile >= 0 && profile < static_cast< int32_t >( MAX_PROFILES ) ? profile : -1 ),
+                            std::memory_order_release );
+    }
+
+    double CTrailerControlState::get_profile_position( const uint32_t profile, const steering_clock_t& now ) const
+    {
+        if ( profile >= MAX_PROFILES ) return 0.0;
+
+        const auto& slot = this->profiles_[ profile ];
+        const auto clock = slot.curve.get_axis() == SteeringProfileAxis::DISTANCE ? now.meters : now.seconds;
+        return clock - slot.origin.load( std::memory_order_relaxed );
+    }
+
+    bool CTrailerControlState::evaluate_profile( const uint32_t index, const steering_clock_t& now, float& steering )
+    {
+        if ( index >= MAX_TRAILERS ) return false;
+
+        auto& slot = this->slots_[ index ];
+        const auto profile = slot.profile.load( std::memory_order_acquire );
+        if ( profile < 0 || profile >= static_cast< int32_t >( MAX_PROFILES ) ) return false;
+
+        const auto& profile_slot = this->profiles_[ profile ];
+        if ( !profile_slot.playing.load( std::memory_order_acquire ) ) return false;
+
+        for ( uint32_t attempt = 0; attempt < 4; ++attempt )
+        {
+            const auto sequence = profile_slot.sequence.load( std::memory_order_acquire );
+            if ( sequence & 1 ) continue;
+
+            // evaluated in place, a torn curve gives a value that is thrown away below
+            const auto& curve = profile_slot.curve;
+            const auto clock = curve.get_axis() == SteeringProfileAxis::DISTANCE ? now.meters : now.seconds;
+            const auto position = static_cast< float >( clock - profile_slot.origin.load( std::memory_order_relaxed ) ) -
+                                  slot.profile_delay.load( std::memory_order_relaxed );
+            const auto value = curve.evaluate( position, slot.profile_hint );
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( profile_slot.sequence.load( std::memory_order_relaxed ) != sequence ) continue;
+
+            steering = std::clamp( value * slot.profile_gain.load( std::memory_order_relaxed ), -1.0f, 1.0f );
+            return true;
+        }
+        return false;
+    }
+
+    void CTrailerControlState::set_controller_steering( const uint32_t index, const bool controlled, const float steering )
+    {
+        if ( index >= MAX_TRAILERS ) return;
+
+        auto& slot = this->slots_[ index ];
+        slot.controller_steering.store( std::clamp( steering, -1.0f, 1.0f ), std::memory_order_relaxed );
+
+        // only locked trailers take the controller's steering, the game would overwrite it otherwise. Taking over locks
+        // once, so a trailer unlocked in the UI while engaged stays unlocked
+        const auto was_controlled = slot.controlled.exchange( controlled, std::memory_order_acq_rel );
+        if ( controlled && !was_controlled && !slot.steering_locked.load( std::memory_order_acquire ) )
+        {
+            slot.controller_locked.store( true, std::memory_order_relaxed );
+            slot.steering_locked.store( true, std::memory_order_release );
+        }
+        else if ( !controlled && was_controlled && slot.controller_locked.exchange( false, std::memory_order_relaxed ) )
+        {
+            slot.steering_locked.store( false, std::memory_order_release );
+        }
+    }
+
+    bool CTrailerControlState::get_controller_steering( const uint32_t index, float& steering ) const
+    {
+        if ( index >= MAX_TRAILERS ) return false;
+
+        const auto& slot = this->slots_[ index ];
+        if ( !slot.controlled.load( std::memory_order_acquire ) ) return false;
+
+        steering = slot.controller_steering.load( std::memory_order_relaxed );
+        return true;
+    }
+
+    bool CTrailerControlState::consume_steering( const uint32_t index, float& steering )
+    {
+        if ( index >= MAX_TRAILERS ) return false;
+
+        auto& slot = this->slots_[ index ];
+        const auto serial = slot.steering_serial.load( std::memory_order_acquire );
+        if ( serial == slot.applied_serial ) return false;
+
+        // a target newer than the serial is fine, it comes with its own bump and is applied again next step
+        slot.applied_serial = serial;
+        steering = slot.steering_target.load( std::memory_order_relaxed );
+        return true;
+    }
+}
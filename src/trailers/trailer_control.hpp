@@ -0,0 +1,186 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "steering_profile.hpp"
+
+namespace ts_extra_utilities::trailers
+{
+    constexpr uint32_t MAX_TRAILERS = 20; // in a chain behind the truck, more than the game can actually pull
+
+    struct TrailerJointState
+    {
+        enum Enum : uint8_t
+        {
+            NORMAL,
+            LOCKED,
+            DISCONNECTED,
+        };
+    };
+
+    // CTelemetry's clocks at the moment of a physics step, profiles run on one of them
+    struct steering_clock_t
+    {
+        double seconds;
+        double meters;
+    };
+
+    /**
+     * \brief What the UI wants done with each trailer, shared between the render thread and the physics thread.
+     *
+     * The render thread writes, the steering_advance detour on the physics thread reads. Every trailer has its own
+     * cache line so toggling one trailer never bounces the line the physics thread is reading for another, and all
+     * fields are atomics so neither side ever sees a torn or stale-forever value. Steering angles aren't written into
+     * the game from the UI, they are handed over with a serial and applied by the physics thread on its next step.
+     *
+     * The physics thread only knows the trailer object it's stepping, so a small open-addressed map from trailer
+     * pointer to chain index is kept next to the slots. It's rebuilt by walking the chain on the render thread when
+     * the telemetry reports trailers (dis)connecting or after the UI changed the chain itself, and is tagged with the
+     * telemetry trailer generation it was built for. Lookups keep resolving against the last map until the rebuild
+     * lands, so trailers that stayed in the chain keep their locks while the game isn't rendering.
+     *
+     * A few steering profiles can be played at the same time, each locked trailer follows at most one of them with
+     * its own gain and delay, so a whole rig can be steered by one curve. The render thread replaces a profile under
+     * its sequence counter, the physics thread evaluates it in place and skips the step if it caught a replacement.
+     *
+     * While reversing with the reverse steering controller engaged, the SDK thread hands its steering over at every
+     * frame_end and the physics thread applies the latest one on each of its steps. Trailers the controller takes over
+     * are locked for as long as it steers them, unless they were locked already or the UI locks or unlocks them in
+     * the meantime, those stay as the user left them.
+     */
+    class CTrailerControlState
+    {
+    private:
+        struct alignas( 64 ) trailer_slot_t
+        {
+            std::atomic< bool > steering_locked = false;
+            std::atomic< uint8_t > joint = TrailerJointState::NORMAL;
+            std::atomic< float > steering_target = 0.0f;
+            std::atomic< uint32_t > steering_serial = 0; // bumped after every new target
+            uint32_t applied_serial = 0; // physics thread only
+
+            std::atomic< int8_t > profile = -1; // followed while steering is locked, -1 = none
+            std::atomic< float > profile_gain = 1.0f;
+            std::atomic< float > profile_delay = 0.0f; // in the profile's axis units, positive follows later
+            uint32_t profile_hint = 0; // physics thread only
+
+            std::atomic< bool > controlled = false; // the reverse steering controller steers it, wins over profiles and targets
+            std::atomic< bool > controller_locked = false; // steering_locked was set when the controller took over, it's released with it
+            std::atomic< float > controller_steering = 0.0f;
+        };
+
+        static_assert(sizeof( trailer_slot_t ) == 64);
+
+        static constexpr uint32_t MAP_SIZE = 32; // power of two, linear probing stays short with MAX_TRAILERS in it
+
+    public:
+        static constexpr uint32_t MAX_PROFILES = 4;
+
+    private:
+        struct alignas( 64 ) profile_slot_t
+        {
+            std::atomic< uint32_t > sequence = 0; // odd while the curve is replaced
+            std::atomic< bool > playing = false;
+            std::atomic< double > origin = 0.0; // clock on the profile's axis when it was started
+            CSteeringProfile curve;
+        };
+
+        trailer_slot_t slots_[ MAX_TRAILERS ];
+        profile_slot_t profiles_[ MAX_PROFILES ];
+
+        // seqlock over the map and its generation, entries are the pointer with index + 1 in the top byte, 0 = empty
+        alignas( 64 ) std::atomic< uint32_t > map_sequence_ = 0; // odd while being rebuilt
+        std::atomic< uint64_t > map_generation_ = ~0ull;
+        std::atomic< uint64_t > map_[ MAP_SIZE ] = {};
+
+        static uint32_t map_bucket( uintptr_t trailer );
+
+    public:
+        // render thread
+
+        void set_steering_locked( uint32_t index, bool locked );
+        void set_steering_target( uint32_t index, float steering );
+        void set_joint( uint32_t index, TrailerJointState::Enum joint );
+
+        // any thread
+
+        bool is_steering_locked( const uint32_t index ) const
+        {
+            return index < MAX_TRAILERS && this->slots_[ index ].steering_locked.load( std::memory_order_acquire );
+        }
+
+        float get_steering_target( const uint32_t index ) const
+        {
+            return index < MAX_TRAILERS ? this->slots_[ index ].steering_target.load( std::memory_order_relaxed ) : 0.0f;
+        }
+
+        TrailerJointState::Enum get_joint( const uint32_t index ) const
+        {
+            return index < MAX_TRAILERS
+                       ? static_cast< TrailerJointState::Enum >( this->slots_[ index ].joint.load( std::memory_order_relaxed ) )
+                       : TrailerJointState::NORMAL;
+        }
+
+        /**
+         * \brief SDK thread, output of CReverseSteeringController::update
+         * \param controlled locks the trailer's steering when it turns true and releases that lock when it turns false again
+         */
+        void set_controller_steering( uint32_t index, bool controlled, float steering );
+
+        bool is_controlled( const uint32_t index ) const
+        {
+            return index < MAX_TRAILERS && this->slots_[ index ].controlled.load( std::memory_order_acquire );
+        }
+
+        /**
+         * \brief Any thread, the controller's latest steering for the trailer
+         * \return false while the controller doesn't steer it
+         */
+        bool get_controller_steering( uint32_t index, float& steering ) const;
+
+        /**
+         * \brief Physics thread only, hands out a steering target once after the UI set it
+         * \return false if nothing changed since the last call for this trailer
+         */
+        bool consume_steering( uint32_t index, float& steering );
+
+        // render thread, replacing a curve stops it
+        bool set_profile( uint32_t profile, const CSteeringProfile& curve );
+        void start_profile( uint32_t profile, const steering_clock_t& now );
+        void stop_profile( uint32_t profile );
+        // -1 detaches the trailer from any profile
+        void assign_profile( uint32_t index, int32_t profile, float gain = 1.0f, float delay = 0.0f );
+
+        bool is_profile_playing( const uint32_t profile ) const
+        {
+            return profile < MAX_PROFILES && this->profiles_[ profile ].playing.load( std::memory_order_acquire );
+        }
+
+        int32_t get_assigned_profile( const uint32_t index ) const { return index < MAX_TRAILERS ? this->slots_[ index ].profile.load( std::memory_order_relaxed ) : -1; }
+        float get_profile_gain( const uint32_t index ) const { return index < MAX_TRAILERS ? this->slots_[ index ].profile_gain.load( std::memory_order_relaxed ) : 1.0f; }
+        float get_profile_delay( const uint32_t index ) const { return index < MAX_TRAILERS ? this->slots_[ index ].profile_delay.load( std::memory_order_relaxed ) : 0.0f; }
+
+        // render thread, how far into `profile` the clock is, for progress display
+        double get_profile_position( uint32_t profile, const steering_clock_t& now ) const;
+
+        /**
+         * \brief Physics thread only, steering of the profile the trailer follows at `now`
+         * \return false if it doesn't follow a playing profile or the profile was being replaced
+         */
+        bool evaluate_profile( uint32_t index, const steering_clock_t& now, float& steering );
+
+        /**
+         * \brief Render thread only, replaces the trailer map
+         * \param trailers the chain starting behind the truck, position in the array is the trailer index
+         * \param generation CTelemetry::get_trailer_generation() read before walking the chain
+         */
+        void rebuild_trailer_map( const void* const* trailers, uint32_t count, uint64_t generation );
+        uint64_t get_trailer_map_generation() const { return this->map_generation_.load( std::memory_order_relaxed ); }
+
+        /**
+         * \brief Any thread, a few relaxed loads
+         * \return index of `trailer` in the chain the map was last built for, -1 if it isn't in the map
+         */
+        int32_t find_trailer( const void* trailer ) const;
+    };
+}
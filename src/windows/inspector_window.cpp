@@ -0,0 +1,222 @@
+#include "inspector_window.hpp"
+
+#include <Windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "core.hpp"
+#include "imgui.h"
+#include "debug/debug_helpers.hpp"
+#include "memory/safe_read.hpp"
+
+namespace ts_extra_utilities
+{
+    namespace
+    {
+        constexpr uint32_t MAX_STRING_PREVIEW = 47;
+    }
+
+    bool CInspectorWindow::init()
+    {
+        return true;
+    }
+
+    void CInspectorWindow::inspect( const prism::game_object_t& target )
+    {
+        if ( target.info == this->info_ && target.address == this->address_ ) return;
+
+        this->info_ = target.info;
+        this->address_ = target.address;
+        this->rows_.clear();
+
+        uint32_t size = target.info->size;
+        for ( const auto& field : *target.info )
+        {
+            const auto offset = prism::get_field_offset( *target.info, field );
+            this->rows_.push_back( { &field, offset, -1, -1 } );
+            size = std::max( size, offset + field.get_size() );
+        }
+        this->read_.assign( size, 0 );
+        this->values_.assign( size, 0 );
+    }
+
+    void CInspectorWindow::read_rows( const uint32_t* begin, const uint32_t* end, const int frame )
+    {
+        uint32_t begin_offset = UINT32_MAX, end_offset = 0;
+        for ( auto* it = begin; it != end; ++it )
+        {
+            const auto& row = this->rows_[ *it ];
+            if ( row.read_frame == frame ) continue;
+            begin_offset = std::min( begin_offset, row.offset );
+            end_offset = std::max( end_offset, row.offset + row.field->get_size() );
+        }
+        if ( begin_offset >= end_offset ) return;
+
+        ++this->reads_;
+        this->read_bytes_ += end_offset - begin_offset;
+        const auto readable = memory::safe_copy( this->read_.data() + begin_offset, this->address_ + begin_offset, end_offset - begin_offset );
+
+        for ( auto* it = begin; it != end; ++it )
+        {
+            auto& row = this->rows_[ *it ];
+            if ( row.read_frame == frame ) continue;
+            if ( !readable )
+            {
+                row.read_frame = -1;
+                continue;
+            }
+
+            const auto* value = this->read_.data() + row.offset;
+            auto* last = this->values_.data() + row.offset;
+            if ( row.read_frame == frame - 1 && memcmp( value, last, row.field->get_size() ) != 0 ) row.changed_frame = frame;
+            memcpy( last, value, row.field->get_size() );
+            row.read_frame = frame;
+        }
+    }
+
+    void CInspectorWindow::render_row( const row_t& row, const int frame ) const
+    {
+        char type[ 32 ], value[ 160 ];
+
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex( 0 );
+        ImGui::Text( "0x%04X", row.offset );
+        ImGui::TableSetColumnIndex( 1 );
+        ImGui::TextUnformatted( row.field->name );
+        ImGui::TableSetColumnIndex( 2 );
+        prism::format_field_type( *row.field, type, sizeof( type ) );
+        ImGui::TextUnformatted( type );
+
+        ImGui::TableSetColumnIndex( 3 );
+        if ( row.read_frame < 0 )
+        {
+            ImGui::TextDisabled( "unreadable" );
+            return;
+        }
+
+        const auto* data = this->values_.data() + row.offset;
+        prism::format_field_value( *row.field, data, value, sizeof( value ) );
+        if ( row.field->type == prism::FieldType::STRING )
+        {
+            // the characters are somewhere else, only visible strings get here
+            uint64_t characters;
+            uint32_t length;
+            memcpy( &characters, data + 0x08, sizeof( characters ) );
+            memcpy( &length, data + 0x10, sizeof( length ) );
+
+            char text[ MAX_STRING_PREVIEW + 1 ] = {};
+            length = std::min( length, MAX_STRING_PREVIEW );
+            if ( characters != 0 && length != 0 && memory::safe_copy( text, characters, length ) )
+            {
+                const auto used = strlen( value );
+                snprintf( value + used, sizeof( value ) - used, " \"%s\"", text );
+            }
+        }
+
+        if ( row.changed_frame >= 0 && frame - row.changed_frame < HIGHLIGHT_FRAMES ) ImGui::TextColored( ImVec4( 1.0f, 0.8f, 0.2f, 1.0f ), "%s", value );
+        else ImGui::TextUnformatted( value );
+    }
+
+    void CInspectorWindow::dump( const prism::game_object_t& target )
+    {
+        std::vector< uint8_t > data( this->read_.size() );
+        if ( !memory::safe_copy( data.data(), target.address, data.size() ) )
+        {
+            this->dump_status_ = std::string( target.label ) + " isn't readable";
+            return;
+        }
+
+        SYSTEMTIME time;
+        GetLocalTime( &time );
+        char path[ MAX_PATH ];
+        snprintf( path, sizeof( path ), "%s\\ats_mod_inspect_%s_%04u%02u%02u_%02u%02u%02u.txt", debug::DebugLogger::LOG_DIRECTORY, target.label,
+                  time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond );
+
+        FILE* file = nullptr;
+        if ( fopen_s( &file, path, "w" ) != 0 || file == nullptr )
+        {
+            this->dump_status_ = std::string( "Cannot create " ) + path;
+            return;
+        }
+        fprintf( file, "# %s, %s @ 0x%llx, %s %s\n", target.label, target.info->name, target.address, CCore::g_instance->get_game_name().c_str(),
+                 CCore::g_instance->get_game_version().c_str() );
+        prism::write_struct_dump( file, *target.info, data.data(), data.size() );
+        fclose( file );
+        this->dump_status_ = std::string( "Written to " ) + path;
+    }
+
+    void CInspectorWindow::render()
+    {
+        ImGui::Begin( "Inspector" );
+
+        prism::collect_game_objects( reinterpret_cast< uint64_t >( CCore::g_instance->get_game_actor() ), this->targets_ );
+        if ( this->targets_.empty() )
+        {
+            ImGui::Text( "No game actor" );
+            ImGui::End();
+            return;
+        }
+
+        const auto selected = std::find_if( this->targets_.begin(), this->targets_.end(),
+                                            [ this ]( const prism::game_object_t& target ) { return this->selected_ == target.label; } );
+        const auto& target = selected != this->targets_.end() ? *selected : this->targets_.front();
+        if ( ImGui::BeginCombo( "Object", target.label ) )
+        {
+            for ( const auto& other : this->targets_ )
+            {
+                if ( ImGui::Selectable( other.label, &other == &target ) ) this->selected_ = other.label;
+            }
+            ImGui::EndCombo();
+        }
+        this->inspect( target );
+
+        ImGui::SameLine();
+        if ( ImGui::Button( "Dump" ) ) this->dump( target );
+
+        ImGui::Text( "%s @ 0x%llx, %zu fields", target.info->name, target.address, this->rows_.size() );
+        ImGui::InputText( "Filter", this->filter_, sizeof( this->filter_ ) );
+        ImGui::SameLine();
+        ImGui::Checkbox( "Changed only", &this->changed_only_ );
+
+        const auto frame = ImGui::GetFrameCount();
+        this->reads_ = 0;
+        this->read_bytes_ = 0;
+
+        this->shown_.clear();
+        for ( uint32_t i = 0; i < this->rows_.size(); ++i ) this->shown_.push_back( i );
+        // whether a row changed is only known for rows that are read, so this one reads them all
+        if ( this->changed_only_ ) this->read_rows( this->shown_.data(), this->shown_.data() + this->shown_.size(), frame );
+
+        this->shown_.erase( std::remove_if( this->shown_.begin(), this->shown_.end(), [ this, frame ]( const uint32_t index )
+        {
+            const auto& row = this->rows_[ index ];
+            if ( this->filter_[ 0 ] != '\0' && strstr( row.field->name, this->filter_ ) == nullptr ) return true;
+            return this->changed_only_ && ( row.changed_frame < 0 || frame - row.changed_frame >= HIGHLIGHT_FRAMES );
+        } ), this->shown_.end() );
+
+        constexpr auto flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+        if ( ImGui::BeginTable( "fields", 4, flags, ImVec2( 0.0f, -ImGui::GetFrameHeightWithSpacing() * 2 ) ) )
+        {
+            ImGui::TableSetupScrollFreeze( 0, 1 );
+            ImGui::TableSetupColumn( "Offset", ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( "Field" );
+            ImGui::TableSetupColumn( "Type", ImGuiTableColumnFlags_WidthFixed );
+            ImGui::TableSetupColumn( "Value" );
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin( static_cast< int >( this->shown_.size() ) );
+            while ( clipper.Step() )
+            {
+                this->read_rows( this->shown_.data() + clipper.DisplayStart, this->shown_.data() + clipper.DisplayEnd, frame );
+                for ( int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i ) this->render_row( this->rows_[ this->shown_[ i ] ], frame );
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Text( "%zu shown, %u reads of %llu bytes this frame", this->shown_.size(), this->reads_, this->read_bytes_ );
+        if ( !this->dump_status_.empty() ) ImGui::TextUnformatted( this->dump_status_.c_str() );
+        ImGui::End();
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "window.hpp"
+#include "prism/game_objects.hpp"
+
+namespace ts_extra_utilities
+{
+    /**
+     * \brief Shows the reflected fields of the game actor, the truck, the trailers and their chassis data.
+     *
+     * Only the rows on screen are read, with one guarded copy over their byte range per frame, and a row whose bytes
+     * differ from the previous frame's read is highlighted for a second.
+     */
+    class CInspectorWindow : public CWindow
+    {
+    private:
+        static constexpr int HIGHLIGHT_FRAMES = 60;
+
+        struct row_t
+        {
+            const prism::field_info_t* field;
+            uint32_t offset; // through the offset database
+            int read_frame; // -1 never or the last read faulted
+            int changed_frame;
+        };
+
+        std::vector< prism::game_object_t > targets_;
+        std::string selected_ = "game_actor";
+        char filter_[ 64 ] = {};
+        bool changed_only_ = false;
+
+        // the inspected object
+        const prism::struct_info_t* info_ = nullptr;
+        uint64_t address_ = 0;
+        std::vector< row_t > rows_;
+        std::vector< uint32_t > shown_; // rows passing the filters
+        std::vector< uint8_t > read_; // this frame's copy
+        std::vector< uint8_t > values_; // every row's bytes as of its last read
+
+        uint32_t reads_ = 0; // this frame
+        uint64_t read_bytes_ = 0;
+        std::string dump_status_;
+
+        void inspect( const prism::game_object_t& target );
+
+        // one copy over the bytes of rows [begin, end), diffed against what the previous frame read
+        void read_rows( const uint32_t* begin, const uint32_t* end, int frame );
+        void render_row( const row_t& row, int frame ) const;
+        void dump( const prism::game_object_t& target );
+
+    public:
+        bool init() override;
+        void render() override;
+    };
+}
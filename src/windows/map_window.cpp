@@ -0,0 +1,108 @@
+#include "map_window.hpp"
+
+#include <chrono>
+
+#include "core.hpp"
+#include "imgui.h"
+#include "map/map_index.hpp"
+#include "telemetry/telemetry.hpp"
+
+namespace ts_extra_utilities
+{
+    namespace
+    {
+        constexpr float NEAREST_NODE_DISTANCE = 2000.0f; // meters
+
+        float3_t to_float3( const scs_value_dvector_t& position )
+        {
+            return { static_cast< float >( position.x ), static_cast< float >( position.y ), static_cast< float >( position.z ) };
+        }
+    }
+
+    bool CMapWindow::init()
+    {
+        return CCore::g_instance->get_map_index() != nullptr;
+    }
+
+    void CMapWindow::render_queries()
+    {
+        const auto* telemetry = CCore::g_instance->get_telemetry();
+        if ( telemetry == nullptr || !telemetry->get_frame_store()->read( this->frame_ ) )
+        {
+            ImGui::Text( "No telemetry frame yet" );
+            return;
+        }
+
+        const auto grid = CCore::g_instance->get_map_index()->get_grid();
+        if ( grid == nullptr ) return;
+
+        ImGui::SliderFloat( "Radius (m)", &this->radius_, 10.0f, 1000.0f, "%.0f" );
+
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto truck = to_float3( this->frame_.truck.world_placement.position );
+        float node_distance = 0.0f;
+        const auto node = grid->find_nearest( truck, 1u << map::MapItemKind::NODE, NEAREST_NODE_DISTANCE, &node_distance );
+        const auto truck_items = grid->find_in_radius( truck, this->radius_, map::ALL_MAP_ITEM_KINDS, this->hits_ );
+
+        size_t trailer_items[ telemetry::MAX_TRAILERS ] = {};
+        for ( uint32_t i = 0; i < telemetry::MAX_TRAILERS; ++i )
+        {
+            if ( !this->frame_.trailers.connected[ i ] ) continue;
+            const auto trailer = to_float3( this->frame_.trailers.world_placement[ i ].position );
+            trailer_items[ i ] = grid->find_in_radius( trailer, this->radius_, map::ALL_MAP_ITEM_KINDS, this->hits_ );
+        }
+
+        const auto microseconds = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+
+        ImGui::Text( "Truck (%.1f %.1f %.1f)", truck.x, truck.y, truck.z );
+        if ( node >= 0 )
+        {
+            const auto& position = grid->get_position( node );
+            ImGui::Text( "  nearest node 0x%llx at %.1f m (%.1f %.1f %.1f)", grid->get_address( node ), node_distance, position.x, position.y,
+                         position.z );
+        }
+        else
+        {
+            ImGui::Text( "  no node within %.0f m", NEAREST_NODE_DISTANCE );
+        }
+        ImGui::Text( "  %zu items within %.0f m", truck_items, this->radius_ );
+
+        for ( uint32_t i = 0; i < telemetry::MAX_TRAILERS; ++i )
+        {
+            if ( this->frame_.trailers.connected[ i ] ) ImGui::Text( "Trailer %u: %zu items within %.0f m", i, trailer_items[ i ], this->radius_ );
+        }
+        ImGui::Text( "Queries took %.1f us", microseconds );
+    }
+
+    void CMapWindow::render()
+    {
+        ImGui::Begin( "Map index" );
+
+        const auto* index = CCore::g_instance->get_map_index();
+        const auto grid = index->get_grid();
+        if ( !index->is_running() || grid == nullptr )
+        {
+            ImGui::Text( "Waiting for base_ctrl" );
+            ImGui::End();
+            return;
+        }
+
+        ImGui::Text( "%zu items in %zu cells of %.0f m", grid->size(), grid->get_cell_count(), grid->get_cell_size() );
+        ImGui::Text( "Last change +%u -%u, built in %.2f ms (%llu builds)", index->get_last_added(), index->get_last_removed(),
+                     index->get_build_microseconds() / 1000.0, index->get_builds() );
+        if ( index->get_rejected() != 0 )
+        {
+            ImGui::Text( "%u items rejected", index->get_rejected() );
+            if ( grid->size() == 0 )
+            {
+                ImGui::TextWrapped( "No item had a plausible position, node_item.position and kdop_item.bounds_* in "
+                                    "ts-extra-utilities.offsets probably don't match this game version." );
+            }
+        }
+
+        ImGui::Separator();
+        this->render_queries();
+        ImGui::End();
+    }
+}
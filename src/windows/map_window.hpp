@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+#include "window.hpp"
+#include "telemetry/frame.hpp"
+
+namespace ts_extra_utilities
+{
+    class CMapWindow : public CWindow
+    {
+    private:
+        float radius_ = 100.0f;
+
+        telemetry::telemetry_frame_t frame_ = {}; // too big for the stack
+        std::vector< uint32_t > hits_;
+
+        void render_queries();
+
+    public:
+        bool init() override;
+        void render() override;
+    };
+}
@@ -0,0 +1,220 @@
+#include "memory_diff_window.hpp"
+
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "core.hpp"
+#include "imgui.h"
+#include "debug/debug_helpers.hpp"
+#include "memory/memory_diff_recorder.hpp"
+#include "telemetry/telemetry.hpp"
+
+namespace ts_extra_utilities
+{
+    namespace
+    {
+        bool is_scalar( const telemetry::frame_channel_t& channel )
+        {
+            return channel.type == SCS_VALUE_TYPE_bool || channel.type == SCS_VALUE_TYPE_s32 || channel.type == SCS_VALUE_TYPE_u32 ||
+                   channel.type == SCS_VALUE_TYPE_float;
+        }
+
+        const telemetry::frame_channel_t* find_channel( const std::string& name )
+        {
+            for ( const auto& channel : telemetry::get_truck_channels() )
+            {
+                if ( name == channel.name ) return &channel;
+            }
+            return nullptr;
+        }
+
+        // the reflected field holding `offset`, nullptr for padding and members that aren't reflected
+        const prism::field_info_t* find_field_at( const prism::struct_info_t* info, const uint32_t offset )
+        {
+            if ( info == nullptr ) return nullptr;
+            for ( const auto& field : *info )
+            {
+                const auto field_offset = prism::get_field_offset( *info, field );
+                if ( offset >= field_offset && offset < field_offset + field.get_size() ) return &field;
+            }
+            return nullptr;
+        }
+    }
+
+    bool CMemoryDiffWindow::init()
+    {
+        return CCore::g_instance->get_memory_diff() != nullptr;
+    }
+
+    void CMemoryDiffWindow::render_setup()
+    {
+        if ( this->objects_.empty() )
+        {
+            ImGui::Text( "No game actor" );
+            return;
+        }
+
+        ImGui::Text( "Objects" );
+        for ( const auto& object : this->objects_ )
+        {
+            const auto it = std::find( this->selected_.begin(), this->selected_.end(), object.label );
+            auto selected = it != this->selected_.end();
+            char label[ 96 ];
+            snprintf( label, sizeof( label ), "%s (%s, 0x%X bytes)", object.label, object.info->name, object.info->size );
+            if ( !ImGui::Checkbox( label, &selected ) ) continue;
+
+            if ( selected ) this->selected_.push_back( object.label );
+            else this->selected_.erase( it );
+        }
+
+        if ( ImGui::BeginCombo( "Channel", this->channel_.c_str() ) )
+        {
+            for ( const auto& channel : telemetry::get_truck_channels() )
+            {
+                if ( is_scalar( channel ) && ImGui::Selectable( channel.name, this->channel_ == channel.name ) ) this->channel_ = channel.name;
+            }
+            ImGui::EndCombo();
+        }
+
+        if ( ImGui::Button( "Start recording" ) ) this->start();
+    }
+
+    void CMemoryDiffWindow::start()
+    {
+        std::vector< memory::diff_range_t > ranges;
+        this->range_infos_.clear();
+        for ( const auto& object : this->objects_ )
+        {
+            if ( std::find( this->selected_.begin(), this->selected_.end(), object.label ) == this->selected_.end() ) continue;
+
+            memory::diff_range_t range{ object.address, object.info->size, {} };
+            snprintf( range.label, sizeof( range.label ), "%s", object.label );
+            ranges.push_back( range );
+            this->range_infos_.push_back( object.info );
+        }
+
+        const auto* channel = find_channel( this->channel_ );
+        std::string error;
+        if ( channel == nullptr ) this->status_ = this->channel_ + " isn't a truck channel";
+        else if ( !CCore::g_instance->get_memory_diff()->start( ranges, *channel, error ) ) this->status_ = "Cannot record: " + error;
+        else this->status_.clear();
+        this->candidates_.clear();
+    }
+
+    void CMemoryDiffWindow::analyze()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        CCore::g_instance->get_memory_diff()->get_diff().analyze( this->options_, this->candidates_ );
+        this->analyze_milliseconds_ = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    void CMemoryDiffWindow::write()
+    {
+        const auto& diff = CCore::g_instance->get_memory_diff()->get_diff();
+
+        SYSTEMTIME time;
+        GetLocalTime( &time );
+        char path[ MAX_PATH ];
+        snprintf( path, sizeof( path ), "%s\\ats_mod_diff_%s_%04u%02u%02u_%02u%02u%02u.tsmd", debug::DebugLogger::LOG_DIRECTORY,
+                  diff.get_channel_name().c_str(), time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond );
+
+        if ( diff.write( path, CCore::g_instance->get_game_name(), CCore::g_instance->get_game_version() ) )
+        {
+            this->status_ = std::string( "Written to " ) + path;
+        }
+        else this->status_ = std::string( "Cannot write " ) + path;
+    }
+
+    void CMemoryDiffWindow::render_candidates() const
+    {
+        const auto& ranges = CCore::g_instance->get_memory_diff()->get_diff().get_ranges();
+
+        constexpr auto flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+        if ( !ImGui::BeginTable( "candidates", 8, flags, ImVec2( 0.0f, -ImGui::GetFrameHeightWithSpacing() ) ) ) return;
+
+        ImGui::TableSetupScrollFreeze( 0, 1 );
+        ImGui::TableSetupColumn( "Object" );
+        ImGui::TableSetupColumn( "Offset", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableSetupColumn( "Field" );
+        ImGui::TableSetupColumn( "Type", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableSetupColumn( "Changes", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableSetupColumn( "r", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableSetupColumn( "Events", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableSetupColumn( "Score", ImGuiTableColumnFlags_WidthFixed );
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin( static_cast< int >( this->candidates_.size() ) );
+        while ( clipper.Step() )
+        {
+            for ( int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i )
+            {
+                const auto& candidate = this->candidates_[ i ];
+                const auto* info = candidate.range < this->range_infos_.size() ? this->range_infos_[ candidate.range ] : nullptr;
+                const auto* field = find_field_at( info, candidate.offset );
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex( 0 );
+                ImGui::TextUnformatted( ranges[ candidate.range ].label );
+                ImGui::TableSetColumnIndex( 1 );
+                ImGui::Text( "0x%04X", candidate.offset );
+                ImGui::TableSetColumnIndex( 2 );
+                if ( field != nullptr ) ImGui::TextUnformatted( field->name );
+                else ImGui::TextDisabled( "unknown" );
+                ImGui::TableSetColumnIndex( 3 );
+                ImGui::TextUnformatted( memory::to_string( candidate.type ) );
+                ImGui::TableSetColumnIndex( 4 );
+                ImGui::Text( "%u", candidate.changes );
+                ImGui::TableSetColumnIndex( 5 );
+                ImGui::Text( "%.3f", candidate.correlation );
+                ImGui::TableSetColumnIndex( 6 );
+                ImGui::Text( "%.3f", candidate.event_score );
+                ImGui::TableSetColumnIndex( 7 );
+                ImGui::Text( "%.3f", candidate.score );
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    void CMemoryDiffWindow::render()
+    {
+        ImGui::Begin( "Memory diff" );
+
+        auto* recorder = CCore::g_instance->get_memory_diff();
+        const auto& diff = recorder->get_diff();
+        prism::collect_game_objects( reinterpret_cast< uint64_t >( CCore::g_instance->get_game_actor() ), this->objects_ );
+
+        if ( recorder->is_recording() )
+        {
+            ImGui::Text( "Recording %s, %llu frames, %llu invalid, %.1f us per frame", diff.get_channel_name().c_str(), recorder->get_frames(),
+                         recorder->get_invalid_frames(), recorder->get_capture_microseconds() );
+            if ( ImGui::Button( "Stop" ) ) recorder->stop();
+        }
+        else this->render_setup();
+
+        if ( diff.get_capacity() != 0 )
+        {
+            ImGui::Text( "%u of %u frames of %u bytes kept, %u dwords changed on the last one", diff.get_frame_count(), diff.get_capacity(),
+                         diff.get_frame_bytes(), diff.get_last_changed() );
+
+            auto min_changes = static_cast< int >( this->options_.min_changes );
+            auto tolerance = static_cast< int >( this->options_.tolerance );
+            if ( ImGui::SliderInt( "Min changes", &min_changes, 1, 100 ) ) this->options_.min_changes = static_cast< uint32_t >( min_changes );
+            if ( ImGui::SliderInt( "Tolerance (frames)", &tolerance, 0, 10 ) ) this->options_.tolerance = static_cast< uint32_t >( tolerance );
+            ImGui::SliderFloat( "Min score", &this->options_.min_score, 0.0f, 1.0f, "%.2f" );
+
+            if ( ImGui::Button( "Analyze" ) ) this->analyze();
+            ImGui::SameLine();
+            if ( ImGui::Button( "Export" ) ) this->write();
+            ImGui::SameLine();
+            ImGui::Text( "%zu candidates in %.1f ms", this->candidates_.size(), this->analyze_milliseconds_ );
+
+            this->render_candidates();
+        }
+
+        if ( !this->status_.empty() ) ImGui::TextUnformatted( this->status_.c_str() );
+        ImGui::End();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "window.hpp"
+#include "memory/memory_diff.hpp"
+#include "prism/game_objects.hpp"
+
+namespace ts_extra_utilities
+{
+    /**
+     * \brief Records the selected game objects every frame against a truck channel and lists the fields that follow it,
+     * to put names on unknown members. Start, toggle the control a few times, then analyze or export for memory-diff.
+     */
+    class CMemoryDiffWindow : public CWindow
+    {
+    private:
+        std::vector< prism::game_object_t > objects_;
+        std::vector< std::string > selected_ = { "truck", "truck.vehicle", "truck.chassis" };
+        std::string channel_ = "truck.light.beam.low";
+
+        std::vector< const prism::struct_info_t* > range_infos_; // of the recording's ranges, for the field names
+        memory::diff_options_t options_;
+        std::vector< memory::diff_candidate_t > candidates_;
+        double analyze_milliseconds_ = 0;
+        std::string status_;
+
+        void render_setup();
+        void start();
+        void analyze();
+        void write();
+        void render_candidates() const;
+
+    public:
+        bool init() override;
+        void render() override;
+    };
+}
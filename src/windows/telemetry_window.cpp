@@ -0,0 +1,188 @@
+#include "telemetry_window.hpp"
+
+#include <Windows.h>
+
+#include "core.hpp"
+#include "imgui.h"
+#include "debug/debug_helpers.hpp"
+#include "telemetry/telemetry.hpp"
+
+namespace ts_extra_utilities
+{
+    bool CTelemetryWindow::init()
+    {
+        const auto* telemetry = CCore::g_instance->get_telemetry();
+        if ( telemetry == nullptr ) return false;
+
+        this->gameplay_cursor_ = telemetry->get_gameplay_events()->subscribe();
+        return true;
+    }
+
+    void CTelemetryWindow::render_configuration() const
+    {
+        const auto* configuration = CCore::g_instance->get_telemetry()->get_configuration();
+
+        const auto& truck = configuration->get_truck();
+        if ( truck.present )
+        {
+            ImGui::Text( "Truck: %s %s (%s), %u wheels", truck.identity.brand, truck.identity.name, truck.identity.id, truck.wheels.count );
+            ImGui::Text( "  hook (%.2f %.2f %.2f)", truck.hook_position.x, truck.hook_position.y, truck.hook_position.z );
+        }
+        else
+        {
+            ImGui::Text( "Truck: none" );
+        }
+
+        for ( uint32_t i = 0; i < configuration->get_trailer_count(); ++i )
+        {
+            const auto& trailer = configuration->get_trailer( i );
+            if ( !trailer.present ) continue;
+
+            ImGui::Text( "Trailer %u: %s, %u wheels, hook (%.2f %.2f %.2f)", i, trailer.identity.id, trailer.wheels.count,
+                         trailer.hook_position.x, trailer.hook_position.y, trailer.hook_position.z );
+        }
+
+        const auto& job = configuration->get_job();
+        if ( job.present )
+        {
+            ImGui::Text( "Job: %s, %s -> %s", job.identity.cargo, job.identity.source_city_id, job.identity.destination_city_id );
+        }
+    }
+
+    void CTelemetryWindow::render_recorder()
+    {
+        auto* recorder = CCore::g_instance->get_telemetry()->get_recorder();
+
+        if ( !recorder->is_recording() )
+        {
+            if ( ImGui::Button( "Start recording" ) )
+            {
+                SYSTEMTIME time;
+                GetLocalTime( &time );
+
+                char path[ MAX_PATH ];
+                snprintf( path, sizeof( path ), "%s\\ats_telemetry_%04u%02u%02u_%02u%02u%02u.tsrec",
+                          debug::DebugLogger::LOG_DIRECTORY, time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond );
+
+                if ( recorder->start( path ) ) this->recording_path_ = path;
+                else CCore::g_instance->error( "Could not start the telemetry recording '%s'", path );
+            }
+        }
+        else if ( ImGui::Button( "Stop recording" ) )
+        {
+            recorder->stop();
+        }
+
+        if ( this->recording_path_.empty() ) return;
+
+        ImGui::Text( "%s", this->recording_path_.c_str() );
+        ImGui::Text( "Frames: %llu, dropped: %llu", recorder->get_frames_recorded(), recorder->get_frames_dropped() );
+        ImGui::Text( "Written: %.1f KiB", static_cast< double >( recorder->get_bytes_written() ) / 1024.0 );
+        ImGui::Text( "Gameplay events: %llu", recorder->get_events_recorded() );
+    }
+
+    void CTelemetryWindow::render_filter() const
+    {
+        auto* filter = CCore::g_instance->get_telemetry()->get_filter();
+
+        bool enabled = filter->is_enabled();
+        if ( ImGui::Checkbox( "Filter slow gauges", &enabled ) ) filter->set_enabled( enabled );
+
+        const auto raw = filter->get_raw_changes();
+        const auto passed = filter->get_passed_changes();
+        ImGui::Text( "%u channels, %llu of %llu value changes passed on", filter->get_rule_count(), passed, raw );
+    }
+
+    void CTelemetryWindow::render_stream()
+    {
+        auto* stream = CCore::g_instance->get_telemetry()->get_stream();
+
+        if ( !stream->is_running() )
+        {
+            ImGui::InputInt( "Port", &this->stream_port_ );
+            ImGui::Checkbox( "Allow other machines", &this->stream_allow_remote_ );
+
+            if ( ImGui::Button( "Start streaming" ) )
+            {
+                if ( this->stream_port_ <= 0 || this->stream_port_ > 0xFFFF || !stream->start( static_cast< uint16_t >( this->stream_port_ ), this->stream_allow_remote_ ) )
+                {
+                    CCore::g_instance->error( "Could not start the telemetry stream on port %d", this->stream_port_ );
+                }
+            }
+            return;
+        }
+
+        if ( ImGui::Button( "Stop streaming" ) ) stream->stop();
+
+        ImGui::Text( "UDP %s:%d, subscribers: %u", this->stream_allow_remote_ ? "*" : "127.0.0.1", this->stream_port_, stream->get_subscriber_count() );
+        ImGui::Text( "Frames: %llu, dropped: %llu", stream->get_frames_streamed(), stream->get_frames_dropped() );
+        ImGui::Text( "Datagrams: %llu, %.1f KiB, send errors: %llu", stream->get_datagrams_sent(),
+                     static_cast< double >( stream->get_bytes_sent() ) / 1024.0, stream->get_send_errors() );
+    }
+
+    void CTelemetryWindow::render_gameplay_events()
+    {
+        if ( this->received_events_ == 0 )
+        {
+            ImGui::Text( "None yet" );
+            return;
+        }
+
+        // newest first
+        const auto count = this->received_events_ < RECENT_EVENTS ? this->received_events_ : RECENT_EVENTS;
+        for ( uint64_t i = 0; i < count; ++i )
+        {
+            const auto& event = this->recent_events_[ ( this->received_events_ - 1 - i ) % RECENT_EVENTS ];
+
+            char text[ 256 ];
+            telemetry::format_gameplay_event( event, text, sizeof( text ) );
+            ImGui::Text( "%8.1f s  %s", static_cast< double >( event.render_time ) / 1000000.0, text );
+        }
+
+        if ( this->gameplay_cursor_.lost != 0 ) ImGui::Text( "Missed: %llu", this->gameplay_cursor_.lost );
+    }
+
+    void CTelemetryWindow::render()
+    {
+        ImGui::Begin( "Telemetry" );
+
+        const auto* telemetry = CCore::g_instance->get_telemetry();
+
+        // drained every frame, even collapsed, so the history doesn't depend on the header being open
+        telemetry::gameplay_event_t event;
+        while ( telemetry->get_gameplay_events()->poll( this->gameplay_cursor_, event ) )
+        {
+            this->recent_events_[ this->received_events_++ % RECENT_EVENTS ] = event;
+        }
+
+        ImGui::Text( "Frames published: %llu", telemetry->get_frame_store()->get_published_count() );
+        ImGui::Text( "Trailers connected: %d", telemetry->get_trailer_count() );
+
+        if ( ImGui::CollapsingHeader( "Configuration" ) )
+        {
+            this->render_configuration();
+        }
+
+        if ( ImGui::CollapsingHeader( "Filter" ) )
+        {
+            this->render_filter();
+        }
+
+        if ( ImGui::CollapsingHeader( "Recorder", ImGuiTreeNodeFlags_DefaultOpen ) )
+        {
+            this->render_recorder();
+        }
+
+        if ( ImGui::CollapsingHeader( "Streaming" ) )
+        {
+            this->render_stream();
+        }
+
+        if ( ImGui::CollapsingHeader( "Gameplay events", ImGuiTreeNodeFlags_DefaultOpen ) )
+        {
+            this->render_gameplay_events();
+        }
+
+        ImGui::End();
+    }
+}
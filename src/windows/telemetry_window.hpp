@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+#include "window.hpp"
+#include "telemetry/gameplay_events.hpp"
+#include "telemetry/stream.hpp"
+
+namespace ts_extra_utilities
+{
+    class CTelemetryWindow : public CWindow
+    {
+    private:
+        static constexpr uint32_t RECENT_EVENTS = 8;
+
+        std::string recording_path_;
+
+        telemetry::gameplay_event_cursor_t gameplay_cursor_ = {};
+        telemetry::gameplay_event_t recent_events_[ RECENT_EVENTS ] = {};
+        uint64_t received_events_ = 0;
+
+        int stream_port_ = telemetry::STREAM_DEFAULT_PORT;
+        bool stream_allow_remote_ = false;
+
+        void render_configuration() const;
+        void render_recorder();
+        void render_filter() const;
+        void render_stream();
+        void render_gameplay_events();
+
+    public:
+        bool init() override;
+        void render() override;
+    };
+}
@@ -1,36 +1,34 @@
 ﻿#include "trailer_manipulation.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "imgui.h"
 
 #include "core.hpp"
 #include "hooks/function_hook.hpp"
 #include "hooks/vtable_hook.hpp"
+#include "prism/collections/array_span.hpp"
 #include "prism/controllers/base_ctrl.hpp"
 #include "prism/game_actor.hpp"
+#include "prism/offsets.hpp"
 #include "prism/vehicles/game_trailer_actor.hpp"
 #include "prism/physics/physics_actor_t.hpp"
 #include "prism/vehicles/accessories/data/accessory_chassis_data.hpp"
 #include "memory/robust_pattern_scanner.hpp"
+#include "memory/snapshot_capture.hpp"
+#include "debug/debug_helpers.hpp"
+#include "debug/flight_recorder.hpp"
 
 namespace ts_extra_utilities
 {
-    struct TrailerJointState
-    {
-        enum Enum
-        {
-            NORMAL,
-            LOCKED,
-            DISCONNECTED,
-        };
-    };
+    using trailers::TrailerJointState;
 
-    thread_local bool locked_trailers[ 20 ] = {};
-
-    thread_local TrailerJointState::Enum trailer_joints[ 20 ] = {};
-
-    thread_local std::shared_ptr< CVirtualFunctionHook > steering_advance_hook = nullptr;
-    thread_local std::shared_ptr< CFunctionHook > crashes_when_disconnected_hook = nullptr;
-    thread_local std::shared_ptr< CFunctionHook > connect_slave_hook = nullptr;
+    // set up on the render thread before the hooks are enabled, the detours read them on the physics thread
+    std::shared_ptr< CVirtualFunctionHook > steering_advance_hook = nullptr;
+    std::shared_ptr< CFunctionHook > crashes_when_disconnected_hook = nullptr;
+    std::shared_ptr< CFunctionHook > connect_slave_hook = nullptr;
+    prism::set_individual_steering_fn* set_individual_steering = nullptr;
 
     /**
      * \brief Hook for prism::physics_trailer_u::steering_advance so we can control which trailer can be steered by the game
@@ -39,17 +37,29 @@ namespace ts_extra_utilities
      */
     uint64_t hk_steering_advance( prism::physics_trailer_u* self )
     {
-        int trailer_index = 0;
-        const auto* check_trailer = CCore::g_instance->get_game_actor()->game_trailer_actor;
-        while ( check_trailer != nullptr && self != check_trailer )
+        // runs for every trailer on every physics step, the chain is only walked when it changes, see CCore::refresh_trailer_map,
+        // until then trailers are resolved against the previous chain. Passing through is only the lookup and the lock load, the
+        // flight recorder only sees the steps that override the game
+        auto* control = CCore::g_instance->get_trailer_control();
+        const auto trailer_index = control->find_trailer( self );
+        if ( trailer_index < 0 || !control->is_steering_locked( static_cast< uint32_t >( trailer_index ) ) )
         {
-            check_trailer = check_trailer->slave_trailer;
-            ++trailer_index;
+            return steering_advance_hook->get_original< prism::physics_trailer_u_steering_advance_fn >()( self );
         }
 
-        if ( check_trailer == nullptr || locked_trailers[ trailer_index ] == false )
+        // the game no longer steers this trailer, the reverse steering controller, a playing profile or else angles set in the UI
+        // are applied here between physics steps
+        const auto* telemetry = CCore::g_instance->get_telemetry();
+        const trailers::steering_clock_t now{ telemetry->get_simulation_seconds(), telemetry->get_travelled_distance() };
+
+        float steering;
+        if ( ( control->get_controller_steering( static_cast< uint32_t >( trailer_index ), steering ) ||
+               control->evaluate_profile( static_cast< uint32_t >( trailer_index ), now, steering ) ||
+               control->consume_steering( static_cast< uint32_t >( trailer_index ), steering ) ) && set_individual_steering != nullptr )
         {
-            return steering_advance_hook->get_original< prism::physics_trailer_u_steering_advance_fn >()( self );
+            debug::record_event( debug::FlightEvent::HOOK_CALL, "steering_advance", reinterpret_cast< uint64_t >( self ), static_cast< uint64_t >( trailer_index ) );
+            prism::fields::vehicle_shared::steering( self ) = steering;
+            set_individual_steering( prism::fields::vehicle_shared::wheel_steering_stuff( self ), steering );
         }
         return 0;
     }
@@ -59,6 +69,8 @@ namespace ts_extra_utilities
     // and the joint is not there when we have the trailer disconnected
     void hk_crashes_when_disconnected( prism::physics_trailer_u* self, prism::game_trailer_actor_u* trailer_actor )
     {
+        debug::record_event( debug::FlightEvent::HOOK_CALL, "crashes_when_disconnected", reinterpret_cast< uint64_t >( self ),
+                             reinterpret_cast< uint64_t >( trailer_actor ) );
         CCore::g_instance->info("crashes_when_disconnected: Hook function called!");
         
         // For now, let's just prevent any calls to this function entirely
@@ -103,6 +115,7 @@ namespace ts_extra_utilities
      */
     void hk_connect_slave( prism::physics_trailer_u* _ )
     {
+        debug::record_event( debug::FlightEvent::HOOK_CALL, "connect_slave", reinterpret_cast< uint64_t >( _ ) );
         // original_connect_slave(self);
     }
 
@@ -126,6 +139,7 @@ namespace ts_extra_utilities
         if (steering_addr != 0)
         {
             this->set_individual_steering_fn_ = reinterpret_cast<prism::set_individual_steering_fn*>(steering_addr);
+            set_individual_steering = this->set_individual_steering_fn_;
             CCore::g_instance->debug( "Found set_individual_steering function @ +{:x}", memory::as_offset(steering_addr) );
         }
         else
@@ -229,7 +243,7 @@ namespace ts_extra_utilities
         
         // Check if we have a valid game actor
         auto game_actor = CCore::g_instance->get_game_actor();
-        if (!game_actor || !game_actor->game_trailer_actor) {
+        if (!game_actor || !prism::fields::game_actor::game_trailer_actor(game_actor)) {
             CCore::g_instance->warning("Game actor or trailer actor is null");
             return false;
         }
@@ -253,13 +267,13 @@ namespace ts_extra_utilities
             if (this->connect_slave_address_ != 0 && trailer_index > 0) {
                 // Get the game actor
                 auto game_actor = CCore::g_instance->get_game_actor();
-                if (game_actor && game_actor->game_trailer_actor) {
+                if (game_actor && prism::fields::game_actor::game_trailer_actor(game_actor)) {
                     CCore::g_instance->info("Attempting to disconnect by setting slave to null");
                     
                     // For direct disconnection, we'll try setting the slave to nullptr
                     // This is a safer approach than calling unknown functions
                     auto connect_fn = reinterpret_cast<void(*)(prism::game_trailer_actor_u*, prism::game_trailer_actor_u*)>(this->connect_slave_address_);
-                    connect_fn(game_actor->game_trailer_actor, nullptr);
+                    connect_fn(prism::fields::game_actor::game_trailer_actor(game_actor), nullptr);
                     
                     CCore::g_instance->info("Disconnection attempt completed");
                 }
@@ -273,15 +287,29 @@ namespace ts_extra_utilities
 
     void CTrailerManipulation::render_trailer_steering( prism::game_trailer_actor_u* current_trailer, uint32_t i ) const
     {
-        if ( ImGui::Checkbox( "Locked##steering", &locked_trailers[ i ] ) )
+        auto* control = CCore::g_instance->get_trailer_control();
+
+        bool locked = control->is_steering_locked( i );
+        if ( ImGui::Checkbox( "Locked##steering", &locked ) )
         {
-            CCore::g_instance->info( "{} steering for {}", locked_trailers[ i ] ? "Locking" : "Unlocking", i );
+            // hold the wheels where the game left them until an angle is chosen
+            if ( locked ) control->set_steering_target( i, prism::fields::vehicle_shared::steering( current_trailer ) );
+            control->set_steering_locked( i, locked );
+
+            debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "steering_lock", i, reinterpret_cast< uint64_t >( current_trailer ),
+                                 locked ? debug::TrailerOperation::LOCK_STEERING : debug::TrailerOperation::UNLOCK_STEERING );
+            CCore::g_instance->info( "{} steering for {}", locked ? "Locking" : "Unlocking", i );
         }
-        ImGui::BeginDisabled( !locked_trailers[ i ] );
-        if ( ImGui::SliderFloat( "Angle", &current_trailer->steering, -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp ) )
+        ImGui::BeginDisabled( !locked );
+
+        float steering = control->get_steering_target( i );
+        bool steering_changed = false;
+        if ( ImGui::SliderFloat( "Angle", &steering, -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp ) )
         {
-            CCore::g_instance->info( "Changed steering angle for trailer {} to {}", i, current_trailer->steering );
-            this->set_individual_steering_fn_( current_trailer->wheel_steering_stuff, current_trailer->steering );
+            CCore::g_instance->info( "Changed steering angle for trailer {} to {}", i, steering );
+            debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "set_steering", i, reinterpret_cast< uint64_t >( current_trailer ),
+                                 debug::TrailerOperation::SET_STEERING );
+            steering_changed = true;
         }
 
         // Note: PushItemFlag was removed in newer ImGui, using button repeat directly
@@ -292,29 +320,34 @@ namespace ts_extra_utilities
 
         if ( ImGui::ArrowButton( "rotate_left", ImGuiDir_Left ) )
         {
-            current_trailer->steering -= 0.02f;
-            if ( current_trailer->steering < -1.f )
-            {
-                current_trailer->steering = -1.f;
-            }
-            this->set_individual_steering_fn_( current_trailer->wheel_steering_stuff, current_trailer->steering );
+            steering -= 0.02f;
+            steering_changed = true;
         }
         ImGui::SameLine();
         if ( ImGui::Button( "center" ) )
         {
-            current_trailer->steering = 0.f;
-            this->set_individual_steering_fn_( current_trailer->wheel_steering_stuff, current_trailer->steering );
+            steering = 0.f;
+            steering_changed = true;
         }
         ImGui::SameLine();
 
         if ( ImGui::ArrowButton( "rotate_right", ImGuiDir_Right ) )
         {
-            current_trailer->steering += 0.02f;
-            if ( current_trailer->steering > 1.f )
+            steering += 0.02f;
+            steering_changed = true;
+        }
+
+        if ( steering_changed )
+        {
+            control->set_steering_target( i, steering );
+
+            // without the detour nothing on the physics thread picks the target up, so it's written from here as before
+            if ( steering_advance_hook == nullptr || steering_advance_hook->get_status() != CHook::HOOKED )
             {
-                current_trailer->steering = 1.f;
+                auto& trailer_steering = prism::fields::vehicle_shared::steering( current_trailer );
+                trailer_steering = control->get_steering_target( i );
+                this->set_individual_steering_fn_( prism::fields::vehicle_shared::wheel_steering_stuff( current_trailer ), trailer_steering );
             }
-            this->set_individual_steering_fn_( current_trailer->wheel_steering_stuff, current_trailer->steering );
         }
 
         // Restore original repeat settings
@@ -325,73 +358,204 @@ namespace ts_extra_utilities
         ImGui::EndDisabled();
     }
 
-    void CTrailerManipulation::connect_trailer( prism::game_trailer_actor_u* current_trailer, const uint32_t i ) const
+    uint32_t CTrailerManipulation::get_trailer_chain( prism::game_trailer_actor_u** chain )
     {
-        // disable the function that automatically connects slave trailers
-        if ( connect_slave_hook->hook() != CHook::HOOKED )
+        uint32_t count = 0;
+        const auto* game_actor = CCore::g_instance->get_game_actor();
+        for ( auto* trailer = game_actor != nullptr ? prism::fields::game_actor::game_trailer_actor( game_actor ) : nullptr;
+              trailer != nullptr && count < trailers::MAX_TRAILERS; trailer = prism::fields::physics_trailer::slave_trailer( trailer ) )
         {
-            CCore::g_instance->error( "Could not enable 'connect_slave' hook in 'connect_trailer'" );
-            return;
+            chain[ count++ ] = trailer;
         }
-        auto* last_connected_trailer = CCore::g_instance->get_game_actor()->get_last_trailer_connected_to_truck();
+        return count;
+    }
 
-        if ( last_connected_trailer == nullptr )
+    float3_t CTrailerManipulation::get_hook_vector( prism::game_trailer_actor_u* parent ) const
+    {
+        if ( parent == nullptr )
         {
-            auto* truck = CCore::g_instance->get_game_actor()->game_physics_vehicle;
-            const float3_t vec{
-                truck->accessory_chassis_data->hook_position.x - truck->hook_locator.x,
-                truck->accessory_chassis_data->hook_position.y - truck->hook_locator.y,
-                truck->accessory_chassis_data->hook_position.z - truck->hook_locator.z
-            };
-            current_trailer->connect( truck, vec, 0, true, false );
-            current_trailer->set_trailer_brace( false );
+            const auto* truck = prism::fields::game_actor::game_physics_vehicle( CCore::g_instance->get_game_actor() );
+            const auto& hook_position = prism::fields::accessory_chassis_data::hook_position( prism::fields::vehicle_shared::accessory_chassis_data( truck ) );
+            const auto& hook_locator = prism::fields::vehicle_shared::hook_locator( truck );
+            return { hook_position.x - hook_locator.x, hook_position.y - hook_locator.y, hook_position.z - hook_locator.z };
         }
-        else
+
+        float3_t slave_hook_position{};
+        get_slave_hook_position_fn_( parent, &slave_hook_position );
+        const auto& hook_locator = prism::fields::vehicle_shared::hook_locator( parent );
+        return { slave_hook_position.x - hook_locator.x, slave_hook_position.y - hook_locator.y, slave_hook_position.z - hook_locator.z };
+    }
+
+    uint32_t CTrailerManipulation::connect_chain( prism::game_trailer_actor_u* const* chain, const uint32_t* indices, const uint32_t count ) const
+    {
+        auto* game_actor = CCore::g_instance->get_game_actor();
+        if ( game_actor == nullptr || count == 0 ) return 0;
+
+        // everything is resolved before the first connect, each trailer hangs from the one before it in the batch
+        struct link_t
         {
-            float3_t slave_hook_position{};
-            get_slave_hook_position_fn_( last_connected_trailer, &slave_hook_position );
-            const float3_t vec{
-                slave_hook_position.x - last_connected_trailer->hook_locator.x,
-                slave_hook_position.y - last_connected_trailer->hook_locator.y,
-                slave_hook_position.z - last_connected_trailer->hook_locator.z
-            };
-            current_trailer->connect( last_connected_trailer, vec, 0, true, false );
-            current_trailer->set_trailer_brace( false );
+            prism::game_trailer_actor_u* trailer;
+            prism::game_trailer_actor_u* parent; // nullptr = the truck
+            float3_t hook;
+            uint32_t index;
+        };
+
+        link_t links[ trailers::MAX_TRAILERS ];
+        uint32_t link_count = 0;
+        auto* parent = game_actor->get_last_trailer_connected_to_truck();
+        for ( uint32_t i = 0; i < count && link_count < trailers::MAX_TRAILERS; ++i )
+        {
+            auto* trailer = chain[ i ];
+            if ( trailer == nullptr || trailer == parent || prism::fields::physics_trailer::physics_joint( trailer ) != nullptr ) continue;
+
+            links[ link_count++ ] = { trailer, parent, this->get_hook_vector( parent ), indices[ i ] };
+            parent = trailer;
+        }
+        if ( link_count == 0 ) return 0;
+
+        // disable the function that automatically connects slave trailers, once for the whole batch
+        if ( connect_slave_hook->hook() != CHook::HOOKED )
+        {
+            CCore::g_instance->error( "Could not enable 'connect_slave' hook in 'connect_chain'" );
+            return 0;
+        }
+
+        auto* control = CCore::g_instance->get_trailer_control();
+        for ( uint32_t i = 0; i < link_count; ++i )
+        {
+            const auto& link = links[ i ];
+            debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "connect", link.index, reinterpret_cast< uint64_t >( link.trailer ),
+                                 debug::TrailerOperation::CONNECT );
+
+            if ( link.parent == nullptr ) link.trailer->connect( prism::fields::game_actor::game_physics_vehicle( game_actor ), link.hook, 0, true, false );
+            else link.trailer->connect( link.parent, link.hook, 0, true, false );
+            link.trailer->set_trailer_brace( false );
+            control->set_joint( link.index, TrailerJointState::NORMAL );
         }
 
         if ( connect_slave_hook->unhook() != CHook::CREATED )
         {
-            CCore::g_instance->error( "Could not disable 'connect_slave' hook in 'connect_trailer'" );
+            CCore::g_instance->error( "Could not disable 'connect_slave' hook in 'connect_chain'" );
+        }
+
+        CCore::g_instance->refresh_trailer_map( true );
+        return link_count;
+    }
+
+    void CTrailerManipulation::connect_trailer( prism::game_trailer_actor_u* current_trailer, const uint32_t i ) const
+    {
+        this->connect_chain( &current_trailer, &i, 1 );
+    }
+
+    uint32_t CTrailerManipulation::connect_trailers( const uint32_t* indices, const uint32_t count ) const
+    {
+        prism::game_trailer_actor_u* chain[ trailers::MAX_TRAILERS ];
+        const auto chain_length = get_trailer_chain( chain );
+
+        prism::game_trailer_actor_u* batch[ trailers::MAX_TRAILERS ];
+        uint32_t batch_indices[ trailers::MAX_TRAILERS ];
+        uint32_t batch_count = 0;
+        for ( uint32_t i = 0; i < count && batch_count < trailers::MAX_TRAILERS; ++i )
+        {
+            if ( indices[ i ] >= chain_length ) continue;
+            batch[ batch_count ] = chain[ indices[ i ] ];
+            batch_indices[ batch_count++ ] = indices[ i ];
+        }
+
+        const auto connected = this->connect_chain( batch, batch_indices, batch_count );
+        CCore::g_instance->info( "Connected %u of %u trailers", connected, count );
+        return connected;
+    }
+
+    uint32_t CTrailerManipulation::disconnect_trailers_behind( const int32_t index ) const
+    {
+        prism::game_trailer_actor_u* chain[ trailers::MAX_TRAILERS ];
+        const auto chain_length = get_trailer_chain( chain );
+
+        // from the back, so no trailer is ever left hanging from one that is already gone
+        auto* control = CCore::g_instance->get_trailer_control();
+        uint32_t disconnected = 0;
+        for ( auto i = static_cast< int32_t >( chain_length ) - 1; i > index; --i )
+        {
+            auto* trailer = chain[ i ];
+            if ( prism::fields::physics_trailer::physics_joint( trailer ) == nullptr ) continue;
+
+            debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "disconnect", static_cast< uint64_t >( i ), reinterpret_cast< uint64_t >( trailer ),
+                                 debug::TrailerOperation::DISCONNECT );
+            trailer->set_trailer_brace( true );
+            trailer->disconnect();
+            control->set_joint( static_cast< uint32_t >( i ), TrailerJointState::DISCONNECTED );
+            ++disconnected;
+        }
+
+        if ( disconnected != 0 ) CCore::g_instance->refresh_trailer_map( true );
+        CCore::g_instance->info( "Disconnected %u trailers behind trailer %d", disconnected, index );
+        return disconnected;
+    }
+
+    void CTrailerManipulation::render_trailer_chassis( const prism::game_trailer_actor_u* current_trailer ) const
+    {
+        const auto* chassis = prism::fields::vehicle_shared::accessory_chassis_data( current_trailer );
+        if ( chassis == nullptr || IsBadReadPtr( chassis, sizeof( prism::accessory_chassis_data_u ) ) )
+        {
+            ImGui::TextDisabled( "No chassis data" );
+            return;
+        }
+
+        // the names are interned, nothing is decoded or allocated after the first frame
+        auto* names = CCore::g_instance->get_token_dictionary();
+        ImGui::Text( "Variant: %s, look: %s", names->get_name( chassis->variant ), names->get_name( chassis->look ) );
+
+        ImGui::Text( "Steerable axles:" );
+        const auto axles = prism::make_span( chassis->steerable_axle, 32 );
+        if ( axles.empty() || IsBadReadPtr( axles.data(), axles.size() * sizeof( prism::token_t ) ) )
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled( "none" );
+            return;
+        }
+        for ( const auto axle : axles )
+        {
+            ImGui::SameLine();
+            ImGui::Text( "%s", names->get_name( axle ) );
         }
     }
 
     void CTrailerManipulation::render_trailer_joint( prism::game_trailer_actor_u* current_trailer, const uint32_t i ) const
     {
+        auto* control = CCore::g_instance->get_trailer_control();
+
         ImGui::SeparatorText( "Joint" );
         if ( CCore::g_instance->get_base_ctrl_instance()->selected_physics_engine == 1 ) // PhysX
         {
-            if ( current_trailer->physics_joint != nullptr && current_trailer->physics_joint->px_joint != nullptr )
+            auto* physics_joint = prism::fields::physics_trailer::physics_joint( current_trailer );
+            auto* px_joint = physics_joint != nullptr ? prism::fields::physics_joint_physx::px_joint( physics_joint ) : nullptr;
+            if ( px_joint != nullptr )
             {
-                if ( ImGui::RadioButton( "Unlocked##joint", trailer_joints[ i ] == TrailerJointState::NORMAL ) )
+                if ( ImGui::RadioButton( "Unlocked##joint", control->get_joint( i ) == TrailerJointState::NORMAL ) )
                 {
-                    if ( trailer_joints[ i ] == TrailerJointState::DISCONNECTED )
+                    if ( control->get_joint( i ) == TrailerJointState::DISCONNECTED )
                     {
                         this->connect_trailer( current_trailer, i );
                     }
 
-                    trailer_joints[ i ] = TrailerJointState::NORMAL;
-                    current_trailer->physics_joint->px_joint->setMotion( physx::PxD6Axis::eTWIST, physx::PxD6Motion::eFREE );
+                    control->set_joint( i, TrailerJointState::NORMAL );
+                    debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "joint_unlock", i, reinterpret_cast< uint64_t >( current_trailer ),
+                                         debug::TrailerOperation::UNLOCK_JOINT );
+                    px_joint->setMotion( physx::PxD6Axis::eTWIST, physx::PxD6Motion::eFREE );
                 }
                 ImGui::SameLine();
-                if ( ImGui::RadioButton( "Locked##joint", trailer_joints[ i ] == TrailerJointState::LOCKED ) )
+                if ( ImGui::RadioButton( "Locked##joint", control->get_joint( i ) == TrailerJointState::LOCKED ) )
                 {
-                    if ( trailer_joints[ i ] == TrailerJointState::DISCONNECTED )
+                    if ( control->get_joint( i ) == TrailerJointState::DISCONNECTED )
                     {
                         this->connect_trailer( current_trailer, i );
                     }
 
-                    trailer_joints[ i ] = TrailerJointState::LOCKED;
-                    current_trailer->physics_joint->px_joint->setMotion( physx::PxD6Axis::eTWIST, physx::PxD6Motion::eLOCKED );
+                    control->set_joint( i, TrailerJointState::LOCKED );
+                    debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "joint_lock", i, reinterpret_cast< uint64_t >( current_trailer ),
+                                         debug::TrailerOperation::LOCK_JOINT );
+                    px_joint->setMotion( physx::PxD6Axis::eTWIST, physx::PxD6Motion::eLOCKED );
                 }
             }
         }
@@ -404,18 +568,21 @@ namespace ts_extra_utilities
         // nothing in this plugin is recommended to be used in TruckersMP but this is completely broken when used in TruckersMP and WILL get you banned, so I've explicitly disabled it.
         if ( !CCore::g_instance->is_truckersmp() )
         {
-            ImGui::BeginDisabled( current_trailer->physics_joint != nullptr );
+            const auto connected = prism::fields::physics_trailer::physics_joint( current_trailer ) != nullptr;
+            ImGui::BeginDisabled( connected );
             if ( ImGui::Button( "Connect##trailer" ) )
             {
                 this->connect_trailer( current_trailer, i );
-                trailer_joints[ i ] = TrailerJointState::NORMAL;
+                control->set_joint( i, TrailerJointState::NORMAL );
             }
             ImGui::EndDisabled();
             ImGui::SameLine();
-            ImGui::BeginDisabled( current_trailer->physics_joint == nullptr );
+            ImGui::BeginDisabled( !connected );
             if ( ImGui::Button( "Disconnect##trailer" ) )
             {
                 CCore::g_instance->info("User clicked disconnect button for trailer {}", i);
+                debug::record_event( debug::FlightEvent::TRAILER_OPERATION, "disconnect", i, reinterpret_cast< uint64_t >( current_trailer ),
+                                     debug::TrailerOperation::DISCONNECT );
                 
                 // Use our safer disconnection approach
                 this->safe_disconnect_trailer(i);
@@ -423,7 +590,8 @@ namespace ts_extra_utilities
                 // Also do the original approach as backup
                 current_trailer->set_trailer_brace( true );
                 current_trailer->disconnect();
-                trailer_joints[ i ] = TrailerJointState::DISCONNECTED;
+                CCore::g_instance->refresh_trailer_map( true );
+                control->set_joint( i, TrailerJointState::DISCONNECTED );
             }
             ImGui::EndDisabled();
         }
@@ -487,7 +655,7 @@ namespace ts_extra_utilities
         ImGui::Text("Base ctrl: 0x%016llx", reinterpret_cast<uint64_t>(base_ctrl));
         ImGui::Text("Game actor: 0x%016llx", reinterpret_cast<uint64_t>(game_actor));
         if (game_actor != nullptr) {
-            ImGui::Text("game_trailer_actor field: 0x%016llx", reinterpret_cast<uint64_t>(game_actor->game_trailer_actor));
+            ImGui::Text("game_trailer_actor field: 0x%016llx", reinterpret_cast<uint64_t>(prism::fields::game_actor::game_trailer_actor(game_actor)));
             ImGui::TextDisabled("(This field is null in SDK 1.14 - trailers moved to telemetry)");
         }
         
@@ -501,136 +669,16 @@ namespace ts_extra_utilities
         if (has_trailers) {
             ImGui::Text("Ready to manipulate %d trailer(s)!", trailer_count);
             
-            // COMPREHENSIVE MEMORY ACCESS DEBUGGING
-            CCore::g_instance->info("=== MEMORY ACCESS ANALYSIS FOR TRAILER MANIPULATION ===");
-            
-            // Try to get memory-based trailer access for manipulation
-            auto* game_actor = CCore::g_instance->get_game_actor();
-            prism::game_trailer_actor_u* memory_trailer = nullptr;
-            
-            CCore::g_instance->info("Step 1: Game actor lookup result: 0x%016llx", reinterpret_cast<uint64_t>(game_actor));
-            
-            if (game_actor) {
-                CCore::g_instance->info("Step 2: Checking game_actor->game_trailer_actor field...");
-                CCore::g_instance->info("  game_trailer_actor field: 0x%016llx", reinterpret_cast<uint64_t>(game_actor->game_trailer_actor));
-                
-                if (game_actor->game_trailer_actor) {
-                    memory_trailer = game_actor->game_trailer_actor;
-                    CCore::g_instance->info("SUCCESS: Memory access available via game_actor->game_trailer_actor!");
-                    ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Memory access available for manipulation!");
-                } else {
-                    CCore::g_instance->warning("Step 2 FAILED: game_actor->game_trailer_actor is NULL");
-                    CCore::g_instance->info("Step 2.5: SDK 1.14 - searching game actor for alternative trailer storage...");
-                    
-                    // In SDK 1.14, trailers might be stored differently in the game actor
-                    // Let's scan the entire game actor structure for potential trailer pointers
-                    auto* actor_ptr = reinterpret_cast<uint64_t*>(game_actor);
-                    for (int i = 0; i < 200; i++) { // Scan first 1600 bytes
-                        if (!IsBadReadPtr(&actor_ptr[i], sizeof(uint64_t))) {
-                            uint64_t value = actor_ptr[i];
-                            
-                            // Look for valid pointer values
-                            if (value > 0x10000 && value < 0x7FFFFFFFFFFF) {
-                                // Try to validate if this could be a trailer
-                                auto* potential_trailer = reinterpret_cast<void*>(value);
-                                if (!IsBadReadPtr(potential_trailer, 0x100)) {
-                                    auto* trailer_data = reinterpret_cast<uint64_t*>(potential_trailer);
-                                    uint64_t first_val = trailer_data[0];
-                                    
-                                    // Check if this looks like a trailer structure
-                                    if (first_val > 0x10000 && first_val < 0x7FFFFFFFFFFF) {
-                                        // Additional validation - check for trailer-like patterns
-                                        bool looks_like_trailer = false;
-                                        
-                                        // Check for common trailer structure patterns
-                                        for (int j = 1; j < 10; j++) {
-                                            if (!IsBadReadPtr(&trailer_data[j], sizeof(uint64_t))) {
-                                                uint64_t val = trailer_data[j];
-                                                // Look for null pointers or reasonable values
-                                                if (val == 0 || (val > 0x10000 && val < 0x7FFFFFFFFFFF)) {
-                                                    looks_like_trailer = true;
-                                                    break;
-                                                }
-                                            }
-                                        }
-                                        
-                                        if (looks_like_trailer) {
-                                            CCore::g_instance->info("  Potential trailer found at game_actor+0x%03x: 0x%016llx", 
-                                                i * 8, value);
-                                            if (!memory_trailer) {
-                                                memory_trailer = reinterpret_cast<prism::game_trailer_actor_u*>(potential_trailer);
-                                                CCore::g_instance->info("  Using as primary trailer for manipulation");
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    
-                    if (memory_trailer) {
-                        CCore::g_instance->info("SUCCESS: Found trailer via alternative scanning in game actor!");
-                        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Alternative trailer memory access found!");
-                    } else {
-                        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "Memory access not available - trying base controller...");
-                    }
-                }
+            // the chain starts at the game actor, its offset comes from the offset database (see tools/offset_discovery)
+            auto* memory_trailer = game_actor != nullptr ? prism::fields::game_actor::game_trailer_actor(game_actor) : nullptr;
+            if (memory_trailer) {
+                ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Memory access available for manipulation!");
             } else {
-                CCore::g_instance->error("Step 1 FAILED: Could not get game actor");
-                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Game actor not accessible");
-            }
-            
-            // Alternative method: base controller arrays
-            if (!memory_trailer) {
-                CCore::g_instance->info("Step 3: Trying base controller trailer arrays...");
-                auto* base_ctrl = CCore::g_instance->get_base_ctrl_instance();
-                if (base_ctrl && !IsBadReadPtr(base_ctrl, 0x300)) {
-                    auto* base_ctrl_ptr = reinterpret_cast<uint8_t*>(base_ctrl);
-                    void** trailer_array_ptr = reinterpret_cast<void**>(base_ctrl_ptr + 0x0228);
-                    
-                    CCore::g_instance->info("  Base controller: 0x%016llx", reinterpret_cast<uint64_t>(base_ctrl));
-                    CCore::g_instance->info("  Trailer array pointer: 0x%016llx", reinterpret_cast<uint64_t>(trailer_array_ptr));
-                    
-                    if (!IsBadReadPtr(trailer_array_ptr, 32)) {
-                        void* array_data = trailer_array_ptr[0];
-                        uint64_t array_size = reinterpret_cast<uint64_t>(trailer_array_ptr[1]);
-                        
-                        CCore::g_instance->info("  Array data: 0x%016llx", reinterpret_cast<uint64_t>(array_data));
-                        CCore::g_instance->info("  Array size: %llu", array_size);
-                        
-                        if (array_data && array_size > 0 && array_size < 10) {
-                            auto* trailer_ptrs = reinterpret_cast<void**>(array_data);
-                            if (!IsBadReadPtr(trailer_ptrs, array_size * sizeof(void*))) {
-                                CCore::g_instance->info("  Scanning array entries:");
-                                for (uint64_t i = 0; i < array_size; i++) {
-                                    void* trailer_ptr = trailer_ptrs[i];
-                                    CCore::g_instance->info("    [%llu]: 0x%016llx", i, reinterpret_cast<uint64_t>(trailer_ptr));
-                                    if (trailer_ptr) {
-                                        memory_trailer = reinterpret_cast<prism::game_trailer_actor_u*>(trailer_ptr);
-                                        CCore::g_instance->info("SUCCESS: Found trailer in base controller array!");
-                                        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Found trailer in base controller array!");
-                                        break;
-                                    }
-                                }
-                            } else {
-                                CCore::g_instance->warning("  Cannot read trailer array entries");
-                            }
-                        } else {
-                            CCore::g_instance->warning("  Array data is null or invalid size");
-                        }
-                    } else {
-                        CCore::g_instance->warning("  Cannot read trailer array pointer");
-                    }
-                } else {
-                    CCore::g_instance->warning("  Base controller is null or unreadable");
-                }
+                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "Memory access not available, game_actor.game_trailer_actor may need an offset database update");
             }
             
-            CCore::g_instance->info("Step 4: Final memory_trailer result: 0x%016llx", reinterpret_cast<uint64_t>(memory_trailer));
-            CCore::g_instance->info("=== MEMORY ACCESS ANALYSIS COMPLETE ===");
-            
-            // Initialize steering hook if we have memory access
-            if (memory_trailer && game_actor && game_actor->game_trailer_actor) {
+            // the steering detour is installed on the vtable of the first trailer seen
+            if (memory_trailer) {
                 // Initialize steering hook if not already done
                 if (steering_advance_hook == nullptr) {
                     CCore::g_instance->info("=== STEERING HOOK INITIALIZATION ===");
@@ -667,35 +715,6 @@ namespace ts_extra_utilities
                         CCore::g_instance->error("Cannot read trailer vtable");
                     }
                     CCore::g_instance->info("=== STEERING HOOK INITIALIZATION COMPLETE ===");
-                } else {
-                    CCore::g_instance->debug("Steering hook already initialized");
-                }
-            } else {
-                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "Memory access not available - trying alternative methods...");
-                
-                // Try to find trailer memory via base controller arrays
-                auto* base_ctrl = CCore::g_instance->get_base_ctrl_instance();
-                if (base_ctrl && !IsBadReadPtr(base_ctrl, 0x300)) {
-                    auto* base_ctrl_ptr = reinterpret_cast<uint8_t*>(base_ctrl);
-                    void** trailer_array_ptr = reinterpret_cast<void**>(base_ctrl_ptr + 0x0228);
-                    
-                    if (!IsBadReadPtr(trailer_array_ptr, 32)) {
-                        void* array_data = trailer_array_ptr[0];
-                        uint64_t array_size = reinterpret_cast<uint64_t>(trailer_array_ptr[1]);
-                        
-                        if (array_data && array_size > 0 && array_size < 10) {
-                            auto* trailer_ptrs = reinterpret_cast<void**>(array_data);
-                            if (!IsBadReadPtr(trailer_ptrs, array_size * sizeof(void*))) {
-                                for (uint64_t i = 0; i < array_size; i++) {
-                                    if (trailer_ptrs[i]) {
-                                        memory_trailer = reinterpret_cast<prism::game_trailer_actor_u*>(trailer_ptrs[i]);
-                                        ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Found trailer in base controller array!");
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
                 }
             }
             
@@ -709,7 +728,7 @@ namespace ts_extra_utilities
                             // Use the memory-based manipulation functions for the first trailer
                             // (for multi-trailer setups, we'd need to walk the linked list)
                             
-                            if (memory_trailer->wheel_steering_stuff != nullptr && set_individual_steering_fn_ != nullptr) {
+                            if (prism::fields::vehicle_shared::wheel_steering_stuff(memory_trailer) != nullptr && set_individual_steering_fn_ != nullptr) {
                                 ImGui::SeparatorText("Steering");
                                 this->render_trailer_steering(memory_trailer, i);
                             } else {
@@ -718,10 +737,13 @@ namespace ts_extra_utilities
                             
                             ImGui::SeparatorText("Joint Control");
                             this->render_trailer_joint(memory_trailer, i);
+
+                            ImGui::SeparatorText("Chassis");
+                            this->render_trailer_chassis(memory_trailer);
                             
                             // For multiple trailers, walk to the next one
-                            if (i == 0 && memory_trailer->slave_trailer) {
-                                memory_trailer = memory_trailer->slave_trailer;
+                            if (i == 0 && prism::fields::physics_trailer::slave_trailer(memory_trailer)) {
+                                memory_trailer = prism::fields::physics_trailer::slave_trailer(memory_trailer);
                             }
                             
                         } else {
@@ -737,6 +759,289 @@ namespace ts_extra_utilities
         }
     }
 
+    void CTrailerManipulation::render_profiles()
+    {
+        auto* control = CCore::g_instance->get_trailer_control();
+        const auto* telemetry = CCore::g_instance->get_telemetry();
+        const trailers::steering_clock_t now{ telemetry->get_simulation_seconds(), telemetry->get_travelled_distance() };
+
+        ImGui::SliderInt( "Profile", &this->selected_profile_, 0, trailers::CTrailerControlState::MAX_PROFILES - 1 );
+        const auto profile = static_cast< uint32_t >( this->selected_profile_ );
+        auto& editor = this->profile_editors_[ profile ];
+        if ( editor.keyframes.empty() ) editor.keyframes = { { 0.0f, 0.0f }, { 3.0f, 0.5f }, { 6.0f, 0.0f } };
+
+        ImGui::PushID( this->selected_profile_ );
+        ImGui::Combo( "Keyed by", &editor.axis, "time (s)\0distance (m)\0" );
+        ImGui::Combo( "Interpolation", &editor.interpolation, "linear\0cubic\0spline\0" );
+        ImGui::Checkbox( "Loop", &editor.loop );
+
+        ImGui::SeparatorText( "Keyframes" );
+        for ( size_t k = 0; k < editor.keyframes.size(); ++k )
+        {
+            auto& keyframe = editor.keyframes[ k ];
+            ImGui::PushID( static_cast< int >( k ) );
+            ImGui::SetNextItemWidth( 100.0f );
+            ImGui::DragFloat( "##position", &keyframe.position, 0.1f, 0.0f, 10000.0f, "%.1f" );
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth( 200.0f );
+            ImGui::SliderFloat( "##steering", &keyframe.steering, -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp );
+            ImGui::SameLine();
+            ImGui::BeginDisabled( editor.keyframes.size() <= 2 );
+            const auto remove = ImGui::SmallButton( "x" );
+            ImGui::EndDisabled();
+            ImGui::PopID();
+
+            if ( remove )
+            {
+                editor.keyframes.erase( editor.keyframes.begin() + static_cast< ptrdiff_t >( k ) );
+                break;
+            }
+        }
+        ImGui::BeginDisabled( editor.keyframes.size() >= trailers::CSteeringProfile::MAX_KEYFRAMES );
+        if ( ImGui::Button( "Add keyframe" ) ) editor.keyframes.push_back( { editor.keyframes.back().position + 1.0f, 0.0f } );
+        ImGui::EndDisabled();
+
+        // gain -1 mirrors the curve, the delay lets trailers further back follow the same curve later
+        ImGui::SeparatorText( "Trailers" );
+        for ( uint32_t i = 0; i < 10; ++i )
+        {
+            if ( !CCore::g_instance->is_trailer_connected( static_cast< int >( i ) ) ) continue;
+
+            ImGui::PushID( static_cast< int >( i ) );
+            bool assigned = control->get_assigned_profile( i ) == this->selected_profile_;
+            float gain = control->get_profile_gain( i );
+            float delay = control->get_profile_delay( i );
+
+            bool changed = ImGui::Checkbox( ( "Trailer " + std::to_string( i ) ).c_str(), &assigned );
+            ImGui::BeginDisabled( !assigned );
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth( 120.0f );
+            changed |= ImGui::SliderFloat( "Gain", &gain, -2.0f, 2.0f, "%.2f" );
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth( 120.0f );
+            changed |= ImGui::DragFloat( "Delay", &delay, 0.1f, 0.0f, 1000.0f, "%.1f" );
+            ImGui::EndDisabled();
+            ImGui::PopID();
+
+            if ( changed )
+            {
+                const auto current = control->get_assigned_profile( i );
+                control->assign_profile( i, assigned ? this->selected_profile_ : ( current == this->selected_profile_ ? -1 : current ), gain, delay );
+            }
+        }
+
+        ImGui::Separator();
+        if ( ImGui::Button( "Apply and start" ) )
+        {
+            trailers::CSteeringProfile curve;
+            if ( !curve.build( editor.keyframes.data(), static_cast< uint32_t >( editor.keyframes.size() ),
+                               static_cast< trailers::SteeringProfileAxis::Enum >( editor.axis ),
+                               static_cast< trailers::SteeringInterpolation::Enum >( editor.interpolation ), editor.loop ) )
+            {
+                CCore::g_instance->error( "Steering profile %u: keyframe positions have to increase", profile );
+            }
+            else
+            {
+                control->set_profile( profile, curve );
+
+                // profiles only steer locked trailers, the game would overwrite them otherwise
+                for ( uint32_t i = 0; i < trailers::MAX_TRAILERS; ++i )
+                {
+                    if ( control->get_assigned_profile( i ) == this->selected_profile_ ) control->set_steering_locked( i, true );
+                }
+                control->start_profile( profile, now );
+                CCore::g_instance->info( "Started steering profile %u (%s, %s, %zu keyframes)", profile,
+                                         trailers::to_string( curve.get_axis() ), trailers::to_string( curve.get_interpolation() ),
+                                         editor.keyframes.size() );
+            }
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled( !control->is_profile_playing( profile ) );
+        if ( ImGui::Button( "Stop" ) ) control->stop_profile( profile );
+        ImGui::EndDisabled();
+
+        if ( control->is_profile_playing( profile ) )
+        {
+            ImGui::SameLine();
+            ImGui::Text( "at %.1f of %.1f %s", control->get_profile_position( profile, now ), editor.keyframes.back().position,
+                         editor.axis == trailers::SteeringProfileAxis::DISTANCE ? "m" : "s" );
+        }
+        ImGui::PopID();
+    }
+
+    void CTrailerManipulation::render_reverse_controller()
+    {
+        auto* controller = CCore::g_instance->get_reverse_controller();
+        auto* control = CCore::g_instance->get_trailer_control();
+
+        ImGui::TextWrapped( "Steers the steerable trailers along an arc behind the last trailer while reversing, drive the truck yourself." );
+
+        auto params = controller->get_params();
+        auto max_wheel_angle = params.max_wheel_angle * 57.2957795f;
+        bool changed = ImGui::SliderFloat( "Lookahead (m)", &params.lookahead, 1.0f, 30.0f, "%.1f" );
+        changed |= ImGui::SliderFloat( "Max wheel angle", &max_wheel_angle, 5.0f, 60.0f, "%.0f deg" );
+        changed |= ImGui::Checkbox( "Invert steering", &params.invert );
+        if ( changed )
+        {
+            params.max_wheel_angle = max_wheel_angle / 57.2957795f;
+            controller->set_params( params );
+        }
+
+        ImGui::SliderFloat( "Turn radius (m)", &this->reverse_radius_, -200.0f, 200.0f, this->reverse_radius_ == 0.0f ? "straight" : "%.0f" );
+        ImGui::SameLine();
+        if ( ImGui::SmallButton( "Straight" ) ) this->reverse_radius_ = 0.0f;
+
+        if ( !controller->is_engaged() )
+        {
+            if ( ImGui::Button( "Engage" ) )
+            {
+                // the steered trailers are locked from the SDK thread for as long as the controller steers them, see CTrailerControlState
+                controller->request_engage( std::fabs( this->reverse_radius_ ) >= 1.0f ? 1.0f / this->reverse_radius_ : 0.0f );
+                CCore::g_instance->info( "Reverse steering engaged, radius %.0f m", this->reverse_radius_ );
+            }
+            return;
+        }
+
+        if ( ImGui::Button( "Disengage" ) ) controller->request_disengage();
+        for ( uint32_t i = 0; i < trailers::MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            if ( !control->is_controlled( i ) ) continue;
+
+            float steering = 0.0f;
+            control->get_controller_steering( i, steering );
+            ImGui::Text( "Trailer %u: steering %+.2f, %.2f m off the path", i, steering, controller->get_cross_track( i ) );
+        }
+    }
+
+    void CTrailerManipulation::render_chain()
+    {
+        if ( CCore::g_instance->is_truckersmp() )
+        {
+            ImGui::TextWrapped( "Individually detachable trailers does not work in TruckersMP" );
+            return;
+        }
+
+        prism::game_trailer_actor_u* chain[ trailers::MAX_TRAILERS ];
+        const auto chain_length = get_trailer_chain( chain );
+        if ( chain_length == 0 )
+        {
+            ImGui::TextDisabled( "No trailers" );
+            return;
+        }
+
+        // ticking detached trailers builds the order they are connected in
+        this->chain_selection_.erase( std::remove_if( this->chain_selection_.begin(), this->chain_selection_.end(), [ & ]( const uint32_t index )
+        {
+            return index >= chain_length || prism::fields::physics_trailer::physics_joint( chain[ index ] ) != nullptr;
+        } ), this->chain_selection_.end() );
+        for ( uint32_t i = 0; i < chain_length; ++i )
+        {
+            const auto connected = prism::fields::physics_trailer::physics_joint( chain[ i ] ) != nullptr;
+            const auto position = std::find( this->chain_selection_.begin(), this->chain_selection_.end(), i );
+            bool selected = position != this->chain_selection_.end();
+
+            ImGui::PushID( static_cast< int >( i ) );
+            ImGui::BeginDisabled( connected );
+            if ( ImGui::Checkbox( ( "Trailer " + std::to_string( i ) ).c_str(), &selected ) )
+            {
+                if ( selected ) this->chain_selection_.push_back( i );
+                else this->chain_selection_.erase( position );
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            const auto order = std::find( this->chain_selection_.begin(), this->chain_selection_.end(), i ) - this->chain_selection_.begin();
+            if ( connected ) ImGui::TextDisabled( "connected" );
+            else if ( order < static_cast< ptrdiff_t >( this->chain_selection_.size() ) ) ImGui::Text( "detached, connects #%d", static_cast< int >( order ) + 1 );
+            else ImGui::TextDisabled( "detached" );
+            ImGui::PopID();
+        }
+
+        ImGui::BeginDisabled( this->chain_selection_.empty() );
+        if ( ImGui::Button( "Connect selected" ) )
+        {
+            this->connect_trailers( this->chain_selection_.data(), static_cast< uint32_t >( this->chain_selection_.size() ) );
+            this->chain_selection_.clear();
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        if ( ImGui::Button( "Reconnect all" ) )
+        {
+            uint32_t indices[ trailers::MAX_TRAILERS ];
+            for ( uint32_t i = 0; i < chain_length; ++i ) indices[ i ] = i;
+            this->connect_trailers( indices, chain_length );
+            this->chain_selection_.clear();
+        }
+
+        this->detach_behind_ = std::clamp( this->detach_behind_, -1, static_cast< int >( chain_length ) - 1 );
+        ImGui::SetNextItemWidth( 120.0f );
+        ImGui::SliderInt( "##detach_behind", &this->detach_behind_, -1, static_cast< int >( chain_length ) - 1,
+                          this->detach_behind_ < 0 ? "truck" : "trailer %d" );
+        ImGui::SameLine();
+        if ( ImGui::Button( "Detach everything behind" ) ) this->disconnect_trailers_behind( this->detach_behind_ );
+    }
+
+    void CTrailerManipulation::render_snapshot()
+    {
+        constexpr uint64_t SNAPSHOT_INTERVAL_MS = 1000;
+
+        ImGui::TextWrapped( "Copies the truck, trailer and joint objects to %s for offset-discovery, take a series while driving.",
+                            debug::DebugLogger::LOG_DIRECTORY );
+        ImGui::SliderInt( "Depth##snapshot", &this->snapshot_depth_, 1, 16 );
+        ImGui::SliderInt( "Snapshots##snapshot", &this->snapshot_count_, 1, 30 );
+        ImGui::Checkbox( "Other objects they point to##snapshot", &this->snapshot_neighbours_ );
+
+        const auto now = GetTickCount64();
+        if ( this->snapshot_remaining_ == 0 )
+        {
+            if ( ImGui::Button( "Capture##snapshot" ) )
+            {
+                SYSTEMTIME time;
+                GetLocalTime( &time );
+                snprintf( this->snapshot_base_path_, sizeof( this->snapshot_base_path_ ), "%s\\ats_mod_snapshot_%04u%02u%02u_%02u%02u%02u",
+                          debug::DebugLogger::LOG_DIRECTORY, time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond );
+                this->snapshot_taken_ = 0;
+                this->snapshot_remaining_ = static_cast< uint32_t >( this->snapshot_count_ );
+                this->snapshot_next_tick_ = now;
+            }
+        }
+        else if ( ImGui::Button( "Stop##snapshot" ) ) this->snapshot_remaining_ = 0;
+
+        if ( this->snapshot_remaining_ > 0 && now >= this->snapshot_next_tick_ )
+        {
+            memory::snapshot_capture_options_t options;
+            options.max_depth = static_cast< uint32_t >( this->snapshot_depth_ );
+            options.capture_neighbours = this->snapshot_neighbours_;
+            options.frame = this->snapshot_taken_;
+            options.game = CCore::g_instance->get_game_name();
+            options.game_version = CCore::g_instance->get_game_version();
+
+            char path[ MAX_PATH ];
+            snprintf( path, sizeof( path ), "%s_%02u.tsms", this->snapshot_base_path_, this->snapshot_taken_ );
+            memory::snapshot_capture_stats_t stats{};
+            std::string error;
+            if ( memory::capture_memory_snapshot( path, CCore::g_instance->get_base_ctrl_instance(), options, stats, error ) )
+            {
+                char status[ 512 ];
+                snprintf( status, sizeof( status ), "%s: %u objects, %u pointers, %u skipped, %.1f KiB, copied in %.2f ms", path, stats.regions,
+                          stats.relocations, stats.skipped, stats.bytes / 1024.0, stats.milliseconds );
+                this->snapshot_status_ = status;
+                CCore::g_instance->info( "Memory snapshot %s", status );
+                ++this->snapshot_taken_;
+                --this->snapshot_remaining_;
+                this->snapshot_next_tick_ = now + SNAPSHOT_INTERVAL_MS;
+            }
+            else
+            {
+                this->snapshot_status_ = "Snapshot failed: " + error;
+                CCore::g_instance->error( "Memory snapshot %s failed: %s", path, error.c_str() );
+                this->snapshot_remaining_ = 0;
+            }
+        }
+
+        if ( this->snapshot_remaining_ > 0 ) ImGui::Text( "%u of %d taken", this->snapshot_taken_, this->snapshot_count_ );
+        if ( !this->snapshot_status_.empty() ) ImGui::TextWrapped( "%s", this->snapshot_status_.c_str() );
+    }
+
     void CTrailerManipulation::render()
     {
         ImGui::Begin( "Trailer Manipulation"/*, &this->open_ */ );
@@ -764,6 +1069,26 @@ namespace ts_extra_utilities
 
         this->render_trailers();
 
+        if ( ImGui::CollapsingHeader( "Steering profiles" ) )
+        {
+            this->render_profiles();
+        }
+
+        if ( ImGui::CollapsingHeader( "Trailer chain" ) )
+        {
+            this->render_chain();
+        }
+
+        if ( ImGui::CollapsingHeader( "Reverse steering" ) )
+        {
+            this->render_reverse_controller();
+        }
+
+        if ( ImGui::CollapsingHeader( "Memory snapshot" ) )
+        {
+            this->render_snapshot();
+        }
+
         ImGui::End();
     }
 }
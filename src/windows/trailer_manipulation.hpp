@@ -1,8 +1,11 @@
 ﻿#pragma once
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "window.hpp"
 #include "prism/functions.hpp"
+#include "trailers/trailer_control.hpp"
 
 namespace prism
 {
@@ -22,16 +25,71 @@ namespace ts_extra_utilities
         prism::set_individual_steering_fn* set_individual_steering_fn_ = nullptr;
         prism::physics_trailer_u_get_slave_hook_position_fn* get_slave_hook_position_fn_ = nullptr;
 
+        // keyframes as edited, only turned into a curve when applied
+        struct profile_editor_t
+        {
+            std::vector< trailers::steering_keyframe_t > keyframes;
+            int axis = trailers::SteeringProfileAxis::TIME;
+            int interpolation = trailers::SteeringInterpolation::CUBIC;
+            bool loop = false;
+        };
+
+        profile_editor_t profile_editors_[ trailers::CTrailerControlState::MAX_PROFILES ];
+        int selected_profile_ = 0;
+
+        float reverse_radius_ = 0.0f; // meters, positive turns left looking backwards, 0 = straight
+
+        std::vector< uint32_t > chain_selection_; // chain indices in the order they were ticked
+        int detach_behind_ = 0;
+
+        // memory snapshots for offset-discovery, a series is taken one per second
+        int snapshot_depth_ = 8;
+        int snapshot_count_ = 1;
+        bool snapshot_neighbours_ = true;
+        uint32_t snapshot_taken_ = 0;
+        uint32_t snapshot_remaining_ = 0;
+        uint64_t snapshot_next_tick_ = 0;
+        char snapshot_base_path_[ 260 ] = {};
+        std::string snapshot_status_;
+
+        // the game's trailer list from the first trailer on, connected or not, at most trailers::MAX_TRAILERS
+        static uint32_t get_trailer_chain( prism::game_trailer_actor_u** chain );
+        // what connect() wants for hanging a trailer from `parent`, nullptr for the truck
+        float3_t get_hook_vector( prism::game_trailer_actor_u* parent ) const;
+        // connects `chain` in order behind whatever is connected to the truck, `indices` are their chain indices
+        uint32_t connect_chain( prism::game_trailer_actor_u* const* chain, const uint32_t* indices, uint32_t count ) const;
+
         void render_trailer_steering( prism::game_trailer_actor_u* current_trailer, uint32_t i ) const;
         void connect_trailer( prism::game_trailer_actor_u* current_trailer, uint32_t i ) const;
         void render_trailer_joint( prism::game_trailer_actor_u* current_trailer, uint32_t i ) const;
+        void render_trailer_chassis( const prism::game_trailer_actor_u* current_trailer ) const;
         void render_trailers() const;
+        void render_profiles();
+        void render_reverse_controller();
+        void render_chain();
+        void render_snapshot();
         
         // Safety functions for trailer manipulation
         bool is_safe_to_manipulate_trailer(int trailer_index) const;
         void safe_disconnect_trailer(int trailer_index) const;
 
     public:
+        /**
+         * \brief Connects the trailers at chain `indices` in that order, the first one to the end of what is still connected to the truck
+         *
+         * Hook vectors are all resolved before the first trailer is connected and connect_slave stays hooked over the
+         * whole batch, so a road train is rebuilt in one go instead of one trailer per frame.
+         * \return trailers connected, ones already connected and indices past the chain are skipped
+         */
+        uint32_t connect_trailers( const uint32_t* indices, uint32_t count ) const;
+
+        /**
+         * \brief Disconnects every connected trailer behind chain index `index`, the last one first
+         * \param index -1 for the whole chain
+         * \return trailers disconnected
+         */
+        uint32_t disconnect_trailers_behind( int32_t index ) const;
+
         CTrailerManipulation();
         ~CTrailerManipulation() override;
 
@@ -0,0 +1,140 @@
+// Benchmarks prefetching() of prism/collections/array_span.hpp on scattered objects and checks it against a plain loop.
+//
+// usage: array-span-bench [--objects <count>] [--distance <objects>]
+//
+// Objects are 0x600 bytes like a game object, pointed to in shuffled order from one array with every 64th pointer
+// null, so every object is a cache miss the way items of a loaded sector are. Times a light loop that only copies a
+// field and a loop that inserts every object's field into a hash map, like the map index does, each with and
+// without prefetching(). Exits with 1 if prefetching() hands out anything else than a plain loop over the span,
+// also on spans shorter than the prefetch distance and empty ones.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "prism/collections/array_span.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    constexpr size_t OBJECT_SIZE = 0x600;
+    constexpr uint32_t POSITION_OFFSET = 0x448; // float3, its own line
+
+    struct position_t
+    {
+        float x, y, z;
+    };
+
+    // prefetching() against a plain loop over `objects`, prints what differs
+    bool check( const prism::array_span_t< uint8_t* >& objects, const uint32_t distance, const char* what )
+    {
+        uint64_t index = 0;
+        auto in_order = true;
+        for ( auto* object : prism::prefetching( objects, POSITION_OFFSET, distance ) ) in_order &= index < objects.size() && objects[ index++ ] == object;
+        if ( in_order && index == objects.size() ) return true;
+
+        printf( "%s: prefetching() handed out %llu objects expected %llu%s\n", what, static_cast< unsigned long long >( index ),
+                static_cast< unsigned long long >( objects.size() ), in_order ? "" : ", not in array order" );
+        return false;
+    }
+
+    template < class F >
+    double time_ns( const size_t count, F&& body )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        return std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() / static_cast< double >( count );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    size_t object_count = 100000;
+    uint32_t distance = prism::DEFAULT_PREFETCH_DISTANCE;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--objects" ) == 0 ) object_count = strtoull( argv[ i + 1 ], nullptr, 10 );
+        else if ( strcmp( argv[ i ], "--distance" ) == 0 ) distance = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else
+        {
+            printf( "usage: array-span-bench [--objects <count>] [--distance <objects>]\n" );
+            return EXIT_FAILURE;
+        }
+    }
+    if ( object_count == 0 )
+    {
+        printf( "objects has to be positive\n" );
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937_64 random( 48 );
+    std::uniform_real_distribution< float > world( -200000.0f, 200000.0f );
+    const auto storage = std::make_unique< uint8_t[] >( object_count * OBJECT_SIZE );
+    std::vector< uint8_t* > pointers( object_count );
+    for ( size_t i = 0; i < object_count; ++i )
+    {
+        auto* object = storage.get() + i * OBJECT_SIZE;
+        std::memset( object, static_cast< int >( i ), OBJECT_SIZE );
+        const position_t position{ world( random ), world( random ) * 0.01f, world( random ) };
+        std::memcpy( object + POSITION_OFFSET, &position, sizeof( position ) );
+        pointers[ i ] = i % 64 == 63 ? nullptr : object;
+    }
+    std::shuffle( pointers.begin(), pointers.end(), random );
+    const prism::array_span_t< uint8_t* > objects( pointers.data(), pointers.size() );
+
+    auto result = EXIT_SUCCESS;
+    if ( !check( objects, distance, "all objects" ) ) result = EXIT_FAILURE;
+    if ( !check( objects.subspan( 0, distance / 2 + 1 ), distance, "shorter than the distance" ) ) result = EXIT_FAILURE;
+    if ( !check( objects.subspan( 0, distance ), distance, "as long as the distance" ) ) result = EXIT_FAILURE;
+    if ( !check( objects, 0, "distance 0" ) ) result = EXIT_FAILURE;
+    if ( !check( {}, distance, "empty" ) ) result = EXIT_FAILURE;
+    printf( "checked prefetching() against a plain loop: %s\n", result == EXIT_SUCCESS ? "ok" : "MISMATCH" );
+
+    // each pass is preceded by one over another buffer so no object is still cached from the one before
+    std::vector< uint8_t > flush( 64 * 1024 * 1024 );
+    const auto evict = [ & ]
+    {
+        for ( size_t i = 0; i < flush.size(); i += 64 ) flush[ i ] += 1;
+    };
+
+    std::vector< position_t > positions( object_count );
+    size_t copied = 0;
+    const auto copy = [ & ]( const uint8_t* object )
+    {
+        if ( object == nullptr ) return;
+        std::memcpy( &positions[ copied++ ], object + POSITION_OFFSET, sizeof( position_t ) );
+    };
+
+    evict();
+    const auto plain_copy_ns = time_ns( object_count, [ & ] { for ( const auto* object : objects ) copy( object ); } );
+    copied = 0;
+    evict();
+    const auto prefetching_copy_ns = time_ns( object_count, [ & ] { for ( const auto* object : prism::prefetching( objects, POSITION_OFFSET, distance ) ) copy( object ); } );
+    printf( "field copy: plain %.1f ns, prefetching() %.1f ns per object\n", plain_copy_ns, prefetching_copy_ns );
+
+    std::unordered_map< uint64_t, position_t > items;
+    items.reserve( object_count );
+    const auto insert = [ & ]( const uint8_t* object )
+    {
+        if ( object == nullptr ) return;
+        position_t position;
+        std::memcpy( &position, object + POSITION_OFFSET, sizeof( position ) );
+        items[ reinterpret_cast< uintptr_t >( object ) ] = position;
+    };
+
+    evict();
+    const auto plain_insert_ns = time_ns( object_count, [ & ] { for ( const auto* object : objects ) insert( object ); } );
+    items.clear();
+    evict();
+    const auto prefetching_insert_ns = time_ns( object_count, [ & ] { for ( const auto* object : prism::prefetching( objects, POSITION_OFFSET, distance ) ) insert( object ); } );
+    printf( "hash map insert: plain %.1f ns, prefetching() %.1f ns per object, distance %u\n", plain_insert_ns, prefetching_insert_ns, distance );
+
+    return result;
+}
@@ -0,0 +1,268 @@
+#include "fake_sdk_host.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/scssdk_telemetry_common_configs.h"
+
+namespace ts_extra_utilities::tools
+{
+    CFakeSdkHost* CFakeSdkHost::g_instance = nullptr;
+
+    namespace
+    {
+        const telemetry::frame_channel_t* find_channel( const telemetry::frame_channel_list_t channels, const char* name, const scs_value_type_t type )
+        {
+            for ( const auto& channel : channels )
+            {
+                if ( std::strcmp( channel.name, name ) == 0 && channel.type == type ) return &channel;
+            }
+            return nullptr;
+        }
+
+        // telemetry_frame_t offset of a (name, index) registration, false if the frame doesn't carry it
+        bool resolve_channel( const char* name, const scs_u32_t index, const scs_value_type_t type, uint32_t& offset, uint32_t& size )
+        {
+            using namespace telemetry;
+
+            constexpr char truck_wheel_prefix[] = "truck.wheel.";
+            constexpr char trailer_prefix[] = "trailer.";
+
+            if ( const auto* channel = find_channel( get_truck_channels(), name, type ); channel != nullptr && index == SCS_U32_NIL )
+            {
+                offset = static_cast< uint32_t >( offsetof( telemetry_frame_t, truck ) ) + channel->offset;
+                size = channel->size;
+                return true;
+            }
+
+            if ( std::strncmp( name, truck_wheel_prefix, sizeof( truck_wheel_prefix ) - 1 ) == 0 )
+            {
+                const auto* channel = find_channel( get_wheel_channels(), name + sizeof( truck_wheel_prefix ) - 1, type );
+                if ( channel == nullptr || index >= MAX_WHEELS ) return false;
+
+                offset = static_cast< uint32_t >( offsetof( telemetry_frame_t, truck.wheels ) ) + channel->offset + channel->size * index;
+                size = channel->size;
+                return true;
+            }
+
+            // trailer.N.<channel>, the tables store them without the N
+            if ( std::strncmp( name, trailer_prefix, sizeof( trailer_prefix ) - 1 ) != 0 ) return false;
+
+            char* rest = nullptr;
+            const auto trailer = std::strtoul( name + sizeof( trailer_prefix ) - 1, &rest, 10 );
+            if ( rest == name + sizeof( trailer_prefix ) - 1 || *rest != '.' || trailer >= MAX_TRAILERS ) return false;
+            ++rest;
+
+            constexpr char wheel_prefix[] = "wheel.";
+            if ( std::strncmp( rest, wheel_prefix, sizeof( wheel_prefix ) - 1 ) == 0 )
+            {
+                const auto* channel = find_channel( get_wheel_channels(), rest + sizeof( wheel_prefix ) - 1, type );
+                if ( channel == nullptr || index >= MAX_WHEELS ) return false;
+
+                offset = static_cast< uint32_t >( offsetof( telemetry_frame_t, trailers.wheels ) + sizeof( wheels_soa_t ) * trailer ) +
+                         channel->offset + channel->size * index;
+                size = channel->size;
+                return true;
+            }
+
+            char unindexed[ 64 ];
+            snprintf( unindexed, sizeof( unindexed ), "%s%s", trailer_prefix, rest );
+            const auto* channel = find_channel( get_trailer_channels(), unindexed, type );
+            if ( channel == nullptr || index != SCS_U32_NIL ) return false;
+
+            offset = static_cast< uint32_t >( offsetof( telemetry_frame_t, trailers ) ) + channel->offset + channel->size * static_cast< uint32_t >( trailer );
+            size = channel->size;
+            return true;
+        }
+    }
+
+    CFakeSdkHost::CFakeSdkHost( const bool echo_log ) : echo_log_( echo_log )
+    {
+        g_instance = this;
+
+        this->init_params_.common.game_name = "Fake SDK host";
+        this->init_params_.common.game_id = "ats";
+        this->init_params_.common.game_version = SCS_MAKE_VERSION( 1, 5 );
+        this->init_params_.common.log = log;
+        this->init_params_.register_for_event = register_for_event;
+        this->init_params_.unregister_from_event = unregister_from_event;
+        this->init_params_.register_for_channel = register_for_channel;
+        this->init_params_.unregister_from_channel = unregister_from_channel;
+    }
+
+    CFakeSdkHost::~CFakeSdkHost()
+    {
+        if ( g_instance == this ) g_instance = nullptr;
+    }
+
+    SCSAPI_RESULT CFakeSdkHost::register_for_event( const scs_event_t event, const scs_telemetry_event_callback_t callback, const scs_context_t context )
+    {
+        if ( g_instance == nullptr ) return SCS_RESULT_not_now;
+        if ( event == SCS_TELEMETRY_EVENT_invalid || event > SCS_TELEMETRY_EVENT_gameplay || callback == nullptr ) return SCS_RESULT_invalid_parameter;
+
+        auto& registration = g_instance->events_[ event ];
+        if ( registration.callback != nullptr ) return SCS_RESULT_already_registered;
+
+        registration.callback = callback;
+        registration.context = context;
+        return SCS_RESULT_ok;
+    }
+
+    SCSAPI_RESULT CFakeSdkHost::unregister_from_event( const scs_event_t event )
+    {
+        if ( g_instance == nullptr ) return SCS_RESULT_not_now;
+        if ( event > SCS_TELEMETRY_EVENT_gameplay || g_instance->events_[ event ].callback == nullptr ) return SCS_RESULT_not_found;
+
+        g_instance->events_[ event ] = {};
+        return SCS_RESULT_ok;
+    }
+
+    SCSAPI_RESULT CFakeSdkHost::register_for_channel( const scs_string_t name, const scs_u32_t index, const scs_value_type_t type, const scs_u32_t flags,
+                                                      const scs_telemetry_channel_callback_t callback, const scs_context_t context )
+    {
+        if ( g_instance == nullptr ) return SCS_RESULT_not_now;
+        if ( name == nullptr || callback == nullptr ) return SCS_RESULT_invalid_parameter;
+
+        for ( const auto& channel : g_instance->channels_ )
+        {
+            if ( channel.index == index && channel.type == type && channel.name == name ) return SCS_RESULT_already_registered;
+        }
+
+        channel_registration_t registration;
+        registration.name = name;
+        registration.index = index;
+        registration.type = type;
+        registration.flags = flags;
+        registration.callback = callback;
+        registration.context = context;
+        resolve_channel( name, index, type, registration.frame_offset, registration.size );
+        g_instance->channels_.push_back( std::move( registration ) );
+        return SCS_RESULT_ok;
+    }
+
+    SCSAPI_RESULT CFakeSdkHost::unregister_from_channel( const scs_string_t name, const scs_u32_t index, const scs_value_type_t type )
+    {
+        if ( g_instance == nullptr ) return SCS_RESULT_not_now;
+
+        auto& channels = g_instance->channels_;
+        for ( auto it = channels.begin(); it != channels.end(); ++it )
+        {
+            if ( it->index != index || it->type != type || it->name != name ) continue;
+            channels.erase( it );
+            return SCS_RESULT_ok;
+        }
+        return SCS_RESULT_not_found;
+    }
+
+    SCSAPI_VOID CFakeSdkHost::log( const scs_log_type_t type, const scs_string_t message )
+    {
+        if ( g_instance == nullptr ) return;
+
+        ++g_instance->stats_.log_lines;
+        if ( !g_instance->echo_log_ ) return;
+
+        const char* prefix = type == SCS_LOG_TYPE_error ? "<ERROR> " : type == SCS_LOG_TYPE_warning ? "<WARNING> " : "";
+        fprintf( stderr, "%s%s\n", prefix, message );
+    }
+
+    void CFakeSdkHost::send_event( const scs_event_t event, const void* event_info )
+    {
+        if ( event > SCS_TELEMETRY_EVENT_gameplay ) return;
+
+        const auto& registration = this->events_[ event ];
+        if ( registration.callback == nullptr ) return;
+
+        ++this->stats_.event_callbacks;
+        registration.callback( event, event_info, registration.context );
+    }
+
+    void CFakeSdkHost::configure_truck( const uint32_t wheel_count )
+    {
+        scs_named_value_t attributes[ 2 ] = {};
+        if ( wheel_count != 0 )
+        {
+            attributes[ 0 ].name = SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_count;
+            attributes[ 0 ].index = SCS_U32_NIL;
+            attributes[ 0 ].value.type = SCS_VALUE_TYPE_u32;
+            attributes[ 0 ].value.value_u32.value = wheel_count;
+        }
+
+        scs_telemetry_configuration_t configuration{};
+        configuration.id = SCS_TELEMETRY_CONFIG_truck;
+        configuration.attributes = attributes;
+        this->send_event( SCS_TELEMETRY_EVENT_configuration, &configuration );
+    }
+
+    void CFakeSdkHost::configure_trailer( const uint32_t trailer_index, const uint32_t wheel_count )
+    {
+        scs_named_value_t attributes[ 2 ] = {};
+        if ( wheel_count != 0 )
+        {
+            attributes[ 0 ].name = SCS_TELEMETRY_CONFIG_ATTRIBUTE_wheel_count;
+            attributes[ 0 ].index = SCS_U32_NIL;
+            attributes[ 0 ].value.type = SCS_VALUE_TYPE_u32;
+            attributes[ 0 ].value.value_u32.value = wheel_count;
+        }
+
+        char id[ 32 ];
+        snprintf( id, sizeof( id ), "%s.%u", SCS_TELEMETRY_CONFIG_trailer, trailer_index );
+
+        scs_telemetry_configuration_t configuration{};
+        configuration.id = id;
+        configuration.attributes = attributes;
+        this->send_event( SCS_TELEMETRY_EVENT_configuration, &configuration );
+    }
+
+    void CFakeSdkHost::set_paused( const bool paused )
+    {
+        if ( paused == this->paused_ ) return;
+
+        this->paused_ = paused;
+        this->send_event( paused ? SCS_TELEMETRY_EVENT_paused : SCS_TELEMETRY_EVENT_started, nullptr );
+    }
+
+    void CFakeSdkHost::replay_frame( const telemetry::telemetry_frame_t& frame )
+    {
+        scs_telemetry_frame_start_t frame_start{};
+        frame_start.flags = frame.timer_restart ? SCS_TELEMETRY_FRAME_START_FLAG_timer_restart : 0;
+        frame_start.render_time = frame.render_time;
+        frame_start.simulation_time = frame.simulation_time;
+        frame_start.paused_simulation_time = frame.paused_simulation_time;
+        this->send_event( SCS_TELEMETRY_EVENT_frame_start, &frame_start );
+
+        const auto* bytes = reinterpret_cast< const uint8_t* >( &frame );
+        scs_value_t value{};
+        for ( auto& channel : this->channels_ )
+        {
+            if ( channel.frame_offset == UINT32_MAX ) continue;
+
+            const auto* current = bytes + channel.frame_offset;
+            const auto changed = !channel.delivered || std::memcmp( channel.last_value, current, channel.size ) != 0;
+            if ( !changed && ( channel.flags & SCS_TELEMETRY_CHANNEL_FLAG_each_frame ) == 0 ) continue;
+
+            std::memcpy( channel.last_value, current, channel.size );
+            channel.delivered = true;
+
+            value.type = channel.type;
+            std::memcpy( &value.value_bool, current, channel.size );
+
+            ++this->stats_.channel_callbacks;
+            channel.callback( channel.name.c_str(), channel.index, &value, channel.context );
+        }
+
+        this->send_event( SCS_TELEMETRY_EVENT_frame_end, nullptr );
+        ++this->stats_.frames;
+    }
+
+    uint32_t CFakeSdkHost::get_resolved_channel_count() const
+    {
+        uint32_t count = 0;
+        for ( const auto& channel : this->channels_ )
+        {
+            if ( channel.frame_offset != UINT32_MAX ) ++count;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "scssdk_telemetry.h"
+
+#include "telemetry/frame.hpp"
+
+namespace ts_extra_utilities::tools
+{
+    /**
+     * \brief Stand-in for the game side of the telemetry SDK, so the plugin's telemetry layer runs headless.
+     *
+     * Provides scs_telemetry_init_params_v101_t with working register/unregister functions and a log, then plays
+     * frames into whatever got registered: frame_start, the channel callbacks, frame_end. Channels are resolved
+     * against the frame channel tables and, like the game, only called when their value changed unless they were
+     * registered with SCS_TELEMETRY_CHANNEL_FLAG_each_frame. Channels the host has no data for are accepted but
+     * never called.
+     *
+     * The SDK registration functions carry no context, so only one host can exist at a time.
+     */
+    class CFakeSdkHost
+    {
+    public:
+        struct stats_t
+        {
+            uint64_t frames = 0;
+            uint64_t event_callbacks = 0;
+            uint64_t channel_callbacks = 0;
+            uint64_t log_lines = 0;
+        };
+
+    private:
+        struct event_registration_t
+        {
+            scs_telemetry_event_callback_t callback = nullptr;
+            scs_context_t context = nullptr;
+        };
+
+        struct channel_registration_t
+        {
+            std::string name;
+            scs_u32_t index = SCS_U32_NIL;
+            scs_value_type_t type = SCS_VALUE_TYPE_INVALID;
+            scs_u32_t flags = SCS_TELEMETRY_CHANNEL_FLAG_none;
+            scs_telemetry_channel_callback_t callback = nullptr;
+            scs_context_t context = nullptr;
+
+            // where the value lives in telemetry_frame_t, UINT32_MAX if the host doesn't know the channel
+            uint32_t frame_offset = UINT32_MAX;
+            uint32_t size = 0;
+
+            // last value passed to the callback, for the on change semantics
+            bool delivered = false;
+            uint8_t last_value[ sizeof( scs_value_dplacement_t ) ] = {};
+        };
+
+        static CFakeSdkHost* g_instance;
+
+        scs_telemetry_init_params_v101_t init_params_ = {};
+        event_registration_t events_[ SCS_TELEMETRY_EVENT_gameplay + 1 ] = {};
+        std::vector< channel_registration_t > channels_;
+        bool echo_log_ = false;
+        bool paused_ = true;
+        stats_t stats_;
+
+        static SCSAPI_RESULT register_for_event( scs_event_t event, scs_telemetry_event_callback_t callback, scs_context_t context );
+        static SCSAPI_RESULT unregister_from_event( scs_event_t event );
+        static SCSAPI_RESULT register_for_channel( scs_string_t name, scs_u32_t index, scs_value_type_t type, scs_u32_t flags,
+                                                   scs_telemetry_channel_callback_t callback, scs_context_t context );
+        static SCSAPI_RESULT unregister_from_channel( scs_string_t name, scs_u32_t index, scs_value_type_t type );
+        static SCSAPI_VOID log( scs_log_type_t type, scs_string_t message );
+
+    public:
+        explicit CFakeSdkHost( bool echo_log = false );
+        CFakeSdkHost( const CFakeSdkHost& ) = delete;
+        CFakeSdkHost& operator=( const CFakeSdkHost& ) = delete;
+        ~CFakeSdkHost();
+
+        const scs_telemetry_init_params_v101_t* get_init_params() const { return &this->init_params_; }
+
+        void send_event( scs_event_t event, const void* event_info );
+
+        // configuration events the game sends on load and on every truck/trailer change, wheel_count 0 means no such vehicle
+        void configure_truck( uint32_t wheel_count );
+        void configure_trailer( uint32_t trailer_index, uint32_t wheel_count );
+
+        void set_paused( bool paused );
+
+        // frame_start, every registered channel whose value changed (or each_frame), frame_end
+        void replay_frame( const telemetry::telemetry_frame_t& frame );
+
+        uint32_t get_channel_count() const { return static_cast< uint32_t >( this->channels_.size() ); }
+        uint32_t get_resolved_channel_count() const;
+        const stats_t& get_stats() const { return this->stats_; }
+    };
+}
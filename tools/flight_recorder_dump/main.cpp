@@ -0,0 +1,60 @@
+// Prints a flight recorder dump (ats_mod_crash_*.tsfr) in event order.
+//
+// usage: flight-recorder-dump <file.tsfr> [--thread <tid>] [--type <event type>] [--last <n>]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "debug/flight_recorder.hpp"
+
+using namespace ts_extra_utilities;
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <file.tsfr> [--thread <tid>] [--type <event type>] [--last <n>]\n", argv[ 0 ] );
+        return 1;
+    }
+
+    uint32_t thread_filter = 0;
+    const char* type_filter = nullptr;
+    size_t last = 0;
+    for ( int i = 2; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--thread" ) == 0 ) thread_filter = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--type" ) == 0 ) type_filter = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "--last" ) == 0 ) last = strtoull( argv[ i + 1 ], nullptr, 10 );
+    }
+
+    debug::flight_recorder_dump_t dump;
+    std::string error;
+    if ( !debug::load_flight_recorder_dump( argv[ 1 ], dump, error ) )
+    {
+        fprintf( stderr, "%s: %s\n", argv[ 1 ], error.c_str() );
+        return 1;
+    }
+
+    printf( "flight recorder v%u, %u rings x %u records, %zu valid records\n",
+            dump.header.version, dump.header.ring_count, dump.header.ring_capacity, dump.entries.size() );
+    for ( const auto& ring : dump.rings )
+    {
+        if ( ring.head == 0 ) continue;
+        printf( "  ring tid %-6u %s %llu writes\n", ring.thread_id, ring.flags & 1 ? "(shared)" : "        ",
+                static_cast< unsigned long long >( ring.head ) );
+    }
+    printf( "times are relative to the dump\n\n" );
+
+    const size_t first = last != 0 && dump.entries.size() > last ? dump.entries.size() - last : 0;
+    for ( size_t i = first; i < dump.entries.size(); ++i )
+    {
+        const auto& record = dump.entries[ i ].record;
+        if ( thread_filter != 0 && record.thread_id != thread_filter ) continue;
+        if ( type_filter != nullptr && strcmp( type_filter, debug::to_string( static_cast< debug::FlightEvent::Enum >( record.type ) ) ) != 0 ) continue;
+
+        printf( "%s\n", debug::format_flight_record( record, dump.header.dump_timestamp ).c_str() );
+    }
+    return 0;
+}
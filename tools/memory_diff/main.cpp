@@ -0,0 +1,258 @@
+// Finds the fields behind a telemetry channel in a recording of the memory diff window.
+//
+// usage: memory-diff [--min-changes <n>] [--tolerance <frames>] [--min-score <0-1>] [--top <n>] <export.tsmd>
+//        memory-diff --bench [--bytes <per frame>] [--frames <count>]
+//        memory-diff --self-test
+//
+// A recording holds a copy of each watched object for every frame and the channel's value on that frame. Dwords that
+// changed at least min-changes times are read as each of their bytes, an int and a float, and scored by their Pearson
+// correlation with the channel and, for a channel that only changes now and then like lights or wipers, by how well
+// their changes line up with the channel's within the tolerance. Toggle the control a few times while recording, a
+// single toggle looks the same as anything that happens to change once.
+//
+// --bench times capture and analysis on synthetic frames where one dword in a hundred changes per frame. --self-test
+// records synthetic objects with a light switch, a steering angle and a frame counter in them, round trips the
+// recording through a file and exits with 1 if a field isn't found at the top or the counter is.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "memory/memory_diff.hpp"
+#include "memory/snapshot.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    void print_candidates( const memory::CMemoryDiff& diff, const std::vector< memory::diff_candidate_t >& candidates )
+    {
+        printf( "%-24s %-8s %-6s %8s %8s %8s %6s\n", "object", "offset", "type", "changes", "r", "events", "score" );
+        for ( const auto& candidate : candidates )
+        {
+            printf( "%-24s 0x%04X   %-6s %8u %8.3f %8.3f %6.3f\n", diff.get_ranges()[ candidate.range ].label, candidate.offset,
+                    memory::to_string( candidate.type ), candidate.changes, candidate.correlation, candidate.event_score, candidate.score );
+        }
+    }
+
+    memory::diff_range_t make_range( const char* label, const uint64_t address, const uint32_t size )
+    {
+        memory::diff_range_t range{ address, size, {} };
+        snprintf( range.label, sizeof( range.label ), "%s", label );
+        return range;
+    }
+
+    int run_bench( const uint32_t bytes, const uint32_t frames )
+    {
+        // split like the game objects, a few KB each
+        std::vector< memory::diff_range_t > ranges;
+        for ( uint32_t offset = 0, i = 0; offset < bytes; offset += 0x1000, ++i )
+        {
+            char label[ 24 ];
+            snprintf( label, sizeof( label ), "object%u", i );
+            ranges.push_back( make_range( label, 0x10000000ull + offset * 2, std::min( 0x1000u, bytes - offset ) ) );
+        }
+
+        memory::CMemoryDiff diff;
+        std::string error;
+        if ( !diff.configure( ranges.data(), ranges.size(), error ) )
+        {
+            printf( "%s\n", error.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        std::mt19937 random( 7 );
+        std::vector< uint8_t > objects( bytes );
+        for ( auto& byte : objects ) byte = static_cast< uint8_t >( random() );
+
+        double capture_us = 0;
+        for ( uint32_t frame = 0; frame < frames; ++frame )
+        {
+            for ( uint32_t i = 0; i < bytes / 400; ++i ) objects[ random() % bytes ] ^= 0x5A;
+
+            const auto start = std::chrono::steady_clock::now();
+            auto* slot = diff.begin_frame();
+            for ( size_t i = 0; i < ranges.size(); ++i )
+            {
+                memcpy( slot + diff.get_range_offset( i ), objects.data() + ( ranges[ i ].address - 0x10000000ull ) / 2, ranges[ i ].size );
+            }
+            diff.commit_frame( frame, static_cast< float >( frame / 30 % 2 ), true );
+            capture_us += std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector< memory::diff_candidate_t > candidates;
+        diff.analyze( {}, candidates );
+        const auto analyze_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+        printf( "%u bytes in %zu ranges, %u of %u frames kept\n", bytes, ranges.size(), diff.get_frame_count(), frames );
+        printf( "capture and diff: %.2f us per frame, %.3f%% of a 60 FPS frame\n", capture_us / frames, capture_us / frames / 16666.7 * 100 );
+        printf( "analysis: %.1f ms, %zu candidates\n", analyze_ms, candidates.size() );
+        return EXIT_SUCCESS;
+    }
+
+    // records `frames` frames of a truck-ish and a chassis-ish object
+    struct synthetic_fields_t
+    {
+        uint8_t light; // 0x11, follows the light switch a frame late
+        float steering; // 0x24, wheel angle from the steering input
+        uint32_t counter; // 0x40, every frame
+        float noise; // 0x80
+    };
+
+    bool check_top( const memory::CMemoryDiff& diff, const char* name, const uint32_t range, const uint32_t offset, const memory::DiffValueType::Enum type )
+    {
+        std::vector< memory::diff_candidate_t > candidates;
+        diff.analyze( {}, candidates );
+
+        printf( "%s, %u frames:\n", name, diff.get_frame_count() );
+        print_candidates( diff, std::vector< memory::diff_candidate_t >( candidates.begin(), candidates.begin() + std::min< size_t >( 5, candidates.size() ) ) );
+
+        bool counter = false;
+        for ( const auto& candidate : candidates ) counter |= candidate.range == 0 && candidate.offset >= 0x40 && candidate.offset < 0x44;
+        const auto found = !candidates.empty() && candidates[ 0 ].range == range && candidates[ 0 ].offset == offset && candidates[ 0 ].type == type;
+        printf( "%s: %s%s\n\n", name, found ? "found" : "NOT FOUND", counter ? ", the counter passed too" : "" );
+        return found && !counter;
+    }
+
+    int run_self_test()
+    {
+        const memory::diff_range_t ranges[] = { make_range( "truck", 0x20000000, 0x100 ), make_range( "truck.chassis", 0x20004000, 0x4A8 ) };
+        memory::CMemoryDiff diff;
+        std::string error;
+        if ( !diff.configure( ranges, 2, error ) )
+        {
+            printf( "%s\n", error.c_str() );
+            return EXIT_FAILURE;
+        }
+
+        std::mt19937 random( 11 );
+        std::uniform_real_distribution< float > noise( -1.0f, 1.0f );
+        std::vector< uint8_t > truck( 0x100 ), chassis( 0x4A8 );
+
+        const auto record = [ & ]( const uint32_t frames, const bool lights )
+        {
+            diff.reset();
+            diff.set_channel_name( lights ? "truck.light.beam.low" : "truck.effective.steering" );
+            bool light = false;
+            for ( uint32_t frame = 0; frame < frames; ++frame )
+            {
+                // the game's light flag lags the switch by a frame, the steering wheel follows the input smoothly
+                const auto light_switch = frame % 90 >= 45;
+                const auto input = std::sin( frame * 0.05f ) * 0.8f;
+
+                truck[ 0x11 ] = light ? 1 : 0;
+                light = light_switch;
+                const auto counter = frame;
+                const auto value = noise( random );
+                memcpy( truck.data() + 0x40, &counter, sizeof( counter ) );
+                memcpy( truck.data() + 0x80, &value, sizeof( value ) );
+                const auto wheel = input * 0.6f;
+                memcpy( chassis.data() + 0x424, &wheel, sizeof( wheel ) );
+
+                auto* slot = diff.begin_frame();
+                memcpy( slot + diff.get_range_offset( 0 ), truck.data(), truck.size() );
+                memcpy( slot + diff.get_range_offset( 1 ), chassis.data(), chassis.size() );
+                // a frame without telemetry now and then
+                diff.commit_frame( frame, lights ? ( light_switch ? 1.0f : 0.0f ) : input, frame % 97 != 13 );
+            }
+        };
+
+        auto result = EXIT_SUCCESS;
+        record( 600, true );
+        if ( !check_top( diff, "light switch", 0, 0x11, memory::DiffValueType::U8 ) ) result = EXIT_FAILURE;
+
+        record( 600, false );
+        if ( !check_top( diff, "steering", 1, 0x424, memory::DiffValueType::FLOAT ) ) result = EXIT_FAILURE;
+
+        // the file has to give the same answer
+        const char* path = "memory_diff_self_test.tsmd";
+        memory::CMemoryDiff loaded;
+        memory::diff_file_header_t header{};
+        if ( !diff.write( path, "ats", "1.50" ) || !loaded.load( path, header, error ) )
+        {
+            printf( "round trip: %s\n", error.empty() ? "cannot write the file" : error.c_str() );
+            result = EXIT_FAILURE;
+        }
+        else
+        {
+            const auto same = loaded.get_channel_name() == diff.get_channel_name() && loaded.serialize( "ats", "1.50" ).size() == diff.serialize( "ats", "1.50" ).size();
+            if ( !same || !check_top( loaded, "steering, loaded", 1, 0x424, memory::DiffValueType::FLOAT ) ) result = EXIT_FAILURE;
+        }
+        std::remove( path );
+
+        printf( "self test: %s\n", result == EXIT_SUCCESS ? "ok" : "FAILED" );
+        return result;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    memory::diff_options_t options;
+    options.max_results = 40;
+    const char* path = nullptr;
+    bool bench = false, self_test = false, usage = false;
+    uint32_t bytes = 8 * 1024, frames = 10000;
+    for ( int i = 1; i < argc; ++i )
+    {
+        const auto has_value = i + 1 < argc;
+        if ( strcmp( argv[ i ], "--self-test" ) == 0 ) self_test = true;
+        else if ( strcmp( argv[ i ], "--bench" ) == 0 ) bench = true;
+        else if ( strcmp( argv[ i ], "--bytes" ) == 0 && has_value ) bytes = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--frames" ) == 0 && has_value ) frames = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--min-changes" ) == 0 && has_value ) options.min_changes = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--tolerance" ) == 0 && has_value ) options.tolerance = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--min-score" ) == 0 && has_value ) options.min_score = strtof( argv[ ++i ], nullptr );
+        else if ( strcmp( argv[ i ], "--top" ) == 0 && has_value ) options.max_results = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( argv[ i ][ 0 ] != '-' && path == nullptr ) path = argv[ i ];
+        else usage = true;
+    }
+
+    if ( self_test ) return run_self_test();
+    if ( bench )
+    {
+        if ( bytes == 0 || bytes > memory::CMemoryDiff::MAX_FRAME_BYTES - 0x1000 || frames == 0 )
+        {
+            printf( "bytes have to be within 1-%u and frames positive\n", memory::CMemoryDiff::MAX_FRAME_BYTES - 0x1000 );
+            return EXIT_FAILURE;
+        }
+        return run_bench( bytes, frames );
+    }
+    if ( usage || path == nullptr )
+    {
+        printf( "usage: memory-diff [--min-changes <n>] [--tolerance <frames>] [--min-score <0-1>] [--top <n>] <export.tsmd>\n"
+                "       memory-diff --bench [--bytes <per frame>] [--frames <count>]\n"
+                "       memory-diff --self-test\n" );
+        return EXIT_FAILURE;
+    }
+
+    memory::CMemoryDiff diff;
+    memory::diff_file_header_t header{};
+    std::string error;
+    if ( !diff.load( path, header, error ) )
+    {
+        printf( "%s: %s\n", path, error.c_str() );
+        return EXIT_FAILURE;
+    }
+
+    printf( "%s %s, %u frames of %u bytes against %s\n", memory::get_snapshot_string( header.game, sizeof( header.game ) ).c_str(),
+            memory::get_snapshot_string( header.game_version, sizeof( header.game_version ) ).c_str(), diff.get_frame_count(), diff.get_frame_bytes(),
+            diff.get_channel_name().c_str() );
+    for ( size_t i = 0; i < diff.get_ranges().size(); ++i )
+    {
+        const auto& range = diff.get_ranges()[ i ];
+        printf( "  %-24s 0x%llx, 0x%X bytes\n", range.label, static_cast< unsigned long long >( range.address ), range.size );
+    }
+    printf( "\n" );
+
+    std::vector< memory::diff_candidate_t > candidates;
+    diff.analyze( options, candidates );
+    print_candidates( diff, candidates );
+    printf( "%zu candidates\n", candidates.size() );
+    return EXIT_SUCCESS;
+}
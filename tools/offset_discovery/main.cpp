@@ -0,0 +1,587 @@
+// Finds the offsets of the fields in prism/offsets.hpp, and a few more, in memory snapshots of a new game build.
+//
+// usage: offset-discovery [--game <ats|ets2>] [--version <pack set version>] [--top <n>] [--min-confidence <0-1>] <snapshot>...
+//        offset-discovery --self-test
+//
+// Every rule describes one field: which captured objects own it and what a value there has to look like, a pointer to
+// a captured object of some type (by its address or its vtable) or floats in a range that change between snapshots or
+// stay put. Every offset of every owning object is tested in every snapshot. Offsets that fit are scored by how many
+// objects agree, a little higher close to the last known offset since fields rarely move far, and the scores of a
+// field are normalized into a confidence. Objects whose first qword isn't a vtable in the game's .rdata are skipped.
+// Several snapshots of one session, e.g. a series taken while driving with "Memory snapshot" in the trailer window, let
+// the change rules work.
+//
+// Prints the candidates per field and an offset database section with the best ones.
+//
+// --self-test builds snapshots of a synthetic layout with fields moved around and exits with 1 if any isn't found.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "memory/snapshot.hpp"
+#include "prism/offsets.hpp"
+
+using namespace ts_extra_utilities;
+using memory::SnapshotType;
+
+namespace
+{
+    constexpr uint32_t bit( const SnapshotType::Enum type ) { return 1u << type; }
+
+    constexpr uint32_t VEHICLES = bit( SnapshotType::GAME_PHYSICS_VEHICLE ) | bit( SnapshotType::GAME_TRAILER_ACTOR );
+    constexpr double MAX_MISS_RATE = 0.1; // objects that were mid-update or not what they were captured as
+    constexpr double PRIOR_WEIGHT = 0.5;
+    constexpr double PRIOR_DISTANCE = 128.0; // bytes
+
+    struct RuleKind
+    {
+        enum Enum
+        {
+            POINTER,
+            FLOAT,
+            FLOAT3,
+        };
+    };
+
+    struct Change
+    {
+        enum Enum
+        {
+            ANY,
+            VARIES, // between snapshots of the same object
+            CONSTANT,
+        };
+    };
+
+    struct field_rule_t
+    {
+        const char* name; // "owner.field" like the offset database
+        uint32_t owners; // SnapshotType bits
+        RuleKind::Enum kind;
+        uint32_t targets; // POINTER, SnapshotType bits
+        bool nullable;
+        float min, max; // FLOAT, FLOAT3
+        Change::Enum change;
+        uint32_t expected; // last known offset, the database defaults for database fields
+    };
+
+    field_rule_t pointer_rule( const char* name, const uint32_t owners, const uint32_t targets, const bool nullable, const uint32_t expected = 0 )
+    {
+        return { name, owners, RuleKind::POINTER, targets, nullable, 0.0f, 0.0f, Change::ANY, expected };
+    }
+
+    field_rule_t float_rule( const char* name, const uint32_t owners, const RuleKind::Enum kind, const float min, const float max, const Change::Enum change,
+                             const uint32_t expected = 0 )
+    {
+        return { name, owners, kind, 0, false, min, max, change, expected };
+    }
+
+    uint32_t default_offset( const char* name, const uint32_t fallback )
+    {
+        for ( uint32_t i = 0; i < prism::field_id::COUNT; ++i )
+        {
+            if ( strcmp( prism::field_names[ i ], name ) == 0 ) return prism::default_field_offsets[ i ];
+        }
+        return fallback;
+    }
+
+    bool is_database_field( const char* name ) { return default_offset( name, UINT32_MAX ) != UINT32_MAX; }
+
+    std::vector< field_rule_t > make_rules()
+    {
+        const auto trailer = bit( SnapshotType::GAME_TRAILER_ACTOR );
+        const auto actor = bit( SnapshotType::GAME_ACTOR );
+        std::vector< field_rule_t > rules = {
+            pointer_rule( "base_ctrl.game_actor", bit( SnapshotType::BASE_CTRL ), actor, false ),
+            pointer_rule( "game_actor.game_physics_vehicle", actor, bit( SnapshotType::GAME_PHYSICS_VEHICLE ), false ),
+            pointer_rule( "game_actor.game_trailer_actor", actor, trailer, true ),
+            pointer_rule( "vehicle_shared.accessory_chassis_data", VEHICLES, bit( SnapshotType::ACCESSORY_CHASSIS_DATA ), false ),
+            float_rule( "vehicle_shared.hook_locator", VEHICLES, RuleKind::FLOAT3, -20.0f, 20.0f, Change::CONSTANT ),
+            float_rule( "vehicle_shared.steering", VEHICLES, RuleKind::FLOAT, -1.0f, 1.0f, Change::VARIES ),
+            pointer_rule( "vehicle_shared.wheel_steering_stuff", VEHICLES, bit( SnapshotType::WHEEL_STEERING_DATA ), true ),
+            pointer_rule( "physics_trailer.physics_joint", trailer, bit( SnapshotType::PHYSICS_JOINT ), true ),
+            pointer_rule( "physics_trailer.parent_vehicle", trailer, VEHICLES, true ),
+            pointer_rule( "physics_trailer.slave_trailer", trailer, trailer, true ),
+            pointer_rule( "physics_joint_physx.px_joint", bit( SnapshotType::PHYSICS_JOINT ), bit( SnapshotType::PX_D6_JOINT ), false ),
+            float_rule( "accessory_chassis_data.hook_position", bit( SnapshotType::ACCESSORY_CHASSIS_DATA ), RuleKind::FLOAT3, -20.0f, 20.0f, Change::CONSTANT ),
+            // not in the database, they confirm that a series of snapshots was taken while driving
+            float_rule( "vehicle_shared.speed", VEHICLES, RuleKind::FLOAT, -70.0f, 70.0f, Change::VARIES, 0x0218 ),
+            float_rule( "game_actor.rpm", actor, RuleKind::FLOAT, 0.0f, 4000.0f, Change::VARIES, 0x01C8 ),
+        };
+        for ( auto& rule : rules ) rule.expected = default_offset( rule.name, rule.expected );
+        return rules;
+    }
+
+    // ---- analysis ---------------------------------------------------------------------------------------------
+
+    struct object_t
+    {
+        const memory::memory_snapshot_t* snapshot;
+        uint32_t snapshot_index;
+        const memory::snapshot_region_t* region;
+        const uint8_t* data;
+    };
+
+    struct candidate_t
+    {
+        uint32_t offset;
+        double score;
+        double confidence;
+        uint32_t hits, nulls, misses; // POINTER: objects pointing at a target, null, anything else; floats: in range, -, out of range
+    };
+
+    struct rule_result_t
+    {
+        std::vector< candidate_t > candidates; // best first
+        uint32_t objects;
+    };
+
+    class CDiscovery
+    {
+    private:
+        const std::vector< memory::memory_snapshot_t >& snapshots_;
+        std::vector< object_t > objects_[ SnapshotType::COUNT ];
+        std::vector< std::vector< uint64_t > > vtables_; // per snapshot and type, sorted
+        // objects of one type grouped by address across snapshots, only groups seen more than once
+        std::vector< std::vector< uint32_t > > series_[ SnapshotType::COUNT ];
+
+        const std::vector< uint64_t >& get_vtables( const uint32_t snapshot, const uint32_t type ) const
+        {
+            return this->vtables_[ snapshot * SnapshotType::COUNT + type ];
+        }
+
+        bool points_to( const object_t& object, const uint64_t value, const uint32_t targets ) const
+        {
+            const auto& snapshot = *object.snapshot;
+            if ( const auto* region = snapshot.find_region( value ); region != nullptr && region->address == value && ( bit( static_cast< SnapshotType::Enum >( region->type ) ) & targets ) != 0 )
+            {
+                return true;
+            }
+
+            // an object of the right class that was captured as something else or only partly
+            uint64_t vtable = 0;
+            if ( !snapshot.read( value, vtable ) ) return false;
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                if ( ( targets & ( 1u << type ) ) == 0 ) continue;
+                const auto& vtables = this->get_vtables( object.snapshot_index, type );
+                if ( std::binary_search( vtables.begin(), vtables.end(), vtable ) ) return true;
+            }
+            return false;
+        }
+
+        bool score_pointer( const field_rule_t& rule, const uint32_t offset, candidate_t& candidate ) const
+        {
+            uint32_t total = 0;
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                if ( ( rule.owners & ( 1u << type ) ) == 0 ) continue;
+                for ( const auto& object : this->objects_[ type ] )
+                {
+                    if ( offset + sizeof( uint64_t ) > object.region->size ) continue;
+                    ++total;
+
+                    uint64_t value;
+                    memcpy( &value, object.data + offset, sizeof( value ) );
+                    if ( value == 0 ) ++( rule.nullable ? candidate.nulls : candidate.misses );
+                    else if ( this->points_to( object, value, rule.targets ) ) ++candidate.hits;
+                    else ++candidate.misses;
+                }
+            }
+
+            if ( candidate.hits == 0 || candidate.misses > total * MAX_MISS_RATE ) return false;
+            candidate.score = ( candidate.hits + 0.5 * candidate.nulls - candidate.misses ) / total;
+            return candidate.score > 0.0;
+        }
+
+        // false if out of range, `nonzero` tells zeros apart since most memory is zero
+        static bool read_floats( const field_rule_t& rule, const object_t& object, const uint32_t offset, bool& nonzero )
+        {
+            const auto count = rule.kind == RuleKind::FLOAT3 ? 3u : 1u;
+            float values[ 3 ];
+            memcpy( values, object.data + offset, count * sizeof( float ) );
+
+            nonzero = false;
+            for ( uint32_t i = 0; i < count; ++i )
+            {
+                // the upper halves of pointers read as subnormals
+                const auto kind = std::fpclassify( values[ i ] );
+                if ( kind == FP_NAN || kind == FP_INFINITE || kind == FP_SUBNORMAL || values[ i ] < rule.min || values[ i ] > rule.max ) return false;
+                nonzero |= kind != FP_ZERO;
+            }
+            return true;
+        }
+
+        bool score_floats( const field_rule_t& rule, const uint32_t offset, candidate_t& candidate ) const
+        {
+            const auto size = rule.kind == RuleKind::FLOAT3 ? 3u * sizeof( float ) : sizeof( float );
+            uint32_t total = 0, nonzero = 0, series = 0, fitting_series = 0;
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                if ( ( rule.owners & ( 1u << type ) ) == 0 ) continue;
+                const auto& objects = this->objects_[ type ];
+                for ( const auto& object : objects )
+                {
+                    if ( offset + size > object.region->size ) continue;
+                    ++total;
+
+                    // a vector of zeros isn't worth anything, a single zero may be a value at rest
+                    bool is_nonzero;
+                    if ( read_floats( rule, object, offset, is_nonzero ) && ( is_nonzero || rule.kind == RuleKind::FLOAT ) )
+                    {
+                        ++candidate.hits;
+                        nonzero += is_nonzero;
+                    }
+                    else ++candidate.misses;
+                }
+
+                if ( rule.change == Change::ANY ) continue;
+                for ( const auto& group : this->series_[ type ] )
+                {
+                    if ( offset + size > objects[ group.front() ].region->size ) continue;
+                    ++series;
+
+                    bool changed = false;
+                    for ( size_t i = 1; i < group.size() && !changed; ++i )
+                    {
+                        changed = memcmp( objects[ group[ i ] ].data + offset, objects[ group.front() ].data + offset, size ) != 0;
+                    }
+                    fitting_series += changed == ( rule.change == Change::VARIES );
+                }
+            }
+
+            if ( candidate.hits == 0 || nonzero == 0 || candidate.misses > total * MAX_MISS_RATE ) return false;
+            candidate.score = static_cast< double >( candidate.hits - candidate.misses ) / total;
+
+            // a single snapshot can't tell, the change rules then only weaken the score
+            if ( series == 0 ) candidate.score *= 0.5;
+            else
+            {
+                const auto fitting = static_cast< double >( fitting_series ) / series;
+                if ( fitting < 1.0 - MAX_MISS_RATE ) return false;
+                candidate.score *= fitting;
+            }
+            return candidate.score > 0.0;
+        }
+
+    public:
+        explicit CDiscovery( const std::vector< memory::memory_snapshot_t >& snapshots ) : snapshots_( snapshots )
+        {
+            this->vtables_.resize( snapshots.size() * SnapshotType::COUNT );
+            std::unordered_map< uint64_t, uint32_t > series_index[ SnapshotType::COUNT ];
+            std::vector< std::vector< uint32_t > > groups[ SnapshotType::COUNT ];
+
+            for ( uint32_t s = 0; s < snapshots.size(); ++s )
+            {
+                const auto& snapshot = snapshots[ s ];
+                const auto has_rdata = snapshot.header.rdata_end > snapshot.header.rdata_begin;
+                for ( const auto& region : snapshot.regions )
+                {
+                    if ( region.type == SnapshotType::UNKNOWN || region.type >= SnapshotType::COUNT || region.size < sizeof( uint64_t ) ) continue;
+
+                    uint64_t vtable;
+                    memcpy( &vtable, snapshot.get_data( region ), sizeof( vtable ) );
+                    if ( has_rdata && ( vtable < snapshot.header.rdata_begin || vtable >= snapshot.header.rdata_end ) ) continue;
+
+                    auto& objects = this->objects_[ region.type ];
+                    const auto index = static_cast< uint32_t >( objects.size() );
+                    objects.push_back( { &snapshot, s, &region, snapshot.get_data( region ) } );
+                    this->vtables_[ s * SnapshotType::COUNT + region.type ].push_back( vtable );
+
+                    const auto [ it, inserted ] = series_index[ region.type ].emplace( region.address, static_cast< uint32_t >( groups[ region.type ].size() ) );
+                    if ( inserted ) groups[ region.type ].emplace_back();
+                    groups[ region.type ][ it->second ].push_back( index );
+                }
+            }
+
+            for ( auto& vtables : this->vtables_ )
+            {
+                std::sort( vtables.begin(), vtables.end() );
+                vtables.erase( std::unique( vtables.begin(), vtables.end() ), vtables.end() );
+            }
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                for ( auto& group : groups[ type ] )
+                {
+                    if ( group.size() > 1 ) this->series_[ type ].push_back( std::move( group ) );
+                }
+            }
+        }
+
+        uint32_t get_object_count( const uint32_t owners ) const
+        {
+            uint32_t count = 0;
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                if ( ( owners & ( 1u << type ) ) != 0 ) count += static_cast< uint32_t >( this->objects_[ type ].size() );
+            }
+            return count;
+        }
+
+        rule_result_t run( const field_rule_t& rule ) const
+        {
+            rule_result_t result{ {}, this->get_object_count( rule.owners ) };
+
+            uint32_t max_size = 0;
+            for ( uint32_t type = 0; type < SnapshotType::COUNT; ++type )
+            {
+                if ( ( rule.owners & ( 1u << type ) ) == 0 ) continue;
+                for ( const auto& object : this->objects_[ type ] ) max_size = std::max( max_size, object.region->size );
+            }
+
+            // the vtable is at 0, pointers are 8 byte aligned, floats 4
+            const auto step = rule.kind == RuleKind::POINTER ? 8u : 4u;
+            for ( uint32_t offset = 8; offset < max_size; offset += step )
+            {
+                candidate_t candidate{ offset, 0.0, 0.0, 0, 0, 0 };
+                const auto fits = rule.kind == RuleKind::POINTER ? this->score_pointer( rule, offset, candidate ) : this->score_floats( rule, offset, candidate );
+                if ( !fits ) continue;
+
+                const auto distance = std::fabs( static_cast< double >( offset ) - rule.expected );
+                candidate.score *= 1.0 + PRIOR_WEIGHT * std::exp( -distance / PRIOR_DISTANCE );
+                result.candidates.push_back( candidate );
+            }
+
+            double sum = 0.0;
+            for ( const auto& candidate : result.candidates ) sum += candidate.score;
+            for ( auto& candidate : result.candidates ) candidate.confidence = candidate.score / sum;
+            std::sort( result.candidates.begin(), result.candidates.end(), []( const auto& a, const auto& b ) { return a.score > b.score; } );
+            return result;
+        }
+    };
+
+    // ---- synthetic snapshots ----------------------------------------------------------------------------------
+
+    constexpr uint64_t RDATA_BEGIN = 0x7FF6'1000'0000, RDATA_END = 0x7FF6'1100'0000;
+
+    struct synthetic_object_t
+    {
+        SnapshotType::Enum type;
+        uint64_t address;
+        std::vector< uint8_t > data;
+    };
+
+    void put_qword( synthetic_object_t& object, const uint32_t offset, const uint64_t value ) { memcpy( object.data.data() + offset, &value, 8 ); }
+    void put_float( synthetic_object_t& object, const uint32_t offset, const float value ) { memcpy( object.data.data() + offset, &value, 4 ); }
+
+    /**
+     * \brief A truck with three trailers, every database field moved by a few bytes from its default
+     * \param planted where each rule's field ended up
+     */
+    std::vector< memory::memory_snapshot_t > make_synthetic_snapshots( const std::vector< field_rule_t >& rules, std::vector< uint32_t >& planted )
+    {
+        planted.clear();
+        for ( size_t i = 0; i < rules.size(); ++i ) planted.push_back( rules[ i ].expected + static_cast< uint32_t >( i % 4 ) * 8 );
+        const auto at = [ &rules, &planted ]( const char* name )
+        {
+            for ( size_t i = 0; i < rules.size(); ++i )
+            {
+                if ( strcmp( rules[ i ].name, name ) == 0 ) return planted[ i ];
+            }
+            return 0u;
+        };
+
+        std::mt19937_64 random( 1456 );
+        uint64_t next_address = 0x0000'01F0'0000'0000;
+        std::vector< synthetic_object_t > objects;
+        const auto make = [ & ]( const SnapshotType::Enum type, const uint32_t size ) -> size_t
+        {
+            synthetic_object_t object{ type, next_address, std::vector< uint8_t >( size ) };
+            next_address += ( size + 0xFFF ) & ~0xFFFull;
+
+            // zeros, floats and pointers somewhere else, like real objects
+            for ( uint32_t offset = 8; offset + 8 <= size; offset += 8 )
+            {
+                const auto kind = random() % 4;
+                if ( kind == 1 )
+                {
+                    put_float( object, offset, std::uniform_real_distribution< float >( -500.0f, 500.0f )( random ) );
+                    put_float( object, offset + 4, std::uniform_real_distribution< float >( -500.0f, 500.0f )( random ) );
+                }
+                else if ( kind == 2 ) put_qword( object, offset, 0x0000'02A0'0000'0000 + ( random() & 0xFFFF'FFF0 ) );
+                else if ( kind == 3 ) put_qword( object, offset, RDATA_BEGIN + 0x8000 + ( random() & 0xFFFF8 ) ); // some other class's vtable
+            }
+            put_qword( object, 0, RDATA_BEGIN + 0x100 * ( type + 1 ) );
+            objects.push_back( std::move( object ) );
+            return objects.size() - 1;
+        };
+
+        const auto base_ctrl = make( SnapshotType::BASE_CTRL, 0x2980 );
+        const auto game_actor = make( SnapshotType::GAME_ACTOR, 0x10D8 );
+        const auto truck = make( SnapshotType::GAME_PHYSICS_VEHICLE, 0x0E00 );
+        size_t trailers[ 3 ], joints[ 3 ];
+        for ( auto& trailer : trailers ) trailer = make( SnapshotType::GAME_TRAILER_ACTOR, 0x0FE8 );
+        for ( auto& joint : joints ) joint = make( SnapshotType::PHYSICS_JOINT, 0x0080 );
+
+        const auto link = [ & ]( const size_t from, const char* field, const size_t to ) { put_qword( objects[ from ], at( field ), objects[ to ].address ); };
+        link( base_ctrl, "base_ctrl.game_actor", game_actor );
+        link( game_actor, "game_actor.game_physics_vehicle", truck );
+        link( game_actor, "game_actor.game_trailer_actor", trailers[ 0 ] );
+
+        std::vector< size_t > vehicles = { truck, trailers[ 0 ], trailers[ 1 ], trailers[ 2 ] };
+        for ( const auto vehicle : vehicles )
+        {
+            link( vehicle, "vehicle_shared.accessory_chassis_data", make( SnapshotType::ACCESSORY_CHASSIS_DATA, 0x0498 ) );
+            link( vehicle, "vehicle_shared.wheel_steering_stuff", make( SnapshotType::WHEEL_STEERING_DATA, 0x0060 ) );
+            put_float( objects[ vehicle ], at( "vehicle_shared.hook_locator" ), 0.0f );
+            put_float( objects[ vehicle ], at( "vehicle_shared.hook_locator" ) + 4, 1.2f );
+            put_float( objects[ vehicle ], at( "vehicle_shared.hook_locator" ) + 8, -3.5f );
+        }
+        for ( auto& object : objects )
+        {
+            if ( object.type != SnapshotType::ACCESSORY_CHASSIS_DATA ) continue;
+            put_float( object, at( "accessory_chassis_data.hook_position" ), 0.0f );
+            put_float( object, at( "accessory_chassis_data.hook_position" ) + 4, 1.1f );
+            put_float( object, at( "accessory_chassis_data.hook_position" ) + 8, 2.4f );
+        }
+        for ( size_t i = 0; i < 3; ++i )
+        {
+            link( trailers[ i ], "physics_trailer.physics_joint", joints[ i ] );
+            link( trailers[ i ], "physics_trailer.parent_vehicle", i == 0 ? truck : trailers[ i - 1 ] );
+            if ( i < 2 ) link( trailers[ i ], "physics_trailer.slave_trailer", trailers[ i + 1 ] );
+            else put_qword( objects[ trailers[ i ] ], at( "physics_trailer.slave_trailer" ), 0 );
+            link( joints[ i ], "physics_joint_physx.px_joint", make( SnapshotType::PX_D6_JOINT, 0x0088 ) );
+        }
+
+        // frames while driving, only the live values change
+        std::vector< memory::memory_snapshot_t > snapshots( 4 );
+        for ( uint32_t frame = 0; frame < snapshots.size(); ++frame )
+        {
+            put_float( objects[ game_actor ], at( "game_actor.rpm" ), 800.0f + 350.0f * frame );
+            for ( size_t v = 0; v < vehicles.size(); ++v )
+            {
+                put_float( objects[ vehicles[ v ] ], at( "vehicle_shared.speed" ), -1.5f - 0.4f * frame );
+                put_float( objects[ vehicles[ v ] ], at( "vehicle_shared.steering" ), 0.1f * frame - 0.05f * v );
+            }
+
+            memory::snapshot_file_header_t header{};
+            header.frame = frame;
+            header.rdata_begin = RDATA_BEGIN;
+            header.rdata_end = RDATA_END;
+            memory::set_snapshot_string( header.game, sizeof( header.game ), "ats" );
+            memory::set_snapshot_string( header.game_version, sizeof( header.game_version ), "9.99.0.1" );
+
+            std::vector< memory::snapshot_source_region_t > regions;
+            for ( const auto& object : objects )
+            {
+                regions.push_back( { object.address, object.data.data(), static_cast< uint32_t >( object.data.size() ), object.type, 0, 0 } );
+            }
+
+            std::string error;
+            if ( !memory::parse_memory_snapshot( memory::serialize_memory_snapshot( header, regions.data(), regions.size() ), snapshots[ frame ], error ) )
+            {
+                printf( "synthetic snapshot: %s\n", error.c_str() );
+                exit( EXIT_FAILURE );
+            }
+        }
+        return snapshots;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    std::string game, version;
+    uint32_t top = 3;
+    double min_confidence = 0.5;
+    bool self_test = false;
+    std::vector< const char* > paths;
+    for ( int i = 1; i < argc; ++i )
+    {
+        const auto has_value = i + 1 < argc;
+        if ( strcmp( argv[ i ], "--self-test" ) == 0 ) self_test = true;
+        else if ( strcmp( argv[ i ], "--game" ) == 0 && has_value ) game = argv[ ++i ];
+        else if ( strcmp( argv[ i ], "--version" ) == 0 && has_value ) version = argv[ ++i ];
+        else if ( strcmp( argv[ i ], "--top" ) == 0 && has_value ) top = static_cast< uint32_t >( strtoul( argv[ ++i ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--min-confidence" ) == 0 && has_value ) min_confidence = atof( argv[ ++i ] );
+        else paths.push_back( argv[ i ] );
+    }
+
+    const auto rules = make_rules();
+    std::vector< memory::memory_snapshot_t > snapshots;
+    std::vector< uint32_t > planted;
+    const auto load_start = std::chrono::steady_clock::now();
+    if ( self_test ) snapshots = make_synthetic_snapshots( rules, planted );
+    else
+    {
+        if ( paths.empty() )
+        {
+            printf( "usage: offset-discovery [--game <ats|ets2>] [--version <pack set version>] [--top <n>] [--min-confidence <0-1>] <snapshot>...\n"
+                    "       offset-discovery --self-test\n" );
+            return EXIT_FAILURE;
+        }
+
+        snapshots.resize( paths.size() );
+        for ( size_t i = 0; i < paths.size(); ++i )
+        {
+            std::string error;
+            if ( !memory::load_memory_snapshot( paths[ i ], snapshots[ i ], error ) )
+            {
+                printf( "%s: %s\n", paths[ i ], error.c_str() );
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    const auto& first = snapshots.front().header;
+    if ( game.empty() ) game = memory::get_snapshot_string( first.game, sizeof( first.game ) );
+    if ( version.empty() ) version = memory::get_snapshot_string( first.game_version, sizeof( first.game_version ) );
+
+    size_t bytes = 0, regions = 0;
+    for ( const auto& snapshot : snapshots )
+    {
+        bytes += snapshot.size;
+        regions += snapshot.regions.size();
+    }
+
+    const auto analysis_start = std::chrono::steady_clock::now();
+    const CDiscovery discovery( snapshots );
+    std::vector< rule_result_t > results;
+    for ( const auto& rule : rules ) results.push_back( discovery.run( rule ) );
+    const auto end = std::chrono::steady_clock::now();
+
+    printf( "%zu snapshots, %zu regions, %.1f KiB, loaded in %.1f ms, analyzed in %.1f ms\n\n", snapshots.size(), regions, bytes / 1024.0,
+            std::chrono::duration< double, std::milli >( analysis_start - load_start ).count(),
+            std::chrono::duration< double, std::milli >( end - analysis_start ).count() );
+
+    int result = EXIT_SUCCESS;
+    for ( size_t i = 0; i < rules.size(); ++i )
+    {
+        const auto& rule = rules[ i ];
+        const auto& candidates = results[ i ].candidates;
+        printf( "%-40s %u objects, last known 0x%04X\n", rule.name, results[ i ].objects, rule.expected );
+        if ( candidates.empty() ) printf( "    no candidates\n" );
+        for ( size_t c = 0; c < candidates.size() && c < top; ++c )
+        {
+            const auto& candidate = candidates[ c ];
+            if ( rule.kind == RuleKind::POINTER ) printf( "    0x%04X  confidence %.2f  %u hits, %u null, %u miss\n", candidate.offset, candidate.confidence, candidate.hits, candidate.nulls, candidate.misses );
+            else printf( "    0x%04X  confidence %.2f  %u in range, %u out of range\n", candidate.offset, candidate.confidence, candidate.hits, candidate.misses );
+        }
+
+        if ( self_test && ( candidates.empty() || candidates.front().offset != planted[ i ] ) )
+        {
+            printf( "    expected 0x%04X\n", planted[ i ] );
+            result = EXIT_FAILURE;
+        }
+    }
+
+    printf( "\n# offset-discovery, minimum confidence %.2f\n[%s %s]\n", min_confidence, game.c_str(), version.c_str() );
+    for ( size_t i = 0; i < rules.size(); ++i )
+    {
+        if ( !is_database_field( rules[ i ].name ) ) continue;
+        const auto& candidates = results[ i ].candidates;
+        if ( candidates.empty() ) printf( "# %-38s not found\n", rules[ i ].name );
+        else printf( "%s%-38s 0x%04X  # confidence %.2f\n", candidates.front().confidence >= min_confidence ? "" : "# ", rules[ i ].name, candidates.front().offset,
+                     candidates.front().confidence );
+    }
+
+    if ( self_test ) printf( "\n%s\n", result == EXIT_SUCCESS ? "self test passed" : "self test FAILED" );
+    return result;
+}
@@ -0,0 +1,308 @@
+// Drives the reverse steering controller against a kinematic truck and trailer model and checks that it keeps the
+// steerable trailers on the path.
+//
+// usage: reverse-steering-sim [--trailers <n>] [--speed <m/s>] [--lookahead <m>] [--distance <m>] [--print 1]
+//
+// Every scenario reverses a rig with the first trailer kinked a little, the truck's driver follows the same path with
+// pure pursuit on the truck's rear axle. The controller runs at 60 Hz like frame_end and its steering is held over the
+// physics steps in between, the way the steering_advance detour applies it. The model is the usual one for steered
+// axles: the kingpin moves with whatever pulls it, the axle only rolls in the direction its wheels point.
+//
+// Exits with 1 if a trailer jackknifes or is still more than 0.5 m off the path at the end of a scenario.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "trailers/reverse_controller.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double PHYSICS_STEP = 1.0 / 600.0;
+    constexpr uint32_t STEPS_PER_FRAME = 10;
+
+    constexpr double TRUCK_WHEELBASE = 3.8;
+    constexpr double TRUCK_MAX_STEER = 0.6;
+    constexpr double TRUCK_HITCH = 0.4; // fifth wheel ahead of the rear axle
+    constexpr double FIRST_TRAILER_LENGTH = 7.5; // kingpin to steered axle
+    constexpr double TRAILER_LENGTH = 6.0;
+    constexpr double REAR_COUPLING = 1.2; // behind the axle
+
+    constexpr double JACKKNIFE = 70.0 * PI / 180.0;
+    constexpr double MAX_FINAL_ERROR = 0.5;
+
+    double wrap( const double angle ) { return angle - 2.0 * PI * std::floor( angle / ( 2.0 * PI ) + 0.5 ); }
+
+    // same path as the controller lays, the line up to the origin and the arc behind it, in doubles
+    struct path_t
+    {
+        double x, y, angle, curvature;
+
+        // `s` is the previous result for the same point, it tells which turn around the arc the point is on
+        void nearest( const double px, const double py, double& s, double& error ) const
+        {
+            const auto dx = std::cos( this->angle ), dy = std::sin( this->angle );
+            const auto u = ( px - this->x ) * dx + ( py - this->y ) * dy;
+            const auto w = ( py - this->y ) * dx - ( px - this->x ) * dy;
+            if ( std::fabs( this->curvature ) >= 1.0e-4 )
+            {
+                const auto ku = this->curvature * u, kw = 1.0 - this->curvature * w;
+                const auto period = 2.0 * PI / std::fabs( this->curvature );
+                auto arc = std::atan2( ku, kw ) / this->curvature;
+                arc += period * std::floor( ( s - arc ) / period + 0.5 );
+                if ( arc > 0.0 )
+                {
+                    s = arc;
+                    error = ( 1.0 - std::sqrt( ku * ku + kw * kw ) ) / this->curvature;
+                    return;
+                }
+            }
+            s = u;
+            error = w;
+        }
+
+        void point( const double s, double& px, double& py ) const
+        {
+            const auto dx = std::cos( this->angle ), dy = std::sin( this->angle );
+            double u = s, w = 0.0;
+            if ( std::fabs( this->curvature ) >= 1.0e-4 && s > 0.0 )
+            {
+                u = std::sin( this->curvature * s ) / this->curvature;
+                w = ( 1.0 - std::cos( this->curvature * s ) ) / this->curvature;
+            }
+            px = this->x + u * dx - w * dy;
+            py = this->y + u * dy + w * dx;
+        }
+    };
+
+    struct rig_t
+    {
+        uint32_t trailers;
+        double truck_x, truck_y, truck_angle; // rear axle
+        double angle[ trailers::MAX_CONTROLLED_TRAILERS ];
+        double wheel_angle[ trailers::MAX_CONTROLLED_TRAILERS ];
+
+        static double length( const uint32_t i ) { return i == 0 ? FIRST_TRAILER_LENGTH : TRAILER_LENGTH; }
+
+        // kingpins and steered axles of all trailers
+        void joints( double* kingpin_x, double* kingpin_y, double* axle_x, double* axle_y ) const
+        {
+            auto x = this->truck_x + TRUCK_HITCH * std::cos( this->truck_angle );
+            auto y = this->truck_y + TRUCK_HITCH * std::sin( this->truck_angle );
+            for ( uint32_t i = 0; i < this->trailers; ++i )
+            {
+                kingpin_x[ i ] = x;
+                kingpin_y[ i ] = y;
+                axle_x[ i ] = x - length( i ) * std::cos( this->angle[ i ] );
+                axle_y[ i ] = y - length( i ) * std::sin( this->angle[ i ] );
+                x = axle_x[ i ] - REAR_COUPLING * std::cos( this->angle[ i ] );
+                y = axle_y[ i ] - REAR_COUPLING * std::sin( this->angle[ i ] );
+            }
+        }
+
+        // the truck reverses with curvature `truck_curvature` of its rear axle path, every trailer follows its kingpin
+        void step( const double speed, const double truck_curvature, const double dt )
+        {
+            double old_x[ trailers::MAX_CONTROLLED_TRAILERS ], old_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+            double axle_x[ trailers::MAX_CONTROLLED_TRAILERS ], axle_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+            this->joints( old_x, old_y, axle_x, axle_y );
+
+            const auto reverse_angle = this->truck_angle + PI + speed * truck_curvature * dt;
+            this->truck_angle = reverse_angle - PI;
+            this->truck_x += speed * dt * std::cos( reverse_angle );
+            this->truck_y += speed * dt * std::sin( reverse_angle );
+
+            auto x = this->truck_x + TRUCK_HITCH * std::cos( this->truck_angle );
+            auto y = this->truck_y + TRUCK_HITCH * std::sin( this->truck_angle );
+            for ( uint32_t i = 0; i < this->trailers; ++i )
+            {
+                // the axle can't move sideways to its wheels
+                const auto wheels = this->angle[ i ] + this->wheel_angle[ i ];
+                const auto rate = ( ( x - old_x[ i ] ) * -std::sin( wheels ) + ( y - old_y[ i ] ) * std::cos( wheels ) ) / dt /
+                                  ( length( i ) * std::cos( this->wheel_angle[ i ] ) );
+                this->angle[ i ] += rate * dt;
+
+                x = x - ( length( i ) + REAR_COUPLING ) * std::cos( this->angle[ i ] );
+                y = y - ( length( i ) + REAR_COUPLING ) * std::sin( this->angle[ i ] );
+            }
+        }
+    };
+
+    // what the telemetry reports, trailer placements are at the kingpin so the controller has to use the geometry
+    void fill_frame( const rig_t& rig, const double speed, telemetry::telemetry_frame_t& frame )
+    {
+        double kingpin_x[ trailers::MAX_CONTROLLED_TRAILERS ], kingpin_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+        double axle_x[ trailers::MAX_CONTROLLED_TRAILERS ], axle_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+        rig.joints( kingpin_x, kingpin_y, axle_x, axle_y );
+
+        frame.truck.speed = static_cast< float >( -speed );
+        frame.truck.world_placement.position = { rig.truck_x, 0.0, -rig.truck_y };
+        frame.truck.world_placement.orientation.heading = static_cast< float >( std::fmod( rig.truck_angle / ( 2.0 * PI ) - 0.25 + 8.0, 1.0 ) );
+        for ( uint32_t i = 0; i < trailers::MAX_CONTROLLED_TRAILERS; ++i )
+        {
+            frame.trailers.connected[ i ] = i < rig.trailers;
+            if ( i >= rig.trailers ) continue;
+
+            auto& placement = frame.trailers.world_placement[ i ];
+            placement.position = { kingpin_x[ i ], 0.0, -kingpin_y[ i ] };
+            placement.orientation.heading = static_cast< float >( std::fmod( rig.angle[ i ] / ( 2.0 * PI ) - 0.25 + 8.0, 1.0 ) );
+        }
+    }
+
+    struct scenario_t
+    {
+        const char* name;
+        double radius; // 0 = straight, positive turns left looking backwards
+        double kink; // degrees of the first trailer against the truck at the start
+        bool controlled;
+    };
+
+    struct result_t
+    {
+        double final_error[ trailers::MAX_CONTROLLED_TRAILERS ];
+        double max_articulation;
+        bool jackknifed;
+        double update_ns;
+    };
+
+    result_t run( const scenario_t& scenario, const uint32_t trailer_count, const double speed, const double lookahead, const double distance,
+                  const bool print )
+    {
+        rig_t rig = {};
+        rig.trailers = trailer_count;
+        rig.angle[ 0 ] = scenario.kink * PI / 180.0;
+
+        trailers::reverse_rig_geometry_t geometry = {};
+        for ( uint32_t i = 0; i < trailer_count; ++i )
+        {
+            geometry.axle_z[ i ] = static_cast< float >( rig_t::length( i ) );
+            geometry.steerable |= 1u << i;
+        }
+
+        trailers::CReverseSteeringController controller;
+        const auto max_wheel_angle = 0.5f;
+        controller.set_geometry( geometry );
+        controller.set_params( { static_cast< float >( lookahead ), max_wheel_angle, 0.05f, false } );
+
+        auto* frame = new telemetry::telemetry_frame_t();
+        fill_frame( rig, speed, *frame );
+        controller.request_engage( scenario.radius != 0.0 ? static_cast< float >( 1.0 / scenario.radius ) : 0.0f );
+
+        // the path as the controller lays it
+        double kingpin_x[ trailers::MAX_CONTROLLED_TRAILERS ], kingpin_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+        double axle_x[ trailers::MAX_CONTROLLED_TRAILERS ], axle_y[ trailers::MAX_CONTROLLED_TRAILERS ];
+        rig.joints( kingpin_x, kingpin_y, axle_x, axle_y );
+        const auto last = trailer_count - 1;
+        const path_t path{ axle_x[ last ], axle_y[ last ], rig.angle[ last ] + PI, scenario.radius != 0.0 ? 1.0 / scenario.radius : 0.0 };
+
+        result_t result = {};
+        double update_total = 0.0;
+        uint32_t updates = 0;
+        double truck_station = 0.0, error = 0.0;
+        double stations[ trailers::MAX_CONTROLLED_TRAILERS ] = {};
+        const auto steps = static_cast< uint32_t >( distance / speed / PHYSICS_STEP );
+        for ( uint32_t step = 0; step < steps && !result.jackknifed; ++step )
+        {
+            if ( step % STEPS_PER_FRAME == 0 )
+            {
+                fill_frame( rig, speed, *frame );
+                float steering[ trailers::MAX_CONTROLLED_TRAILERS ];
+                const auto start = std::chrono::steady_clock::now();
+                const auto steered = controller.update( *frame, steering );
+                update_total += std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+                ++updates;
+
+                for ( uint32_t i = 0; i < trailer_count; ++i )
+                {
+                    rig.wheel_angle[ i ] = scenario.controlled && ( steered >> i & 1 ) != 0 ? steering[ i ] * max_wheel_angle : 0.0;
+                }
+            }
+
+            // the driver keeps the truck's rear axle on the path
+            double target_x, target_y;
+            path.nearest( rig.truck_x, rig.truck_y, truck_station, error );
+            path.point( truck_station + 6.0, target_x, target_y );
+            const auto to_target = std::atan2( target_y - rig.truck_y, target_x - rig.truck_x ) - ( rig.truck_angle + PI );
+            const auto limit = std::tan( TRUCK_MAX_STEER ) / TRUCK_WHEELBASE;
+            const auto curvature = std::clamp( 2.0 * std::sin( wrap( to_target ) ) / std::hypot( target_x - rig.truck_x, target_y - rig.truck_y ), -limit, limit );
+            rig.step( speed, curvature, PHYSICS_STEP );
+
+            rig.joints( kingpin_x, kingpin_y, axle_x, axle_y );
+            auto parent = rig.truck_angle;
+            for ( uint32_t i = 0; i < trailer_count; ++i )
+            {
+                const auto articulation = std::fabs( wrap( rig.angle[ i ] - parent ) );
+                result.max_articulation = std::max( result.max_articulation, articulation );
+                result.jackknifed |= articulation > JACKKNIFE;
+                parent = rig.angle[ i ];
+                path.nearest( axle_x[ i ], axle_y[ i ], stations[ i ], result.final_error[ i ] );
+            }
+
+            if ( print && step % ( STEPS_PER_FRAME * 30 ) == 0 )
+            {
+                printf( "  %6.2f s", step * PHYSICS_STEP );
+                for ( uint32_t i = 0; i < trailer_count; ++i )
+                {
+                    printf( "  t%u %+6.2f m %+5.1f deg", i, result.final_error[ i ], rig.wheel_angle[ i ] * 180.0 / PI );
+                }
+                printf( "\n" );
+            }
+        }
+
+        result.update_ns = updates != 0 ? update_total / updates : 0.0;
+        delete frame;
+        return result;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t trailer_count = 2;
+    double speed = 2.0;
+    double lookahead = 6.0;
+    double distance = 60.0;
+    bool print = false;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--trailers" ) == 0 ) trailer_count = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--speed" ) == 0 ) speed = atof( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--lookahead" ) == 0 ) lookahead = atof( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--distance" ) == 0 ) distance = atof( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--print" ) == 0 ) print = atoi( argv[ i + 1 ] ) != 0;
+    }
+    trailer_count = std::clamp( trailer_count, 1u, trailers::MAX_CONTROLLED_TRAILERS );
+    speed = std::max( speed, 0.1 );
+
+    const scenario_t scenarios[] = {
+        { "straight, kinked 6 deg", 0.0, 6.0, true },
+        { "arc 40 m left", 40.0, 0.0, true },
+        { "arc 60 m right, kinked -4 deg", -60.0, -4.0, true },
+        { "straight, kinked 6 deg, no steering", 0.0, 6.0, false },
+    };
+
+    printf( "%u trailers reversing at %.1f m/s for %.0f m, lookahead %.1f m\n", trailer_count, speed, distance, lookahead );
+
+    bool failed = false;
+    for ( const auto& scenario : scenarios )
+    {
+        if ( print ) printf( "%s\n", scenario.name );
+        const auto result = run( scenario, trailer_count, speed, lookahead, distance, print );
+
+        double worst = 0.0;
+        for ( uint32_t i = 0; i < trailer_count; ++i ) worst = std::max( worst, std::fabs( result.final_error[ i ] ) );
+
+        // the unsteered run is only there to show the rig doesn't stay straight on its own
+        const auto ok = !scenario.controlled || ( !result.jackknifed && worst <= MAX_FINAL_ERROR );
+        failed |= !ok;
+        printf( "%-38s %s  final error %.3f m, max articulation %.1f deg, update %.0f ns\n", scenario.name,
+                !scenario.controlled ? "    " : ok ? "ok  " : "FAIL", worst, result.max_articulation * 180.0 / PI, result.update_ns );
+        if ( result.jackknifed ) printf( "%-38s       jackknifed\n", "" );
+    }
+    return failed ? 1 : 0;
+}
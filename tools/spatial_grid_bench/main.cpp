@@ -0,0 +1,144 @@
+// Benchmarks the map item spatial grid on a synthetic road network and checks it against a linear scan.
+//
+// usage: spatial-grid-bench [--items <count>] [--queries <count>] [--cell <meters>] [--radius <meters>]
+//
+// Roads are random polylines over a 400 km square with a node every 20 m and kdop items scattered next to them,
+// which is roughly how dense a loaded map is along the roads and how empty it is in between. Queries are taken
+// around the roads, where a truck would be. Prints build time and time per nearest and radius query, and exits with 1
+// if any of the first thousand queries differs from a scan over every item.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "map/spatial_grid.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    constexpr float WORLD_SIZE = 400000.0f; // meters
+    constexpr size_t CHECKED_QUERIES = 1000;
+
+    std::vector< map::map_item_t > make_items( const size_t count, std::mt19937& random )
+    {
+        std::uniform_real_distribution< float > world( -WORLD_SIZE / 2, WORLD_SIZE / 2 );
+        std::uniform_real_distribution< float > turn( -0.15f, 0.15f ), offset( -30.0f, 30.0f ), height( 0.0f, 40.0f );
+
+        std::vector< map::map_item_t > items;
+        items.reserve( count );
+        while ( items.size() < count )
+        {
+            // a road of up to 10 km
+            float x = world( random ), z = world( random ), y = height( random ), heading = world( random );
+            for ( int i = 0; i < 500 && items.size() < count; ++i )
+            {
+                heading += turn( random );
+                x += std::cos( heading ) * 20.0f;
+                z += std::sin( heading ) * 20.0f;
+                y += turn( random );
+                items.push_back( { { x, y, z }, map::MapItemKind::NODE, 0x10000 + items.size() * 0x40 } );
+                if ( items.size() < count )
+                {
+                    items.push_back( { { x + offset( random ), y, z + offset( random ) }, map::MapItemKind::KDOP_ITEM, 0x10000 + items.size() * 0x40 } );
+                }
+            }
+        }
+        return items;
+    }
+
+    float distance( const float3_t& a, const float3_t& b )
+    {
+        const auto dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return std::sqrt( dx * dx + dy * dy + dz * dz );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    size_t item_count = 400000, query_count = 100000;
+    float cell_size = map::CSpatialGrid::DEFAULT_CELL_SIZE, radius = 100.0f;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--items" ) == 0 ) item_count = strtoull( argv[ i + 1 ], nullptr, 10 );
+        else if ( strcmp( argv[ i ], "--queries" ) == 0 ) query_count = strtoull( argv[ i + 1 ], nullptr, 10 );
+        else if ( strcmp( argv[ i ], "--cell" ) == 0 ) cell_size = static_cast< float >( atof( argv[ i + 1 ] ) );
+        else if ( strcmp( argv[ i ], "--radius" ) == 0 ) radius = static_cast< float >( atof( argv[ i + 1 ] ) );
+        else
+        {
+            printf( "usage: spatial-grid-bench [--items <count>] [--queries <count>] [--cell <meters>] [--radius <meters>]\n" );
+            return EXIT_FAILURE;
+        }
+    }
+    if ( item_count == 0 || query_count == 0 || !( cell_size > 0.0f ) )
+    {
+        printf( "items, queries and cell size have to be positive\n" );
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 random( 47 );
+    const auto items = make_items( item_count, random );
+
+    std::vector< float3_t > queries( query_count );
+    std::uniform_int_distribution< size_t > pick( 0, items.size() - 1 );
+    std::uniform_real_distribution< float > near( -500.0f, 500.0f );
+    for ( auto& query : queries )
+    {
+        const auto& around = items[ pick( random ) ].position;
+        query = { around.x + near( random ), around.y, around.z + near( random ) };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const map::CSpatialGrid grid( items.data(), items.size(), cell_size );
+    const auto build_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+    printf( "%zu items in %zu cells of %.0f m, built in %.1f ms\n", grid.size(), grid.get_cell_count(), cell_size, build_ms );
+
+    constexpr float MAX_DISTANCE = 2000.0f;
+    const auto node = 1u << map::MapItemKind::NODE;
+    int result = EXIT_SUCCESS;
+
+    start = std::chrono::steady_clock::now();
+    int64_t found = 0;
+    for ( const auto& query : queries ) found += grid.find_nearest( query, node, MAX_DISTANCE ) >= 0;
+    const auto nearest_ns = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() / query_count;
+
+    std::vector< uint32_t > hits;
+    start = std::chrono::steady_clock::now();
+    size_t in_radius = 0;
+    for ( const auto& query : queries ) in_radius += grid.find_in_radius( query, radius, map::ALL_MAP_ITEM_KINDS, hits );
+    const auto radius_ns = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() / query_count;
+
+    printf( "nearest node within %.0f m: %.0f ns per query, %lld of %zu found\n", MAX_DISTANCE, nearest_ns, static_cast< long long >( found ), query_count );
+    printf( "items within %.0f m: %.0f ns per query, %.1f items on average\n", radius, radius_ns, static_cast< double >( in_radius ) / query_count );
+
+    // against a scan over everything, distances rather than indices since two items can be equally far away
+    for ( size_t q = 0; q < queries.size() && q < CHECKED_QUERIES; ++q )
+    {
+        const auto& query = queries[ q ];
+        float expected = MAX_DISTANCE;
+        size_t expected_radius = 0;
+        for ( const auto& item : items )
+        {
+            const auto d = distance( query, item.position );
+            if ( item.kind == map::MapItemKind::NODE && d < expected ) expected = d;
+            expected_radius += d <= radius;
+        }
+
+        float actual = 0.0f;
+        const auto index = grid.find_nearest( query, node, MAX_DISTANCE, &actual );
+        const auto nearest_ok = index < 0 ? expected >= MAX_DISTANCE : std::fabs( actual - expected ) < 1.0e-3f && grid.get_kind( index ) == map::MapItemKind::NODE;
+        const auto radius_ok = grid.find_in_radius( query, radius, map::ALL_MAP_ITEM_KINDS, hits ) == expected_radius;
+        if ( !nearest_ok || !radius_ok )
+        {
+            printf( "query %zu (%.1f %.1f %.1f): nearest %.3f expected %.3f, %zu in radius expected %zu\n", q, query.x, query.y, query.z,
+                    index < 0 ? -1.0f : actual, expected, hits.size(), expected_radius );
+            result = EXIT_FAILURE;
+        }
+    }
+    printf( "checked %zu queries against a linear scan: %s\n", std::min( queries.size(), CHECKED_QUERIES ), result == EXIT_SUCCESS ? "ok" : "MISMATCH" );
+    return result;
+}
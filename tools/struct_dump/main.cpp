@@ -0,0 +1,121 @@
+// Prints the reflected fields (prism/reflection.hpp) of the objects in a memory snapshot, or what changed between two.
+//
+// usage: struct-dump [--type <struct>] <snapshot> [<later snapshot>]
+//
+// Every region captured as a game actor, vehicle or accessory chassis data is printed with one line per field. With a
+// second snapshot of the same session, e.g. two of a series taken with "Memory snapshot" in the trailer window, only
+// the fields of objects at the same address whose bytes differ are printed, old and new value. Offsets are the ones
+// the plugin was built with.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "memory/snapshot.hpp"
+#include "prism/reflection.hpp"
+
+using namespace ts_extra_utilities;
+using memory::SnapshotType;
+
+namespace
+{
+    const prism::struct_info_t* get_struct_info( const SnapshotType::Enum type )
+    {
+        switch ( type )
+        {
+            case SnapshotType::GAME_ACTOR: return prism::find_struct_info( "game_actor" );
+            case SnapshotType::GAME_PHYSICS_VEHICLE:
+            case SnapshotType::GAME_TRAILER_ACTOR: return prism::find_struct_info( "vehicle_shared" );
+            case SnapshotType::ACCESSORY_CHASSIS_DATA: return prism::find_struct_info( "accessory_chassis_data" );
+            default: return nullptr;
+        }
+    }
+
+    bool load( const char* path, memory::memory_snapshot_t& snapshot )
+    {
+        std::string error;
+        if ( memory::load_memory_snapshot( path, snapshot, error ) ) return true;
+        printf( "%s: %s\n", path, error.c_str() );
+        return false;
+    }
+
+    // true if anything differed
+    bool print_changes( const prism::struct_info_t& info, const uint8_t* before, const uint8_t* after, const size_t size )
+    {
+        char old_value[ 128 ], new_value[ 128 ];
+        bool changed = false;
+        for ( const auto& field : info )
+        {
+            const auto offset = prism::get_field_offset( info, field );
+            if ( offset + field.get_size() > size || memcmp( before + offset, after + offset, field.get_size() ) == 0 ) continue;
+
+            prism::format_field_value( field, before + offset, old_value, sizeof( old_value ) );
+            prism::format_field_value( field, after + offset, new_value, sizeof( new_value ) );
+            printf( "0x%04X  %-36s %s -> %s\n", offset, field.name, old_value, new_value );
+            changed = true;
+        }
+        return changed;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const char* type_filter = nullptr;
+    const char* paths[ 2 ] = {};
+    int path_count = 0;
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[ i ], "--type" ) == 0 && i + 1 < argc ) type_filter = argv[ ++i ];
+        else if ( argv[ i ][ 0 ] != '-' && path_count < 2 ) paths[ path_count++ ] = argv[ i ];
+        else path_count = -1;
+
+        if ( path_count < 0 ) break;
+    }
+    if ( path_count <= 0 )
+    {
+        printf( "usage: struct-dump [--type <struct>] <snapshot> [<later snapshot>]\n" );
+        return EXIT_FAILURE;
+    }
+    if ( type_filter != nullptr && prism::find_struct_info( type_filter ) == nullptr )
+    {
+        printf( "%s isn't reflected, one of:", type_filter );
+        for ( size_t i = 0; i < prism::reflected_struct_count; ++i ) printf( " %s", prism::reflected_structs[ i ].name );
+        printf( "\n" );
+        return EXIT_FAILURE;
+    }
+
+    memory::memory_snapshot_t snapshot, later;
+    if ( !load( paths[ 0 ], snapshot ) || ( path_count == 2 && !load( paths[ 1 ], later ) ) ) return EXIT_FAILURE;
+
+    size_t objects = 0, changed = 0;
+    for ( const auto& region : snapshot.regions )
+    {
+        const auto type = static_cast< SnapshotType::Enum >( region.type );
+        const auto* info = get_struct_info( type );
+        if ( info == nullptr || ( type_filter != nullptr && strcmp( type_filter, info->name ) != 0 ) ) continue;
+
+        if ( path_count == 1 )
+        {
+            printf( "# %s @ 0x%llx, %s, depth %u\n", memory::to_string( type ), static_cast< unsigned long long >( region.address ), info->name,
+                    region.depth );
+            prism::write_struct_dump( stdout, *info, snapshot.get_data( region ), region.size );
+            printf( "\n" );
+            ++objects;
+            continue;
+        }
+
+        const auto* other = later.find_region( region.address );
+        if ( other == nullptr || other->address != region.address || other->type != region.type ) continue;
+
+        ++objects;
+        printf( "# %s @ 0x%llx\n", memory::to_string( type ), static_cast< unsigned long long >( region.address ) );
+        if ( print_changes( *info, snapshot.get_data( region ), later.get_data( *other ), region.size < other->size ? region.size : other->size ) ) ++changed;
+        else printf( "unchanged\n" );
+        printf( "\n" );
+    }
+
+    if ( path_count == 1 ) printf( "%zu objects\n", objects );
+    else printf( "%zu objects in both, %zu changed\n", objects, changed );
+    return EXIT_SUCCESS;
+}
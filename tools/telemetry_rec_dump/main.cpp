@@ -0,0 +1,174 @@
+// Prints the block index of a .tsrec telemetry recording or exports selected columns as csv.
+//
+// usage: telemetry-rec-dump <file.tsrec> [--column <name prefix>]... [--from <seconds>] [--to <seconds>]
+//
+// Without --column only the header, block index and gameplay events are printed. Times are render time in seconds.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "telemetry/recorder.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    std::string column_label( const telemetry::recording_column_t& column )
+    {
+        char label[ 64 ];
+        if ( strncmp( column.name, "trailer.wheel.", 14 ) == 0 )
+        {
+            snprintf( label, sizeof( label ), "%s[%u][%u]", column.name, column.element / telemetry::MAX_WHEELS, column.element % telemetry::MAX_WHEELS );
+        }
+        else if ( strncmp( column.name, "truck.wheel.", 12 ) == 0 || strncmp( column.name, "trailer.", 8 ) == 0 )
+        {
+            snprintf( label, sizeof( label ), "%s[%u]", column.name, column.element );
+        }
+        else
+        {
+            snprintf( label, sizeof( label ), "%s", column.name );
+        }
+        return label;
+    }
+
+    void print_value( const uint8_t type, const uint64_t raw )
+    {
+        switch ( type )
+        {
+            case telemetry::ColumnType::BOOL: printf( "%u", static_cast< uint32_t >( raw != 0 ) ); break;
+            case telemetry::ColumnType::S32: printf( "%d", static_cast< int32_t >( raw ) ); break;
+            case telemetry::ColumnType::U32: printf( "%u", static_cast< uint32_t >( raw ) ); break;
+            case telemetry::ColumnType::S64: printf( "%" PRId64, static_cast< int64_t >( raw ) ); break;
+            case telemetry::ColumnType::U64: printf( "%" PRIu64, raw ); break;
+            case telemetry::ColumnType::F32:
+            {
+                float value;
+                const auto bits = static_cast< uint32_t >( raw );
+                memcpy( &value, &bits, sizeof( value ) );
+                printf( "%.9g", value );
+                break;
+            }
+            case telemetry::ColumnType::F64:
+            {
+                double value;
+                memcpy( &value, &raw, sizeof( value ) );
+                printf( "%.17g", value );
+                break;
+            }
+            default: printf( "?" ); break;
+        }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        printf( "usage: telemetry-rec-dump <file.tsrec> [--column <name prefix>]... [--from <seconds>] [--to <seconds>]\n" );
+        return 1;
+    }
+
+    std::vector< const char* > prefixes;
+    int64_t from = INT64_MIN;
+    int64_t to = INT64_MAX;
+    for ( int i = 2; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--column" ) == 0 ) prefixes.push_back( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--from" ) == 0 ) from = static_cast< int64_t >( strtod( argv[ i + 1 ], nullptr ) * 1000000.0 );
+        else if ( strcmp( argv[ i ], "--to" ) == 0 ) to = static_cast< int64_t >( strtod( argv[ i + 1 ], nullptr ) * 1000000.0 );
+    }
+
+    telemetry::CRecordingReader reader;
+    std::string error;
+    if ( !reader.open( argv[ 1 ], error ) )
+    {
+        printf( "could not open '%s': %s\n", argv[ 1 ], error.c_str() );
+        return 1;
+    }
+
+    const auto& header = reader.get_header();
+    const auto& columns = reader.get_columns();
+    const auto& index = reader.get_index();
+
+    if ( prefixes.empty() )
+    {
+        printf( "version %u, %u columns, %u frames per block, %zu blocks%s\n", header.version, header.column_count, header.block_frames,
+                index.size(), reader.was_index_rebuilt() ? " (no footer, index rebuilt)" : "" );
+        for ( size_t i = 0; i < index.size(); ++i )
+        {
+            printf( "  block %4zu  offset %10" PRIu64 "  frame %10" PRIu64 "  render time %.3f - %.3f s\n", i, index[ i ].file_offset,
+                    index[ i ].first_frame_index, static_cast< double >( index[ i ].first_render_time ) / 1000000.0,
+                    static_cast< double >( index[ i ].last_render_time ) / 1000000.0 );
+        }
+
+        std::vector< telemetry::gameplay_event_t > events;
+        if ( !reader.read_events( events, error ) )
+        {
+            fprintf( stderr, "gameplay events: %s\n", error.c_str() );
+            return 1;
+        }
+
+        printf( "%zu gameplay events\n", events.size() );
+        for ( const auto& event : events )
+        {
+            char text[ 256 ];
+            telemetry::format_gameplay_event( event, text, sizeof( text ) );
+            printf( "  #%-6" PRIu64 " render time %10.3f s  %s\n", event.sequence, static_cast< double >( event.render_time ) / 1000000.0, text );
+        }
+        return 0;
+    }
+
+    std::vector< size_t > selected;
+    size_t render_time_column = SIZE_MAX;
+    for ( size_t i = 0; i < columns.size(); ++i )
+    {
+        if ( strcmp( columns[ i ].name, "frame.render_time" ) == 0 ) render_time_column = i;
+        for ( const auto* prefix : prefixes )
+        {
+            if ( strncmp( columns[ i ].name, prefix, strlen( prefix ) ) != 0 ) continue;
+            selected.push_back( i );
+            break;
+        }
+    }
+
+    if ( selected.empty() || render_time_column == SIZE_MAX )
+    {
+        printf( "no matching columns\n" );
+        return 1;
+    }
+
+    printf( "render_time" );
+    for ( const auto column : selected ) printf( ";%s", column_label( columns[ column ] ).c_str() );
+    printf( "\n" );
+
+    std::vector< std::vector< uint64_t > > values;
+    for ( auto block = from == INT64_MIN ? 0 : reader.find_block( from ); block < index.size(); ++block )
+    {
+        if ( index[ block ].first_render_time > to ) break;
+        if ( !reader.read_block_columns( block, values, error ) )
+        {
+            fprintf( stderr, "block %u: %s\n", block, error.c_str() );
+            return 1;
+        }
+
+        for ( size_t frame = 0; frame < values[ render_time_column ].size(); ++frame )
+        {
+            const auto render_time = static_cast< int64_t >( values[ render_time_column ][ frame ] );
+            if ( render_time < from || render_time > to ) continue;
+
+            printf( "%" PRId64, render_time );
+            for ( const auto column : selected )
+            {
+                printf( ";" );
+                print_value( columns[ column ].type, values[ column ][ frame ] );
+            }
+            printf( "\n" );
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+// Replays recorded or synthetic frames through the plugin's telemetry layer on top of the fake SDK host and reports
+// callback throughput and per frame overhead.
+//
+// usage: telemetry-replay [--recording <file.tsrec>] [--frames <n>] [--repeat <n>] [--record <out.tsrec>] [--log 1] [--filter 0]
+//
+// Synthetic frames are deterministic, so runs with the same arguments are comparable. Timings are only meaningful
+// in an optimized build (-DCMAKE_BUILD_TYPE=Release). With --record the replay waits whenever the recorder's queue is
+// half full, which the wall time includes and the per frame times don't, and fails if a frame was dropped.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/scssdk_telemetry_common_gameplay_events.h"
+
+#include "fake_sdk_host/fake_sdk_host.hpp"
+#include "telemetry/telemetry.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    constexpr uint32_t SYNTHETIC_WHEELS = 6;
+    constexpr uint32_t GAMEPLAY_EVENT_INTERVAL = 5000; // frames between tollgates
+
+    void send_tollgate( tools::CFakeSdkHost& host, const int64_t amount )
+    {
+        scs_named_value_t attributes[ 2 ] = {};
+        attributes[ 0 ].name = SCS_TELEMETRY_GAMEPLAY_EVENT_ATTRIBUTE_pay_amount;
+        attributes[ 0 ].index = SCS_U32_NIL;
+        attributes[ 0 ].value.type = SCS_VALUE_TYPE_s64;
+        attributes[ 0 ].value.value_s64.value = amount;
+
+        const scs_telemetry_gameplay_event_t event{ SCS_TELEMETRY_GAMEPLAY_EVENT_player_tollgate_paid, attributes };
+        host.send_event( SCS_TELEMETRY_EVENT_gameplay, &event );
+    }
+
+    // deterministic -0.5 - 0.5, gauges in game jitter a little every frame
+    float jitter( const uint32_t i, const uint32_t salt )
+    {
+        return static_cast< float >( ( ( i * 2654435761u ) ^ salt ) >> 16 & 0xff ) / 255.0f - 0.5f;
+    }
+
+    // a truck with one trailer doing laps, the trailer is dropped and picked up again every 1000 frames
+    std::vector< telemetry::telemetry_frame_t > make_synthetic_frames( const uint32_t count )
+    {
+        std::vector< telemetry::telemetry_frame_t > frames( count );
+
+        double x = 1000.0, z = -500.0;
+        float heading = 0.0f;
+        for ( uint32_t i = 0; i < count; ++i )
+        {
+            auto& frame = frames[ i ];
+            frame.frame_index = i;
+            frame.render_time = 16667ll * i + i % 3;
+            frame.simulation_time = 16667ll * i;
+            frame.paused_simulation_time = 16667ll * i;
+
+            auto& truck = frame.truck;
+            const auto speed = 20.0f + 5.0f * std::sin( i * 0.001f );
+            heading += 0.0001f * std::sin( i * 0.0005f );
+            x += speed * 0.016667 * std::cos( heading );
+            z += speed * 0.016667 * std::sin( heading );
+
+            truck.world_placement.position = { x, 50.0 + std::sin( i * 0.01 ), z };
+            truck.world_placement.orientation.heading = heading;
+            truck.linear_velocity.z = speed;
+            truck.speed = speed;
+            truck.engine_rpm = 1200.0f + 300.0f * std::sin( i * 0.002f );
+            truck.engine_gear = 8 + static_cast< int32_t >( i / 3000 % 4 );
+            truck.effective_steering = 0.1f * std::sin( i * 0.003f );
+            truck.effective_throttle = i / 600 % 2 ? 0.8f : 0.0f;
+            truck.fuel = 400.0f - i * 0.001f;
+            truck.odometer = 12345.0f + i * 0.0003f;
+            truck.oil_temperature = 90.0f + 3.0f * std::sin( i * 0.0002f ) + 0.02f * jitter( i, 1 );
+            truck.water_temperature = 85.0f + 2.0f * std::sin( i * 0.0001f ) + 0.02f * jitter( i, 2 );
+            truck.battery_voltage = 24.2f + 0.05f * jitter( i, 3 );
+            truck.engine_enabled = true;
+            truck.light_low_beam = true;
+            truck.lblinker = i / 20 % 2 && i % 3000 < 300;
+
+            const auto connected = i % 2000 < 1000;
+            frame.trailers.connected[ 0 ] = connected;
+            frame.trailers.world_placement[ 0 ] = truck.world_placement;
+            frame.trailers.world_placement[ 0 ].position.x -= 8.0;
+            if ( connected ) frame.trailers.linear_velocity[ 0 ].z = speed;
+
+            for ( uint32_t wheel = 0; wheel < SYNTHETIC_WHEELS; ++wheel )
+            {
+                const auto rotation = std::fmod( i * 0.05f, 1.0f );
+                const auto deflection = 0.01f * std::sin( i * 0.05f + wheel );
+
+                truck.wheels.rotation[ wheel ] = rotation;
+                truck.wheels.angular_velocity[ wheel ] = speed / 0.5f;
+                truck.wheels.suspension_deflection[ wheel ] = deflection;
+                truck.wheels.on_ground[ wheel ] = true;
+                truck.wheels.steering[ wheel ] = wheel < 2 ? truck.effective_steering : 0.0f;
+
+                auto& trailer_wheels = frame.trailers.wheels[ 0 ];
+                trailer_wheels.rotation[ wheel ] = connected ? rotation : 0.0f;
+                trailer_wheels.angular_velocity[ wheel ] = connected ? speed / 0.5f : 0.0f;
+                trailer_wheels.suspension_deflection[ wheel ] = deflection;
+                trailer_wheels.on_ground[ wheel ] = true;
+            }
+        }
+        return frames;
+    }
+
+    bool load_recording( const char* path, std::vector< telemetry::telemetry_frame_t >& frames )
+    {
+        telemetry::CRecordingReader reader;
+        std::string error;
+        if ( !reader.open( path, error ) )
+        {
+            printf( "could not open '%s': %s\n", path, error.c_str() );
+            return false;
+        }
+
+        std::vector< telemetry::telemetry_frame_t > block;
+        for ( uint32_t i = 0; i < reader.get_index().size(); ++i )
+        {
+            if ( !reader.read_block( i, block, error ) )
+            {
+                printf( "block %u: %s\n", i, error.c_str() );
+                return false;
+            }
+            frames.insert( frames.end(), block.begin(), block.end() );
+        }
+        return true;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const char* recording = nullptr;
+    const char* record = nullptr;
+    uint32_t frame_count = 100000;
+    uint32_t repeat = 1;
+    bool echo_log = false;
+    bool filter = true;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--recording" ) == 0 ) recording = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "--record" ) == 0 ) record = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "--frames" ) == 0 ) frame_count = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--repeat" ) == 0 ) repeat = std::max( 1u, static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) ) );
+        else if ( strcmp( argv[ i ], "--log" ) == 0 ) echo_log = atoi( argv[ i + 1 ] ) != 0;
+        else if ( strcmp( argv[ i ], "--filter" ) == 0 ) filter = atoi( argv[ i + 1 ] ) != 0;
+    }
+
+    std::vector< telemetry::telemetry_frame_t > frames;
+    if ( recording != nullptr )
+    {
+        if ( !load_recording( recording, frames ) ) return 1;
+    }
+    else
+    {
+        frames = make_synthetic_frames( frame_count );
+    }
+
+    if ( frames.empty() )
+    {
+        printf( "nothing to replay\n" );
+        return 1;
+    }
+
+    tools::CFakeSdkHost host( echo_log );
+    telemetry::CTelemetry telemetry( host.get_init_params() );
+    if ( !telemetry.init() )
+    {
+        printf( "telemetry init failed\n" );
+        return 1;
+    }
+    telemetry.get_filter()->set_enabled( filter );
+
+    // wheel channels are only registered once the configuration says how many there are
+    host.configure_truck( SYNTHETIC_WHEELS );
+    host.configure_trailer( 0, SYNTHETIC_WHEELS );
+    for ( uint32_t i = 1; i < telemetry::MAX_TRAILERS; ++i ) host.configure_trailer( i, 0 );
+    host.set_paused( false );
+
+    printf( "channels registered: %u (%u resolved by the host)\n", host.get_channel_count(), host.get_resolved_channel_count() );
+
+    if ( record != nullptr && !telemetry.get_recorder()->start( record ) )
+    {
+        printf( "could not start recording to '%s'\n", record );
+        return 1;
+    }
+
+    std::vector< uint32_t > frame_ns;
+    frame_ns.reserve( frames.size() * repeat );
+
+    // frames are copied in before the clock starts, in game the values are hot and reading the input from memory
+    // would otherwise dominate the measurement
+    telemetry::telemetry_frame_t current{};
+    uint64_t gameplay_events = 0;
+
+    const auto start_stats = host.get_stats();
+    const auto start = std::chrono::steady_clock::now();
+    for ( uint32_t pass = 0; pass < repeat; ++pass )
+    {
+        for ( const auto& frame : frames )
+        {
+            current = frame;
+            if ( frame.frame_index % GAMEPLAY_EVENT_INTERVAL == GAMEPLAY_EVENT_INTERVAL - 1 ) send_tollgate( host, static_cast< int64_t >( ++gameplay_events ) );
+
+            // the replay runs far faster than the game, let the recorder catch up instead of having it drop frames,
+            // outside the measured time
+            while ( record != nullptr && telemetry.get_recorder()->get_queued_frames() >= telemetry::CTelemetryRecorder::QUEUE_CAPACITY / 2 )
+            {
+                std::this_thread::yield();
+            }
+
+            const auto frame_start = std::chrono::steady_clock::now();
+            host.replay_frame( current );
+            frame_ns.push_back( static_cast< uint32_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - frame_start ).count() ) );
+        }
+    }
+    const auto wall_time = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+    if ( record != nullptr ) telemetry.get_recorder()->stop();
+
+    const auto& stats = host.get_stats();
+    const auto replayed = stats.frames - start_stats.frames;
+    const auto callbacks = stats.channel_callbacks - start_stats.channel_callbacks;
+    const auto game_seconds = static_cast< double >( frames.back().render_time - frames.front().render_time ) / 1000000.0 * repeat;
+
+    double elapsed = 0.0;
+    for ( const auto ns : frame_ns ) elapsed += static_cast< double >( ns ) / 1e9;
+
+    std::sort( frame_ns.begin(), frame_ns.end() );
+    const auto percentile = [ &frame_ns ]( const double p ) { return frame_ns[ static_cast< size_t >( p * static_cast< double >( frame_ns.size() - 1 ) ) ]; };
+
+    printf( "frames:            %" PRIu64 " in %.3f s, %.3f s spent in callbacks (%.0fx real time)\n", replayed, wall_time, elapsed,
+            wall_time > 0.0 ? game_seconds / wall_time : 0.0 );
+    printf( "channel callbacks: %" PRIu64 " (%.1f per frame, %.1f M/s)\n", callbacks, static_cast< double >( callbacks ) / static_cast< double >( replayed ),
+            static_cast< double >( callbacks ) / elapsed / 1000000.0 );
+    printf( "per frame:         mean %.0f ns, p50 %u ns, p99 %u ns, max %u ns\n", elapsed * 1e9 / static_cast< double >( replayed ), percentile( 0.5 ),
+            percentile( 0.99 ), frame_ns.back() );
+    if ( record != nullptr )
+    {
+        const auto* recorder = telemetry.get_recorder();
+        printf( "recorded:          %" PRIu64 " frames, %" PRIu64 " dropped, %" PRIu64 " gameplay events, %" PRIu64 " bytes\n",
+                recorder->get_frames_recorded(), recorder->get_frames_dropped(), recorder->get_events_recorded(), recorder->get_bytes_written() );
+    }
+
+    if ( filter )
+    {
+        const auto* channel_filter = telemetry.get_filter();
+        printf( "filtered channels: %" PRIu64 " value changes, %" PRIu64 " passed on\n", channel_filter->get_raw_changes(),
+                channel_filter->get_passed_changes() );
+    }
+
+    // the published frame has to match what was fed in, anything else means a binding went to the wrong place, with
+    // the filter on only the unfiltered working frame can be compared
+    telemetry::telemetry_frame_t published{};
+    const auto& last = frames.back();
+    if ( !telemetry.get_frame_store()->read( published ) || telemetry.get_frame_store()->get_published_count() != replayed )
+    {
+        printf( "FAILED: %" PRIu64 " frames published, expected %" PRIu64 "\n", telemetry.get_frame_store()->get_published_count(), replayed );
+        return 1;
+    }
+    const auto& checked = filter ? telemetry.get_frame_store()->working() : published;
+    if ( std::memcmp( &checked.truck, &last.truck, sizeof( last.truck ) ) != 0 ||
+         std::memcmp( &checked.trailers, &last.trailers, sizeof( last.trailers ) ) != 0 || published.render_time != last.render_time )
+    {
+        printf( "FAILED: last published frame does not match the replayed one\n" );
+        return 1;
+    }
+
+    int connected = 0;
+    for ( const auto trailer : last.trailers.connected ) connected += trailer ? 1 : 0;
+    if ( telemetry.get_trailer_count() != connected )
+    {
+        printf( "FAILED: %d trailers connected, expected %d\n", telemetry.get_trailer_count(), connected );
+        return 1;
+    }
+
+    if ( telemetry.get_gameplay_events()->get_pushed_count() != gameplay_events )
+    {
+        printf( "FAILED: %" PRIu64 " gameplay events queued, expected %" PRIu64 "\n", telemetry.get_gameplay_events()->get_pushed_count(), gameplay_events );
+        return 1;
+    }
+
+    // a recording with gaps can't be compared with its source
+    if ( record != nullptr && ( telemetry.get_recorder()->get_frames_dropped() != 0 || telemetry.get_recorder()->get_frames_recorded() != replayed ) )
+    {
+        printf( "FAILED: %" PRIu64 " frames recorded and %" PRIu64 " dropped, expected %" PRIu64 " and 0\n", telemetry.get_recorder()->get_frames_recorded(),
+                telemetry.get_recorder()->get_frames_dropped(), replayed );
+        return 1;
+    }
+
+    printf( "published frames match\n" );
+    return 0;
+}
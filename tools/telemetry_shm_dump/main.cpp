@@ -0,0 +1,129 @@
+// Attaches to the telemetry shared memory exported by the plugin and prints its layout and the latest frame.
+//
+// usage: telemetry-shm-dump [--name <region>] [--field <channel>]... [--watch <ms>]
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "telemetry/shared_memory.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    const char* type_name( const uint16_t type )
+    {
+        switch ( type )
+        {
+            case SCS_VALUE_TYPE_bool: return "bool";
+            case SCS_VALUE_TYPE_s32: return "s32";
+            case SCS_VALUE_TYPE_u32: return "u32";
+            case SCS_VALUE_TYPE_float: return "float";
+            case SCS_VALUE_TYPE_fvector: return "fvector";
+            case SCS_VALUE_TYPE_dplacement: return "dplacement";
+            default: return "?";
+        }
+    }
+
+    void print_value( const uint16_t type, const uint8_t* data )
+    {
+        switch ( type )
+        {
+            case SCS_VALUE_TYPE_bool: printf( "%s", *data ? "true" : "false" ); break;
+            case SCS_VALUE_TYPE_s32: printf( "%d", *reinterpret_cast< const int32_t* >( data ) ); break;
+            case SCS_VALUE_TYPE_u32: printf( "%u", *reinterpret_cast< const uint32_t* >( data ) ); break;
+            case SCS_VALUE_TYPE_float: printf( "%.3f", *reinterpret_cast< const float* >( data ) ); break;
+            case SCS_VALUE_TYPE_fvector:
+            {
+                const auto* v = reinterpret_cast< const scs_value_fvector_t* >( data );
+                printf( "(%.3f %.3f %.3f)", v->x, v->y, v->z );
+                break;
+            }
+            case SCS_VALUE_TYPE_dplacement:
+            {
+                const auto* p = reinterpret_cast< const scs_value_dplacement_t* >( data );
+                printf( "(%.2f %.2f %.2f | %.3f %.3f %.3f)", p->position.x, p->position.y, p->position.z,
+                        p->orientation.heading, p->orientation.pitch, p->orientation.roll );
+                break;
+            }
+            default: printf( "?" ); break;
+        }
+    }
+
+    void print_field( const telemetry::shared_memory_field_t& field, const std::vector< uint8_t >& slot )
+    {
+        printf( "  %-36s", field.name );
+        for ( uint32_t i = 0; i < field.count; ++i )
+        {
+            if ( field.stride != 0 && i != 0 && i % field.stride == 0 ) printf( " |" );
+            printf( " " );
+            print_value( field.type, slot.data() + field.offset + static_cast< size_t >( field.element_size ) * i );
+        }
+        printf( "\n" );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const char* name = telemetry::SHARED_MEMORY_NAME;
+    std::vector< const char* > fields;
+    uint32_t watch_ms = 0;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--name" ) == 0 ) name = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "--field" ) == 0 ) fields.push_back( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--watch" ) == 0 ) watch_ms = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+    }
+
+    telemetry::CSharedMemoryReader reader;
+    if ( !reader.open( name ) )
+    {
+        fprintf( stderr, "%s: not found or not a v%u telemetry export\n", name, telemetry::SHARED_MEMORY_VERSION );
+        return 1;
+    }
+
+    const auto* header = reader.get_header();
+    printf( "telemetry export v%u, %u bytes, %u slots x %u bytes\n", header->version, header->region_size, header->ring_capacity, header->slot_size );
+    printf( "truck wheels %u, trailers %u x %u wheels, %u fields\n", header->truck_wheel_count, header->trailer_count,
+            header->trailer_wheel_count, header->field_count );
+    if ( fields.empty() )
+    {
+        std::vector< telemetry::shared_memory_field_t > table;
+        if ( !reader.read_fields( table ) ) printf( "  the field table kept changing\n" );
+        for ( const auto& field : table )
+        {
+            printf( "  0x%04x %-36s %-10s x%u\n", field.offset, field.name, type_name( field.type ), field.count );
+        }
+    }
+
+    std::vector< uint8_t > slot;
+    do
+    {
+        if ( !reader.read_latest( slot ) )
+        {
+            printf( "no frame published yet\n" );
+        }
+        else
+        {
+            const auto* slot_header = reinterpret_cast< const telemetry::shared_memory_slot_header_t* >( slot.data() );
+            printf( "frame %" PRIu64 " render %" PRId64 " us%s\n", slot_header->frame_index, slot_header->render_time,
+                    slot_header->flags & telemetry::SharedFrameFlags::PAUSED ? " (paused)" : "" );
+
+            for ( const auto* field_name : fields )
+            {
+                telemetry::shared_memory_field_t field;
+                if ( !reader.find_field( field_name, field ) ) printf( "  %-36s not exported\n", field_name );
+                else print_field( field, slot );
+            }
+        }
+
+        if ( watch_ms != 0 ) std::this_thread::sleep_for( std::chrono::milliseconds( watch_ms ) );
+    }
+    while ( watch_ms != 0 );
+    return 0;
+}
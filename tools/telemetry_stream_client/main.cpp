@@ -0,0 +1,264 @@
+// Subscribes to the plugin's UDP telemetry stream and prints what arrives, or benchmarks the stream on loopback.
+//
+// usage: telemetry-stream-client [--host <ip>] [--port <n>] [--channel <name prefix>]... [--batch <n>] [--divisor <n>]
+//                                [--seconds <n>] [--print 1]
+//        telemetry-stream-client --bench <frames> [--rate <frames/s>] [--port <n>] [--channel <name prefix>]... [--batch <n>]
+//
+// --bench runs a stream server inside this process, pushes synthetic frames into it from the main thread the way
+// frame_end does and receives them with a client thread. Without --rate it pushes as fast as the server thread
+// encodes and waits whenever the queue is half full, so every frame is streamed and the push cost is measured under
+// load. With --rate it pushes at that many frames/s like the game would and never waits, frames the server can't
+// keep up with are dropped and reported. Timings are only meaningful in an optimized build (-DCMAKE_BUILD_TYPE=Release).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry/stream.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    struct print_context_t
+    {
+        const telemetry::CTelemetryStreamClient* client;
+        bool print;
+    };
+
+    void print_value( const uint8_t type, const uint64_t raw )
+    {
+        switch ( type )
+        {
+            case telemetry::ColumnType::BOOL: printf( "%u", static_cast< uint32_t >( raw != 0 ) ); break;
+            case telemetry::ColumnType::S32: printf( "%d", static_cast< int32_t >( raw ) ); break;
+            case telemetry::ColumnType::U32: printf( "%u", static_cast< uint32_t >( raw ) ); break;
+            case telemetry::ColumnType::S64: printf( "%" PRId64, static_cast< int64_t >( raw ) ); break;
+            case telemetry::ColumnType::U64: printf( "%" PRIu64, raw ); break;
+            case telemetry::ColumnType::F32:
+            {
+                float value;
+                const auto bits = static_cast< uint32_t >( raw );
+                memcpy( &value, &bits, sizeof( value ) );
+                printf( "%.6g", value );
+                break;
+            }
+            case telemetry::ColumnType::F64:
+            {
+                double value;
+                memcpy( &value, &raw, sizeof( value ) );
+                printf( "%.10g", value );
+                break;
+            }
+            default: printf( "?" ); break;
+        }
+    }
+
+    void on_frame( const uint64_t frame_index, const int64_t render_time, const uint64_t* values, const uint32_t count, void* user_data )
+    {
+        const auto* context = static_cast< const print_context_t* >( user_data );
+        if ( !context->print ) return;
+
+        const auto& columns = context->client->get_columns();
+        printf( "%" PRIu64 " %.3f", frame_index, static_cast< double >( render_time ) / 1000000.0 );
+        for ( uint32_t i = 0; i < count; ++i )
+        {
+            printf( " %s[%u]=", columns[ i ].name, columns[ i ].element );
+            print_value( columns[ i ].type, values[ i ] );
+        }
+        printf( "\n" );
+    }
+
+    void print_stats( const telemetry::CTelemetryStreamClient& client, const double seconds )
+    {
+        const auto& stats = client.get_stats();
+        printf( "received:          %" PRIu64 " frames in %" PRIu64 " datagrams (%.1f frames per datagram), %" PRIu64 " lost\n", stats.frames,
+                stats.datagrams, stats.datagrams != 0 ? static_cast< double >( stats.frames ) / static_cast< double >( stats.datagrams ) : 0.0,
+                stats.lost_datagrams );
+        printf( "                   %.0f frames/s, %.0f datagrams/s, %.1f KiB/s, %zu columns\n", static_cast< double >( stats.frames ) / seconds,
+                static_cast< double >( stats.datagrams ) / seconds, static_cast< double >( stats.bytes ) / 1024.0 / seconds, client.get_columns().size() );
+    }
+
+    // enough movement that nothing about the values is special, the stream sends raw values either way
+    void fill_synthetic_frame( telemetry::telemetry_frame_t& frame, const uint32_t i )
+    {
+        frame.frame_index = i;
+        frame.render_time = 16667ll * i;
+        frame.simulation_time = 16667ll * i;
+        frame.paused_simulation_time = 16667ll * i;
+
+        auto& truck = frame.truck;
+        truck.speed = 20.0f + 5.0f * std::sin( i * 0.001f );
+        truck.engine_rpm = 1200.0f + 300.0f * std::sin( i * 0.002f );
+        truck.effective_steering = 0.1f * std::sin( i * 0.003f );
+        truck.world_placement.position.x += truck.speed * 0.016667;
+        truck.odometer = 12345.0f + i * 0.0003f;
+        for ( uint32_t wheel = 0; wheel < 6; ++wheel ) truck.wheels.rotation[ wheel ] = std::fmod( i * 0.05f, 1.0f );
+    }
+
+    int run_bench( const uint32_t frame_count, const uint32_t rate, const uint16_t port, const std::vector< std::string >& channels, const uint16_t batch )
+    {
+        telemetry::CTelemetryStreamServer server;
+        if ( !server.start( port ) )
+        {
+            printf( "could not start the stream server on port %u\n", port );
+            return 1;
+        }
+
+        telemetry::CTelemetryStreamClient client;
+        if ( !client.connect( "127.0.0.1", port, channels, batch ) )
+        {
+            printf( "could not connect\n" );
+            return 1;
+        }
+
+        std::atomic< bool > ready = false;
+        std::atomic< bool > done = false;
+        std::thread receiver( [ & ]
+        {
+            print_context_t context{ &client, false };
+            while ( !done.load( std::memory_order_acquire ) )
+            {
+                client.poll( 10, on_frame, &context );
+                if ( client.has_schema() ) ready.store( true, std::memory_order_release );
+            }
+            // whatever is still in flight
+            while ( client.poll( 100, on_frame, &context ) != 0 ) {}
+        } );
+
+        const auto wait_start = std::chrono::steady_clock::now();
+        while ( !ready.load( std::memory_order_acquire ) || server.get_subscriber_count() == 0 )
+        {
+            if ( std::chrono::steady_clock::now() - wait_start > std::chrono::seconds( 5 ) )
+            {
+                printf( "no schema from the server\n" );
+                done = true;
+                receiver.join();
+                return 1;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+
+        // one frame reused like the frame store's working frame, only the push is timed
+        auto* frame = new telemetry::telemetry_frame_t();
+        std::vector< uint32_t > push_ns;
+        push_ns.reserve( frame_count );
+
+        const auto interval = rate != 0 ? std::chrono::nanoseconds( 1000000000ll / rate ) : std::chrono::nanoseconds( 0 );
+        uint64_t waits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for ( uint32_t i = 0; i < frame_count; ++i )
+        {
+            if ( rate != 0 )
+            {
+                while ( std::chrono::steady_clock::now() < start + interval * i ) {}
+            }
+            else if ( server.get_queued_frames() >= telemetry::CTelemetryStreamServer::QUEUE_CAPACITY / 2 )
+            {
+                // unpaced, the server thread sets the pace instead of the drop counter
+                ++waits;
+                while ( server.get_queued_frames() >= telemetry::CTelemetryStreamServer::QUEUE_CAPACITY / 2 ) std::this_thread::yield();
+            }
+
+            fill_synthetic_frame( *frame, i );
+
+            const auto push_start = std::chrono::steady_clock::now();
+            server.push( *frame );
+            push_ns.push_back( static_cast< uint32_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - push_start ).count() ) );
+        }
+        const auto push_seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+        // a partly filled batch goes out after STREAM_MAX_BATCH_DELAY_MS
+        std::this_thread::sleep_for( std::chrono::milliseconds( telemetry::STREAM_MAX_BATCH_DELAY_MS * 4 ) );
+        done = true;
+        receiver.join();
+        server.stop();
+        client.disconnect();
+        delete frame;
+
+        double push_total = 0.0;
+        for ( const auto ns : push_ns ) push_total += static_cast< double >( ns );
+        std::sort( push_ns.begin(), push_ns.end() );
+        const auto percentile = [ &push_ns ]( const double p ) { return push_ns[ static_cast< size_t >( p * static_cast< double >( push_ns.size() - 1 ) ) ]; };
+
+        printf( "pushed:            %u frames in %.3f s (%.0f frames/s), %s\n", frame_count, push_seconds, frame_count / push_seconds,
+                rate != 0 ? "paced" : ( std::to_string( waits ) + " waits for the queue" ).c_str() );
+        printf( "push cost:         mean %.0f ns, p50 %u ns, p99 %u ns, max %u ns\n", push_total / frame_count, percentile( 0.5 ), percentile( 0.99 ),
+                push_ns.back() );
+        printf( "server:            %" PRIu64 " frames streamed, %" PRIu64 " dropped at the queue, %" PRIu64 " datagrams, %" PRIu64 " bytes, %" PRIu64
+                " send errors\n", server.get_frames_streamed(), server.get_frames_dropped(), server.get_datagrams_sent(), server.get_bytes_sent(),
+                server.get_send_errors() );
+        print_stats( client, push_seconds );
+
+        if ( client.get_stats().frames != server.get_frames_streamed() )
+        {
+            printf( "%" PRIu64 " streamed frames never arrived\n", server.get_frames_streamed() - client.get_stats().frames );
+        }
+        if ( rate == 0 && server.get_frames_dropped() != 0 )
+        {
+            printf( "FAIL: frames were dropped although the bench waited for the queue\n" );
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    const char* host = "127.0.0.1";
+    uint16_t port = telemetry::STREAM_DEFAULT_PORT;
+    std::vector< std::string > channels;
+    uint16_t batch = 0;
+    uint16_t divisor = 1;
+    double seconds = 10.0;
+    bool print = false;
+    uint32_t bench_frames = 0;
+    uint32_t rate = 0;
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[ i ], "--host" ) == 0 ) host = argv[ i + 1 ];
+        else if ( strcmp( argv[ i ], "--port" ) == 0 ) port = static_cast< uint16_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--channel" ) == 0 ) channels.emplace_back( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--batch" ) == 0 ) batch = static_cast< uint16_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--divisor" ) == 0 ) divisor = static_cast< uint16_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--seconds" ) == 0 ) seconds = atof( argv[ i + 1 ] );
+        else if ( strcmp( argv[ i ], "--print" ) == 0 ) print = atoi( argv[ i + 1 ] ) != 0;
+        else if ( strcmp( argv[ i ], "--bench" ) == 0 ) bench_frames = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+        else if ( strcmp( argv[ i ], "--rate" ) == 0 ) rate = static_cast< uint32_t >( strtoul( argv[ i + 1 ], nullptr, 10 ) );
+    }
+
+    if ( bench_frames != 0 ) return run_bench( bench_frames, rate, port, channels, batch );
+
+    telemetry::CTelemetryStreamClient client;
+    if ( !client.connect( host, port, channels, batch, divisor ) )
+    {
+        printf( "could not connect to %s:%u\n", host, port );
+        return 1;
+    }
+
+    print_context_t context{ &client, print };
+    const auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    while ( elapsed < seconds )
+    {
+        client.poll( 100, on_frame, &context );
+        elapsed = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+    }
+    client.disconnect();
+
+    if ( !client.has_schema() )
+    {
+        printf( "no schema from %s:%u, is the stream started in the telemetry window?\n", host, port );
+        return 1;
+    }
+    print_stats( client, elapsed );
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Converts between names and prism tokens and benchmarks the batch token codec and the token dictionary.
+//
+// usage: token-tool encode <name>...
+//        token-tool decode <token>...          decimal or 0x hex
+//        token-tool --bench <count>            random names, default 1000000
+//
+// The benchmark decodes and encodes the same random tokens with the per-token functions from token.hpp (to_string()
+// with its std::string per name, and string_to_token) and with the batch functions into one arena, then looks them up
+// in a token dictionary of the first 4096, half of them given at startup and half interned on the first lookup. It
+// checks that all of them give the same names and tokens and exits with 1 if they don't.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "prism/token_codec.hpp"
+#include "prism/token_dictionary.hpp"
+
+using namespace ts_extra_utilities;
+
+namespace
+{
+    using clock_t_ = std::chrono::steady_clock;
+
+    double elapsed_ns( const clock_t_::time_point start, const size_t count )
+    {
+        return std::chrono::duration< double, std::nano >( clock_t_::now() - start ).count() / static_cast< double >( count );
+    }
+
+    // names of 1 - 12 letters from the whole alphabet, no zeros in the middle
+    std::vector< prism::token_t > make_tokens( const size_t count )
+    {
+        std::mt19937_64 random( 38 );
+        std::uniform_int_distribution< uint32_t > length( 1, prism::max_token_length );
+        std::uniform_int_distribution< uint32_t > letter( 1, prism::i_num_letters - 1 );
+
+        std::vector< prism::token_t > tokens;
+        tokens.reserve( count );
+        for ( size_t i = 0; i < count; ++i )
+        {
+            uint64_t token = 0;
+            for ( auto l = length( random ); l > 0; --l ) token = token * 38 + letter( random );
+            tokens.emplace_back( token );
+        }
+        return tokens;
+    }
+
+    int bench( const size_t count )
+    {
+        const auto tokens = make_tokens( count );
+        int result = EXIT_SUCCESS;
+
+        // decode
+        auto start = clock_t_::now();
+        std::vector< std::string > strings;
+        strings.reserve( count );
+        for ( const auto& token : tokens ) strings.push_back( token.to_string() );
+        const auto to_string_ns = elapsed_ns( start, count );
+
+        start = clock_t_::now();
+        std::vector< char > arena( prism::decoded_arena_size( count ) );
+        size_t length_sum = 0;
+        for ( const auto& token : tokens ) length_sum += token.decode( arena.data() );
+        const auto decode_ns = elapsed_ns( start, count );
+
+        std::vector< prism::token_name_t > names( count );
+        start = clock_t_::now();
+        const auto arena_size = prism::decode_tokens( tokens.data(), count, arena.data(), names.data() );
+        const auto batch_decode_ns = elapsed_ns( start, count );
+
+        if ( arena_size != length_sum + count ) result = EXIT_FAILURE;
+        for ( size_t i = 0; i < count && result == EXIT_SUCCESS; ++i )
+        {
+            if ( strings[ i ].compare( 0, std::string::npos, arena.data() + names[ i ].offset, names[ i ].length ) != 0 )
+            {
+                printf( "decode mismatch for %" PRIu64 ": '%s' vs '%s'\n", tokens[ i ].m_token, strings[ i ].c_str(), arena.data() + names[ i ].offset );
+                result = EXIT_FAILURE;
+            }
+        }
+
+        // encode
+        std::vector< prism::token_t > encoded( count, prism::token_t( 0 ) );
+        start = clock_t_::now();
+        for ( size_t i = 0; i < count; ++i ) encoded[ i ] = prism::string_to_token( strings[ i ].c_str() );
+        const auto string_to_token_ns = elapsed_ns( start, count );
+
+        std::vector< prism::token_t > batch_encoded( count, prism::token_t( 0 ) );
+        start = clock_t_::now();
+        const auto encoded_count = prism::encode_token_arena( arena.data(), arena_size, batch_encoded.data(), count );
+        const auto batch_encode_ns = elapsed_ns( start, count );
+
+        if ( encoded_count != count || encoded != tokens || batch_encoded != tokens )
+        {
+            printf( "encode mismatch\n" );
+            result = EXIT_FAILURE;
+        }
+
+        // dictionary over a working set the size of the names in a game's definitions, the first half is the startup set
+        const auto working_set = std::min< size_t >( count, 4096 );
+        std::vector< std::string_view > startup_names;
+        for ( size_t i = 0; i < working_set / 2; ++i ) startup_names.emplace_back( arena.data() + names[ i ].offset, names[ i ].length );
+        start = clock_t_::now();
+        prism::CTokenDictionary dictionary( startup_names.data(), startup_names.size() );
+        const auto build_ns = elapsed_ns( start, std::max< size_t >( startup_names.size(), 1 ) );
+
+        start = clock_t_::now();
+        for ( size_t i = 0; i < working_set; ++i ) dictionary.get_name( tokens[ i ] );
+        const auto first_lookup_ns = elapsed_ns( start, working_set );
+
+        size_t mismatches = 0;
+        start = clock_t_::now();
+        for ( size_t i = 0; i < count; ++i ) mismatches += dictionary.get_name( tokens[ i % working_set ] ) == nullptr;
+        const auto get_name_ns = elapsed_ns( start, count );
+
+        start = clock_t_::now();
+        for ( size_t i = 0; i < count; ++i ) mismatches += tokens[ i % working_set ].to_string() != strings[ i % working_set ];
+        const auto compare_to_string_ns = elapsed_ns( start, count );
+
+        start = clock_t_::now();
+        for ( size_t i = 0; i < count; ++i ) mismatches += strcmp( dictionary.get_name( tokens[ i % working_set ] ), strings[ i % working_set ].c_str() ) != 0;
+        const auto lookup_ns = elapsed_ns( start, count );
+
+        start = clock_t_::now();
+        for ( size_t i = 0; i < count; ++i )
+        {
+            prism::token_t token( 0 );
+            mismatches += !dictionary.find_token( strings[ i % working_set ], token ) || token != tokens[ i % working_set ];
+        }
+        const auto reverse_lookup_ns = elapsed_ns( start, count );
+
+        std::vector< uint64_t > distinct;
+        for ( size_t i = 0; i < working_set; ++i ) distinct.push_back( tokens[ i ].m_token );
+        std::sort( distinct.begin(), distinct.end() );
+        distinct.erase( std::unique( distinct.begin(), distinct.end() ), distinct.end() );
+        if ( mismatches != 0 || dictionary.size() != distinct.size() )
+        {
+            printf( "dictionary mismatch\n" );
+            result = EXIT_FAILURE;
+        }
+
+        printf( "%zu tokens, %.2f letters on average, arena %zu bytes\n", count, static_cast< double >( length_sum ) / count, arena_size );
+        printf( "decode  to_string          %7.2f ns/token\n", to_string_ns );
+        printf( "        token_t::decode    %7.2f ns/token\n", decode_ns );
+        printf( "        decode_tokens      %7.2f ns/token  %.2fx to_string\n", batch_decode_ns, to_string_ns / batch_decode_ns );
+        printf( "encode  string_to_token    %7.2f ns/token\n", string_to_token_ns );
+        printf( "        encode_token_arena %7.2f ns/token\n", batch_encode_ns );
+        printf( "dict    %zu names, %zu at startup\n", working_set, startup_names.size() );
+        printf( "        build              %7.2f ns/name\n", build_ns );
+        printf( "        get_name, first    %7.2f ns/token  the other half interned here\n", first_lookup_ns );
+        printf( "        get_name           %7.2f ns/token\n", get_name_ns );
+        printf( "        to_string + ==     %7.2f ns/token\n", compare_to_string_ns );
+        printf( "        get_name + strcmp  %7.2f ns/token  %.2fx to_string\n", lookup_ns, compare_to_string_ns / lookup_ns );
+        printf( "        find_token         %7.2f ns/token\n", reverse_lookup_ns );
+        printf( "%s\n", result == EXIT_SUCCESS ? "results match" : "results DIFFER" );
+        return result;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc >= 2 && strcmp( argv[ 1 ], "--bench" ) == 0 )
+    {
+        const auto count = argc >= 3 ? static_cast< size_t >( strtoull( argv[ 2 ], nullptr, 10 ) ) : 1000000;
+        return bench( std::max< size_t >( count, 1 ) );
+    }
+
+    if ( argc >= 3 && strcmp( argv[ 1 ], "encode" ) == 0 )
+    {
+        for ( int i = 2; i < argc; ++i )
+        {
+            const auto token = prism::string_to_token( argv[ i ] );
+            printf( "%s = %" PRIu64 " (0x%016" PRIx64 ")\n", argv[ i ], token.m_token, token.m_token );
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if ( argc >= 3 && strcmp( argv[ 1 ], "decode" ) == 0 )
+    {
+        const auto count = static_cast< size_t >( argc - 2 );
+        std::vector< prism::token_t > tokens;
+        for ( int i = 2; i < argc; ++i ) tokens.emplace_back( strtoull( argv[ i ], nullptr, 0 ) );
+
+        std::vector< char > arena( prism::decoded_arena_size( count ) );
+        std::vector< prism::token_name_t > names( count );
+        prism::decode_tokens( tokens.data(), count, arena.data(), names.data() );
+        for ( size_t i = 0; i < count; ++i ) printf( "%" PRIu64 " = %s\n", tokens[ i ].m_token, arena.data() + names[ i ].offset );
+        return EXIT_SUCCESS;
+    }
+
+    printf( "usage: token-tool encode <name>... | decode <token>... | --bench [count]\n" );
+    return EXIT_FAILURE;
+}